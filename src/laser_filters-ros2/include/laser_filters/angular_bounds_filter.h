@@ -41,6 +41,9 @@
 #include <builtin_interfaces/msg/time.hpp>
 #include <sensor_msgs/msg/laser_scan.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace laser_filters
 {
   class LaserScanAngularBoundsFilter : public filters::FilterBase<sensor_msgs::msg::LaserScan>
@@ -66,57 +69,49 @@ namespace laser_filters
       virtual ~LaserScanAngularBoundsFilter(){}
 
       bool update(const sensor_msgs::msg::LaserScan& input_scan, sensor_msgs::msg::LaserScan& filtered_scan){
-        filtered_scan.ranges.resize(input_scan.ranges.size());
-        filtered_scan.intensities.resize(input_scan.intensities.size());
-
-        double start_angle = input_scan.angle_min;
-        double current_angle = input_scan.angle_min;
-        rclcpp::Time start_time = input_scan.header.stamp;
-        unsigned int count = 0;
-        //loop through the scan and truncate the beginning and the end of the scan as necessary
-        for(unsigned int i = 0; i < input_scan.ranges.size(); ++i){
-          //wait until we get to our desired starting angle
-          if(start_angle < lower_angle_){
-            start_angle += input_scan.angle_increment;
-            current_angle += input_scan.angle_increment;
-            start_time += rclcpp::Duration::from_seconds(input_scan.time_increment);
-          }
-          else{
-            filtered_scan.ranges[count] = input_scan.ranges[i];
-
-            //make sure  that we don't update intensity data if its not available
-            if(input_scan.intensities.size() > i)
-              filtered_scan.intensities[count] = input_scan.intensities[i];
-
-            count++;
-
-            //check if we need to break out of the loop, basically if the next increment will put us over the threshold
-            if(current_angle + input_scan.angle_increment > upper_angle_){
-              break;
-            }
-
-            current_angle += input_scan.angle_increment;
-
-          }
+        const size_t num_beams = input_scan.ranges.size();
+
+        if(input_scan.angle_increment <= 0){
+          RCLCPP_ERROR(logging_interface_->get_logger(), "Scans with non-positive angle_increment are not supported.");
+          return false;
+        }
+
+        //compute the index range [first, first + count) of the beams to keep in closed form
+        //first beam at or above lower_angle_
+        const double lower = std::ceil((lower_angle_ - input_scan.angle_min) / input_scan.angle_increment - 1e-6);
+        const size_t first = size_t(std::min(std::max(lower, 0.), double(num_beams)));
+
+        //last beam at or below upper_angle_, the first beam is always kept
+        size_t count = 0;
+        if(first < num_beams){
+          const double upper = std::floor((upper_angle_ - input_scan.angle_min) / input_scan.angle_increment + 1e-6);
+          const size_t last = size_t(std::min(std::max(upper, double(first)), double(num_beams - 1)));
+          count = last - first + 1;
         }
 
+        filtered_scan.ranges.assign(input_scan.ranges.begin() + first, input_scan.ranges.begin() + first + count);
+
+        //make sure that we don't copy intensity data if its not available
+        const size_t num_intensities = input_scan.intensities.size();
+        const size_t intensities_end = std::min(first + count, num_intensities);
+        if(first < intensities_end)
+          filtered_scan.intensities.assign(input_scan.intensities.begin() + first, input_scan.intensities.begin() + intensities_end);
+        else
+          filtered_scan.intensities.clear();
+
         //make sure to set all the needed fields on the filtered scan
         filtered_scan.header.frame_id = input_scan.header.frame_id;
-        filtered_scan.header.stamp = start_time;
-        filtered_scan.angle_min = start_angle;
-        filtered_scan.angle_max = current_angle;
+        filtered_scan.header.stamp = rclcpp::Time(input_scan.header.stamp) +
+            rclcpp::Duration::from_seconds(first * input_scan.time_increment);
+        filtered_scan.angle_min = input_scan.angle_min + first * input_scan.angle_increment;
+        filtered_scan.angle_max = filtered_scan.angle_min + (count > 0 ? count - 1 : 0) * input_scan.angle_increment;
         filtered_scan.angle_increment = input_scan.angle_increment;
         filtered_scan.time_increment = input_scan.time_increment;
         filtered_scan.scan_time = input_scan.scan_time;
         filtered_scan.range_min = input_scan.range_min;
         filtered_scan.range_max = input_scan.range_max;
 
-        filtered_scan.ranges.resize(count);
-
-        if(input_scan.intensities.size() >= count)
-          filtered_scan.intensities.resize(count);
-
-        RCLCPP_DEBUG(logging_interface_->get_logger(), "Filtered out %d points from the laser scan.", (int)input_scan.ranges.size() - (int)count);
+        RCLCPP_DEBUG(logging_interface_->get_logger(), "Filtered out %d points from the laser scan.", (int)num_beams - (int)count);
 
         return true;
 
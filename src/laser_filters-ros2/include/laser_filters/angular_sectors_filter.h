@@ -0,0 +1,164 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2009, Willow Garage, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_SCAN_ANGULAR_SECTORS_FILTER_H
+#define LASER_SCAN_ANGULAR_SECTORS_FILTER_H
+
+#include <filters/filter_base.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace laser_filters
+{
+  /**
+   * @brief Removes the points inside of several angular sectors (lower_angles[k], upper_angles[k])
+   * from a laser scan, keeping the scan size. This generalizes LaserScanAngularBoundsFilterInPlace.
+   *
+   * The index range of each sector is computed in closed form from angle_min / angle_increment
+   * and cached until the scan geometry changes.
+   */
+  class LaserScanAngularSectorsFilter : public filters::FilterBase<sensor_msgs::msg::LaserScan>
+  {
+    public:
+      std::vector<double> lower_angles_;
+      std::vector<double> upper_angles_;
+      bool replace_with_nan_;
+
+      bool configure()
+      {
+        lower_angles_.clear();
+        upper_angles_.clear();
+        replace_with_nan_ = false;
+
+        if (!getParam("lower_angles", lower_angles_) || !getParam("upper_angles", upper_angles_))
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "Both the lower_angles and upper_angles parameters must be set to use this filter.");
+          return false;
+        }
+        if (lower_angles_.empty() || lower_angles_.size() != upper_angles_.size())
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "lower_angles and upper_angles must have the same, non-zero number of elements.");
+          return false;
+        }
+        for (size_t k = 0; k < lower_angles_.size(); ++k)
+        {
+          if (lower_angles_[k] >= upper_angles_[k])
+          {
+            RCLCPP_ERROR(logging_interface_->get_logger(), "Sector %zu: lower angle %f must be smaller than upper angle %f.", k, lower_angles_[k], upper_angles_[k]);
+            return false;
+          }
+        }
+        getParam("replace_with_nan", replace_with_nan_);
+
+        cached_size_ = 0;
+        return true;
+      }
+
+      virtual ~LaserScanAngularSectorsFilter(){}
+
+      bool update(const sensor_msgs::msg::LaserScan& input_scan, sensor_msgs::msg::LaserScan& filtered_scan){
+        filtered_scan = input_scan; //copy entire message
+
+        if (input_scan.angle_increment <= 0)
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "Scans with non-positive angle_increment are not supported.");
+          return false;
+        }
+
+        if (input_scan.ranges.size() != cached_size_ ||
+            input_scan.angle_min != cached_angle_min_ ||
+            input_scan.angle_increment != cached_angle_increment_)
+        {
+          updateIndexRanges(input_scan);
+        }
+
+        const float replacement = replace_with_nan_ ?
+            std::numeric_limits<float>::quiet_NaN() : input_scan.range_max + 1.0;
+        const size_t num_intensities = filtered_scan.intensities.size();
+
+        size_t count = 0;
+        for (const auto& range : index_ranges_)
+        {
+          std::fill(filtered_scan.ranges.begin() + range.first, filtered_scan.ranges.begin() + range.second, replacement);
+          if (range.first < num_intensities)
+          {
+            std::fill(filtered_scan.intensities.begin() + range.first,
+                      filtered_scan.intensities.begin() + std::min(range.second, num_intensities), 0.0f);
+          }
+          count += range.second - range.first;
+        }
+
+        RCLCPP_DEBUG(logging_interface_->get_logger(), "Filtered out %zu points from the laser scan.", count);
+
+        return true;
+      }
+
+    private:
+      // [begin, end) index ranges of the beams strictly inside each sector
+      std::vector<std::pair<size_t, size_t> > index_ranges_;
+      size_t cached_size_ = 0;
+      float cached_angle_min_ = 0;
+      float cached_angle_increment_ = 0;
+
+      void updateIndexRanges(const sensor_msgs::msg::LaserScan& scan)
+      {
+        const double num_beams = scan.ranges.size();
+        index_ranges_.clear();
+
+        for (size_t k = 0; k < lower_angles_.size(); ++k)
+        {
+          // first beam with angle > lower, last beam with angle < upper
+          const double lower = (lower_angles_[k] - scan.angle_min) / scan.angle_increment;
+          const double upper = (upper_angles_[k] - scan.angle_min) / scan.angle_increment;
+          const double begin = std::min(std::max(std::floor(lower) + 1, 0.), num_beams);
+          const double end = std::min(std::max(std::ceil(upper), 0.), num_beams);
+          if (begin < end)
+          {
+            index_ranges_.emplace_back(size_t(begin), size_t(end));
+          }
+        }
+
+        cached_size_ = scan.ranges.size();
+        cached_angle_min_ = scan.angle_min;
+        cached_angle_increment_ = scan.angle_increment;
+      }
+  };
+};
+#endif
@@ -0,0 +1,219 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_SCAN_EDGE_ARTIFACT_FILTER_H
+#define LASER_SCAN_EDGE_ARTIFACT_FILTER_H
+
+#include <filters/filter_base.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+
+#include "laser_filters/scan_shadow_detector.h"
+#include "laser_filters/speckle_filter.h"
+
+#include <angles/angles.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace laser_filters
+{
+  /**
+   * @brief Combines ScanShadowsFilter and LaserScanSpeckleFilter in a single pass over the scan.
+   *
+   * Takes the parameters of both filters (min_angle, max_angle, window, neighbors and
+   * filter_type, max_range, max_range_difference, filter_window) with the same meaning.
+   * Both tests are evaluated on the input scan and their deletions are merged into one mask,
+   * i.e. the result is the same as running both filters side by side on the same scan and
+   * removing the union of their points. Both tests walk the same neighbour window of each
+   * beam, the speckle window is checked with SpeckleWindowTest. The sin / cos of the neighbour
+   * angles are shared by both tests and cached until the angle_increment changes.
+   */
+  class LaserScanEdgeArtifactFilter : public filters::FilterBase<sensor_msgs::msg::LaserScan>
+  {
+    public:
+      double min_angle_, max_angle_;
+      int window_, neighbors_;
+      int filter_type_;
+      double max_range_;
+      double max_range_difference_;
+      int filter_window_;
+
+      ScanShadowDetector shadow_detector_;
+      SpeckleWindowTest speckle_test_;
+
+      bool configure()
+      {
+        if (!getParam("min_angle", min_angle_) || !getParam("max_angle", max_angle_) || !getParam("window", window_))
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "EdgeArtifactFilter needs the min_angle, max_angle and window parameters.");
+          return false;
+        }
+        neighbors_ = 0;
+        getParam("neighbors", neighbors_);
+
+        if (!getParam("filter_type", filter_type_) || !getParam("max_range", max_range_) ||
+            !getParam("max_range_difference", max_range_difference_) || !getParam("filter_window", filter_window_))
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "EdgeArtifactFilter needs the filter_type, max_range, max_range_difference and filter_window parameters.");
+          return false;
+        }
+        if (filter_type_ != SpeckleFilterType::Distance && filter_type_ != SpeckleFilterType::RadiusOutlier)
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "Unknown filter_type %d.", filter_type_);
+          return false;
+        }
+        if (filter_window_ < 1 || window_ < 0 || neighbors_ < 0)
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "filter_window must be positive, window and neighbors must not be negative.");
+          return false;
+        }
+
+        // same limits as ScanShadowsFilter
+        min_angle_ = std::min(std::max(min_angle_, 0.), 90.);
+        max_angle_ = std::min(std::max(max_angle_, 90.), 180.);
+        shadow_detector_.configure(angles::from_degrees(min_angle_), angles::from_degrees(max_angle_));
+        speckle_test_.configure(filter_type_, max_range_, max_range_difference_, filter_window_);
+
+        trig_window_ = std::max(window_, filter_window_);
+        cached_angle_increment_ = std::numeric_limits<float>::quiet_NaN();
+        return true;
+      }
+
+      virtual ~LaserScanEdgeArtifactFilter(){}
+
+      bool update(const sensor_msgs::msg::LaserScan& input_scan, sensor_msgs::msg::LaserScan& filtered_scan)
+      {
+        filtered_scan = input_scan; //copy entire message
+
+        if (!(input_scan.angle_increment == cached_angle_increment_))
+        {
+          updateTrigTable(input_scan.angle_increment);
+        }
+
+        const std::vector<float>& ranges = input_scan.ranges;
+        const int num_beams = ranges.size();
+        const float* cos_table = cos_table_.data() + trig_window_;
+        delete_mask_.assign(num_beams, 0);
+
+        // speckle windows start at [0, num_beams - filter_window], a beam stays if it is
+        // covered by one valid window or beyond max_range
+        const int last_window = num_beams - filter_window_;
+        int last_valid_window = -filter_window_;
+
+        for (int i = 0; i < num_beams; ++i)
+        {
+          if (isShadow(ranges, i))
+          {
+            const int begin = std::max(i - neighbors_, 0);
+            const int end = std::min(i + neighbors_, num_beams - 1);
+            for (int k = begin; k <= end; ++k)
+            {
+              if (ranges[i] < ranges[k])
+              {  // delete neighbor if they are farther away (note not self)
+                delete_mask_[k] = 1;
+              }
+            }
+          }
+
+          if (i <= last_window && speckle_test_.isWindowValid(ranges.data(), num_beams, nullptr, i, ranges[i], cos_table))
+          {
+            last_valid_window = i;
+          }
+          const bool out_of_range = last_window >= 0 && speckle_test_.isBeyondMaxRange(ranges[i]);
+          if (last_valid_window <= i - filter_window_ && !out_of_range)
+          {
+            delete_mask_[i] = 1;
+          }
+        }
+
+        size_t count = 0;
+        for (int i = 0; i < num_beams; ++i)
+        {
+          if (delete_mask_[i])
+          {
+            filtered_scan.ranges[i] = std::numeric_limits<float>::quiet_NaN();
+            count++;
+          }
+        }
+
+        RCLCPP_DEBUG(logging_interface_->get_logger(), "EdgeArtifactFilter removing %zu points from the laser scan.", count);
+
+        return true;
+      }
+
+    private:
+      // sin / cos of y * angle_increment for y in [-trig_window_, trig_window_]
+      std::vector<float> sin_table_;
+      std::vector<float> cos_table_;
+      int trig_window_ = 0;
+      float cached_angle_increment_ = 0;
+      std::vector<uint8_t> delete_mask_;
+
+      void updateTrigTable(const float angle_increment)
+      {
+        sin_table_.resize(2 * trig_window_ + 1);
+        cos_table_.resize(2 * trig_window_ + 1);
+        for (int y = -trig_window_; y <= trig_window_; ++y)
+        {
+          sin_table_[y + trig_window_] = sinf(y * angle_increment);
+          cos_table_[y + trig_window_] = cosf(y * angle_increment);
+        }
+        cached_angle_increment_ = angle_increment;
+      }
+
+      // ScanShadowsFilter: beam i forms a shadow with one of its neighbours
+      bool isShadow(const std::vector<float>& ranges, const int i)
+      {
+        const int num_beams = ranges.size();
+        for (int y = -window_; y < window_ + 1; y++)
+        {
+          const int j = i + y;
+          if (j < 0 || j >= num_beams || i == j)
+          {
+            continue;
+          }
+          if (shadow_detector_.isShadow(ranges[i], ranges[j], sin_table_[y + trig_window_], cos_table_[y + trig_window_]))
+          {
+            return true;
+          }
+        }
+        return false;
+      }
+  };
+}
+#endif
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2008, Willow Garage, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LASER_FILTERS_INSTRUMENTED_FILTER_CHAIN_H
+#define LASER_FILTERS_INSTRUMENTED_FILTER_CHAIN_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <filters/filter_base.hpp>
+#include <neo_tracetools/tracetools.h>
+#include <pluginlib/class_loader.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+
+namespace laser_filters
+{
+
+/**
+ * @brief Keeps the last N samples of a value to compute percentiles on demand.
+ */
+class RollingStatistics
+{
+public:
+  explicit RollingStatistics(size_t window = 100)
+  {
+    setWindow(window);
+  }
+
+  void setWindow(size_t window)
+  {
+    samples_.assign(std::max(window, size_t(1)), 0.0);
+    next_ = 0;
+    size_ = 0;
+  }
+
+  void add(double value)
+  {
+    samples_[next_] = value;
+    next_ = (next_ + 1) % samples_.size();
+    size_ = std::min(size_ + 1, samples_.size());
+  }
+
+  size_t size() const { return size_; }
+
+  /**
+   * @brief Returns the p-th percentile (0 to 100) of the current window, 0 if empty.
+   */
+  double percentile(double p) const
+  {
+    if (size_ == 0) {
+      return 0;
+    }
+    std::vector<double> sorted(samples_.begin(), samples_.begin() + size_);
+    const size_t k = std::min(size_t(std::round(p / 100. * (size_ - 1))), size_ - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    return sorted[k];
+  }
+
+  double max() const
+  {
+    return size_ ? *std::max_element(samples_.begin(), samples_.begin() + size_) : 0;
+  }
+
+private:
+  std::vector<double> samples_;
+  size_t next_ = 0;
+  size_t size_ = 0;
+};
+
+struct FilterStatistics
+{
+  std::string name;
+  std::string type;
+  uint64_t updates = 0;
+  uint64_t failures = 0;
+  uint64_t nan_beams = 0;   // beams that were turned into NaN by this filter
+  RollingStatistics duration;   // [s]
+};
+
+/**
+ * @brief Drop-in replacement for filters::FilterChain<sensor_msgs::msg::LaserScan> which,
+ * when enabled, times every filter's update() and counts failures and NaN'd beams.
+ *
+ * The chain is configured from the same "filterN.name / filterN.type / filterN.params"
+ * parameters. When disabled, update() only costs a branch compared to the regular chain.
+ */
+class InstrumentedFilterChain
+{
+public:
+  typedef sensor_msgs::msg::LaserScan Scan;
+
+  InstrumentedFilterChain()
+    : loader_("filters", "filters::FilterBase<sensor_msgs::msg::LaserScan>")
+  {
+  }
+
+  ~InstrumentedFilterChain()
+  {
+    clear();
+  }
+
+  bool configure(
+    std::string param_prefix,
+    const rclcpp::node_interfaces::NodeLoggingInterface::SharedPtr & node_logger,
+    const rclcpp::node_interfaces::NodeParametersInterface::SharedPtr & node_params)
+  {
+    clear();
+
+    if (!param_prefix.empty() && param_prefix.back() != '.') {
+      param_prefix += ".";
+    }
+    const auto & overrides = node_params->get_parameter_overrides();
+
+    for (size_t i = 1; ; ++i)
+    {
+      const std::string filter_n = param_prefix + "filter" + std::to_string(i);
+      const std::string name_param = filter_n + ".name";
+      const std::string type_param = filter_n + ".type";
+      if (!node_params->has_parameter(name_param) && overrides.find(name_param) == overrides.end()) {
+        break;
+      }
+
+      std::string name, type;
+      if (!getStringParam(node_params, name_param, name) || !getStringParam(node_params, type_param, type)) {
+        RCLCPP_ERROR(node_logger->get_logger(), "%s needs both a name and a type", filter_n.c_str());
+        return false;
+      }
+
+      pluginlib::UniquePtr<filters::FilterBase<Scan> > filter;
+      try {
+        filter = loader_.createUniqueInstance(type);
+      } catch (const pluginlib::PluginlibException & ex) {
+        RCLCPP_ERROR(node_logger->get_logger(), "Could not load filter %s of type %s: %s", name.c_str(), type.c_str(), ex.what());
+        return false;
+      }
+      if (!filter || !filter->configure(filter_n + ".params", name, node_logger, node_params)) {
+        RCLCPP_ERROR(node_logger->get_logger(), "Could not configure filter %s of type %s", name.c_str(), type.c_str());
+        return false;
+      }
+      RCLCPP_INFO(node_logger->get_logger(), "Configured %s filter with name %s", type.c_str(), name.c_str());
+
+      filters_.push_back(std::move(filter));
+      statistics_.emplace_back();
+      statistics_.back().name = name;
+      statistics_.back().type = type;
+      statistics_.back().duration.setWindow(window_);
+    }
+    return true;
+  }
+
+  bool update(const Scan & data_in, Scan & data_out)
+  {
+    NEO_TRACE_SCOPE("laser_filters", "FilterChain::update", neo_tracetools::stamp_ns(data_in.header.stamp));
+
+    if (!enabled_) {
+      return updateChain(data_in, data_out);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool result = updateChain(data_in, data_out);
+    chain_duration_.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    chain_updates_++;
+    if (!result) {
+      chain_failures_++;
+    }
+    return result;
+  }
+
+  void clear()
+  {
+    statistics_.clear();
+    filters_.clear();
+  }
+
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+
+  bool isEnabled() const { return enabled_; }
+
+  /**
+   * @brief Sets the number of samples used for the percentiles, resets all statistics.
+   */
+  void setWindow(size_t window)
+  {
+    window_ = window;
+    chain_duration_.setWindow(window);
+    for (auto & stats : statistics_) {
+      stats.duration.setWindow(window);
+    }
+  }
+
+  size_t size() const { return filters_.size(); }
+
+  const std::vector<FilterStatistics> & getFilterStatistics() const { return statistics_; }
+
+  const RollingStatistics & getChainDuration() const { return chain_duration_; }
+
+  uint64_t getChainUpdates() const { return chain_updates_; }
+
+  uint64_t getChainFailures() const { return chain_failures_; }
+
+private:
+  static bool getStringParam(
+    const rclcpp::node_interfaces::NodeParametersInterface::SharedPtr & node_params,
+    const std::string & name, std::string & value)
+  {
+    if (!node_params->has_parameter(name)) {
+      node_params->declare_parameter(name, rclcpp::ParameterValue(std::string()));
+    }
+    rclcpp::Parameter param;
+    if (!node_params->get_parameter(name, param) || param.get_type() != rclcpp::ParameterType::PARAMETER_STRING) {
+      return false;
+    }
+    value = param.as_string();
+    return !value.empty();
+  }
+
+  static size_t countNaN(const Scan & scan)
+  {
+    return std::count_if(scan.ranges.begin(), scan.ranges.end(), [](float r) { return std::isnan(r); });
+  }
+
+  bool updateFilter(size_t i, const Scan & data_in, Scan & data_out)
+  {
+    NEO_TRACE_SCOPE("laser_filters", statistics_[i].name.c_str(), neo_tracetools::stamp_ns(data_in.header.stamp));
+
+    if (!enabled_) {
+      return filters_[i]->update(data_in, data_out);
+    }
+
+    auto & stats = statistics_[i];
+    const size_t nan_before = countNaN(data_in);
+    const auto start = std::chrono::steady_clock::now();
+    const bool result = filters_[i]->update(data_in, data_out);
+    stats.duration.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    stats.updates++;
+    if (!result) {
+      stats.failures++;
+    } else {
+      const size_t nan_after = countNaN(data_out);
+      stats.nan_beams += nan_after > nan_before ? nan_after - nan_before : 0;
+    }
+    return result;
+  }
+
+  // same buffering scheme as filters::FilterChain::update()
+  bool updateChain(const Scan & data_in, Scan & data_out)
+  {
+    const size_t list_size = filters_.size();
+    if (list_size == 0) {
+      data_out = data_in;
+      return true;
+    }
+    if (list_size == 1) {
+      return updateFilter(0, data_in, data_out);
+    }
+    if (list_size == 2) {
+      return updateFilter(0, data_in, buffer0_) && updateFilter(1, buffer0_, data_out);
+    }
+
+    bool result = updateFilter(0, data_in, buffer0_);
+    for (size_t i = 1; i < list_size - 1 && result; ++i) {
+      if (i % 2 == 1) {
+        result = updateFilter(i, buffer0_, buffer1_);
+      } else {
+        result = updateFilter(i, buffer1_, buffer0_);
+      }
+    }
+    if (!result) {
+      return false;
+    }
+    if (list_size % 2 == 1) {
+      return updateFilter(list_size - 1, buffer1_, data_out);
+    }
+    return updateFilter(list_size - 1, buffer0_, data_out);
+  }
+
+  pluginlib::ClassLoader<filters::FilterBase<Scan> > loader_;
+  std::vector<pluginlib::UniquePtr<filters::FilterBase<Scan> > > filters_;
+  std::vector<FilterStatistics> statistics_;
+  Scan buffer0_;
+  Scan buffer1_;
+
+  bool enabled_ = false;
+  size_t window_ = 100;
+  RollingStatistics chain_duration_;
+  uint64_t chain_updates_ = 0;
+  uint64_t chain_failures_ = 0;
+};
+
+}  // namespace laser_filters
+
+#endif  // LASER_FILTERS_INSTRUMENTED_FILTER_CHAIN_H
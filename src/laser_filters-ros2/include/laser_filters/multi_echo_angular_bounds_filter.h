@@ -0,0 +1,120 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_FILTERS_MULTI_ECHO_ANGULAR_BOUNDS_FILTER_H
+#define LASER_FILTERS_MULTI_ECHO_ANGULAR_BOUNDS_FILTER_H
+
+#include <filters/filter_base.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include "laser_filters/multi_echo_scan.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace laser_filters
+{
+
+/**
+ * @brief LaserScanAngularBoundsFilter for a MultiEchoScan, crops all echoes to
+ * [lower_angle, upper_angle].
+ */
+class MultiEchoAngularBoundsFilter : public filters::FilterBase<MultiEchoScan>
+{
+public:
+  double lower_angle_;
+  double upper_angle_;
+
+  bool configure()
+  {
+    lower_angle_ = 0;
+    upper_angle_ = 0;
+
+    if (!getParam("lower_angle", lower_angle_) || !getParam("upper_angle", upper_angle_))
+    {
+      RCLCPP_ERROR(logging_interface_->get_logger(), "Both the lower_angle and upper_angle parameters must be set to use this filter.");
+      return false;
+    }
+    return true;
+  }
+
+  virtual ~MultiEchoAngularBoundsFilter(){}
+
+  bool update(const MultiEchoScan& input_scan, MultiEchoScan& filtered_scan)
+  {
+    const size_t num_beams = input_scan.num_beams;
+
+    if (input_scan.angle_increment <= 0)
+    {
+      RCLCPP_ERROR(logging_interface_->get_logger(), "Scans with non-positive angle_increment are not supported.");
+      return false;
+    }
+
+    // same index range [first, first + count) as LaserScanAngularBoundsFilter
+    const double lower = std::ceil((lower_angle_ - input_scan.angle_min) / input_scan.angle_increment - 1e-6);
+    const size_t first = size_t(std::min(std::max(lower, 0.), double(num_beams)));
+
+    size_t count = 0;
+    if (first < num_beams)
+    {
+      const double upper = std::floor((upper_angle_ - input_scan.angle_min) / input_scan.angle_increment + 1e-6);
+      const size_t last = size_t(std::min(std::max(upper, double(first)), double(num_beams - 1)));
+      count = last - first + 1;
+    }
+
+    filtered_scan.copyMetaData(input_scan);
+    filtered_scan.resize(count, input_scan.num_echoes, input_scan.hasIntensities());
+    std::copy_n(input_scan.echo_counts.begin() + first, count, filtered_scan.echo_counts.begin());
+    for (size_t e = 0; e < input_scan.num_echoes; ++e)
+    {
+      std::copy_n(input_scan.echo(e) + first, count, filtered_scan.echo(e));
+      if (input_scan.hasIntensities()) {
+        std::copy_n(input_scan.echoIntensities(e) + first, count, filtered_scan.echoIntensities(e));
+      }
+    }
+
+    filtered_scan.header.stamp = rclcpp::Time(input_scan.header.stamp) +
+        rclcpp::Duration::from_seconds(first * input_scan.time_increment);
+    filtered_scan.angle_min = input_scan.angle_min + first * input_scan.angle_increment;
+    filtered_scan.angle_max = filtered_scan.angle_min + (count > 0 ? count - 1 : 0) * input_scan.angle_increment;
+
+    RCLCPP_DEBUG(logging_interface_->get_logger(), "Filtered out %d beams from the multi echo scan.", (int)num_beams - (int)count);
+    return true;
+  }
+};
+
+}  // namespace laser_filters
+
+#endif  // LASER_FILTERS_MULTI_ECHO_ANGULAR_BOUNDS_FILTER_H
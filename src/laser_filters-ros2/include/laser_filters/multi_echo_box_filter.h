@@ -0,0 +1,206 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_FILTERS_MULTI_ECHO_BOX_FILTER_H
+#define LASER_FILTERS_MULTI_ECHO_BOX_FILTER_H
+
+#include <filters/filter_base.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
+#include <tf2/LinearMath/Transform.h>
+#include <tf2/exceptions.h>
+#include <tf2_ros/buffer.h>
+#include <tf2_ros/transform_listener.h>
+
+#include "laser_filters/multi_echo_scan.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace laser_filters
+{
+
+/**
+ * @brief LaserScanBoxFilter for all echoes of a MultiEchoScan, takes the same parameters.
+ *
+ * Like laser_geometry's high fidelity projection, the transform into box_frame is interpolated
+ * between the start and the end of the scan. The origin and direction of every beam are computed
+ * once and shared by all of its echoes, no point cloud is built.
+ */
+class MultiEchoBoxFilter : public filters::FilterBase<MultiEchoScan>, public rclcpp_lifecycle::LifecycleNode
+{
+public:
+  MultiEchoBoxFilter() : rclcpp_lifecycle::LifecycleNode("multi_echo_box_filter"), buffer_(get_clock()), tf_(buffer_){}
+
+  bool configure()
+  {
+    double min_x, min_y, min_z, max_x, max_y, max_z;
+    bool box_frame_set = getParam("box_frame", box_frame_);
+    bool x_max_set = getParam("max_x", max_x);
+    bool y_max_set = getParam("max_y", max_y);
+    bool z_max_set = getParam("max_z", max_z);
+    bool x_min_set = getParam("min_x", min_x);
+    bool y_min_set = getParam("min_y", min_y);
+    bool z_min_set = getParam("min_z", min_z);
+
+    max_.setValue(max_x, max_y, max_z);
+    min_.setValue(min_x, min_y, min_z);
+
+    bool invert = false;
+    getParam("invert", invert);
+    remove_box_points_ = !invert;
+
+    if (!(box_frame_set && x_max_set && y_max_set && z_max_set && x_min_set && y_min_set && z_min_set))
+    {
+      RCLCPP_ERROR(get_logger(), "MultiEchoBoxFilter needs the box_frame, min_x, min_y, min_z, max_x, max_y and max_z parameters.");
+      return false;
+    }
+    return true;
+  }
+
+  virtual ~MultiEchoBoxFilter(){}
+
+  bool update(const MultiEchoScan& input_scan, MultiEchoScan& output_scan)
+  {
+    using namespace std::chrono_literals;
+    output_scan = input_scan;
+
+    const size_t num_beams = input_scan.num_beams;
+    if (num_beams == 0)
+    {
+      return true;
+    }
+
+    const rclcpp::Time start_time(input_scan.header.stamp);
+    const rclcpp::Time end_time = start_time + rclcpp::Duration::from_seconds((num_beams - 1) * input_scan.time_increment);
+
+    std::string error_msg;
+    if (!buffer_.canTransform(box_frame_, input_scan.header.frame_id, end_time, 1.0s, &error_msg))
+    {
+      RCLCPP_WARN(get_logger(), "Could not get transform, ignoring multi echo scan! %s", error_msg.c_str());
+      return false;
+    }
+
+    tf2::Transform start, end;
+    try
+    {
+      start = lookupTransform(input_scan.header.frame_id, start_time);
+      end = lookupTransform(input_scan.header.frame_id, end_time);
+    }
+    catch (tf2::TransformException &ex)
+    {
+      rclcpp::Clock steady_clock(RCL_STEADY_TIME);
+      RCLCPP_WARN_THROTTLE(get_logger(), steady_clock, 1000, "Dropping scan: transform unavailable %s", ex.what());
+      return true;
+    }
+
+    // origin and unit direction of every beam in box_frame
+    origin_x_.resize(num_beams); origin_y_.resize(num_beams); origin_z_.resize(num_beams);
+    dir_x_.resize(num_beams); dir_y_.resize(num_beams); dir_z_.resize(num_beams);
+    const tf2::Quaternion start_rotation = start.getRotation();
+    const tf2::Quaternion end_rotation = end.getRotation();
+    for (size_t i = 0; i < num_beams; ++i)
+    {
+      const double ratio = num_beams > 1 ? double(i) / (num_beams - 1) : 0.;
+      const tf2::Vector3 origin = start.getOrigin().lerp(end.getOrigin(), ratio);
+      const tf2::Quaternion rotation = start_rotation.slerp(end_rotation, ratio);
+      const double angle = input_scan.angle_min + i * input_scan.angle_increment;
+      const tf2::Vector3 dir = tf2::quatRotate(rotation, tf2::Vector3(cos(angle), sin(angle), 0));
+      origin_x_[i] = origin.x(); origin_y_[i] = origin.y(); origin_z_[i] = origin.z();
+      dir_x_[i] = dir.x(); dir_y_[i] = dir.y(); dir_z_[i] = dir.z();
+    }
+
+    // same validity as laser_geometry, readings outside [range_min, range_max) are left alone
+    const float range_min = input_scan.range_min;
+    const float range_max = input_scan.range_max;
+    for (size_t e = 0; e < input_scan.num_echoes; ++e)
+    {
+      float * ranges = output_scan.echo(e);
+      for (size_t i = 0; i < num_beams; ++i)
+      {
+        const float r = ranges[i];
+        if (!(r >= range_min && r < range_max))
+        {
+          continue;
+        }
+        const float x = origin_x_[i] + r * dir_x_[i];
+        const float y = origin_y_[i] + r * dir_y_[i];
+        const float z = origin_z_[i] + r * dir_z_[i];
+        if (remove_box_points_ == inBox(x, y, z))
+        {
+          ranges[i] = std::numeric_limits<float>::quiet_NaN();
+        }
+      }
+    }
+    return true;
+  }
+
+private:
+  tf2::Transform lookupTransform(const std::string & frame_id, const rclcpp::Time & time)
+  {
+    const auto msg = buffer_.lookupTransform(box_frame_, frame_id, time).transform;
+    return tf2::Transform(
+      tf2::Quaternion(msg.rotation.x, msg.rotation.y, msg.rotation.z, msg.rotation.w),
+      tf2::Vector3(msg.translation.x, msg.translation.y, msg.translation.z));
+  }
+
+  bool inBox(float x, float y, float z) const
+  {
+    return x < max_.x() && x > min_.x() &&
+           y < max_.y() && y > min_.y() &&
+           z < max_.z() && z > min_.z();
+  }
+
+  std::string box_frame_;
+
+  // tf listener to transform scans into the box_frame
+  tf2_ros::Buffer buffer_;
+  tf2_ros::TransformListener tf_;
+
+  // parameter to decide if points in box or points outside of box are removed
+  bool remove_box_points_ = true;
+
+  // defines two opposite corners of the box
+  tf2::Vector3 min_, max_;
+
+  // per beam origin and direction, reused across scans
+  std::vector<float> origin_x_, origin_y_, origin_z_;
+  std::vector<float> dir_x_, dir_y_, dir_z_;
+};
+
+}  // namespace laser_filters
+
+#endif  // LASER_FILTERS_MULTI_ECHO_BOX_FILTER_H
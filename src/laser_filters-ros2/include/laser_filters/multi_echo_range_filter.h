@@ -0,0 +1,111 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_FILTERS_MULTI_ECHO_RANGE_FILTER_H
+#define LASER_FILTERS_MULTI_ECHO_RANGE_FILTER_H
+
+#include <filters/filter_base.hpp>
+
+#include "laser_filters/multi_echo_scan.h"
+
+#include <limits>
+
+namespace laser_filters
+{
+
+/**
+ * @brief LaserScanRangeFilter for all echoes of a MultiEchoScan, takes the same parameters.
+ */
+class MultiEchoRangeFilter : public filters::FilterBase<MultiEchoScan>
+{
+public:
+  double lower_threshold_;
+  double upper_threshold_;
+  bool use_message_range_limits_;
+  float lower_replacement_value_;
+  float upper_replacement_value_;
+
+  bool configure()
+  {
+    use_message_range_limits_ = false;
+    getParam("use_message_range_limits", use_message_range_limits_);
+
+    double temp_replacement_value = std::numeric_limits<double>::quiet_NaN();
+    getParam("lower_replacement_value", temp_replacement_value);
+    lower_replacement_value_ = static_cast<float>(temp_replacement_value);
+
+    temp_replacement_value = std::numeric_limits<double>::quiet_NaN();
+    getParam("upper_replacement_value", temp_replacement_value);
+    upper_replacement_value_ = static_cast<float>(temp_replacement_value);
+
+    lower_threshold_ = 0.0;
+    upper_threshold_ = 100000.0;
+    getParam("lower_threshold", lower_threshold_);
+    getParam("upper_threshold", upper_threshold_);
+    return true;
+  }
+
+  virtual ~MultiEchoRangeFilter(){}
+
+  bool update(const MultiEchoScan& input_scan, MultiEchoScan& filtered_scan)
+  {
+    if (use_message_range_limits_)
+    {
+      lower_threshold_ = input_scan.range_min;
+      upper_threshold_ = input_scan.range_max;
+    }
+    filtered_scan = input_scan;
+
+    // all echoes are one contiguous array, the NaN padding never matches
+    const float lower = lower_threshold_;
+    const float upper = upper_threshold_;
+    for (float & range : filtered_scan.ranges)
+    {
+      if (range <= lower)
+      {
+        range = lower_replacement_value_;
+      }
+      else if (range >= upper)
+      {
+        range = upper_replacement_value_;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace laser_filters
+
+#endif  // LASER_FILTERS_MULTI_ECHO_RANGE_FILTER_H
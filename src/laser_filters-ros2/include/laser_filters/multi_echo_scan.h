@@ -0,0 +1,302 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_FILTERS_MULTI_ECHO_SCAN_H
+#define LASER_FILTERS_MULTI_ECHO_SCAN_H
+
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/multi_echo_laser_scan.hpp>
+#include <std_msgs/msg/header.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace laser_filters
+{
+
+/**
+ * @brief Structure-of-arrays version of sensor_msgs::msg::MultiEchoLaserScan.
+ *
+ * All echoes are stored in one contiguous array per channel, echo-major: echo e of beam i is at
+ * [e * num_beams + i], so that every echo forms a contiguous scan line which the filters can
+ * walk like LaserScan::ranges. Beams with fewer than num_echoes returns are padded with NaN,
+ * echo_counts keeps how many of them came with the message, so that filtered echoes (also NaN)
+ * are not mistaken for padding. The arrays keep their capacity across scans, no allocation is
+ * done per beam.
+ */
+struct MultiEchoScan
+{
+  std_msgs::msg::Header header;
+  float angle_min = 0;
+  float angle_max = 0;
+  float angle_increment = 0;
+  float time_increment = 0;
+  float scan_time = 0;
+  float range_min = 0;
+  float range_max = 0;
+
+  size_t num_beams = 0;
+  size_t num_echoes = 0;
+
+  std::vector<float> ranges;
+  std::vector<float> intensities;   // same layout as ranges, empty if the sensor has none
+  std::vector<uint32_t> echo_counts;  // echoes of each beam in the message, the rest is padding
+
+  bool hasIntensities() const { return !intensities.empty(); }
+
+  float * echo(size_t e) { return ranges.data() + e * num_beams; }
+  const float * echo(size_t e) const { return ranges.data() + e * num_beams; }
+
+  float * echoIntensities(size_t e) { return intensities.data() + e * num_beams; }
+  const float * echoIntensities(size_t e) const { return intensities.data() + e * num_beams; }
+
+  /**
+   * @brief Resizes to num_beams x num_echoes, keeps the capacity.
+   */
+  void resize(size_t beams, size_t echoes, bool with_intensities)
+  {
+    num_beams = beams;
+    num_echoes = echoes;
+    ranges.resize(beams * echoes);
+    intensities.resize(with_intensities ? beams * echoes : 0);
+    echo_counts.resize(beams);
+  }
+
+  void copyMetaData(const MultiEchoScan & other)
+  {
+    header = other.header;
+    angle_min = other.angle_min;
+    angle_max = other.angle_max;
+    angle_increment = other.angle_increment;
+    time_increment = other.time_increment;
+    scan_time = other.scan_time;
+    range_min = other.range_min;
+    range_max = other.range_max;
+  }
+};
+
+/**
+ * @brief Which echo of a beam is kept when converting to a LaserScan.
+ */
+enum class EchoSelection
+{
+  First,       // first valid return in the order of the message
+  Last,        // last valid return
+  Strongest    // valid return with the highest intensity, the first one without intensities
+};
+
+/**
+ * @brief Parses "first", "last" or "strongest", returns false for anything else.
+ */
+inline bool parseEchoSelection(const std::string & name, EchoSelection & selection)
+{
+  if (name == "first") {
+    selection = EchoSelection::First;
+  } else if (name == "last") {
+    selection = EchoSelection::Last;
+  } else if (name == "strongest") {
+    selection = EchoSelection::Strongest;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Flattens a MultiEchoLaserScan into the echo-major arrays of scan.
+ */
+inline void fromMsg(const sensor_msgs::msg::MultiEchoLaserScan & msg, MultiEchoScan & scan)
+{
+  const size_t num_beams = msg.ranges.size();
+  size_t num_echoes = 0;
+  for (const auto & beam : msg.ranges) {
+    num_echoes = std::max(num_echoes, beam.echoes.size());
+  }
+  // intensities are optional, but if present they have to match the ranges
+  const bool with_intensities = msg.intensities.size() == num_beams && num_beams > 0;
+
+  scan.header = msg.header;
+  scan.angle_min = msg.angle_min;
+  scan.angle_max = msg.angle_max;
+  scan.angle_increment = msg.angle_increment;
+  scan.time_increment = msg.time_increment;
+  scan.scan_time = msg.scan_time;
+  scan.range_min = msg.range_min;
+  scan.range_max = msg.range_max;
+  scan.resize(num_beams, num_echoes, with_intensities);
+
+  std::fill(scan.ranges.begin(), scan.ranges.end(), std::numeric_limits<float>::quiet_NaN());
+  std::fill(scan.intensities.begin(), scan.intensities.end(), 0.f);
+
+  for (size_t i = 0; i < num_beams; ++i)
+  {
+    const auto & echoes = msg.ranges[i].echoes;
+    scan.echo_counts[i] = echoes.size();
+    for (size_t e = 0; e < echoes.size(); ++e) {
+      scan.ranges[e * num_beams + i] = echoes[e];
+    }
+    if (with_intensities)
+    {
+      const auto & values = msg.intensities[i].echoes;
+      const size_t count = std::min(values.size(), num_echoes);
+      for (size_t e = 0; e < count; ++e) {
+        scan.intensities[e * num_beams + i] = values[e];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Converts back to a MultiEchoLaserScan, every beam gets as many echoes as it had in
+ * the message fromMsg() was called with, filtered ones are NaN.
+ */
+inline void toMsg(const MultiEchoScan & scan, sensor_msgs::msg::MultiEchoLaserScan & msg)
+{
+  msg.header = scan.header;
+  msg.angle_min = scan.angle_min;
+  msg.angle_max = scan.angle_max;
+  msg.angle_increment = scan.angle_increment;
+  msg.time_increment = scan.time_increment;
+  msg.scan_time = scan.scan_time;
+  msg.range_min = scan.range_min;
+  msg.range_max = scan.range_max;
+
+  const size_t num_beams = scan.num_beams;
+  msg.ranges.resize(num_beams);
+  msg.intensities.resize(scan.hasIntensities() ? num_beams : 0);
+
+  for (size_t i = 0; i < num_beams; ++i)
+  {
+    const size_t count = scan.echo_counts[i];
+    auto & echoes = msg.ranges[i].echoes;
+    echoes.resize(count);
+    for (size_t e = 0; e < count; ++e) {
+      echoes[e] = scan.ranges[e * num_beams + i];
+    }
+    if (scan.hasIntensities())
+    {
+      auto & values = msg.intensities[i].echoes;
+      values.resize(count);
+      for (size_t e = 0; e < count; ++e) {
+        values[e] = scan.intensities[e * num_beams + i];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Picks one echo per beam into a LaserScan.
+ *
+ * Only finite ranges are considered valid returns. If a beam has none, the range of its first
+ * echo is kept as is (NaN or +/-Inf), so that "no return" readings stay what they were.
+ */
+inline void selectEcho(const MultiEchoScan & scan, EchoSelection selection, sensor_msgs::msg::LaserScan & out)
+{
+  out.header = scan.header;
+  out.angle_min = scan.angle_min;
+  out.angle_max = scan.angle_max;
+  out.angle_increment = scan.angle_increment;
+  out.time_increment = scan.time_increment;
+  out.scan_time = scan.scan_time;
+  out.range_min = scan.range_min;
+  out.range_max = scan.range_max;
+
+  const size_t num_beams = scan.num_beams;
+  const size_t num_echoes = scan.num_echoes;
+  const bool with_intensities = scan.hasIntensities();
+  if (selection == EchoSelection::Strongest && !with_intensities) {
+    selection = EchoSelection::First;
+  }
+
+  out.ranges.assign(num_beams, std::numeric_limits<float>::quiet_NaN());
+  out.intensities.assign(with_intensities ? num_beams : 0, 0.f);
+  if (num_echoes == 0) {
+    return;
+  }
+
+  // walk the echoes one contiguous line at a time, out.ranges is finite once a beam has a valid return
+  for (size_t e = 0; e < num_echoes; ++e)
+  {
+    const float * ranges = scan.echo(e);
+    const float * intensities = with_intensities ? scan.echoIntensities(e) : nullptr;
+    for (size_t i = 0; i < num_beams; ++i)
+    {
+      if (!std::isfinite(ranges[i])) {
+        continue;
+      }
+      bool take = false;
+      switch (selection)
+      {
+        case EchoSelection::First:
+          take = !std::isfinite(out.ranges[i]);
+          break;
+        case EchoSelection::Last:
+          take = true;
+          break;
+        case EchoSelection::Strongest:
+          take = !std::isfinite(out.ranges[i]) || intensities[i] > out.intensities[i];
+          break;
+      }
+      if (take)
+      {
+        out.ranges[i] = ranges[i];
+        if (with_intensities) {
+          out.intensities[i] = intensities[i];
+        }
+      }
+    }
+  }
+
+  const float * first = scan.echo(0);
+  for (size_t i = 0; i < num_beams; ++i)
+  {
+    if (!std::isfinite(out.ranges[i]))
+    {
+      out.ranges[i] = first[i];
+      if (with_intensities) {
+        out.intensities[i] = scan.echoIntensities(0)[i];
+      }
+    }
+  }
+}
+
+}  // namespace laser_filters
+
+#endif  // LASER_FILTERS_MULTI_ECHO_SCAN_H
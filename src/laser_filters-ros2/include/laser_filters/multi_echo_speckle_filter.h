@@ -0,0 +1,170 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_FILTERS_MULTI_ECHO_SPECKLE_FILTER_H
+#define LASER_FILTERS_MULTI_ECHO_SPECKLE_FILTER_H
+
+#include <filters/filter_base.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include "laser_filters/multi_echo_scan.h"
+#include "laser_filters/speckle_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace laser_filters
+{
+
+/**
+ * @brief LaserScanSpeckleFilter for a MultiEchoScan, takes the same parameters.
+ *
+ * Windows start at every echo of every beam. A neighbour beam is tested with its echo closest to
+ * the range at the window start, i.e. an echo is a speckle if it has no consistent neighbours
+ * among all echoes of the adjacent beams, no matter how many returns these have.
+ */
+class MultiEchoSpeckleFilter : public filters::FilterBase<MultiEchoScan>
+{
+public:
+  int filter_type_;
+  double max_range_;
+  double max_range_difference_;
+  int filter_window_;
+
+  bool configure()
+  {
+    if (!getParam("filter_type", filter_type_) || !getParam("max_range", max_range_) ||
+        !getParam("max_range_difference", max_range_difference_) || !getParam("filter_window", filter_window_))
+    {
+      RCLCPP_ERROR(logging_interface_->get_logger(), "MultiEchoSpeckleFilter needs the filter_type, max_range, max_range_difference and filter_window parameters.");
+      return false;
+    }
+    if (filter_type_ != SpeckleFilterType::Distance && filter_type_ != SpeckleFilterType::RadiusOutlier)
+    {
+      RCLCPP_ERROR(logging_interface_->get_logger(), "Unknown filter_type %d.", filter_type_);
+      return false;
+    }
+    if (filter_window_ < 1)
+    {
+      RCLCPP_ERROR(logging_interface_->get_logger(), "filter_window must be positive.");
+      return false;
+    }
+    speckle_test_.configure(filter_type_, max_range_, max_range_difference_, filter_window_);
+    matches_.resize(filter_window_);
+    cached_angle_increment_ = std::numeric_limits<float>::quiet_NaN();
+    return true;
+  }
+
+  virtual ~MultiEchoSpeckleFilter(){}
+
+  bool update(const MultiEchoScan& input_scan, MultiEchoScan& filtered_scan)
+  {
+    filtered_scan = input_scan;
+
+    if (!(input_scan.angle_increment == cached_angle_increment_))
+    {
+      updateCosTable(input_scan.angle_increment);
+    }
+    const float * cos_table = cos_table_.data() + filter_window_;
+
+    const int num_beams = input_scan.num_beams;
+    const int num_echoes = input_scan.num_echoes;
+    const float * ranges = input_scan.ranges.data();
+    const uint32_t * echo_counts = input_scan.echo_counts.data();
+
+    // windows start at [0, num_beams - filter_window] on every echo, an echo stays if it is
+    // covered by one valid window or beyond max_range
+    const int last_window = num_beams - filter_window_;
+    keep_mask_.assign(input_scan.ranges.size(), 0);
+    for (int e = 0; e < num_echoes; ++e)
+    {
+      const float * echo = input_scan.echo(e);
+      for (int i = 0; i <= last_window; ++i)
+      {
+        if (int(echo_counts[i]) <= e ||
+            !speckle_test_.isWindowValid(ranges, num_beams, echo_counts, i, echo[i], cos_table, matches_.data()))
+        {
+          continue;
+        }
+        keep_mask_[e * num_beams + i] = 1;
+        for (int k = 1; k < filter_window_; ++k)
+        {
+          if (matches_[k - 1] >= 0)
+          {
+            keep_mask_[matches_[k - 1] * num_beams + i + k] = 1;
+          }
+        }
+      }
+    }
+
+    size_t count = 0;
+    for (size_t n = 0; n < filtered_scan.ranges.size(); ++n)
+    {
+      float & range = filtered_scan.ranges[n];
+      if (!keep_mask_[n] && !std::isnan(range) && !(last_window >= 0 && speckle_test_.isBeyondMaxRange(range)))
+      {
+        range = std::numeric_limits<float>::quiet_NaN();
+        count++;
+      }
+    }
+
+    RCLCPP_DEBUG(logging_interface_->get_logger(), "MultiEchoSpeckleFilter removing %zu echoes.", count);
+    return true;
+  }
+
+private:
+  SpeckleWindowTest speckle_test_;
+  std::vector<float> cos_table_;   // cos(y * angle_increment) for y in [-filter_window_, filter_window_]
+  float cached_angle_increment_ = 0;
+  std::vector<int> matches_;
+  std::vector<uint8_t> keep_mask_;
+
+  void updateCosTable(const float angle_increment)
+  {
+    cos_table_.resize(2 * filter_window_ + 1);
+    for (int y = -filter_window_; y <= filter_window_; ++y)
+    {
+      cos_table_[y + filter_window_] = cosf(y * angle_increment);
+    }
+    cached_angle_increment_ = angle_increment;
+  }
+};
+
+}  // namespace laser_filters
+
+#endif  // LASER_FILTERS_MULTI_ECHO_SPECKLE_FILTER_H
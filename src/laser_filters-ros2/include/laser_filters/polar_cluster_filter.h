@@ -0,0 +1,328 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+#ifndef LASER_SCAN_POLAR_CLUSTER_FILTER_H
+#define LASER_SCAN_POLAR_CLUSTER_FILTER_H
+
+#include <filters/filter_base.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+
+#include <angles/angles.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace laser_filters
+{
+  /**
+   * @brief Summary of one cluster of consecutive beams.
+   */
+  struct ScanCluster
+  {
+    uint32_t first_beam = 0;
+    uint32_t last_beam = 0;   // inclusive
+    uint32_t num_points = 0;
+    float x = 0;              // centroid in the scan frame
+    float y = 0;
+    float extent = 0;         // distance between the first and the last point
+    float min_range = 0;
+  };
+
+  /**
+   * @brief Segments the scan into clusters of consecutive beams in a single pass.
+   *
+   * Two neighbouring beams belong to the same cluster if the distance between their points
+   * is below the adaptive breakpoint distance of Borges and Aldon:
+   *   d_max = r * sin(angle_increment) / sin(lambda - angle_increment) + 3 * sigma
+   * Invalid beams (NaN, inf or outside of [range_min, range_max]) end a cluster.
+   *
+   * Clusters with less than min_points / more than max_points beams or an extent outside of
+   * [min_extent, max_extent] are rejected and their beams removed if remove_rejected is set.
+   * With annotate_intensities the intensity of each beam is replaced by the index of its
+   * accepted cluster plus one, or zero.
+   *
+   * The accepted clusters are published as a sensor_msgs::msg::PointCloud2 on cluster_topic,
+   * one point per cluster with the fields x, y, z (centroid), extent, min_range, first_beam,
+   * last_beam and num_points.
+   */
+  class LaserScanPolarClusterFilter : public filters::FilterBase<sensor_msgs::msg::LaserScan>
+  {
+    public:
+      double lambda_ = 10.;
+      double sigma_ = 0.01;
+      int min_points_ = 1;
+      int max_points_ = std::numeric_limits<int>::max();
+      double min_extent_ = 0.;
+      double max_extent_ = std::numeric_limits<double>::infinity();
+      bool remove_rejected_ = true;
+      bool annotate_intensities_ = false;
+      bool publish_clusters_ = true;
+      std::string cluster_topic_ = "scan_clusters";
+
+      bool configure()
+      {
+        getParam("lambda", lambda_);
+        getParam("sigma", sigma_);
+        getParam("min_points", min_points_);
+        getParam("max_points", max_points_);
+        getParam("min_extent", min_extent_);
+        getParam("max_extent", max_extent_);
+        getParam("remove_rejected", remove_rejected_);
+        getParam("annotate_intensities", annotate_intensities_);
+        getParam("publish_clusters", publish_clusters_);
+        getParam("cluster_topic", cluster_topic_);
+
+        if (lambda_ <= 0. || lambda_ >= 90. || sigma_ < 0.)
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "PolarClusterFilter needs 0 < lambda < 90 and sigma >= 0.");
+          return false;
+        }
+        if (min_points_ < 1 || max_points_ < min_points_ || max_extent_ < min_extent_)
+        {
+          RCLCPP_ERROR(logging_interface_->get_logger(), "PolarClusterFilter needs 1 <= min_points <= max_points and min_extent <= max_extent.");
+          return false;
+        }
+
+        if (publish_clusters_)
+        {
+          node_ = std::make_shared<rclcpp::Node>(getName());
+          cluster_pub_ = node_->create_publisher<sensor_msgs::msg::PointCloud2>(cluster_topic_, 10);
+        }
+        cached_size_ = 0;
+        return true;
+      }
+
+      virtual ~LaserScanPolarClusterFilter(){}
+
+      bool update(const sensor_msgs::msg::LaserScan& input_scan, sensor_msgs::msg::LaserScan& filtered_scan)
+      {
+        filtered_scan = input_scan; //copy entire message
+
+        const std::vector<float>& ranges = input_scan.ranges;
+        const size_t num_beams = ranges.size();
+
+        if (num_beams != cached_size_ || !(input_scan.angle_min == cached_angle_min_) ||
+            !(input_scan.angle_increment == cached_angle_increment_))
+        {
+          updateTrigTable(input_scan);
+        }
+
+        // breakpoint distance is d_max = r * break_factor_ + 3 sigma
+        const double increment = std::fabs(input_scan.angle_increment);
+        const double lambda = angles::from_degrees(lambda_);
+        const float break_factor = increment < lambda ? std::sin(increment) / std::sin(lambda - increment) : 0.f;
+        const float break_offset = 3 * sigma_;
+        const float cos_increment = std::cos(input_scan.angle_increment);
+
+        if (annotate_intensities_)
+        {
+          filtered_scan.intensities.assign(num_beams, 0.f);
+        }
+        clusters_.clear();
+
+        ScanCluster current;
+        float first_x = 0, first_y = 0, last_x = 0, last_y = 0;
+        double sum_x = 0, sum_y = 0;
+        float last_range = std::numeric_limits<float>::quiet_NaN();
+        size_t count = 0;
+
+        for (size_t i = 0; i <= num_beams; ++i)
+        {
+          const float r = i < num_beams ? ranges[i] : std::numeric_limits<float>::quiet_NaN();
+          const bool valid = std::isfinite(r) && r >= input_scan.range_min && r <= input_scan.range_max;
+
+          bool breakpoint = !valid || current.num_points == 0;
+          if (!breakpoint)
+          {
+            const float dist2 = r * r + last_range * last_range - 2 * r * last_range * cos_increment;
+            const float d_max = last_range * break_factor + break_offset;
+            breakpoint = dist2 > d_max * d_max;
+          }
+
+          if (breakpoint && current.num_points > 0)
+          {
+            current.x = sum_x / current.num_points;
+            current.y = sum_y / current.num_points;
+            current.extent = std::hypot(last_x - first_x, last_y - first_y);
+            count += finishCluster(current, filtered_scan);
+            current = ScanCluster();
+          }
+          if (!valid)
+          {
+            last_range = std::numeric_limits<float>::quiet_NaN();
+            continue;
+          }
+
+          const float x = r * cos_table_[i];
+          const float y = r * sin_table_[i];
+          if (current.num_points == 0)
+          {
+            current.first_beam = i;
+            current.min_range = r;
+            first_x = x;
+            first_y = y;
+            sum_x = 0;
+            sum_y = 0;
+          }
+          current.last_beam = i;
+          current.num_points++;
+          current.min_range = std::min(current.min_range, r);
+          sum_x += x;
+          sum_y += y;
+          last_x = x;
+          last_y = y;
+          last_range = r;
+        }
+
+        if (cluster_pub_)
+        {
+          publishClusters(input_scan.header);
+        }
+
+        RCLCPP_DEBUG(logging_interface_->get_logger(), "PolarClusterFilter found %zu clusters, removing %zu points from the laser scan.",
+                     clusters_.size(), count);
+        return true;
+      }
+
+      /**
+       * @brief The clusters accepted in the last update().
+       */
+      const std::vector<ScanCluster>& clusters() const
+      {
+        return clusters_;
+      }
+
+    private:
+      rclcpp::Node::SharedPtr node_;
+      rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr cluster_pub_;
+
+      std::vector<ScanCluster> clusters_;
+      std::vector<float> sin_table_;
+      std::vector<float> cos_table_;
+      size_t cached_size_ = 0;
+      float cached_angle_min_ = 0;
+      float cached_angle_increment_ = 0;
+
+      void updateTrigTable(const sensor_msgs::msg::LaserScan& scan)
+      {
+        const size_t num_beams = scan.ranges.size();
+        sin_table_.resize(num_beams);
+        cos_table_.resize(num_beams);
+        for (size_t i = 0; i < num_beams; ++i)
+        {
+          const double angle = scan.angle_min + i * scan.angle_increment;
+          sin_table_[i] = std::sin(angle);
+          cos_table_[i] = std::cos(angle);
+        }
+        cached_size_ = num_beams;
+        cached_angle_min_ = scan.angle_min;
+        cached_angle_increment_ = scan.angle_increment;
+      }
+
+      // accepts or rejects a finished cluster, returns the number of removed points
+      size_t finishCluster(const ScanCluster& cluster, sensor_msgs::msg::LaserScan& scan)
+      {
+        const bool accepted = int(cluster.num_points) >= min_points_ && int(cluster.num_points) <= max_points_ &&
+                              cluster.extent >= min_extent_ && cluster.extent <= max_extent_;
+        if (accepted)
+        {
+          clusters_.push_back(cluster);
+          if (annotate_intensities_)
+          {
+            for (uint32_t i = cluster.first_beam; i <= cluster.last_beam; ++i)
+            {
+              scan.intensities[i] = clusters_.size();
+            }
+          }
+          return 0;
+        }
+        if (remove_rejected_)
+        {
+          for (uint32_t i = cluster.first_beam; i <= cluster.last_beam; ++i)
+          {
+            scan.ranges[i] = std::numeric_limits<float>::quiet_NaN();
+          }
+          return cluster.num_points;
+        }
+        return 0;
+      }
+
+      void publishClusters(const std_msgs::msg::Header& header)
+      {
+        sensor_msgs::msg::PointCloud2 cloud;
+        cloud.header = header;
+        sensor_msgs::PointCloud2Modifier modifier(cloud);
+        modifier.setPointCloud2Fields(8,
+            "x", 1, sensor_msgs::msg::PointField::FLOAT32,
+            "y", 1, sensor_msgs::msg::PointField::FLOAT32,
+            "z", 1, sensor_msgs::msg::PointField::FLOAT32,
+            "extent", 1, sensor_msgs::msg::PointField::FLOAT32,
+            "min_range", 1, sensor_msgs::msg::PointField::FLOAT32,
+            "first_beam", 1, sensor_msgs::msg::PointField::UINT32,
+            "last_beam", 1, sensor_msgs::msg::PointField::UINT32,
+            "num_points", 1, sensor_msgs::msg::PointField::UINT32);
+        modifier.resize(clusters_.size());
+
+        sensor_msgs::PointCloud2Iterator<float> iter_x(cloud, "x");
+        sensor_msgs::PointCloud2Iterator<float> iter_y(cloud, "y");
+        sensor_msgs::PointCloud2Iterator<float> iter_z(cloud, "z");
+        sensor_msgs::PointCloud2Iterator<float> iter_extent(cloud, "extent");
+        sensor_msgs::PointCloud2Iterator<float> iter_min_range(cloud, "min_range");
+        sensor_msgs::PointCloud2Iterator<uint32_t> iter_first(cloud, "first_beam");
+        sensor_msgs::PointCloud2Iterator<uint32_t> iter_last(cloud, "last_beam");
+        sensor_msgs::PointCloud2Iterator<uint32_t> iter_num(cloud, "num_points");
+        for (const ScanCluster& cluster : clusters_)
+        {
+          *iter_x = cluster.x;
+          *iter_y = cluster.y;
+          *iter_z = 0.f;
+          *iter_extent = cluster.extent;
+          *iter_min_range = cluster.min_range;
+          *iter_first = cluster.first_beam;
+          *iter_last = cluster.last_beam;
+          *iter_num = cluster.num_points;
+          ++iter_x; ++iter_y; ++iter_z; ++iter_extent; ++iter_min_range; ++iter_first; ++iter_last; ++iter_num;
+        }
+        cluster_pub_->publish(cloud);
+      }
+  };
+}
+#endif
@@ -59,8 +59,13 @@ public:
   }
   bool isShadow(const float r1, const float r2, const float included_angle)
   {
-    const float perpendicular_y_ = r2 * sinf(included_angle);
-    const float perpendicular_x_ = r1 - r2 * cosf(included_angle);
+    return isShadow(r1, r2, sinf(included_angle), cosf(included_angle));
+  }
+  /** Same as above, with the sine and cosine of the included angle precomputed */
+  bool isShadow(const float r1, const float r2, const float included_angle_sin, const float included_angle_cos)
+  {
+    const float perpendicular_y_ = r2 * included_angle_sin;
+    const float perpendicular_x_ = r1 - r2 * included_angle_cos;
     const float perpendicular_tan_ = fabs(perpendicular_y_) / perpendicular_x_;
 
     if (perpendicular_tan_ > 0)
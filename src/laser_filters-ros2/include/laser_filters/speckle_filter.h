@@ -43,6 +43,11 @@
 #include <filters/filter_base.hpp>
 #include <sensor_msgs/msg/laser_scan.hpp>
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 namespace laser_filters
 {
 
@@ -153,6 +158,124 @@ class RadiusOutlierWindowValidator : public WindowValidator
   }
 };
 
+/**
+ * @brief The window test of LaserScanSpeckleFilter on plain range arrays, for the filters which
+ * run it on data other than a LaserScan (LaserScanEdgeArtifactFilter, MultiEchoSpeckleFilter).
+ *
+ * Same as DistanceWindowValidator / RadiusOutlierWindowValidator. The ranges are echo-major,
+ * echo e of beam j is at ranges[e * num_beams + j] and beam j has echo_counts[j] echoes, or
+ * exactly one if echo_counts is null. A neighbour beam is tested with its echo closest to the
+ * range at the window start, so with one echo per beam this is the LaserScan test.
+ * The caller keeps cos(y * angle_increment) for y in [-filter_window, filter_window] in
+ * cos_table[y], so that the table can be shared with other tests.
+ */
+class SpeckleWindowTest
+{
+public:
+  void configure(int filter_type, double max_range, double max_range_difference, int filter_window)
+  {
+    filter_type_ = filter_type;
+    max_range_ = max_range;
+    max_range_difference_ = max_range_difference;
+    filter_window_ = filter_window;
+  }
+
+  // ranges beyond max_range are never removed, as long as the scan has one window
+  bool isBeyondMaxRange(const float range) const
+  {
+    return range > max_range_;
+  }
+
+  /**
+   * @brief Tests the window which starts at beam idx with the given range.
+   *
+   * If the window is valid and matches is not null, matches[k - 1] is set to the echo of beam
+   * idx + k closest to range for k in [1, filter_window), or -1 if the beam has none. These are
+   * the echoes which the window covers besides its start.
+   */
+  bool isWindowValid(const float * ranges, const int num_beams, const uint32_t * echo_counts,
+                     const int idx, const float range, const float * cos_table, int * matches = nullptr) const
+  {
+    if (filter_type_ == SpeckleFilterType::Distance)
+    {
+      if (std::isnan(range))
+      {
+        return false;
+      }
+      for (int k = 1; k < filter_window_ && idx + k < num_beams; ++k)
+      {
+        float diff = 0;
+        const int e = closestEcho(ranges, num_beams, echo_counts, idx + k, range, cos_table[k], diff);
+        if (e < 0 || diff > max_range_difference_)
+        {
+          return false;
+        }
+        if (matches)
+        {
+          matches[k - 1] = e;
+        }
+      }
+      return true;
+    }
+
+    int num_neighbors = 0;
+    for (int y = -filter_window_; y < filter_window_ + 1 && num_neighbors < filter_window_; y++)
+    {
+      const int j = idx + y;
+      if (j < 0 || j >= num_beams || j == idx)
+      {
+        continue;
+      }
+      float d = 0;
+      if (closestEcho(ranges, num_beams, echo_counts, j, range, cos_table[y], d) >= 0 && d <= max_range_difference_)
+      {
+        num_neighbors++;
+      }
+    }
+    if (num_neighbors < filter_window_)
+    {
+      return false;
+    }
+    for (int k = 1; matches && k < filter_window_ && idx + k < num_beams; ++k)
+    {
+      float d = 0;
+      matches[k - 1] = closestEcho(ranges, num_beams, echo_counts, idx + k, range, cos_table[k], d);
+    }
+    return true;
+  }
+
+private:
+  int filter_type_ = 0;
+  double max_range_ = 0;
+  double max_range_difference_ = 0;
+  int filter_window_ = 0;
+
+  // echo of beam j closest to range, -1 if all of its echoes are NaN
+  int closestEcho(const float * ranges, const int num_beams, const uint32_t * echo_counts,
+                  const int j, const float range, const float cos_angle, float & distance) const
+  {
+    const int count = echo_counts ? int(echo_counts[j]) : 1;
+    int closest = -1;
+    for (int e = 0; e < count; ++e)
+    {
+      const float r2 = ranges[e * num_beams + j];
+      if (std::isnan(r2))
+      {
+        continue;
+      }
+      // see RadiusOutlierWindowValidator for the distance formula
+      const float d = filter_type_ == SpeckleFilterType::Distance ? std::fabs(r2 - range) :
+          sqrt(pow(range, 2) + pow(r2, 2) - (2 * range * r2 * cos_angle));
+      if (closest < 0 || d < distance)
+      {
+        closest = e;
+        distance = d;
+      }
+    }
+    return closest;
+  }
+};
+
 /**
  * @brief This is a filter that removes speckle points in a laser scan based on consecutive ranges
  */
@@ -37,8 +37,16 @@
 #include "laser_filters/interpolation_filter.h"
 #include "laser_filters/angular_bounds_filter.h"
 #include "laser_filters/angular_bounds_filter_in_place.h"
+#include "laser_filters/angular_sectors_filter.h"
 #include "laser_filters/box_filter.h"
 #include "laser_filters/speckle_filter.h"
+#include "laser_filters/edge_artifact_filter.h"
+#include "laser_filters/polar_cluster_filter.h"
+#include "laser_filters/multi_echo_scan.h"
+#include "laser_filters/multi_echo_range_filter.h"
+#include "laser_filters/multi_echo_angular_bounds_filter.h"
+#include "laser_filters/multi_echo_box_filter.h"
+#include "laser_filters/multi_echo_speckle_filter.h"
 
 #include <sensor_msgs/msg/laser_scan.hpp>
 
@@ -51,9 +59,17 @@ PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanIntensityFilter, filters::FilterB
 PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanRangeFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanAngularBoundsFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanAngularBoundsFilterInPlace, filters::FilterBase<sensor_msgs::msg::LaserScan>)
+PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanAngularSectorsFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanFootprintFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::ScanShadowsFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::InterpolationFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanBoxFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanMaskFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
 PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanSpeckleFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
+PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanEdgeArtifactFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
+PLUGINLIB_EXPORT_CLASS(laser_filters::LaserScanPolarClusterFilter, filters::FilterBase<sensor_msgs::msg::LaserScan>)
+
+PLUGINLIB_EXPORT_CLASS(laser_filters::MultiEchoRangeFilter, filters::FilterBase<laser_filters::MultiEchoScan>)
+PLUGINLIB_EXPORT_CLASS(laser_filters::MultiEchoAngularBoundsFilter, filters::FilterBase<laser_filters::MultiEchoScan>)
+PLUGINLIB_EXPORT_CLASS(laser_filters::MultiEchoBoxFilter, filters::FilterBase<laser_filters::MultiEchoScan>)
+PLUGINLIB_EXPORT_CLASS(laser_filters::MultiEchoSpeckleFilter, filters::FilterBase<laser_filters::MultiEchoScan>)
@@ -0,0 +1,135 @@
+/*********************************************************************
+*
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2022, laser_filters authors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of Willow Garage, Inc. nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************/
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/multi_echo_laser_scan.hpp>
+
+#include <filters/filter_chain.hpp>
+
+#include "laser_filters/multi_echo_scan.h"
+
+#include "neo_tracetools/tracetools.h"
+
+/**
+ * Runs a chain of filters::FilterBase<laser_filters::MultiEchoScan> on the echoes of a
+ * sensor_msgs::msg::MultiEchoLaserScan and publishes one echo per beam as a LaserScan.
+ *
+ * The message is flattened once into a MultiEchoScan, all buffers keep their capacity so that
+ * after the first scan nothing is allocated per beam.
+ */
+class MultiEchoFilterChain
+{
+protected:
+  rclcpp::Node::SharedPtr nh_;
+
+  rclcpp::Subscription<sensor_msgs::msg::MultiEchoLaserScan>::SharedPtr scan_sub_;
+
+  // Filter Chain
+  filters::FilterChain<laser_filters::MultiEchoScan> filter_chain_;
+  laser_filters::EchoSelection echo_selection_ = laser_filters::EchoSelection::First;
+
+  // Components for publishing
+  laser_filters::MultiEchoScan scan_in_;
+  laser_filters::MultiEchoScan scan_out_;
+  sensor_msgs::msg::LaserScan msg_;
+  sensor_msgs::msg::MultiEchoLaserScan echoes_msg_;
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr output_pub_;
+  rclcpp::Publisher<sensor_msgs::msg::MultiEchoLaserScan>::SharedPtr echoes_pub_;
+
+public:
+  MultiEchoFilterChain(rclcpp::Node::SharedPtr node)
+      : nh_(node),
+        filter_chain_("laser_filters::MultiEchoScan")
+  {
+    // Configure filter chain
+    filter_chain_.configure("", nh_->get_node_logging_interface(), nh_->get_node_parameters_interface());
+
+    const std::string echo_selection = nh_->declare_parameter("echo_selection", std::string("first"));
+    if (!laser_filters::parseEchoSelection(echo_selection, echo_selection_))
+    {
+      RCLCPP_ERROR(nh_->get_logger(), "Unknown echo_selection '%s', using 'first'.", echo_selection.c_str());
+    }
+
+    // the filtered echoes are only converted back when asked for
+    if (nh_->declare_parameter("publish_echoes", false))
+    {
+      echoes_pub_ = nh_->create_publisher<sensor_msgs::msg::MultiEchoLaserScan>("echoes_filtered", 1000);
+    }
+    output_pub_ = nh_->create_publisher<sensor_msgs::msg::LaserScan>("scan_filtered", 1000);
+
+    scan_sub_ = nh_->create_subscription<sensor_msgs::msg::MultiEchoLaserScan>(
+      "echoes", rclcpp::SensorDataQoS(),
+      std::bind(&MultiEchoFilterChain::callback, this, std::placeholders::_1));
+  }
+
+  // Callback
+  void callback(const std::shared_ptr<const sensor_msgs::msg::MultiEchoLaserScan>& msg_in)
+  {
+    NEO_TRACEPOINT(message, "multi_echo_filter_chain", "receive", "echoes",
+      neo_tracetools::stamp_ns(msg_in->header.stamp));
+
+    laser_filters::fromMsg(*msg_in, scan_in_);
+
+    // Run the filter chain
+    if (!filter_chain_.update(scan_in_, scan_out_))
+    {
+      return;
+    }
+
+    laser_filters::selectEcho(scan_out_, echo_selection_, msg_);
+    output_pub_->publish(msg_);
+    NEO_TRACEPOINT(message, "multi_echo_filter_chain", "publish", "scan_filtered",
+      neo_tracetools::stamp_ns(msg_.header.stamp));
+
+    if (echoes_pub_)
+    {
+      laser_filters::toMsg(scan_out_, echoes_msg_);
+      echoes_pub_->publish(echoes_msg_);
+    }
+  }
+};
+
+int main(int argc, char **argv)
+{
+  rclcpp::init(argc, argv);
+  auto nh = rclcpp::Node::make_shared("multi_echo_filter_chain");
+  MultiEchoFilterChain t(nh);
+
+  rclcpp::spin(nh);
+  rclcpp::shutdown();
+  return 0;
+}
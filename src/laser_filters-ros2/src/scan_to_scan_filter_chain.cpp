@@ -37,7 +37,11 @@
 
 #include "message_filters/subscriber.h"
 
-#include "filters/filter_chain.hpp"
+#include "laser_filters/instrumented_filter_chain.h"
+
+#include "diagnostic_updater/diagnostic_updater.hpp"
+
+#include "neo_tracetools/tracetools.h"
 
 class ScanToScanFilterChain
 {
@@ -54,7 +58,13 @@ protected:
   double tf_filter_tolerance_;
 
   // Filter Chain
-  filters::FilterChain<sensor_msgs::msg::LaserScan> filter_chain_;
+  laser_filters::InstrumentedFilterChain filter_chain_;
+
+  // Diagnostics, timing is only recorded when enable_diagnostics is set
+  std::unique_ptr<diagnostic_updater::Updater> diagnostic_updater_;
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr param_callback_;
+  laser_filters::RollingStatistics latency_;
+  uint64_t published_ = 0;
 
   // Components for publishing
   sensor_msgs::msg::LaserScan msg_;
@@ -67,12 +77,49 @@ public:
         tf_(NULL),
         buffer_(nh_->get_clock()),
         scan_sub_(nh_, "scan", rmw_qos_profile_sensor_data),
-        tf_filter_(NULL),
-        filter_chain_("sensor_msgs::msg::LaserScan")
+        tf_filter_(NULL)
   {
     // Configure filter chain
     filter_chain_.configure("", nh_->get_node_logging_interface(), nh_->get_node_parameters_interface());
 
+    // Setup diagnostics
+    const bool enable_diagnostics = nh_->declare_parameter("enable_diagnostics", false);
+    const int64_t diagnostics_window = nh_->declare_parameter("diagnostics_window", 100);
+    filter_chain_.setEnabled(enable_diagnostics);
+    filter_chain_.setWindow(std::max<int64_t>(diagnostics_window, 1));
+    latency_.setWindow(std::max<int64_t>(diagnostics_window, 1));
+
+    diagnostic_updater_ = std::make_unique<diagnostic_updater::Updater>(nh_);
+    diagnostic_updater_->setHardwareID("none");
+    diagnostic_updater_->add("filter_chain", this, &ScanToScanFilterChain::chainDiagnostics);
+    const auto & stats = filter_chain_.getFilterStatistics();
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+      diagnostic_updater_->add("filter " + stats[i].name,
+        [this, i](diagnostic_updater::DiagnosticStatusWrapper & wrapper) { filterDiagnostics(i, wrapper); });
+    }
+
+    param_callback_ = nh_->add_on_set_parameters_callback(
+      [this](const std::vector<rclcpp::Parameter> & parameters) {
+        rcl_interfaces::msg::SetParametersResult result;
+        result.successful = true;
+        for (const auto & parameter : parameters)
+        {
+          if (parameter.get_name() == "enable_diagnostics") {
+            filter_chain_.setEnabled(parameter.as_bool());
+          } else if (parameter.get_name() == "diagnostics_window") {
+            if (parameter.as_int() < 1) {
+              result.successful = false;
+              result.reason = "diagnostics_window must be positive";
+            } else {
+              filter_chain_.setWindow(parameter.as_int());
+              latency_.setWindow(parameter.as_int());
+            }
+          }
+        }
+        return result;
+      });
+
     std::string tf_message_filter_target_frame;
     if (nh_->get_parameter("tf_message_filter_target_frame", tf_message_filter_target_frame))
     {
@@ -109,12 +156,74 @@ public:
   // Callback
   void callback(const std::shared_ptr<const sensor_msgs::msg::LaserScan>& msg_in)
   {
+    NEO_TRACEPOINT(message, "scan_to_scan_filter_chain", "receive", "scan",
+      neo_tracetools::stamp_ns(msg_in->header.stamp));
+
     // Run the filter chain
     if (filter_chain_.update(*msg_in, msg_))
     {
       //only publish result if filter succeeded
       output_pub_->publish(msg_);
+      NEO_TRACEPOINT(message, "scan_to_scan_filter_chain", "publish", "scan_filtered",
+        neo_tracetools::stamp_ns(msg_.header.stamp));
+
+      if (filter_chain_.isEnabled())
+      {
+        // input to output latency, from the scan stamp to publishing
+        latency_.add((nh_->now() - rclcpp::Time(msg_in->header.stamp)).seconds());
+        published_++;
+      }
+    }
+  }
+
+  void chainDiagnostics(diagnostic_updater::DiagnosticStatusWrapper & wrapper)
+  {
+    if (!filter_chain_.isEnabled())
+    {
+      wrapper.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "Instrumentation disabled");
+      return;
+    }
+    const auto & duration = filter_chain_.getChainDuration();
+    if (filter_chain_.getChainFailures() > 0) {
+      wrapper.summary(diagnostic_msgs::msg::DiagnosticStatus::WARN, "Filter chain failed on some scans");
+    } else {
+      wrapper.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "OK");
+    }
+    wrapper.add("Filters", filter_chain_.size());
+    wrapper.add("Updates", filter_chain_.getChainUpdates());
+    wrapper.add("Failures", filter_chain_.getChainFailures());
+    wrapper.add("Published", published_);
+    wrapper.add("Duration p50 [ms]", 1e3 * duration.percentile(50));
+    wrapper.add("Duration p95 [ms]", 1e3 * duration.percentile(95));
+    wrapper.add("Duration p99 [ms]", 1e3 * duration.percentile(99));
+    wrapper.add("Duration max [ms]", 1e3 * duration.max());
+    wrapper.add("Latency p50 [ms]", 1e3 * latency_.percentile(50));
+    wrapper.add("Latency p95 [ms]", 1e3 * latency_.percentile(95));
+    wrapper.add("Latency p99 [ms]", 1e3 * latency_.percentile(99));
+    wrapper.add("Latency max [ms]", 1e3 * latency_.max());
+  }
+
+  void filterDiagnostics(size_t index, diagnostic_updater::DiagnosticStatusWrapper & wrapper)
+  {
+    if (!filter_chain_.isEnabled())
+    {
+      wrapper.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "Instrumentation disabled");
+      return;
+    }
+    const auto & stats = filter_chain_.getFilterStatistics()[index];
+    if (stats.failures > 0) {
+      wrapper.summary(diagnostic_msgs::msg::DiagnosticStatus::WARN, "Filter failed on some scans");
+    } else {
+      wrapper.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "OK");
     }
+    wrapper.add("Type", stats.type);
+    wrapper.add("Updates", stats.updates);
+    wrapper.add("Failures", stats.failures);
+    wrapper.add("NaN beams", stats.nan_beams);
+    wrapper.add("Duration p50 [ms]", 1e3 * stats.duration.percentile(50));
+    wrapper.add("Duration p95 [ms]", 1e3 * stats.duration.percentile(95));
+    wrapper.add("Duration p99 [ms]", 1e3 * stats.duration.percentile(99));
+    wrapper.add("Duration max [ms]", 1e3 * stats.duration.max());
   }
 };
 
@@ -33,6 +33,9 @@
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <pluginlib/class_loader.hpp>
 
+#include "laser_filters/instrumented_filter_chain.h"
+#include "laser_filters/multi_echo_scan.h"
+
 using sensor_msgs::msg::LaserScan;
 
 LaserScan gen_msg(rclcpp::Time stamp)
@@ -71,6 +74,36 @@ void expect_ranges_eq(const std::vector<float> &a, const std::vector<float> &b)
   }
 }
 
+/** Same first echo as gen_msg(), plus second echoes on beams 3, 4, 5 and 7.
+ */
+sensor_msgs::msg::MultiEchoLaserScan gen_multi_echo_msg(rclcpp::Time stamp)
+{
+  const LaserScan scan = gen_msg(stamp);
+  sensor_msgs::msg::MultiEchoLaserScan msg;
+  msg.header = scan.header;
+  msg.angle_min = scan.angle_min;
+  msg.angle_max = scan.angle_max;
+  msg.angle_increment = scan.angle_increment;
+  msg.time_increment = scan.time_increment;
+  msg.scan_time = scan.scan_time;
+  msg.range_min = scan.range_min;
+  msg.range_max = scan.range_max;
+  msg.ranges.resize(scan.ranges.size());
+  msg.intensities.resize(scan.ranges.size());
+  for (size_t i = 0; i < scan.ranges.size(); i++) {
+    msg.ranges[i].echoes = {scan.ranges[i]};
+    msg.intensities[i].echoes = {10.0};
+  }
+  const size_t beams[] = {3, 4, 5, 7};
+  const float ranges[] = {2.0, 2.05, 4.0, 3.0};
+  const float intensities[] = {20.0, 5.0, 20.0, 20.0};
+  for (size_t k = 0; k < 4; k++) {
+    msg.ranges[beams[k]].echoes.push_back(ranges[k]);
+    msg.intensities[beams[k]].echoes.push_back(intensities[k]);
+  }
+  return msg;
+}
+
 TEST(ScanToScanFilterChain, BadConfiguration)
 {
   filters::FilterChain<LaserScan> filter_chain_("sensor_msgs::msg::LaserScan");
@@ -168,6 +201,133 @@ TEST(ScanToScanFilterChain, ShadowFilter)
   filter_chain_.clear();
 }
 
+TEST(ScanToScanFilterChain, EdgeArtifactFilter)
+{
+  LaserScan msg_in, msg_out, expected_msg;
+  float nanval = std::numeric_limits<float>::quiet_NaN();
+  // shadows (same as ShadowFilter) plus the speckles at 1 and 9, 9.0 is beyond max_range
+  float temp[] = {nanval, nanval, nanval, 1.0, 1.0, nanval, 1.0, 1.0, 1.0, nanval};
+  std::vector<float> v1 (temp, temp + sizeof(temp) / sizeof(float));
+  expected_msg.ranges = v1;
+  filters::FilterChain<LaserScan> filter_chain_("sensor_msgs::msg::LaserScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("edge_artifact_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  msg_in = gen_msg(node->now());
+
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+
+  // a second scan reuses the cached sin / cos table
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+
+  filter_chain_.clear();
+}
+
+TEST(ScanToScanFilterChain, EdgeArtifactRadiusOutlierFilter)
+{
+  LaserScan msg_in, msg_out, expected_msg;
+  float nanval = std::numeric_limits<float>::quiet_NaN();
+  // same shadows, a speckle window now needs both direct neighbours within 0.1 m,
+  // so beam 6 goes as well
+  float temp[] = {nanval, nanval, nanval, 1.0, 1.0, nanval, nanval, 1.0, 1.0, nanval};
+  std::vector<float> v1 (temp, temp + sizeof(temp) / sizeof(float));
+  expected_msg.ranges = v1;
+  filters::FilterChain<LaserScan> filter_chain_("sensor_msgs::msg::LaserScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("edge_artifact_radius_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  msg_in = gen_msg(node->now());
+
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+
+  filter_chain_.clear();
+}
+
+TEST(ScanToScanFilterChain, PolarClusterFilter)
+{
+  LaserScan msg_in, msg_out, expected_msg;
+  float nanval = std::numeric_limits<float>::quiet_NaN();
+  // clusters {0}, {2, 3, 4} and {6, 7, 8}, the single point cluster is removed
+  float temp[] = {nanval, 0.1, 1.0, 1.0, 1.0, 9.0, 1.0, 1.0, 1.0, 2.3};
+  std::vector<float> v1 (temp, temp + sizeof(temp) / sizeof(float));
+  expected_msg.ranges = v1;
+  float temp2[] = {0, 0, 1, 1, 1, 0, 2, 2, 2, 0};
+  std::vector<float> v2 (temp2, temp2 + sizeof(temp2) / sizeof(float));
+  expected_msg.intensities = v2;
+  filters::FilterChain<LaserScan> filter_chain_("sensor_msgs::msg::LaserScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("polar_cluster_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  msg_in = gen_msg(node->now());
+
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+  expect_ranges_eq(msg_out.intensities, expected_msg.intensities);
+
+  // a second scan reuses the cached sin / cos table
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+  expect_ranges_eq(msg_out.intensities, expected_msg.intensities);
+
+  filter_chain_.clear();
+}
+
+TEST(ScanToScanFilterChain, PolarClusterFilterBreakpoints)
+{
+  LaserScan msg_in, msg_out;
+  // all beams valid, clusters are split by the breakpoint distance only:
+  // {0, 1, 2} accepted, {3, 4, 5} rejected by max_extent (0.28 m), {6} by min_points,
+  // {7, 8, 9, 10} by max_points and {11, 12} accepted. The 0.14 m spacing at 1.4 m is
+  // within the breakpoint distance there, the 0.06 m spacing at 0.6 m as well.
+  float temp[] = {1.0, 1.0, 1.05, 1.4, 1.4, 1.4, 1.0, 0.6, 0.6, 0.6, 0.6, 1.0, 1.0};
+  std::vector<float> v1 (temp, temp + sizeof(temp) / sizeof(float));
+  float temp2[] = {1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2};
+  std::vector<float> v2 (temp2, temp2 + sizeof(temp2) / sizeof(float));
+  filters::FilterChain<LaserScan> filter_chain_("sensor_msgs::msg::LaserScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("polar_cluster_breakpoint_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  msg_in = gen_msg(node->now());
+  msg_in.angle_min = -.6;
+  msg_in.angle_max = .6;
+  msg_in.ranges = v1;
+  msg_in.intensities = v1;
+
+  // rejected clusters are kept with remove_rejected: false, only not annotated
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  ASSERT_EQ(v1.size(), msg_out.ranges.size());
+  ASSERT_EQ(v2.size(), msg_out.intensities.size());
+  for (size_t i = 0; i < v1.size(); i++) {
+    EXPECT_FLOAT_EQ(v1[i], msg_out.ranges[i]);
+    EXPECT_FLOAT_EQ(v2[i], msg_out.intensities[i]);
+  }
+
+  filter_chain_.clear();
+}
+
 TEST(ScanToScanFilterChain, ArrayFilter)
 {
   LaserScan msg_in, msg_out, expected_msg;
@@ -226,6 +386,229 @@ TEST(ScanToScanFilterChain, MaskFilter)
   filter_chain_.clear();
 }
 
+TEST(ScanToScanFilterChain, AngularSectorsFilter)
+{
+  LaserScan msg_in, msg_out, expected_msg;
+  const float nanval = std::numeric_limits<float>::quiet_NaN();
+  const float temp[] = {1.0, nanval, nanval, 1.0, 1.0, 9.0, 1.0, nanval, nanval, 2.3};
+  const std::vector<float> v1 (temp, temp + sizeof(temp) / sizeof(float));
+  expected_msg.ranges = v1;
+  filters::FilterChain<LaserScan> filter_chain_("sensor_msgs::msg::LaserScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("angular_sectors_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  msg_in = gen_msg(node->now());
+
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+  EXPECT_EQ(msg_out.ranges.size(), msg_in.ranges.size());
+  EXPECT_EQ(msg_out.intensities[1], 0.0f);
+  EXPECT_EQ(msg_out.intensities[3], msg_in.intensities[3]);
+
+  filter_chain_.clear();
+}
+
+TEST(ScanToScanFilterChain, AngularBoundsFilter)
+{
+  LaserScan msg_in, msg_out;
+  filters::FilterChain<LaserScan> filter_chain_("sensor_msgs::msg::LaserScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("angular_bounds_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  msg_in = gen_msg(node->now());
+
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+
+  // beams at -0.2 ... 0.2
+  const float expected[] = {1.0, 1.0, 9.0, 1.0, 1.0};
+  ASSERT_EQ(msg_out.ranges.size(), 5u);
+  ASSERT_EQ(msg_out.intensities.size(), 5u);
+  for (size_t i = 0; i < 5; i++) {
+    EXPECT_NEAR(msg_out.ranges[i], expected[i], 1e-6);
+  }
+  EXPECT_NEAR(msg_out.angle_min, -0.2, 1e-6);
+  EXPECT_NEAR(msg_out.angle_max, 0.2, 1e-6);
+  EXPECT_NEAR(
+    (rclcpp::Time(msg_out.header.stamp) - rclcpp::Time(msg_in.header.stamp)).seconds(),
+    3 * msg_in.time_increment, 1e-6);
+
+  filter_chain_.clear();
+}
+
+TEST(ScanToScanFilterChain, InstrumentedFilterChain)
+{
+  LaserScan msg_in, msg_out, expected_msg;
+  float nanval = std::numeric_limits<float>::quiet_NaN();
+  float temp[] = {1.0, nanval, 1.0, 1.0, 1.0, nanval, 1.0, 1.0, 1.0, 2.3};
+  std::vector<float> v1 (temp, temp + sizeof(temp) / sizeof(float));
+  expected_msg.ranges = v1;
+  laser_filters::InstrumentedFilterChain filter_chain_;
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("intensity_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+  ASSERT_EQ(filter_chain_.size(), 1u);
+
+  msg_in = gen_msg(node->now());
+
+  // disabled, same output as filters::FilterChain and no statistics
+  EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+  expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+  EXPECT_EQ(filter_chain_.getChainUpdates(), 0u);
+  EXPECT_EQ(filter_chain_.getFilterStatistics()[0].updates, 0u);
+
+  filter_chain_.setEnabled(true);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(filter_chain_.update(msg_in, msg_out));
+    expect_ranges_eq(msg_out.ranges, expected_msg.ranges);
+  }
+  const auto & stats = filter_chain_.getFilterStatistics()[0];
+  EXPECT_EQ(stats.name, "intensity_threshold");
+  EXPECT_EQ(stats.updates, 3u);
+  EXPECT_EQ(stats.failures, 0u);
+  EXPECT_EQ(stats.nan_beams, 6u);
+  EXPECT_EQ(stats.duration.size(), 3u);
+  EXPECT_EQ(filter_chain_.getChainUpdates(), 3u);
+  EXPECT_LE(filter_chain_.getChainDuration().percentile(50), filter_chain_.getChainDuration().max());
+
+  filter_chain_.clear();
+}
+
+TEST(ScanToScanFilterChain, RollingStatistics)
+{
+  laser_filters::RollingStatistics stats(10);
+  EXPECT_EQ(stats.percentile(50), 0);
+  for (int i = 1; i <= 20; ++i) {
+    stats.add(i);
+  }
+  // only the last 10 samples (11 to 20) are kept
+  EXPECT_EQ(stats.size(), 10u);
+  EXPECT_EQ(stats.percentile(0), 11);
+  EXPECT_EQ(stats.percentile(100), 20);
+  EXPECT_EQ(stats.max(), 20);
+}
+
+TEST(MultiEchoFilterChain, EchoSelection)
+{
+  laser_filters::MultiEchoScan scan;
+  laser_filters::fromMsg(gen_multi_echo_msg(rclcpp::Time(0)), scan);
+  ASSERT_EQ(scan.num_beams, 10u);
+  ASSERT_EQ(scan.num_echoes, 2u);
+  EXPECT_TRUE(std::isnan(scan.echo(1)[0]));
+  EXPECT_FLOAT_EQ(scan.echo(1)[3], 2.0);
+
+  LaserScan msg_out;
+  laser_filters::selectEcho(scan, laser_filters::EchoSelection::First, msg_out);
+  expect_ranges_eq(msg_out.ranges, gen_msg(rclcpp::Time(0)).ranges);
+
+  laser_filters::selectEcho(scan, laser_filters::EchoSelection::Last, msg_out);
+  const float last[] = {1.0, 0.1, 1.0, 2.0, 2.05, 4.0, 1.0, 3.0, 1.0, 2.3};
+  expect_ranges_eq(msg_out.ranges, std::vector<float>(last, last + 10));
+
+  laser_filters::selectEcho(scan, laser_filters::EchoSelection::Strongest, msg_out);
+  const float strongest[] = {1.0, 0.1, 1.0, 2.0, 1.0, 4.0, 1.0, 3.0, 1.0, 2.3};
+  expect_ranges_eq(msg_out.ranges, std::vector<float>(strongest, strongest + 10));
+  EXPECT_EQ(msg_out.intensities[3], 20.0);
+  EXPECT_EQ(msg_out.intensities[4], 10.0);
+
+  laser_filters::EchoSelection selection;
+  EXPECT_TRUE(laser_filters::parseEchoSelection("last", selection));
+  EXPECT_EQ(selection, laser_filters::EchoSelection::Last);
+  EXPECT_FALSE(laser_filters::parseEchoSelection("second", selection));
+}
+
+TEST(MultiEchoFilterChain, RangeBoundsSpeckle)
+{
+  filters::FilterChain<laser_filters::MultiEchoScan> filter_chain_("laser_filters::MultiEchoScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("multi_echo_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  const auto msg_in = gen_multi_echo_msg(node->now());
+  laser_filters::MultiEchoScan scan_in, scan_out;
+  laser_filters::fromMsg(msg_in, scan_in);
+  EXPECT_TRUE(filter_chain_.update(scan_in, scan_out));
+
+  // beams at -0.2 ... 0.4, 0.1 and 9.0 out of range, speckles removed on every echo
+  const float nanval = std::numeric_limits<float>::quiet_NaN();
+  ASSERT_EQ(scan_out.num_beams, 7u);
+  ASSERT_EQ(scan_out.num_echoes, 2u);
+  EXPECT_NEAR(scan_out.angle_min, -0.2, 1e-6);
+  const float first[] = {1.0, 1.0, nanval, 1.0, 1.0, 1.0, nanval};
+  const float second[] = {2.0, 2.05, nanval, nanval, nanval, nanval, nanval};
+  for (size_t i = 0; i < 7; i++) {
+    EXPECT_TRUE(std::isnan(first[i]) ? std::isnan(scan_out.echo(0)[i]) : scan_out.echo(0)[i] == first[i]);
+    EXPECT_TRUE(std::isnan(second[i]) ? std::isnan(scan_out.echo(1)[i]) : scan_out.echo(1)[i] == second[i]);
+  }
+
+  // the padding is dropped again, filtered echoes are kept as NaN
+  sensor_msgs::msg::MultiEchoLaserScan msg_out;
+  laser_filters::toMsg(scan_out, msg_out);
+  ASSERT_EQ(msg_out.ranges.size(), 7u);
+  const size_t counts[] = {2, 2, 2, 1, 2, 1, 1};
+  for (size_t i = 0; i < 7; i++) {
+    ASSERT_EQ(msg_out.ranges[i].echoes.size(), counts[i]);
+    ASSERT_EQ(msg_out.intensities[i].echoes.size(), counts[i]);
+  }
+  EXPECT_TRUE(std::isnan(msg_out.ranges[2].echoes[0]));
+  EXPECT_TRUE(std::isnan(msg_out.ranges[2].echoes[1]));
+  EXPECT_TRUE(std::isnan(msg_out.ranges[4].echoes[1]));
+
+  // the buffers are reused for the next scan
+  const float * data = scan_out.ranges.data();
+  EXPECT_TRUE(filter_chain_.update(scan_in, scan_out));
+  EXPECT_EQ(scan_out.ranges.data(), data);
+
+  filter_chain_.clear();
+}
+
+TEST(MultiEchoFilterChain, SpeckleMixedEchoCounts)
+{
+  filters::FilterChain<laser_filters::MultiEchoScan> filter_chain_("laser_filters::MultiEchoScan");
+
+  rclcpp::Node::SharedPtr node =
+      std::make_shared<rclcpp::Node>("multi_echo_filter_chain");
+  EXPECT_TRUE(filter_chain_.configure(
+      "",
+      node->get_node_logging_interface(),
+      node->get_node_parameters_interface()));
+
+  // beam 8 has a single return next to the second echo of beam 7
+  auto msg_in = gen_multi_echo_msg(node->now());
+  msg_in.ranges[8].echoes = {3.02};
+  laser_filters::MultiEchoScan scan_in, scan_out;
+  laser_filters::fromMsg(msg_in, scan_in);
+  EXPECT_TRUE(filter_chain_.update(scan_in, scan_out));
+
+  // neighbours are matched across echoes, so both stay although they are on different echoes
+  const float nanval = std::numeric_limits<float>::quiet_NaN();
+  ASSERT_EQ(scan_out.num_beams, 7u);
+  const float first[] = {1.0, 1.0, nanval, 1.0, 1.0, 3.02, nanval};
+  const float second[] = {2.0, 2.05, nanval, nanval, 3.0, nanval, nanval};
+  for (size_t i = 0; i < 7; i++) {
+    EXPECT_TRUE(std::isnan(first[i]) ? std::isnan(scan_out.echo(0)[i]) : scan_out.echo(0)[i] == first[i]);
+    EXPECT_TRUE(std::isnan(second[i]) ? std::isnan(scan_out.echo(1)[i]) : scan_out.echo(1)[i] == second[i]);
+  }
+
+  filter_chain_.clear();
+}
 
 int main(int argc, char **argv){
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,167 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2020 Shivang Patel
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Incremental grid search, following the optimized D* Lite of
+ * S. Koenig and M. Likhachev, "D* Lite", AAAI 2002.
+ *********************************************************************/
+
+#ifndef NAV2_STRAIGHTLINE_PLANNER__D_STAR_LITE_HPP_
+#define NAV2_STRAIGHTLINE_PLANNER__D_STAR_LITE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nav2_straightline_planner
+{
+
+struct GridCell
+{
+  int x;
+  int y;
+};
+
+// D* Lite on an 8-connected grid of costmap values.
+//
+// Searches backwards from the goal, so the search state stays valid while the
+// start moves. Between calls for the same goal only cells whose cost changed are
+// repaired. Entering a cell costs the step length times
+// max(round(neutral_cost + cost_factor * cost), 1), cells from 253 (inscribed) up are blocked,
+// unknown cells (255) count as 252 if allowed.
+//
+// Step lengths are 70 and 99 (99 / 70 ~ sqrt(2)), so all costs are integers: the
+// octile heuristic is exact in free space and the key comparisons of D* Lite rely
+// on exact ties, which float rounding breaks.
+class DStarLite
+{
+public:
+  DStarLite();
+
+  // Sets the cost model, discards the search state if it changed.
+  void set_cost_model(double neutral_cost, double cost_factor, bool allow_unknown);
+
+  // Starts a fresh search towards the given goal cell on the next plan().
+  void reset(int size_x, int size_y, int goal_x, int goal_y);
+
+  // Returns true if there is a search for this goal cell and grid size.
+  bool has_goal(int size_x, int size_y, int goal_x, int goal_y) const;
+
+  // Updates the costs (size_x * size_y values, row-major) and returns the cheapest
+  // path from start to goal as a list of cells, including both.
+  // Returns false if the goal cannot be reached.
+  bool plan(const unsigned char * costs, int start_x, int start_y, std::vector<GridCell> & path);
+
+  // statistics of the last plan()
+  bool was_fresh() const {return fresh_;}
+  size_t num_changed_cells() const {return num_changed_;}
+  size_t num_expanded() const {return num_expanded_;}
+
+private:
+  struct Key
+  {
+    double k1;
+    double k2;
+  };
+
+  struct QueueEntry
+  {
+    Key key;
+    uint32_t cell;
+    uint32_t stamp;
+  };
+
+  static bool less(const Key & a, const Key & b)
+  {
+    return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2);
+  }
+
+  // cost to enter cell v from a neighbor at the given step length
+  double edge_cost(uint32_t v, double step) const
+  {
+    return step * traversal_[cost_[v]];
+  }
+
+  double heuristic(uint32_t a, uint32_t b) const;
+  Key calculate_key(uint32_t u) const;
+
+  // min over all successors s of c(u, s) + g(s)
+  double lookahead(uint32_t u) const;
+
+  void update_vertex(uint32_t u);
+  void insert(uint32_t u, const Key & key);
+  void remove(uint32_t u);
+  bool top(QueueEntry & entry);
+  void pop();
+
+  void apply_costs(const unsigned char * costs);
+  void compute_shortest_path();
+  bool extract_path(std::vector<GridCell> & path) const;
+
+  // neighbor offsets and step lengths, in the same order
+  int offset_[8];
+  int dx_[8];
+  int dy_[8];
+  double step_[8];
+
+  double traversal_[256];
+  double min_traversal_ = 0;
+  double neutral_cost_ = -1;
+  double cost_factor_ = -1;
+  bool allow_unknown_ = false;
+
+  int size_x_ = 0;
+  int size_y_ = 0;
+  uint32_t goal_ = 0;
+  uint32_t start_ = 0;
+  uint32_t last_ = 0;
+  double km_ = 0;
+  bool initialized_ = false;
+
+  std::vector<unsigned char> cost_;
+  std::vector<double> g_;
+  std::vector<double> rhs_;
+  // queue membership: an entry is valid while its stamp matches and the cell is open
+  std::vector<uint32_t> stamp_;
+  std::vector<uint8_t> open_;
+  std::vector<QueueEntry> heap_;
+  size_t num_open_ = 0;
+
+  bool fresh_ = false;
+  size_t num_changed_ = 0;
+  size_t num_expanded_ = 0;
+};
+
+}  // namespace nav2_straightline_planner
+
+#endif  // NAV2_STRAIGHTLINE_PLANNER__D_STAR_LITE_HPP_
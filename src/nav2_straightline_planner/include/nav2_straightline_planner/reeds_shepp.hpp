@@ -0,0 +1,103 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2020 Shivang Patel
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Closed-form Dubins and Reeds-Shepp curves, following
+ * J. A. Reeds and L. A. Shepp, "Optimal paths for a car that goes both
+ * forwards and backwards", Pacific J. Math. 145(2), 1990, and
+ * A. M. Shkel and V. Lumelsky, "Classification of the Dubins set",
+ * Robotics and Autonomous Systems 34, 2001.
+ *********************************************************************/
+
+#ifndef NAV2_STRAIGHTLINE_PLANNER__REEDS_SHEPP_HPP_
+#define NAV2_STRAIGHTLINE_PLANNER__REEDS_SHEPP_HPP_
+
+#include <vector>
+
+namespace nav2_straightline_planner
+{
+
+struct CurvePose
+{
+  double x;
+  double y;
+  double yaw;
+};
+
+enum class SegmentType
+{
+  LEFT,
+  STRAIGHT,
+  RIGHT
+};
+
+struct CurveSegment
+{
+  SegmentType type;
+  // signed length in units of the turning radius, negative means driving backwards
+  double length;
+};
+
+// A shortest curve between two poses as a sequence of (at most five) segments.
+class AnalyticCurve
+{
+public:
+  std::vector<CurveSegment> segments;
+
+  // total length in units of the turning radius
+  double length() const;
+
+  // returns true if the curve contains any backwards segment
+  bool has_reversing() const;
+};
+
+// Computes the shortest forward-only curve from start to goal.
+// Returns false if no curve could be found (should not happen for a valid radius).
+bool solve_dubins(
+  const CurvePose & start, const CurvePose & goal,
+  double turning_radius, AnalyticCurve & curve);
+
+// Computes the shortest forward/backward curve from start to goal.
+// Returns false if no curve could be found (should not happen for a valid radius).
+bool solve_reeds_shepp(
+  const CurvePose & start, const CurvePose & goal,
+  double turning_radius, AnalyticCurve & curve);
+
+// Samples the curve every `resolution` meters, including start and end pose.
+std::vector<CurvePose> sample_curve(
+  const CurvePose & start, const AnalyticCurve & curve,
+  double turning_radius, double resolution);
+
+}  // namespace nav2_straightline_planner
+
+#endif  // NAV2_STRAIGHTLINE_PLANNER__REEDS_SHEPP_HPP_
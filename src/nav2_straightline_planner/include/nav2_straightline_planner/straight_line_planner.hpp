@@ -43,6 +43,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "geometry_msgs/msg/point.hpp"
@@ -53,6 +54,7 @@
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_straightline_planner/reeds_shepp.hpp"
 
 namespace nav2_straightline_planner
 {
@@ -84,6 +86,14 @@ public:
     const geometry_msgs::msg::PoseStamped & goal) override;
 
 private:
+  // Creates a Dubins or Reeds-Shepp path, returns an empty path if blocked.
+  nav_msgs::msg::Path createAnalyticPlan(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal);
+
+  // Returns false if any pose is outside the costmap or inside an obstacle.
+  bool isCollisionFree(const std::vector<CurvePose> & poses) const;
+
   // TF buffer
   std::shared_ptr<tf2_ros::Buffer> tf_;
 
@@ -97,6 +107,15 @@ private:
   std::string global_frame_, name_;
 
   double interpolation_resolution_;
+
+  // "straight", "dubins" or "reeds_shepp"
+  std::string mode_;
+
+  // minimum turning radius for the analytic modes [m]
+  double turning_radius_;
+
+  // if to accept unknown cells when validating analytic paths
+  bool allow_unknown_;
 };
 
 }  // namespace nav2_straightline_planner
@@ -0,0 +1,406 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2020 Shivang Patel
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "nav2_straightline_planner/d_star_lite.hpp"
+
+namespace nav2_straightline_planner
+{
+
+namespace
+{
+
+const double INF = std::numeric_limits<double>::infinity();
+
+const double STRAIGHT_STEP = 70;
+const double DIAGONAL_STEP = 99;
+
+// first blocked costmap value (nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE)
+const int BLOCKED_COST = 253;
+const int UNKNOWN_COST = 255;
+
+// above this share of changed cells a fresh search is cheaper than the repair
+const int FRESH_SEARCH_DIVISOR = 8;
+
+struct QueueCompare
+{
+  template<typename T>
+  bool operator()(const T & a, const T & b) const
+  {
+    // std heap functions build a max heap, invert to pop the smallest key first
+    return b.key.k1 < a.key.k1 || (b.key.k1 == a.key.k1 && b.key.k2 < a.key.k2);
+  }
+};
+
+}  // namespace
+
+DStarLite::DStarLite()
+{
+  int i = 0;
+  for (int dy = -1; dy <= 1; ++dy) {
+    for (int dx = -1; dx <= 1; ++dx) {
+      if (dx || dy) {
+        dx_[i] = dx;
+        dy_[i] = dy;
+        step_[i] = (dx && dy) ? DIAGONAL_STEP : STRAIGHT_STEP;
+        ++i;
+      }
+    }
+  }
+  set_cost_model(50, 0.8, true);
+}
+
+void DStarLite::set_cost_model(double neutral_cost, double cost_factor, bool allow_unknown)
+{
+  if (neutral_cost == neutral_cost_ && cost_factor == cost_factor_ &&
+    allow_unknown == allow_unknown_)
+  {
+    return;
+  }
+  neutral_cost_ = neutral_cost;
+  cost_factor_ = cost_factor;
+  allow_unknown_ = allow_unknown;
+
+  min_traversal_ = INF;
+  for (int cost = 0; cost < 256; ++cost) {
+    if (cost < BLOCKED_COST) {
+      // at least 1, with free cells at 0 the path extraction could loop between equal g values
+      traversal_[cost] = std::max(std::round(neutral_cost + cost_factor * cost), 1.);
+      min_traversal_ = std::min(min_traversal_, traversal_[cost]);
+    } else {
+      traversal_[cost] = INF;
+    }
+  }
+  if (allow_unknown) {
+    traversal_[UNKNOWN_COST] = traversal_[BLOCKED_COST - 1];
+  }
+  initialized_ = false;
+}
+
+void DStarLite::reset(int size_x, int size_y, int goal_x, int goal_y)
+{
+  if (size_x != size_x_ || size_y != size_y_) {
+    size_x_ = size_x;
+    size_y_ = size_y;
+    for (int i = 0; i < 8; ++i) {
+      offset_[i] = dy_[i] * size_x + dx_[i];
+    }
+  }
+  goal_ = goal_y * size_x + goal_x;
+  initialized_ = false;
+}
+
+bool DStarLite::has_goal(int size_x, int size_y, int goal_x, int goal_y) const
+{
+  return initialized_ && size_x == size_x_ && size_y == size_y_ &&
+         static_cast<uint32_t>(goal_y * size_x + goal_x) == goal_;
+}
+
+double DStarLite::heuristic(uint32_t a, uint32_t b) const
+{
+  // octile distance times the cheapest traversal cost, never overestimates
+  const int dx = std::abs(static_cast<int>(a % size_x_) - static_cast<int>(b % size_x_));
+  const int dy = std::abs(static_cast<int>(a / size_x_) - static_cast<int>(b / size_x_));
+  const int diagonal = std::min(dx, dy);
+  const int straight = std::max(dx, dy) - diagonal;
+  return (straight * STRAIGHT_STEP + diagonal * DIAGONAL_STEP) * min_traversal_;
+}
+
+DStarLite::Key DStarLite::calculate_key(uint32_t u) const
+{
+  const double k2 = std::min(g_[u], rhs_[u]);
+  return Key{k2 + heuristic(start_, u) + km_, k2};
+}
+
+double DStarLite::lookahead(uint32_t u) const
+{
+  const int x = u % size_x_;
+  const int y = u / size_x_;
+  double best = INF;
+  for (int i = 0; i < 8; ++i) {
+    const int nx = x + dx_[i];
+    const int ny = y + dy_[i];
+    if (nx < 0 || ny < 0 || nx >= size_x_ || ny >= size_y_) {
+      continue;
+    }
+    const uint32_t s = u + offset_[i];
+    best = std::min(best, edge_cost(s, step_[i]) + g_[s]);
+  }
+  return best;
+}
+
+void DStarLite::insert(uint32_t u, const Key & key)
+{
+  if (!open_[u]) {
+    open_[u] = 1;
+    num_open_++;
+  }
+  heap_.push_back(QueueEntry{key, u, ++stamp_[u]});
+  std::push_heap(heap_.begin(), heap_.end(), QueueCompare());
+}
+
+void DStarLite::remove(uint32_t u)
+{
+  // the heap entry goes stale and is dropped once it reaches the top
+  open_[u] = 0;
+  ++stamp_[u];
+  num_open_--;
+}
+
+bool DStarLite::top(QueueEntry & entry)
+{
+  // drop stale entries, rebuild the heap if they make up most of it
+  if (heap_.size() > 4 * num_open_ + 1024) {
+    auto end = std::remove_if(
+      heap_.begin(), heap_.end(), [this](const QueueEntry & e) {
+        return !open_[e.cell] || e.stamp != stamp_[e.cell];
+      });
+    heap_.erase(end, heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), QueueCompare());
+  }
+  while (!heap_.empty()) {
+    const QueueEntry & front = heap_.front();
+    if (open_[front.cell] && front.stamp == stamp_[front.cell]) {
+      entry = front;
+      return true;
+    }
+    pop();
+  }
+  return false;
+}
+
+void DStarLite::pop()
+{
+  std::pop_heap(heap_.begin(), heap_.end(), QueueCompare());
+  heap_.pop_back();
+}
+
+void DStarLite::update_vertex(uint32_t u)
+{
+  if (g_[u] != rhs_[u]) {
+    insert(u, calculate_key(u));
+  } else if (open_[u]) {
+    remove(u);
+  }
+}
+
+void DStarLite::apply_costs(const unsigned char * costs)
+{
+  // cells with a changed edge: the neighbors of every cell whose traversal cost changed
+  std::vector<uint32_t> affected;
+  const size_t num_cells = cost_.size();
+  for (uint32_t v = 0; v < num_cells; ++v) {
+    if (costs[v] == cost_[v]) {
+      continue;
+    }
+    const bool changed = traversal_[costs[v]] != traversal_[cost_[v]];
+    cost_[v] = costs[v];
+    if (!changed) {
+      continue;
+    }
+    const int x = v % size_x_;
+    const int y = v / size_x_;
+    for (int i = 0; i < 8; ++i) {
+      const int nx = x - dx_[i];
+      const int ny = y - dy_[i];
+      if (nx >= 0 && ny >= 0 && nx < size_x_ && ny < size_y_) {
+        affected.push_back(v - offset_[i]);
+      }
+    }
+  }
+  std::sort(affected.begin(), affected.end());
+  affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+  for (const uint32_t u : affected) {
+    if (u != goal_) {
+      rhs_[u] = lookahead(u);
+      update_vertex(u);
+    }
+  }
+}
+
+void DStarLite::compute_shortest_path()
+{
+  QueueEntry entry;
+  while (top(entry)) {
+    if (!less(entry.key, calculate_key(start_)) && rhs_[start_] <= g_[start_]) {
+      break;
+    }
+    const uint32_t u = entry.cell;
+    const Key key_new = calculate_key(u);
+    num_expanded_++;
+
+    if (less(entry.key, key_new)) {
+      pop();
+      insert(u, key_new);
+      continue;
+    }
+
+    const int x = u % size_x_;
+    const int y = u / size_x_;
+
+    if (g_[u] > rhs_[u]) {
+      g_[u] = rhs_[u];
+      pop();
+      remove(u);
+      for (int i = 0; i < 8; ++i) {
+        const int nx = x - dx_[i];
+        const int ny = y - dy_[i];
+        if (nx < 0 || ny < 0 || nx >= size_x_ || ny >= size_y_) {
+          continue;
+        }
+        const uint32_t s = u - offset_[i];
+        if (s != goal_) {
+          const double rhs = edge_cost(u, step_[i]) + g_[u];
+          if (rhs < rhs_[s]) {
+            rhs_[s] = rhs;
+            update_vertex(s);
+          }
+        }
+      }
+    } else {
+      const double g_old = g_[u];
+      g_[u] = INF;
+      for (int i = 0; i < 8; ++i) {
+        const int nx = x - dx_[i];
+        const int ny = y - dy_[i];
+        if (nx < 0 || ny < 0 || nx >= size_x_ || ny >= size_y_) {
+          continue;
+        }
+        const uint32_t s = u - offset_[i];
+        if (s != goal_ && rhs_[s] == edge_cost(u, step_[i]) + g_old) {
+          rhs_[s] = lookahead(s);
+        }
+        update_vertex(s);
+      }
+      // rhs(u) only depends on the successors of u and is still valid
+      update_vertex(u);
+    }
+  }
+}
+
+bool DStarLite::extract_path(std::vector<GridCell> & path) const
+{
+  path.clear();
+  if (rhs_[start_] == INF) {
+    return false;
+  }
+  uint32_t u = start_;
+  path.push_back(GridCell{static_cast<int>(u % size_x_), static_cast<int>(u / size_x_)});
+
+  // every step strictly decreases g, the limit only guards against bad input
+  const size_t max_steps = cost_.size();
+  while (u != goal_) {
+    if (path.size() > max_steps) {
+      path.clear();
+      return false;
+    }
+    const int x = u % size_x_;
+    const int y = u / size_x_;
+    double best = INF;
+    uint32_t next = u;
+    for (int i = 0; i < 8; ++i) {
+      const int nx = x + dx_[i];
+      const int ny = y + dy_[i];
+      if (nx < 0 || ny < 0 || nx >= size_x_ || ny >= size_y_) {
+        continue;
+      }
+      const uint32_t s = u + offset_[i];
+      const double cost = edge_cost(s, step_[i]) + g_[s];
+      if (cost < best) {
+        best = cost;
+        next = s;
+      }
+    }
+    if (best == INF) {
+      path.clear();
+      return false;
+    }
+    u = next;
+    path.push_back(GridCell{static_cast<int>(u % size_x_), static_cast<int>(u / size_x_)});
+  }
+  return true;
+}
+
+bool DStarLite::plan(
+  const unsigned char * costs, int start_x, int start_y, std::vector<GridCell> & path)
+{
+  const size_t num_cells = static_cast<size_t>(size_x_) * size_y_;
+  start_ = start_y * size_x_ + start_x;
+  num_expanded_ = 0;
+  num_changed_ = 0;
+
+  if (initialized_) {
+    for (size_t i = 0; i < num_cells; ++i) {
+      num_changed_ += costs[i] != cost_[i];
+    }
+    if (num_changed_ > num_cells / FRESH_SEARCH_DIVISOR) {
+      initialized_ = false;
+    }
+  }
+
+  fresh_ = !initialized_;
+  if (fresh_) {
+    cost_.assign(costs, costs + num_cells);
+    g_.assign(num_cells, INF);
+    rhs_.assign(num_cells, INF);
+    stamp_.assign(num_cells, 0);
+    open_.assign(num_cells, 0);
+    heap_.clear();
+    num_open_ = 0;
+    km_ = 0;
+    last_ = start_;
+    rhs_[goal_] = 0;
+    insert(goal_, calculate_key(goal_));
+    initialized_ = true;
+  } else {
+    // keys stay comparable while the start moves
+    km_ += heuristic(last_, start_);
+    last_ = start_;
+    if (num_changed_) {
+      apply_costs(costs);
+    }
+  }
+
+  compute_shortest_path();
+  return extract_path(path);
+}
+
+}  // namespace nav2_straightline_planner
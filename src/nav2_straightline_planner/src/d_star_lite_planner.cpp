@@ -0,0 +1,203 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2020 Shivang Patel
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <memory>
+#include <vector>
+#include "nav2_util/node_utils.hpp"
+
+#include "nav2_straightline_planner/d_star_lite_planner.hpp"
+
+namespace nav2_straightline_planner
+{
+
+void DStarLitePlanner::configure(
+  const rclcpp_lifecycle::LifecycleNode::WeakPtr & parent,
+  std::string name, std::shared_ptr<tf2_ros::Buffer>/*tf*/,
+  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros)
+{
+  node_ = parent.lock();
+  name_ = name;
+  costmap_ = costmap_ros->getCostmap();
+  global_frame_ = costmap_ros->getGlobalFrameID();
+
+  double neutral_cost, cost_factor;
+  bool allow_unknown;
+
+  // Parameter initialization, same cost model as the NavfnPlanner
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".neutral_cost", rclcpp::ParameterValue(50.0));
+  node_->get_parameter(name_ + ".neutral_cost", neutral_cost);
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".cost_factor", rclcpp::ParameterValue(0.8));
+  node_->get_parameter(name_ + ".cost_factor", cost_factor);
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".allow_unknown", rclcpp::ParameterValue(true));
+  node_->get_parameter(name_ + ".allow_unknown", allow_unknown);
+
+  // free cells must have a cost, a neutral_cost rounding to 0 makes every free path equally good
+  if (std::round(neutral_cost) < 1 || cost_factor < 0) {
+    RCLCPP_WARN(
+      node_->get_logger(), "Invalid neutral_cost %f / cost_factor %f for plugin %s, using 50 / 0.8",
+      neutral_cost, cost_factor, name_.c_str());
+    neutral_cost = 50.0;
+    cost_factor = 0.8;
+  }
+  search_.set_cost_model(neutral_cost, cost_factor, allow_unknown);
+}
+
+void DStarLitePlanner::cleanup()
+{
+  RCLCPP_INFO(
+    node_->get_logger(), "CleaningUp plugin %s of type DStarLitePlanner",
+    name_.c_str());
+}
+
+void DStarLitePlanner::activate()
+{
+  RCLCPP_INFO(
+    node_->get_logger(), "Activating plugin %s of type DStarLitePlanner",
+    name_.c_str());
+}
+
+void DStarLitePlanner::deactivate()
+{
+  RCLCPP_INFO(
+    node_->get_logger(), "Deactivating plugin %s of type DStarLitePlanner",
+    name_.c_str());
+}
+
+nav_msgs::msg::Path DStarLitePlanner::createPlan(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal)
+{
+  nav_msgs::msg::Path global_path;
+  global_path.header.stamp = node_->now();
+  global_path.header.frame_id = global_frame_;
+
+  // Checking if the goal and start state is in the global frame
+  if (start.header.frame_id != global_frame_ || goal.header.frame_id != global_frame_) {
+    RCLCPP_ERROR(
+      node_->get_logger(), "Planner will only accept start and goal position from %s frame",
+      global_frame_.c_str());
+    return global_path;
+  }
+
+  unsigned int start_x, start_y, goal_x, goal_y;
+  int size_x, size_y;
+  double origin_x, origin_y, resolution;
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+
+    if (!costmap_->worldToMap(start.pose.position.x, start.pose.position.y, start_x, start_y)) {
+      RCLCPP_ERROR(node_->get_logger(), "Start position is outside of the costmap");
+      return global_path;
+    }
+    if (!costmap_->worldToMap(goal.pose.position.x, goal.pose.position.y, goal_x, goal_y)) {
+      RCLCPP_ERROR(node_->get_logger(), "Goal position is outside of the costmap");
+      return global_path;
+    }
+    size_x = costmap_->getSizeInCellsX();
+    size_y = costmap_->getSizeInCellsY();
+    origin_x = costmap_->getOriginX();
+    origin_y = costmap_->getOriginY();
+    resolution = costmap_->getResolution();
+
+    const unsigned char * charmap = costmap_->getCharMap();
+    costs_.assign(charmap, charmap + static_cast<size_t>(size_x) * size_y);
+  }
+
+  // a new goal cell or a moved / resized costmap invalidates the search
+  if (!search_.has_goal(size_x, size_y, goal_x, goal_y) ||
+    origin_x != search_origin_x_ || origin_y != search_origin_y_ ||
+    resolution != search_resolution_)
+  {
+    search_.reset(size_x, size_y, goal_x, goal_y);
+    search_origin_x_ = origin_x;
+    search_origin_y_ = origin_y;
+    search_resolution_ = resolution;
+  }
+
+  std::vector<GridCell> cells;
+  const bool found = search_.plan(costs_.data(), start_x, start_y, cells);
+
+  RCLCPP_DEBUG(
+    node_->get_logger(), "%s search: %zu changed cells, %zu expansions",
+    search_.was_fresh() ? "Fresh" : "Incremental",
+    search_.num_changed_cells(), search_.num_expanded());
+
+  if (!found) {
+    RCLCPP_WARN(
+      node_->get_logger(), "Failed to create plan from (%f, %f) to (%f, %f)",
+      start.pose.position.x, start.pose.position.y,
+      goal.pose.position.x, goal.pose.position.y);
+    return global_path;
+  }
+
+  global_path.poses.reserve(cells.size());
+  double yaw = 0;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    geometry_msgs::msg::PoseStamped pose;
+    pose.header = global_path.header;
+    if (i == 0) {
+      pose.pose.position = start.pose.position;
+    } else {
+      pose.pose.position.x = origin_x + (cells[i].x + 0.5) * resolution;
+      pose.pose.position.y = origin_y + (cells[i].y + 0.5) * resolution;
+    }
+    // face the next cell
+    if (i + 1 < cells.size()) {
+      yaw = std::atan2(cells[i + 1].y - cells[i].y, cells[i + 1].x - cells[i].x);
+    }
+    pose.pose.orientation.z = std::sin(0.5 * yaw);
+    pose.pose.orientation.w = std::cos(0.5 * yaw);
+    global_path.poses.push_back(pose);
+  }
+
+  // make sure we end up exactly at the requested goal
+  if (global_path.poses.size() < 2) {
+    global_path.poses.push_back(global_path.poses.back());
+  }
+  global_path.poses.back().pose = goal.pose;
+
+  return global_path;
+}
+
+}  // namespace nav2_straightline_planner
+
+#include "pluginlib/class_list_macros.hpp"
+PLUGINLIB_EXPORT_CLASS(nav2_straightline_planner::DStarLitePlanner, nav2_core::GlobalPlanner)
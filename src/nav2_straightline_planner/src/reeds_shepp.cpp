@@ -0,0 +1,535 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2020 Shivang Patel
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "nav2_straightline_planner/reeds_shepp.hpp"
+
+namespace nav2_straightline_planner
+{
+
+namespace
+{
+
+const double ZERO = 10 * std::numeric_limits<double>::epsilon();
+const SegmentType L = SegmentType::LEFT;
+const SegmentType S = SegmentType::STRAIGHT;
+const SegmentType R = SegmentType::RIGHT;
+
+// wraps to [-pi, pi)
+double mod2pi(double x)
+{
+  double v = std::fmod(x, 2 * M_PI);
+  if (v < -M_PI) {
+    v += 2 * M_PI;
+  } else if (v >= M_PI) {
+    v -= 2 * M_PI;
+  }
+  return v;
+}
+
+// wraps to [0, 2 * pi)
+double mod2pi_pos(double x)
+{
+  double v = std::fmod(x, 2 * M_PI);
+  if (v < 0) {
+    v += 2 * M_PI;
+  }
+  return v;
+}
+
+void polar(double x, double y, double & r, double & theta)
+{
+  r = std::sqrt(x * x + y * y);
+  theta = std::atan2(y, x);
+}
+
+void tau_omega(
+  double u, double v, double xi, double eta, double phi,
+  double & tau, double & omega)
+{
+  const double delta = mod2pi(u - v);
+  const double A = std::sin(u) - std::sin(delta);
+  const double B = std::cos(u) - std::cos(delta) - 1.;
+  const double t1 = std::atan2(eta * A - xi * B, xi * A + eta * B);
+  const double t2 = 2. * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3.;
+  tau = (t2 < 0) ? mod2pi(t1 + M_PI) : mod2pi(t1);
+  omega = mod2pi(tau - u + v - phi);
+}
+
+// Keeps the candidate if it is shorter than the current best.
+void update_best(
+  AnalyticCurve & best, double & best_length,
+  const std::vector<SegmentType> & types, const std::vector<double> & lengths)
+{
+  double length = 0;
+  for (double l : lengths) {
+    length += std::fabs(l);
+  }
+  if (length >= best_length) {
+    return;
+  }
+  best_length = length;
+  best.segments.clear();
+  for (size_t i = 0; i < types.size(); ++i) {
+    best.segments.push_back({types[i], lengths[i]});
+  }
+}
+
+// Reeds-Shepp formula 8.1
+bool LpSpLp(double x, double y, double phi, double & t, double & u, double & v)
+{
+  polar(x - std::sin(phi), y - 1. + std::cos(phi), u, t);
+  if (t >= -ZERO) {
+    v = mod2pi(phi - t);
+    return v >= -ZERO;
+  }
+  return false;
+}
+
+// Reeds-Shepp formula 8.2
+bool LpSpRp(double x, double y, double phi, double & t, double & u, double & v)
+{
+  double t1, u1;
+  polar(x + std::sin(phi), y - 1. - std::cos(phi), u1, t1);
+  u1 = u1 * u1;
+  if (u1 >= 4.) {
+    u = std::sqrt(u1 - 4.);
+    const double theta = std::atan2(2., u);
+    t = mod2pi(t1 + theta);
+    v = mod2pi(t - phi);
+    return t >= -ZERO && v >= -ZERO;
+  }
+  return false;
+}
+
+// Reeds-Shepp formula 8.3 / 8.4 (corrected)
+bool LpRmL(double x, double y, double phi, double & t, double & u, double & v)
+{
+  const double xi = x - std::sin(phi);
+  const double eta = y - 1. + std::cos(phi);
+  double u1, theta;
+  polar(xi, eta, u1, theta);
+  if (u1 <= 4.) {
+    u = -2. * std::asin(.25 * u1);
+    t = mod2pi(theta + .5 * u + M_PI);
+    v = mod2pi(phi - t + u);
+    return t >= -ZERO && u <= ZERO;
+  }
+  return false;
+}
+
+// Reeds-Shepp formula 8.7
+bool LpRupLumRm(double x, double y, double phi, double & t, double & u, double & v)
+{
+  const double xi = x + std::sin(phi);
+  const double eta = y - 1. - std::cos(phi);
+  const double rho = .25 * (2. + std::sqrt(xi * xi + eta * eta));
+  if (rho <= 1.) {
+    u = std::acos(rho);
+    tau_omega(u, -u, xi, eta, phi, t, v);
+    return t >= -ZERO && v <= ZERO;
+  }
+  return false;
+}
+
+// Reeds-Shepp formula 8.8
+bool LpRumLumRp(double x, double y, double phi, double & t, double & u, double & v)
+{
+  const double xi = x + std::sin(phi);
+  const double eta = y - 1. - std::cos(phi);
+  const double rho = (20. - xi * xi - eta * eta) / 16.;
+  if (rho >= 0 && rho <= 1) {
+    u = -std::acos(rho);
+    if (u >= -.5 * M_PI) {
+      tau_omega(u, u, xi, eta, phi, t, v);
+      return t >= -ZERO && v >= -ZERO;
+    }
+  }
+  return false;
+}
+
+// Reeds-Shepp formula 8.9
+bool LpRmSmLm(double x, double y, double phi, double & t, double & u, double & v)
+{
+  const double xi = x - std::sin(phi);
+  const double eta = y - 1. + std::cos(phi);
+  double rho, theta;
+  polar(xi, eta, rho, theta);
+  if (rho >= 2.) {
+    const double r = std::sqrt(rho * rho - 4.);
+    u = 2. - r;
+    t = mod2pi(theta + std::atan2(r, -2.));
+    v = mod2pi(phi - .5 * M_PI - t);
+    return t >= -ZERO && u <= ZERO && v <= ZERO;
+  }
+  return false;
+}
+
+// Reeds-Shepp formula 8.10
+bool LpRmSmRm(double x, double y, double phi, double & t, double & u, double & v)
+{
+  const double xi = x + std::sin(phi);
+  const double eta = y - 1. - std::cos(phi);
+  double rho, theta;
+  polar(-eta, xi, rho, theta);
+  if (rho >= 2.) {
+    t = theta;
+    u = 2. - rho;
+    v = mod2pi(t + .5 * M_PI - phi);
+    return t >= -ZERO && u <= ZERO && v <= ZERO;
+  }
+  return false;
+}
+
+// Reeds-Shepp formula 8.11 (corrected)
+bool LpRmSLmRp(double x, double y, double phi, double & t, double & u, double & v)
+{
+  const double xi = x + std::sin(phi);
+  const double eta = y - 1. - std::cos(phi);
+  double rho, theta;
+  polar(xi, eta, rho, theta);
+  if (rho >= 2.) {
+    u = 4. - std::sqrt(rho * rho - 4.);
+    if (u <= ZERO) {
+      t = mod2pi(std::atan2((4. - u) * xi - 2. * eta, -2. * xi + (u - 4.) * eta));
+      v = mod2pi(t - phi);
+      return t >= -ZERO && v >= -ZERO;
+    }
+  }
+  return false;
+}
+
+/*
+ * Each family below is evaluated on the goal pose as well as on its
+ * time-flipped (-x, y, -phi), reflected (x, -y, -phi) and combined
+ * (-x, -y, phi) variants, which covers all 48 Reeds-Shepp words.
+ */
+void CSC(double x, double y, double phi, AnalyticCurve & best, double & Lmin)
+{
+  double t, u, v;
+  if (LpSpLp(x, y, phi, t, u, v)) {update_best(best, Lmin, {L, S, L}, {t, u, v});}
+  if (LpSpLp(-x, y, -phi, t, u, v)) {update_best(best, Lmin, {L, S, L}, {-t, -u, -v});}
+  if (LpSpLp(x, -y, -phi, t, u, v)) {update_best(best, Lmin, {R, S, R}, {t, u, v});}
+  if (LpSpLp(-x, -y, phi, t, u, v)) {update_best(best, Lmin, {R, S, R}, {-t, -u, -v});}
+  if (LpSpRp(x, y, phi, t, u, v)) {update_best(best, Lmin, {L, S, R}, {t, u, v});}
+  if (LpSpRp(-x, y, -phi, t, u, v)) {update_best(best, Lmin, {L, S, R}, {-t, -u, -v});}
+  if (LpSpRp(x, -y, -phi, t, u, v)) {update_best(best, Lmin, {R, S, L}, {t, u, v});}
+  if (LpSpRp(-x, -y, phi, t, u, v)) {update_best(best, Lmin, {R, S, L}, {-t, -u, -v});}
+}
+
+void CCC(double x, double y, double phi, AnalyticCurve & best, double & Lmin)
+{
+  double t, u, v;
+  if (LpRmL(x, y, phi, t, u, v)) {update_best(best, Lmin, {L, R, L}, {t, u, v});}
+  if (LpRmL(-x, y, -phi, t, u, v)) {update_best(best, Lmin, {L, R, L}, {-t, -u, -v});}
+  if (LpRmL(x, -y, -phi, t, u, v)) {update_best(best, Lmin, {R, L, R}, {t, u, v});}
+  if (LpRmL(-x, -y, phi, t, u, v)) {update_best(best, Lmin, {R, L, R}, {-t, -u, -v});}
+
+  // backwards
+  const double xb = x * std::cos(phi) + y * std::sin(phi);
+  const double yb = x * std::sin(phi) - y * std::cos(phi);
+  if (LpRmL(xb, yb, phi, t, u, v)) {update_best(best, Lmin, {L, R, L}, {v, u, t});}
+  if (LpRmL(-xb, yb, -phi, t, u, v)) {update_best(best, Lmin, {L, R, L}, {-v, -u, -t});}
+  if (LpRmL(xb, -yb, -phi, t, u, v)) {update_best(best, Lmin, {R, L, R}, {v, u, t});}
+  if (LpRmL(-xb, -yb, phi, t, u, v)) {update_best(best, Lmin, {R, L, R}, {-v, -u, -t});}
+}
+
+void CCCC(double x, double y, double phi, AnalyticCurve & best, double & Lmin)
+{
+  double t, u, v;
+  if (LpRupLumRm(x, y, phi, t, u, v)) {update_best(best, Lmin, {L, R, L, R}, {t, u, -u, v});}
+  if (LpRupLumRm(-x, y, -phi, t, u, v)) {update_best(best, Lmin, {L, R, L, R}, {-t, -u, u, -v});}
+  if (LpRupLumRm(x, -y, -phi, t, u, v)) {update_best(best, Lmin, {R, L, R, L}, {t, u, -u, v});}
+  if (LpRupLumRm(-x, -y, phi, t, u, v)) {update_best(best, Lmin, {R, L, R, L}, {-t, -u, u, -v});}
+
+  if (LpRumLumRp(x, y, phi, t, u, v)) {update_best(best, Lmin, {L, R, L, R}, {t, u, u, v});}
+  if (LpRumLumRp(-x, y, -phi, t, u, v)) {update_best(best, Lmin, {L, R, L, R}, {-t, -u, -u, -v});}
+  if (LpRumLumRp(x, -y, -phi, t, u, v)) {update_best(best, Lmin, {R, L, R, L}, {t, u, u, v});}
+  if (LpRumLumRp(-x, -y, phi, t, u, v)) {update_best(best, Lmin, {R, L, R, L}, {-t, -u, -u, -v});}
+}
+
+void CCSC(double x, double y, double phi, AnalyticCurve & best, double & Lmin)
+{
+  const double a = .5 * M_PI;
+  double t, u, v;
+  if (LpRmSmLm(x, y, phi, t, u, v)) {update_best(best, Lmin, {L, R, S, L}, {t, -a, u, v});}
+  if (LpRmSmLm(-x, y, -phi, t, u, v)) {update_best(best, Lmin, {L, R, S, L}, {-t, a, -u, -v});}
+  if (LpRmSmLm(x, -y, -phi, t, u, v)) {update_best(best, Lmin, {R, L, S, R}, {t, -a, u, v});}
+  if (LpRmSmLm(-x, -y, phi, t, u, v)) {update_best(best, Lmin, {R, L, S, R}, {-t, a, -u, -v});}
+
+  if (LpRmSmRm(x, y, phi, t, u, v)) {update_best(best, Lmin, {L, R, S, R}, {t, -a, u, v});}
+  if (LpRmSmRm(-x, y, -phi, t, u, v)) {update_best(best, Lmin, {L, R, S, R}, {-t, a, -u, -v});}
+  if (LpRmSmRm(x, -y, -phi, t, u, v)) {update_best(best, Lmin, {R, L, S, L}, {t, -a, u, v});}
+  if (LpRmSmRm(-x, -y, phi, t, u, v)) {update_best(best, Lmin, {R, L, S, L}, {-t, a, -u, -v});}
+
+  // backwards
+  const double xb = x * std::cos(phi) + y * std::sin(phi);
+  const double yb = x * std::sin(phi) - y * std::cos(phi);
+  if (LpRmSmLm(xb, yb, phi, t, u, v)) {update_best(best, Lmin, {L, S, R, L}, {v, u, -a, t});}
+  if (LpRmSmLm(-xb, yb, -phi, t, u, v)) {update_best(best, Lmin, {L, S, R, L}, {-v, -u, a, -t});}
+  if (LpRmSmLm(xb, -yb, -phi, t, u, v)) {update_best(best, Lmin, {R, S, L, R}, {v, u, -a, t});}
+  if (LpRmSmLm(-xb, -yb, phi, t, u, v)) {update_best(best, Lmin, {R, S, L, R}, {-v, -u, a, -t});}
+
+  if (LpRmSmRm(xb, yb, phi, t, u, v)) {update_best(best, Lmin, {R, S, R, L}, {v, u, -a, t});}
+  if (LpRmSmRm(-xb, yb, -phi, t, u, v)) {update_best(best, Lmin, {R, S, R, L}, {-v, -u, a, -t});}
+  if (LpRmSmRm(xb, -yb, -phi, t, u, v)) {update_best(best, Lmin, {L, S, L, R}, {v, u, -a, t});}
+  if (LpRmSmRm(-xb, -yb, phi, t, u, v)) {update_best(best, Lmin, {L, S, L, R}, {-v, -u, a, -t});}
+}
+
+void CCSCC(double x, double y, double phi, AnalyticCurve & best, double & Lmin)
+{
+  const double a = .5 * M_PI;
+  double t, u, v;
+  if (LpRmSLmRp(x, y, phi, t, u, v)) {
+    update_best(best, Lmin, {L, R, S, L, R}, {t, -a, u, -a, v});
+  }
+  if (LpRmSLmRp(-x, y, -phi, t, u, v)) {
+    update_best(best, Lmin, {L, R, S, L, R}, {-t, a, -u, a, -v});
+  }
+  if (LpRmSLmRp(x, -y, -phi, t, u, v)) {
+    update_best(best, Lmin, {R, L, S, R, L}, {t, -a, u, -a, v});
+  }
+  if (LpRmSLmRp(-x, -y, phi, t, u, v)) {
+    update_best(best, Lmin, {R, L, S, R, L}, {-t, a, -u, a, -v});
+  }
+}
+
+// Transforms the goal into the start frame, scaled to a unit turning radius.
+void normalize(
+  const CurvePose & start, const CurvePose & goal, double turning_radius,
+  double & x, double & y, double & phi)
+{
+  const double dx = goal.x - start.x;
+  const double dy = goal.y - start.y;
+  const double c = std::cos(start.yaw);
+  const double s = std::sin(start.yaw);
+  x = (c * dx + s * dy) / turning_radius;
+  y = (-s * dx + c * dy) / turning_radius;
+  phi = mod2pi(goal.yaw - start.yaw);
+}
+
+// Moves along a single segment by v (in units of the turning radius).
+CurvePose advance(const CurvePose & pose, SegmentType type, double v, double turning_radius)
+{
+  CurvePose next = pose;
+  switch (type) {
+    case SegmentType::LEFT:
+      next.x += turning_radius * (std::sin(pose.yaw + v) - std::sin(pose.yaw));
+      next.y += turning_radius * (-std::cos(pose.yaw + v) + std::cos(pose.yaw));
+      next.yaw += v;
+      break;
+    case SegmentType::RIGHT:
+      next.x += turning_radius * (-std::sin(pose.yaw - v) + std::sin(pose.yaw));
+      next.y += turning_radius * (std::cos(pose.yaw - v) - std::cos(pose.yaw));
+      next.yaw -= v;
+      break;
+    case SegmentType::STRAIGHT:
+      next.x += turning_radius * v * std::cos(pose.yaw);
+      next.y += turning_radius * v * std::sin(pose.yaw);
+      break;
+  }
+  return next;
+}
+
+}  // namespace
+
+double AnalyticCurve::length() const
+{
+  double sum = 0;
+  for (const auto & segment : segments) {
+    sum += std::fabs(segment.length);
+  }
+  return sum;
+}
+
+bool AnalyticCurve::has_reversing() const
+{
+  for (const auto & segment : segments) {
+    if (segment.length < 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool solve_dubins(
+  const CurvePose & start, const CurvePose & goal,
+  double turning_radius, AnalyticCurve & curve)
+{
+  curve.segments.clear();
+  if (turning_radius <= 0) {
+    return false;
+  }
+
+  const double dx = goal.x - start.x;
+  const double dy = goal.y - start.y;
+  const double d = std::hypot(dx, dy) / turning_radius;
+  const double theta = mod2pi_pos(std::atan2(dy, dx));
+  const double a = mod2pi_pos(start.yaw - theta);
+  const double b = mod2pi_pos(goal.yaw - theta);
+
+  const double sa = std::sin(a);
+  const double sb = std::sin(b);
+  const double ca = std::cos(a);
+  const double cb = std::cos(b);
+  const double cab = std::cos(a - b);
+
+  double Lmin = std::numeric_limits<double>::infinity();
+
+  // LSL
+  {
+    const double p_sq = 2 + d * d - 2 * cab + 2 * d * (sa - sb);
+    if (p_sq >= 0) {
+      const double tmp = std::atan2(cb - ca, d + sa - sb);
+      update_best(
+        curve, Lmin, {L, S, L},
+        {mod2pi_pos(tmp - a), std::sqrt(p_sq), mod2pi_pos(b - tmp)});
+    }
+  }
+  // RSR
+  {
+    const double p_sq = 2 + d * d - 2 * cab + 2 * d * (sb - sa);
+    if (p_sq >= 0) {
+      const double tmp = std::atan2(ca - cb, d - sa + sb);
+      update_best(
+        curve, Lmin, {R, S, R},
+        {mod2pi_pos(a - tmp), std::sqrt(p_sq), mod2pi_pos(tmp - b)});
+    }
+  }
+  // LSR
+  {
+    const double p_sq = -2 + d * d + 2 * cab + 2 * d * (sa + sb);
+    if (p_sq >= 0) {
+      const double p = std::sqrt(p_sq);
+      const double tmp = std::atan2(-ca - cb, d + sa + sb) - std::atan2(-2., p);
+      update_best(curve, Lmin, {L, S, R}, {mod2pi_pos(tmp - a), p, mod2pi_pos(tmp - b)});
+    }
+  }
+  // RSL
+  {
+    const double p_sq = -2 + d * d + 2 * cab - 2 * d * (sa + sb);
+    if (p_sq >= 0) {
+      const double p = std::sqrt(p_sq);
+      const double tmp = std::atan2(ca + cb, d - sa - sb) - std::atan2(2., p);
+      update_best(curve, Lmin, {R, S, L}, {mod2pi_pos(a - tmp), p, mod2pi_pos(b - tmp)});
+    }
+  }
+  // RLR
+  {
+    const double tmp = (6. - d * d + 2 * cab + 2 * d * (sa - sb)) / 8.;
+    if (std::fabs(tmp) <= 1) {
+      const double p = mod2pi_pos(2 * M_PI - std::acos(tmp));
+      const double t = mod2pi_pos(a - std::atan2(ca - cb, d - sa + sb) + p / 2.);
+      update_best(curve, Lmin, {R, L, R}, {t, p, mod2pi_pos(a - b - t + p)});
+    }
+  }
+  // LRL
+  {
+    const double tmp = (6. - d * d + 2 * cab + 2 * d * (sb - sa)) / 8.;
+    if (std::fabs(tmp) <= 1) {
+      const double p = mod2pi_pos(2 * M_PI - std::acos(tmp));
+      const double t = mod2pi_pos(-a - std::atan2(ca - cb, d + sa - sb) + p / 2.);
+      update_best(curve, Lmin, {L, R, L}, {t, p, mod2pi_pos(b - a - t + p)});
+    }
+  }
+  return !curve.segments.empty();
+}
+
+bool solve_reeds_shepp(
+  const CurvePose & start, const CurvePose & goal,
+  double turning_radius, AnalyticCurve & curve)
+{
+  curve.segments.clear();
+  if (turning_radius <= 0) {
+    return false;
+  }
+
+  double x, y, phi;
+  normalize(start, goal, turning_radius, x, y, phi);
+
+  double Lmin = std::numeric_limits<double>::infinity();
+  CSC(x, y, phi, curve, Lmin);
+  CCC(x, y, phi, curve, Lmin);
+  CCCC(x, y, phi, curve, Lmin);
+  CCSC(x, y, phi, curve, Lmin);
+  CCSCC(x, y, phi, curve, Lmin);
+  return !curve.segments.empty();
+}
+
+std::vector<CurvePose> sample_curve(
+  const CurvePose & start, const AnalyticCurve & curve,
+  double turning_radius, double resolution)
+{
+  std::vector<CurvePose> poses;
+  const double total = curve.length() * turning_radius;
+  const int num_steps = std::max(int(std::ceil(total / std::max(resolution, 1e-3))), 1);
+  poses.reserve(num_steps + 1);
+
+  // pose at the beginning of the current segment
+  CurvePose seg_start = start;
+  size_t seg_index = 0;
+  double seg_offset = 0;    // arc length [m] covered by previous segments
+
+  for (int i = 0; i <= num_steps; ++i)
+  {
+    const double s = total * i / num_steps;
+
+    while (seg_index + 1 < curve.segments.size() &&
+      s > seg_offset + std::fabs(curve.segments[seg_index].length) * turning_radius)
+    {
+      const auto & seg = curve.segments[seg_index];
+      seg_start = advance(seg_start, seg.type, seg.length, turning_radius);
+      seg_offset += std::fabs(seg.length) * turning_radius;
+      seg_index++;
+    }
+
+    CurvePose pose = seg_start;
+    if (!curve.segments.empty()) {
+      const auto & seg = curve.segments[seg_index];
+      const double dist = std::min(s - seg_offset, std::fabs(seg.length) * turning_radius);
+      pose = advance(seg_start, seg.type, std::copysign(dist / turning_radius, seg.length),
+          turning_radius);
+    }
+    pose.yaw = mod2pi(pose.yaw);
+    poses.push_back(pose);
+  }
+  return poses;
+}
+
+}  // namespace nav2_straightline_planner
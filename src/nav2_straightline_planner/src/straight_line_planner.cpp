@@ -41,7 +41,9 @@
 #include <cmath>
 #include <string>
 #include <memory>
+#include <vector>
 #include "nav2_util/node_utils.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
 
 #include "nav2_straightline_planner/straight_line_planner.hpp"
 
@@ -91,6 +93,28 @@ void StraightLine::configure(
   nav2_util::declare_parameter_if_not_declared(
     node_, name_ + ".interpolation_resolution", rclcpp::ParameterValue(0.01));
   node_->get_parameter(name_ + ".interpolation_resolution", interpolation_resolution_);
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".mode", rclcpp::ParameterValue("straight"));
+  node_->get_parameter(name_ + ".mode", mode_);
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".turning_radius", rclcpp::ParameterValue(0.5));
+  node_->get_parameter(name_ + ".turning_radius", turning_radius_);
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".allow_unknown", rclcpp::ParameterValue(true));
+  node_->get_parameter(name_ + ".allow_unknown", allow_unknown_);
+
+  if (mode_ != "straight" && mode_ != "dubins" && mode_ != "reeds_shepp") {
+    RCLCPP_WARN(
+      node_->get_logger(), "Unknown mode '%s' for plugin %s, using 'straight'",
+      mode_.c_str(), name_.c_str());
+    mode_ = "straight";
+  }
+  if (mode_ != "straight" && turning_radius_ <= 0) {
+    RCLCPP_WARN(
+      node_->get_logger(), "Invalid turning_radius %f for plugin %s, using 'straight'",
+      turning_radius_, name_.c_str());
+    mode_ = "straight";
+  }
 }
 
 void StraightLine::cleanup()
@@ -142,6 +166,15 @@ nav_msgs::msg::Path StraightLine::createPlan(
     return global_path;
   }
 
+  if (mode_ != "straight") {
+    global_path = createAnalyticPlan(start, goal);
+    if (!global_path.poses.empty()) {
+      last_goal_ = goal;
+      last_global_path_ = global_path;
+    }
+    return global_path;
+  }
+
   global_path.poses.clear();
   global_path.header.stamp = node_->now();
   global_path.header.frame_id = global_frame_;
@@ -225,6 +258,79 @@ nav_msgs::msg::Path StraightLine::createPlan(
   return global_path;
 }
 
+static double getYaw(const geometry_msgs::msg::Quaternion & q)
+{
+  return std::atan2(2 * (q.w * q.z + q.x * q.y), 1 - 2 * (q.y * q.y + q.z * q.z));
+}
+
+nav_msgs::msg::Path StraightLine::createAnalyticPlan(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal)
+{
+  nav_msgs::msg::Path global_path;
+  global_path.header.stamp = node_->now();
+  global_path.header.frame_id = global_frame_;
+
+  const CurvePose start_pose{
+    start.pose.position.x, start.pose.position.y, getYaw(start.pose.orientation)};
+  const CurvePose goal_pose{
+    goal.pose.position.x, goal.pose.position.y, getYaw(goal.pose.orientation)};
+
+  AnalyticCurve curve;
+  const bool found = mode_ == "dubins" ?
+    solve_dubins(start_pose, goal_pose, turning_radius_, curve) :
+    solve_reeds_shepp(start_pose, goal_pose, turning_radius_, curve);
+  if (!found) {
+    RCLCPP_ERROR(node_->get_logger(), "Failed to compute %s curve", mode_.c_str());
+    return global_path;
+  }
+
+  const auto poses = sample_curve(start_pose, curve, turning_radius_, interpolation_resolution_);
+
+  if (!isCollisionFree(poses)) {
+    RCLCPP_WARN(
+      node_->get_logger(), "%s curve of length %f m is blocked by obstacles",
+      mode_.c_str(), curve.length() * turning_radius_);
+    return global_path;
+  }
+
+  global_path.poses.reserve(poses.size());
+  for (const auto & sample : poses) {
+    geometry_msgs::msg::PoseStamped pose;
+    pose.header = global_path.header;
+    pose.pose.position.x = sample.x;
+    pose.pose.position.y = sample.y;
+    pose.pose.position.z = 0.0;
+    pose.pose.orientation.z = std::sin(0.5 * sample.yaw);
+    pose.pose.orientation.w = std::cos(0.5 * sample.yaw);
+    global_path.poses.push_back(pose);
+  }
+
+  // make sure we end up exactly at the requested goal
+  global_path.poses.back().pose = goal.pose;
+
+  return global_path;
+}
+
+bool StraightLine::isCollisionFree(const std::vector<CurvePose> & poses) const
+{
+  for (const auto & pose : poses) {
+    unsigned int mx, my;
+    if (!costmap_->worldToMap(pose.x, pose.y, mx, my)) {
+      return false;
+    }
+    const unsigned char cost = costmap_->getCost(mx, my);
+    if (cost == nav2_costmap_2d::NO_INFORMATION) {
+      if (!allow_unknown_) {
+        return false;
+      }
+    } else if (cost >= nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace nav2_straightline_planner
 
 #include "pluginlib/class_list_macros.hpp"
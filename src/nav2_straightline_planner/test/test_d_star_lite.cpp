@@ -0,0 +1,240 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2020 Shivang Patel
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "nav2_straightline_planner/d_star_lite.hpp"
+
+using nav2_straightline_planner::DStarLite;
+using nav2_straightline_planner::GridCell;
+
+namespace
+{
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// same cost model as DStarLite::set_cost_model()
+struct CostModel
+{
+  double neutral_cost;
+  double cost_factor;
+  bool allow_unknown;
+
+  double traversal(unsigned char cost) const
+  {
+    if (cost == 255 && allow_unknown) {
+      cost = 252;
+    }
+    if (cost >= 253) {
+      return INF;
+    }
+    return std::max(std::round(neutral_cost + cost_factor * cost), 1.);
+  }
+
+  double step(int dx, int dy) const
+  {
+    return (dx != 0 && dy != 0) ? 99. : 70.;
+  }
+};
+
+// cheapest cost from start to goal, plain Dijkstra from scratch
+double dijkstra(
+  const CostModel & model, const std::vector<unsigned char> & costs, int size_x, int size_y,
+  GridCell start, GridCell goal)
+{
+  std::vector<double> dist(costs.size(), INF);
+  typedef std::pair<double, int> entry_t;
+  std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> queue;
+  const int source = start.y * size_x + start.x;
+  const int target = goal.y * size_x + goal.x;
+  dist[source] = 0;
+  queue.push({0, source});
+  while (!queue.empty()) {
+    const auto top = queue.top();
+    queue.pop();
+    const int u = top.second;
+    if (top.first > dist[u]) {
+      continue;
+    }
+    if (u == target) {
+      return top.first;
+    }
+    const int x = u % size_x;
+    const int y = u / size_x;
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        const int nx = x + dx;
+        const int ny = y + dy;
+        if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= size_x || ny >= size_y) {
+          continue;
+        }
+        const int v = ny * size_x + nx;
+        const double d = top.first + model.step(dx, dy) * model.traversal(costs[v]);
+        if (d < dist[v]) {
+          dist[v] = d;
+          queue.push({d, v});
+        }
+      }
+    }
+  }
+  return INF;
+}
+
+// cost of a path, INF if it is not connected
+double pathCost(
+  const CostModel & model, const std::vector<unsigned char> & costs, int size_x,
+  const std::vector<GridCell> & path)
+{
+  double sum = 0;
+  for (size_t i = 1; i < path.size(); ++i) {
+    const int dx = path[i].x - path[i - 1].x;
+    const int dy = path[i].y - path[i - 1].y;
+    if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)) {
+      return INF;
+    }
+    sum += model.step(dx, dy) * model.traversal(costs[path[i].y * size_x + path[i].x]);
+  }
+  return sum;
+}
+
+unsigned char randomCost(std::mt19937 & rng)
+{
+  switch (rng() % 5) {
+    case 0: return 254;
+    case 1: return 255;
+    case 2: return 0;
+    default: return static_cast<unsigned char>(rng() % 253);
+  }
+}
+
+// Random grids, each replanned after random cost changes and start moves.
+// Returns the number of plans which differ from Dijkstra.
+int compareWithDijkstra(const CostModel & model, int num_grids, int num_replans)
+{
+  int num_failed = 0;
+  for (int seed = 0; seed < num_grids; ++seed) {
+    std::mt19937 rng(seed);
+    const int size_x = 3 + rng() % 20;
+    const int size_y = 3 + rng() % 20;
+    std::vector<unsigned char> costs(size_x * size_y);
+    for (auto & cost : costs) {
+      cost = randomCost(rng);
+    }
+    const GridCell goal{static_cast<int>(rng() % size_x), static_cast<int>(rng() % size_y)};
+    GridCell start{static_cast<int>(rng() % size_x), static_cast<int>(rng() % size_y)};
+
+    DStarLite search;
+    search.set_cost_model(model.neutral_cost, model.cost_factor, model.allow_unknown);
+    search.reset(size_x, size_y, goal.x, goal.y);
+
+    for (int i = 0; i < num_replans; ++i) {
+      std::vector<GridCell> path;
+      const bool found = search.plan(costs.data(), start.x, start.y, path);
+      const double expected = dijkstra(model, costs, size_x, size_y, start, goal);
+      const double actual = found ? pathCost(model, costs, size_x, path) : INF;
+      const bool ends_ok = !found ||
+        (path.front().x == start.x && path.front().y == start.y &&
+        path.back().x == goal.x && path.back().y == goal.y);
+      if (!ends_ok || actual != expected) {
+        num_failed++;
+      }
+
+      // a few cost changes, sometimes a new start
+      const int num_changes = rng() % 4;
+      for (int k = 0; k < num_changes; ++k) {
+        costs[rng() % costs.size()] = randomCost(rng);
+      }
+      if (rng() % 2) {
+        start = GridCell{static_cast<int>(rng() % size_x), static_cast<int>(rng() % size_y)};
+      }
+    }
+  }
+  return num_failed;
+}
+
+}  // namespace
+
+TEST(DStarLiteTest, MatchesDijkstra)
+{
+  EXPECT_EQ(0, compareWithDijkstra(CostModel{50.0, 0.8, true}, 400, 30));
+}
+
+TEST(DStarLiteTest, MatchesDijkstraWithoutUnknown)
+{
+  EXPECT_EQ(0, compareWithDijkstra(CostModel{50.0, 0.8, false}, 200, 30));
+}
+
+TEST(DStarLiteTest, MatchesDijkstraWithZeroNeutralCost)
+{
+  // free cells still cost 1, otherwise the path extraction loops between equal g values
+  EXPECT_EQ(0, compareWithDijkstra(CostModel{0.0, 0.8, true}, 400, 30));
+}
+
+TEST(DStarLiteTest, RepairsAfterBlockingThePath)
+{
+  const int size = 10;
+  std::vector<unsigned char> costs(size * size, 0);
+  DStarLite search;
+  search.set_cost_model(50.0, 0.8, false);
+  search.reset(size, size, 9, 5);
+
+  std::vector<GridCell> path;
+  ASSERT_TRUE(search.plan(costs.data(), 0, 5, path));
+  EXPECT_TRUE(search.was_fresh());
+
+  // wall with a gap at the top
+  for (int y = 0; y < size - 1; ++y) {
+    costs[y * size + 5] = 254;
+  }
+  ASSERT_TRUE(search.plan(costs.data(), 0, 5, path));
+  EXPECT_FALSE(search.was_fresh());
+  EXPECT_EQ(size_t(size - 1), search.num_changed_cells());
+  for (const auto & cell : path) {
+    EXPECT_LT(costs[cell.y * size + cell.x], 253);
+  }
+
+  // closed completely
+  costs[(size - 1) * size + 5] = 254;
+  EXPECT_FALSE(search.plan(costs.data(), 0, 5, path));
+}
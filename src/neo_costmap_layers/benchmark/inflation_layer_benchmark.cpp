@@ -0,0 +1,604 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/*
+ * Compares InflationKernel with nav2_costmap_2d::InflationLayer::updateCosts(), reproduced
+ * below without ROS, on a map from the map_server (.yaml + .pgm):
+ *
+ * - global: the map at its own resolution as static layer, with a few moving obstacles marked
+ *   and cleared by an obstacle layer, window = changed area plus inflation radius (as given by
+ *   InflationLayer::updateBounds())
+ * - local: rolling 5 x 5 m window at 0.02 m moving through the map, the obstacles within 2.5 m
+ *   of the robot are marked every update with some dropouts, window = whole costmap
+ * - local static: same without dropouts and with the robot standing still
+ *
+ * Both get the same master grid and window every update, and the whole master grids are
+ * compared afterwards.
+ *
+ * Usage: inflation_layer_benchmark map.yaml [iterations] [inflation_radius] [cost_scaling_factor]
+ */
+
+#include <neo_costmap_layers/InflationKernel.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace neo_costmap_layers;
+
+
+/*
+ * Reference: nav2 InflationLayer (humble), caches and wavefront.
+ */
+namespace reference {
+
+struct CellData {
+	CellData(unsigned int i, unsigned int x, unsigned int y, unsigned int sx, unsigned int sy)
+		:	index_(i), x_(x), y_(y), src_x_(sx), src_y_(sy) {}
+	unsigned int index_;
+	unsigned int x_, y_;
+	unsigned int src_x_, src_y_;
+};
+
+class InflationLayer {
+public:
+	double resolution_ = 0;
+	double inflation_radius_ = 0;
+	double inscribed_radius_ = 0;
+	double cost_scaling_factor_ = 0;
+	bool inflate_unknown_ = false;
+	bool inflate_around_unknown_ = false;
+
+	void computeCaches()
+	{
+		cell_inflation_radius_ = (unsigned int)std::max(0., std::ceil(inflation_radius_ / resolution_));
+		cache_length_ = cell_inflation_radius_ + 2;
+		cached_distances_.resize(cache_length_ * cache_length_);
+		for(unsigned int i = 0; i < cache_length_; ++i) {
+			for(unsigned int j = 0; j < cache_length_; ++j) {
+				cached_distances_[i * cache_length_ + j] = std::hypot(i, j);
+			}
+		}
+		cached_costs_.resize(cache_length_ * cache_length_);
+		for(unsigned int i = 0; i < cache_length_; ++i) {
+			for(unsigned int j = 0; j < cache_length_; ++j) {
+				cached_costs_[i * cache_length_ + j] = computeCost(cached_distances_[i * cache_length_ + j]);
+			}
+		}
+		int max_dist = generateIntegerDistances();
+		inflation_cells_.clear();
+		inflation_cells_.resize(max_dist + 1);
+	}
+
+	void updateCosts(const grid_t& master_grid, int min_i, int min_j, int max_i, int max_j)
+	{
+		if(cell_inflation_radius_ == 0) {
+			return;
+		}
+		unsigned char* master_array = master_grid.data;
+		unsigned int size_x = master_grid.size_x, size_y = master_grid.size_y;
+
+		if(seen_.size() != size_x * size_y) {
+			seen_ = std::vector<bool>(size_x * size_y, false);
+		}
+		std::fill(begin(seen_), end(seen_), false);
+
+		const int base_min_i = min_i;
+		const int base_min_j = min_j;
+		const int base_max_i = max_i;
+		const int base_max_j = max_j;
+		min_i -= static_cast<int>(cell_inflation_radius_);
+		min_j -= static_cast<int>(cell_inflation_radius_);
+		max_i += static_cast<int>(cell_inflation_radius_);
+		max_j += static_cast<int>(cell_inflation_radius_);
+
+		min_i = std::max(0, min_i);
+		min_j = std::max(0, min_j);
+		max_i = std::min(static_cast<int>(size_x), max_i);
+		max_j = std::min(static_cast<int>(size_y), max_j);
+
+		auto& obs_bin = inflation_cells_[0];
+		obs_bin.reserve(200);
+		for(int j = min_j; j < max_j; j++) {
+			for(int i = min_i; i < max_i; i++) {
+				int index = j * size_x + i;
+				unsigned char cost = master_array[index];
+				if(cost == InflationKernel::LETHAL_OBSTACLE || (inflate_around_unknown_ && cost == InflationKernel::NO_INFORMATION)) {
+					obs_bin.emplace_back(index, i, j, i, j);
+				}
+			}
+		}
+
+		for(auto& dist_bin : inflation_cells_) {
+			dist_bin.reserve(200);
+			for(std::size_t i = 0; i < dist_bin.size(); ++i) {
+				const CellData& cell = dist_bin[i];
+				unsigned int index = cell.index_;
+				if(seen_[index]) {
+					continue;
+				}
+				seen_[index] = true;
+
+				unsigned int mx = cell.x_;
+				unsigned int my = cell.y_;
+				unsigned int sx = cell.src_x_;
+				unsigned int sy = cell.src_y_;
+
+				unsigned char cost = costLookup(mx, my, sx, sy);
+				unsigned char old_cost = master_array[index];
+				if(static_cast<int>(mx) >= base_min_i && static_cast<int>(my) >= base_min_j &&
+					static_cast<int>(mx) < base_max_i && static_cast<int>(my) < base_max_j)
+				{
+					if(old_cost == InflationKernel::NO_INFORMATION &&
+						(inflate_unknown_ ? (cost > InflationKernel::FREE_SPACE) : (cost >= InflationKernel::INSCRIBED_INFLATED_OBSTACLE)))
+					{
+						master_array[index] = cost;
+					} else {
+						master_array[index] = std::max(old_cost, cost);
+					}
+				}
+
+				if(mx > 0) {
+					enqueue(index - 1, mx - 1, my, sx, sy);
+				}
+				if(my > 0) {
+					enqueue(index - size_x, mx, my - 1, sx, sy);
+				}
+				if(mx < size_x - 1) {
+					enqueue(index + 1, mx + 1, my, sx, sy);
+				}
+				if(my < size_y - 1) {
+					enqueue(index + size_x, mx, my + 1, sx, sy);
+				}
+			}
+			dist_bin = std::vector<CellData>();
+		}
+	}
+
+private:
+	unsigned char computeCost(double distance) const
+	{
+		unsigned char cost = 0;
+		if(distance == 0) {
+			cost = InflationKernel::LETHAL_OBSTACLE;
+		} else if(distance * resolution_ <= inscribed_radius_) {
+			cost = InflationKernel::INSCRIBED_INFLATED_OBSTACLE;
+		} else {
+			double factor = std::exp(-1.0 * cost_scaling_factor_ * (distance * resolution_ - inscribed_radius_));
+			cost = static_cast<unsigned char>((InflationKernel::INSCRIBED_INFLATED_OBSTACLE - 1) * factor);
+		}
+		return cost;
+	}
+
+	int generateIntegerDistances()
+	{
+		const int r = cell_inflation_radius_ + 2;
+		const int size = r * 2 + 1;
+
+		std::vector<std::pair<int, int>> points;
+		for(int y = -r; y <= r; y++) {
+			for(int x = -r; x <= r; x++) {
+				if(x * x + y * y <= r * r) {
+					points.emplace_back(x, y);
+				}
+			}
+		}
+		std::sort(points.begin(), points.end(),
+			[](const std::pair<int, int>& a, const std::pair<int, int>& b) -> bool {
+				return a.first * a.first + a.second * a.second < b.first * b.first + b.second * b.second;
+			});
+
+		std::vector<std::vector<int>> distance_matrix(size, std::vector<int>(size, 0));
+		std::pair<int, int> last = {0, 0};
+		int level = 0;
+		for(auto const& p : points) {
+			if(p.first * p.first + p.second * p.second != last.first * last.first + last.second * last.second) {
+				level++;
+			}
+			distance_matrix[p.first + r][p.second + r] = level;
+			last = p;
+		}
+		distance_matrix_ = distance_matrix;
+		return level;
+	}
+
+	inline double distanceLookup(unsigned int mx, unsigned int my, unsigned int src_x, unsigned int src_y)
+	{
+		unsigned int dx = (mx > src_x) ? mx - src_x : src_x - mx;
+		unsigned int dy = (my > src_y) ? my - src_y : src_y - my;
+		return cached_distances_[dx * cache_length_ + dy];
+	}
+
+	inline unsigned char costLookup(unsigned int mx, unsigned int my, unsigned int src_x, unsigned int src_y)
+	{
+		unsigned int dx = (mx > src_x) ? mx - src_x : src_x - mx;
+		unsigned int dy = (my > src_y) ? my - src_y : src_y - my;
+		return cached_costs_[dx * cache_length_ + dy];
+	}
+
+	inline void enqueue(unsigned int index, unsigned int mx, unsigned int my, unsigned int src_x, unsigned int src_y)
+	{
+		if(!seen_[index]) {
+			double distance = distanceLookup(mx, my, src_x, src_y);
+			if(distance > cell_inflation_radius_) {
+				return;
+			}
+			const unsigned int r = cell_inflation_radius_ + 2;
+			inflation_cells_[distance_matrix_[mx - src_x + r][my - src_y + r]].emplace_back(index, mx, my, src_x, src_y);
+		}
+	}
+
+	unsigned int cell_inflation_radius_ = 0;
+	unsigned int cache_length_ = 0;
+	std::vector<double> cached_distances_;
+	std::vector<unsigned char> cached_costs_;
+	std::vector<std::vector<int>> distance_matrix_;
+	std::vector<std::vector<CellData>> inflation_cells_;
+	std::vector<bool> seen_;
+};
+
+} // reference
+
+
+struct map_t {
+	std::vector<unsigned char> cells;		// as the static layer: 254 occupied, 0 free, 255 unknown
+	unsigned int size_x = 0;
+	unsigned int size_y = 0;
+	double resolution = 0.05;
+
+	unsigned char at_world(double x, double y) const {
+		const int mx = x / resolution, my = y / resolution;
+		if(mx < 0 || my < 0 || mx >= int(size_x) || my >= int(size_y)) {
+			return 0;
+		}
+		return cells[my * size_x + mx];
+	}
+};
+
+static bool load_map(const std::string& yaml_path, map_t& map)
+{
+	std::ifstream yaml(yaml_path);
+	if(!yaml) {
+		return false;
+	}
+	std::string image, line;
+	double occupied_thresh = 0.65, free_thresh = 0.196;
+	int negate = 0;
+	while(std::getline(yaml, line)) {
+		std::istringstream ss(line);
+		std::string key;
+		ss >> key;
+		if(key == "image:") {
+			ss >> image;
+		} else if(key == "resolution:") {
+			ss >> map.resolution;
+		} else if(key == "negate:") {
+			ss >> negate;
+		} else if(key == "occupied_thresh:") {
+			ss >> occupied_thresh;
+		} else if(key == "free_thresh:") {
+			ss >> free_thresh;
+		}
+	}
+	if(!image.empty() && image[0] != '/') {
+		const size_t slash = yaml_path.find_last_of('/');
+		if(slash != std::string::npos) {
+			image = yaml_path.substr(0, slash + 1) + image;
+		}
+	}
+
+	std::ifstream pgm(image, std::ios::binary);
+	std::string magic;
+	int max_value = 0;
+	pgm >> magic >> map.size_x >> map.size_y >> max_value;
+	pgm.get();
+	if(!pgm || magic != "P5" || max_value != 255) {
+		return false;
+	}
+	std::vector<unsigned char> pixels(size_t(map.size_x) * map.size_y);
+	pgm.read((char*)pixels.data(), pixels.size());
+
+	// map_server trinary mode, image rows top to bottom
+	map.cells.resize(pixels.size());
+	for(unsigned int y = 0; y < map.size_y; ++y) {
+		for(unsigned int x = 0; x < map.size_x; ++x) {
+			const int value = pixels[(map.size_y - 1 - y) * map.size_x + x];
+			const double occ = negate ? value / 255. : (255 - value) / 255.;
+			unsigned char& cell = map.cells[y * map.size_x + x];
+			cell = occ > occupied_thresh ? 254 : (occ < free_thresh ? 0 : 255);
+		}
+	}
+	return true;
+}
+
+struct result_t {
+	double time_ref = 0;
+	double time_new = 0;
+	size_t num_recomputed = 0;
+	size_t num_diff_cells = 0;
+	size_t num_cells = 0;
+	int num_updates = 0;
+};
+
+static void print_result(const char* name, const grid_t& grid, const result_t& res)
+{
+	printf("%s: %u x %u cells at %.3f m, %d updates\n", name, grid.size_x, grid.size_y, grid.resolution, res.num_updates);
+	printf("  InflationLayer:  %8.3f ms per update\n", 1e3 * res.time_ref / res.num_updates);
+	printf("  InflationKernel: %8.3f ms per update (%.1fx), %.1f %% of the cells recomputed\n",
+			1e3 * res.time_new / res.num_updates, res.time_ref / res.time_new,
+			100. * res.num_recomputed / (double(grid.size_x) * grid.size_y * res.num_updates));
+	printf("  cells different: %zu of %zu\n", res.num_diff_cells, res.num_cells);
+}
+
+static void run_inflation(	reference::InflationLayer& layer, InflationKernel& kernel, grid_t& grid_ref, grid_t& grid_new,
+							int min_i, int min_j, int max_i, int max_j, result_t& res)
+{
+	const auto t0 = std::chrono::steady_clock::now();
+	layer.updateCosts(grid_ref, min_i, min_j, max_i, max_j);
+	const auto t1 = std::chrono::steady_clock::now();
+	kernel.update(grid_new, min_i, min_j, max_i, max_j);
+	const auto t2 = std::chrono::steady_clock::now();
+
+	res.time_ref += std::chrono::duration<double>(t1 - t0).count();
+	res.time_new += std::chrono::duration<double>(t2 - t1).count();
+	res.num_recomputed += kernel.num_recomputed();
+	res.num_updates++;
+
+	const size_t num_cells = size_t(grid_ref.size_x) * grid_ref.size_y;
+	for(size_t i = 0; i < num_cells; ++i) {
+		res.num_diff_cells += grid_ref.data[i] != grid_new.data[i];
+	}
+	res.num_cells += num_cells;
+}
+
+/*
+ * Static map with moving round obstacles, like the global costmap.
+ */
+static result_t run_global(const map_t& map, reference::InflationLayer& layer, InflationKernel& kernel, int iterations)
+{
+	const int radius = layer.inflation_radius_ / map.resolution + 1;
+	std::vector<unsigned char> data_ref = map.cells, data_new = map.cells;
+	grid_t grid_ref, grid_new;
+	grid_ref.size_x = grid_new.size_x = map.size_x;
+	grid_ref.size_y = grid_new.size_y = map.size_y;
+	grid_ref.resolution = grid_new.resolution = map.resolution;
+	grid_ref.data = data_ref.data();
+	grid_new.data = data_new.data();
+
+	layer.resolution_ = map.resolution;
+	layer.computeCaches();
+	kernel.configure(map.resolution, layer.inflation_radius_, layer.inscribed_radius_, layer.cost_scaling_factor_,
+					layer.inflate_unknown_, layer.inflate_around_unknown_);
+
+	result_t res;
+	// first update inflates everything (need_reinflation_)
+	run_inflation(layer, kernel, grid_ref, grid_new, 0, 0, map.size_x, map.size_y, res);
+
+	struct mover_t { double x, y, vx, vy; };
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> uniform(0, 1);
+	std::vector<mover_t> movers(4);
+	for(auto& m : movers) {
+		m.x = uniform(generator) * map.size_x;
+		m.y = uniform(generator) * map.size_y;
+		m.vx = uniform(generator) * 2 - 1;
+		m.vy = uniform(generator) * 2 - 1;
+	}
+	const int mover_radius = 0.25 / map.resolution;
+	int last_min_i = 0, last_min_j = 0, last_max_i = 0, last_max_j = 0;
+
+	for(int iter = 0; iter < iterations; ++iter)
+	{
+		// obstacle layer bounds: old and new position of every mover
+		int min_i = map.size_x, min_j = map.size_y, max_i = 0, max_j = 0;
+		auto touch = [&](const mover_t& m) {
+			min_i = std::min(min_i, int(m.x) - mover_radius);
+			min_j = std::min(min_j, int(m.y) - mover_radius);
+			max_i = std::max(max_i, int(m.x) + mover_radius + 1);
+			max_j = std::max(max_j, int(m.y) + mover_radius + 1);
+		};
+		for(auto& m : movers) {
+			touch(m);
+			if(m.x + m.vx < 0 || m.x + m.vx >= map.size_x) {
+				m.vx = -m.vx;
+			}
+			if(m.y + m.vy < 0 || m.y + m.vy >= map.size_y) {
+				m.vy = -m.vy;
+			}
+			m.x += m.vx;
+			m.y += m.vy;
+			touch(m);
+		}
+
+		// InflationLayer::updateBounds(), in cells
+		const int bounds[4] = {min_i, min_j, max_i, max_j};
+		min_i = std::max(std::min(min_i, last_min_i) - radius, 0);
+		min_j = std::max(std::min(min_j, last_min_j) - radius, 0);
+		max_i = std::min(std::max(max_i, last_max_i) + radius, int(map.size_x));
+		max_j = std::min(std::max(max_j, last_max_j) + radius, int(map.size_y));
+		last_min_i = bounds[0];
+		last_min_j = bounds[1];
+		last_max_i = bounds[2];
+		last_max_j = bounds[3];
+
+		// LayeredCostmap: reset window, static layer, obstacle layer
+		for(auto* data : {&data_ref, &data_new}) {
+			for(int y = min_j; y < max_j; ++y) {
+				for(int x = min_i; x < max_i; ++x) {
+					(*data)[y * map.size_x + x] = map.cells[y * map.size_x + x];
+				}
+			}
+			for(const auto& m : movers) {
+				for(int y = std::max(int(m.y) - mover_radius, min_j); y < std::min(int(m.y) + mover_radius + 1, max_j); ++y) {
+					for(int x = std::max(int(m.x) - mover_radius, min_i); x < std::min(int(m.x) + mover_radius + 1, max_i); ++x) {
+						if(std::hypot(x - int(m.x), y - int(m.y)) <= mover_radius) {
+							(*data)[y * map.size_x + x] = 254;
+						}
+					}
+				}
+			}
+		}
+		run_inflation(layer, kernel, grid_ref, grid_new, min_i, min_j, max_i, max_j, res);
+	}
+	print_result("global", grid_ref, res);
+	return res;
+}
+
+/*
+ * Rolling window moving through the map, like the local costmap.
+ */
+static result_t run_local(	const map_t& map, reference::InflationLayer& layer, InflationKernel& kernel, int iterations,
+							bool moving, double dropout)
+{
+	const double resolution = 0.02;
+	const double size = 5;
+	const double sensor_range = 2.5;
+	const unsigned int num_cells = size / resolution;
+
+	std::vector<unsigned char> data_ref(num_cells * num_cells, 0), data_new(num_cells * num_cells, 0);
+	std::vector<unsigned char> obstacles(num_cells * num_cells, 0);		// obstacle layer
+	grid_t grid_ref, grid_new;
+	grid_ref.size_x = grid_new.size_x = num_cells;
+	grid_ref.size_y = grid_new.size_y = num_cells;
+	grid_ref.resolution = grid_new.resolution = resolution;
+	grid_ref.data = data_ref.data();
+	grid_new.data = data_new.data();
+
+	layer.resolution_ = resolution;
+	layer.computeCaches();
+	kernel.configure(resolution, layer.inflation_radius_, layer.inscribed_radius_, layer.cost_scaling_factor_,
+					layer.inflate_unknown_, layer.inflate_around_unknown_);
+
+	// Costmap2D::updateOrigin()
+	auto update_origin = [num_cells](std::vector<unsigned char>& data, int dx, int dy) {
+		std::vector<unsigned char> shifted(data.size(), 0);
+		for(int y = 0; y < int(num_cells); ++y) {
+			for(int x = 0; x < int(num_cells); ++x) {
+				const int sx = x + dx, sy = y + dy;
+				if(sx >= 0 && sy >= 0 && sx < int(num_cells) && sy < int(num_cells)) {
+					shifted[y * num_cells + x] = data[sy * num_cells + sx];
+				}
+			}
+		}
+		std::copy(shifted.begin(), shifted.end(), data.begin());
+	};
+
+	std::mt19937 generator(2);
+	std::uniform_real_distribution<double> uniform(0, 1);
+	const double map_x = map.size_x * map.resolution, map_y = map.size_y * map.resolution;
+	int cell_x = 0, cell_y = 0;		// origin of the rolling window in cells
+
+	result_t res;
+	for(int iter = 0; iter < iterations; ++iter)
+	{
+		// robot on a circle through the map at 0.3 m/s, 10 Hz
+		const double angle = moving ? 0.03 * iter / (0.3 * std::min(map_x, map_y)) : 0;
+		const double robot_x = map_x / 2 + 0.3 * std::min(map_x, map_y) * std::cos(angle);
+		const double robot_y = map_y / 2 + 0.3 * std::min(map_x, map_y) * std::sin(angle);
+		const int new_cell_x = std::floor((robot_x - size / 2) / resolution);
+		const int new_cell_y = std::floor((robot_y - size / 2) / resolution);
+		const int dx = new_cell_x - cell_x, dy = new_cell_y - cell_y;
+		cell_x = new_cell_x;
+		cell_y = new_cell_y;
+		grid_ref.origin_x = grid_new.origin_x = cell_x * resolution;
+		grid_ref.origin_y = grid_new.origin_y = cell_y * resolution;
+		if(iter > 0 && (dx || dy)) {
+			update_origin(data_ref, dx, dy);
+			update_origin(data_new, dx, dy);
+			update_origin(obstacles, dx, dy);
+		}
+
+		// obstacle layer: obstacles within sensor range, some of them missing
+		for(unsigned int y = 0; y < num_cells; ++y) {
+			for(unsigned int x = 0; x < num_cells; ++x) {
+				const double wx = (cell_x + x + 0.5) * resolution, wy = (cell_y + y + 0.5) * resolution;
+				if(std::hypot(wx - robot_x, wy - robot_y) < sensor_range) {
+					const bool occupied = map.at_world(wx, wy) == 254 && uniform(generator) >= dropout;
+					obstacles[y * num_cells + x] = occupied ? 254 : 0;
+				}
+			}
+		}
+
+		// LayeredCostmap: the scan covers the whole window, reset, then obstacle layer with max
+		for(size_t i = 0; i < data_ref.size(); ++i) {
+			data_ref[i] = data_new[i] = obstacles[i];
+		}
+		run_inflation(layer, kernel, grid_ref, grid_new, 0, 0, num_cells, num_cells, res);
+	}
+	print_result(moving ? "local" : "local static", grid_ref, res);
+	return res;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2) {
+		printf("Usage: inflation_layer_benchmark map.yaml [iterations] [inflation_radius] [cost_scaling_factor]\n");
+		return 1;
+	}
+	const int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+	map_t map;
+	if(!load_map(argv[1], map)) {
+		printf("Failed to load map %s\n", argv[1]);
+		return 1;
+	}
+
+	// navigation.yaml of neo_nav2_bringup, inscribed radius of the MPO-700 footprint
+	reference::InflationLayer layer;
+	layer.inflation_radius_ = argc > 3 ? std::atof(argv[3]) : 1.0;
+	layer.cost_scaling_factor_ = argc > 4 ? std::atof(argv[4]) : 4.0;
+	layer.inscribed_radius_ = 0.4;
+
+	size_t num_diff_cells = 0;
+	{
+		InflationKernel kernel;
+		layer.inflate_around_unknown_ = false;
+		num_diff_cells += run_global(map, layer, kernel, iterations).num_diff_cells;
+	}
+	{
+		InflationKernel kernel;
+		num_diff_cells += run_local(map, layer, kernel, iterations, true, 0.1).num_diff_cells;
+	}
+	{
+		InflationKernel kernel;
+		num_diff_cells += run_local(map, layer, kernel, iterations, false, 0).num_diff_cells;
+	}
+	return num_diff_cells > 0 ? 2 : 0;
+}
@@ -0,0 +1,457 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/*
+ * Compares ScanRaytracer with the path a LaserScan takes through nav2_costmap_2d::ObstacleLayer:
+ * projection into a point cloud (laser_geometry), transform of every point into the global
+ * frame (tf2_sensor_msgs), height filtering (ObservationBuffer), then raytraceFreespace() and
+ * marking. The reference below reproduces that code without ROS, message passing and TF buffer
+ * lookups are not included, so the saving shown is a lower bound.
+ *
+ * Usage: scan_layer_benchmark [iterations] [resolution] [size] [num_beams]
+ */
+
+#include <neo_costmap_layers/ScanRaytracer.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace neo_costmap_layers;
+
+
+struct scan_t {
+	std::vector<float> ranges;
+	float angle_min = 0;
+	float angle_increment = 0;
+	float range_min = 0.05;
+	float range_max = 30;
+	sensor_pose_t pose;
+};
+
+/*
+ * Reference: nav2 ObstacleLayer pipeline on point clouds.
+ */
+namespace reference {
+
+// same layout as the point cloud of laser_geometry (x, y, z, intensity, index)
+struct point_t {
+	float x, y, z, intensity;
+	int index;
+};
+
+struct observation_t {
+	std::vector<point_t> cloud;
+	double origin_x, origin_y, origin_z;
+};
+
+static observation_t to_observation(const scan_t& scan)
+{
+	// LaserProjection::projectLaser_()
+	std::vector<point_t> cloud;
+	cloud.reserve(scan.ranges.size());
+	for(size_t i = 0; i < scan.ranges.size(); ++i) {
+		const float r = scan.ranges[i];
+		if(r < scan.range_max && r >= scan.range_min) {
+			const double angle = scan.angle_min + double(i) * scan.angle_increment;
+			cloud.push_back(point_t{float(r * std::cos(angle)), float(r * std::sin(angle)), 0.f, 0.f, int(i)});
+		}
+	}
+
+	// LaserProjection::transformLaserScanToPointCloud_() into the scan frame, as done by
+	// ObstacleLayer::laserScanCallback(): one transform per point, interpolated between the
+	// start and the end of the scan (identity here, the robot does not move)
+	const double q_start[4] = {0, 0, 0, 1};
+	const double q_end[4] = {0, 0, 0, 1};
+	const size_t num_beams = scan.ranges.size();
+
+	for(auto& p : cloud)
+	{
+		const double ratio = num_beams > 1 ? double(p.index) / (num_beams - 1) : 0;
+
+		// tf2::Quaternion::slerp()
+		double dot = 0;
+		for(int k = 0; k < 4; ++k) {
+			dot += q_start[k] * q_end[k];
+		}
+		const double theta = std::acos(std::min(std::abs(dot), 1.0));
+		double q[4];
+		if(theta > 1e-9) {
+			const double d = 1 / std::sin(theta);
+			const double s0 = std::sin((1 - ratio) * theta) * d;
+			const double s1 = std::sin(ratio * theta) * d;
+			for(int k = 0; k < 4; ++k) {
+				q[k] = s0 * q_start[k] + s1 * (dot < 0 ? -q_end[k] : q_end[k]);
+			}
+		} else {
+			for(int k = 0; k < 4; ++k) {
+				q[k] = q_start[k];
+			}
+		}
+		// tf2::Matrix3x3::setRotation()
+		const double s = 2 / (q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		const double xs = q[0] * s, ys = q[1] * s, zs = q[2] * s;
+		const double wz = q[3] * zs, xx = q[0] * xs, yy = q[1] * ys, zz = q[2] * zs, xy = q[0] * ys;
+		const double m00 = 1 - (yy + zz), m01 = xy - wz, m10 = xy + wz, m11 = 1 - (xx + zz);
+
+		const double x = p.x, y = p.y;
+		p.x = m00 * x + m01 * y;
+		p.y = m10 * x + m11 * y;
+	}
+
+	// tf2::doTransform() of the cloud into the global frame, in float
+	float R[3][3], t[3];
+	for(int j = 0; j < 3; ++j) {
+		for(int i = 0; i < 3; ++i) {
+			R[j][i] = scan.pose.R[j][i];
+		}
+		t[j] = scan.pose.t[j];
+	}
+	std::vector<point_t> transformed(cloud.size());
+	for(size_t i = 0; i < cloud.size(); ++i) {
+		const point_t& p = cloud[i];
+		transformed[i] = point_t{
+			R[0][0] * p.x + R[0][1] * p.y + R[0][2] * p.z + t[0],
+			R[1][0] * p.x + R[1][1] * p.y + R[1][2] * p.z + t[1],
+			R[2][0] * p.x + R[2][1] * p.y + R[2][2] * p.z + t[2],
+			p.intensity, p.index};
+	}
+
+	// ObservationBuffer::bufferCloud(), copies the points within the height limits
+	observation_t obs;
+	obs.origin_x = scan.pose.t[0];
+	obs.origin_y = scan.pose.t[1];
+	obs.origin_z = scan.pose.t[2];
+	obs.cloud.reserve(transformed.size());
+	for(const auto& p : transformed) {
+		if(p.z <= 2.0 && p.z >= 0.0) {
+			obs.cloud.push_back(p);
+		}
+	}
+	return obs;
+}
+
+static inline int sign(int x) {
+	return x > 0 ? 1.0 : -1.0;
+}
+
+static void bresenham2D(unsigned char* costmap, unsigned int abs_da, unsigned int abs_db, int error_b,
+						int offset_a, int offset_b, unsigned int offset, unsigned int max_length)
+{
+	unsigned int end = std::min(max_length, abs_da);
+	for(unsigned int i = 0; i < end; ++i) {
+		costmap[offset] = 0;
+		offset += offset_a;
+		error_b += abs_db;
+		if((unsigned int)error_b >= abs_da) {
+			offset += offset_b;
+			error_b -= abs_da;
+		}
+	}
+	costmap[offset] = 0;
+}
+
+static void raytraceLine(	const grid_t& grid, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1,
+							unsigned int max_length, unsigned int min_length)
+{
+	int dx_full = x1 - x0;
+	int dy_full = y1 - y0;
+	double dist = std::hypot(dx_full, dy_full);
+	if(dist < min_length) {
+		return;
+	}
+	unsigned int min_x0, min_y0;
+	if(dist > 0.0) {
+		min_x0 = (unsigned int)(x0 + dx_full / dist * min_length);
+		min_y0 = (unsigned int)(y0 + dy_full / dist * min_length);
+	} else {
+		min_x0 = x0;
+		min_y0 = y0;
+	}
+	unsigned int offset = min_y0 * grid.size_x + min_x0;
+	int dx = x1 - min_x0;
+	int dy = y1 - min_y0;
+	unsigned int abs_dx = std::abs(dx);
+	unsigned int abs_dy = std::abs(dy);
+	int offset_dx = sign(dx);
+	int offset_dy = sign(dy) * grid.size_x;
+	double scale = (dist == 0.0) ? 1.0 : std::min(1.0, max_length / dist);
+	if(abs_dx >= abs_dy) {
+		int error_y = abs_dx / 2;
+		bresenham2D(grid.data, abs_dx, abs_dy, error_y, offset_dx, offset_dy, offset, (unsigned int)(scale * abs_dx));
+		return;
+	}
+	int error_x = abs_dy / 2;
+	bresenham2D(grid.data, abs_dy, abs_dx, error_x, offset_dy, offset_dx, offset, (unsigned int)(scale * abs_dy));
+}
+
+// ObstacleLayer::raytraceFreespace()
+static void raytraceFreespace(	grid_t& grid, const observation_t& obs, double raytrace_min_range,
+								double raytrace_max_range, bounds_t& bounds)
+{
+	double ox = obs.origin_x;
+	double oy = obs.origin_y;
+	unsigned int x0, y0;
+	if(!grid.world_to_map(ox, oy, x0, y0)) {
+		return;
+	}
+	double origin_x = grid.origin_x, origin_y = grid.origin_y;
+	double map_end_x = origin_x + grid.size_x * grid.resolution;
+	double map_end_y = origin_y + grid.size_y * grid.resolution;
+
+	bounds.touch(ox, oy);
+
+	for(const auto& p : obs.cloud)
+	{
+		double wx = p.x;
+		double wy = p.y;
+		double a = wx - ox;
+		double b = wy - oy;
+		if(wx < origin_x) {
+			double t = (origin_x - ox) / a;
+			wx = origin_x;
+			wy = oy + b * t;
+		}
+		if(wy < origin_y) {
+			double t = (origin_y - oy) / b;
+			wx = ox + a * t;
+			wy = origin_y;
+		}
+		if(wx > map_end_x) {
+			double t = (map_end_x - ox) / a;
+			wx = map_end_x - .001;
+			wy = oy + b * t;
+		}
+		if(wy > map_end_y) {
+			double t = (map_end_y - oy) / b;
+			wx = ox + a * t;
+			wy = map_end_y - .001;
+		}
+		unsigned int x1, y1;
+		if(!grid.world_to_map(wx, wy, x1, y1)) {
+			continue;
+		}
+		unsigned int cell_raytrace_max_range = grid.cell_distance(raytrace_max_range);
+		unsigned int cell_raytrace_min_range = grid.cell_distance(raytrace_min_range);
+		raytraceLine(grid, x0, y0, x1, y1, cell_raytrace_max_range, cell_raytrace_min_range);
+
+		// ObstacleLayer::updateRaytraceBounds()
+		double dx = wx - ox, dy = wy - oy;
+		double full_distance = std::hypot(dx, dy);
+		if(full_distance < raytrace_min_range) {
+			continue;
+		}
+		double scale = std::min(1.0, raytrace_max_range / full_distance);
+		bounds.touch(ox + dx * scale, oy + dy * scale);
+	}
+}
+
+// marking part of ObstacleLayer::updateBounds()
+static void mark(	grid_t& grid, const observation_t& obs, double obstacle_min_range, double obstacle_max_range,
+					double max_obstacle_height, bounds_t& bounds)
+{
+	double sq_obstacle_max_range = obstacle_max_range * obstacle_max_range;
+	double sq_obstacle_min_range = obstacle_min_range * obstacle_min_range;
+	for(const auto& p : obs.cloud)
+	{
+		double px = p.x, py = p.y, pz = p.z;
+		if(pz > max_obstacle_height) {
+			continue;
+		}
+		double sq_dist = (px - obs.origin_x) * (px - obs.origin_x) + (py - obs.origin_y) * (py - obs.origin_y)
+				+ (pz - obs.origin_z) * (pz - obs.origin_z);
+		if(sq_dist >= sq_obstacle_max_range || sq_dist < sq_obstacle_min_range) {
+			continue;
+		}
+		unsigned int mx, my;
+		if(!grid.world_to_map(px, py, mx, my)) {
+			continue;
+		}
+		grid.data[my * grid.size_x + mx] = 254;
+		bounds.touch(px, py);
+	}
+}
+
+} // reference
+
+
+/*
+ * Simulated scan of a rectangular room with a few round obstacles and some dropouts.
+ */
+static void simulate_scan(scan_t& scan, size_t num_beams, std::mt19937& generator)
+{
+	struct circle_t { double x, y, r; };
+	static const circle_t obstacles[] = {{1.2, 0.4, 0.15}, {-0.8, 1.1, 0.3}, {0.3, -1.6, 0.1}, {-1.9, -0.7, 0.25}};
+	const double room_x = 3.1, room_y = 2.3;
+
+	std::normal_distribution<float> noise(0, 0.01);
+	std::uniform_real_distribution<float> uniform(0, 1);
+
+	const double yaw = std::atan2(scan.pose.R[1][0], scan.pose.R[0][0]);
+	scan.angle_min = -2.35619449f;
+	scan.angle_increment = 4.71238898f / (num_beams - 1);
+	scan.ranges.resize(num_beams);
+
+	for(size_t i = 0; i < num_beams; ++i)
+	{
+		const double angle = yaw + scan.angle_min + i * scan.angle_increment;
+		const double dx = std::cos(angle), dy = std::sin(angle);
+		const double ox = scan.pose.t[0], oy = scan.pose.t[1];
+
+		double range = std::min(dx != 0 ? ((dx > 0 ? room_x : -room_x) - ox) / dx : 1e9,
+								dy != 0 ? ((dy > 0 ? room_y : -room_y) - oy) / dy : 1e9);
+		for(const auto& c : obstacles) {
+			const double px = c.x - ox, py = c.y - oy;
+			const double proj = px * dx + py * dy;
+			const double d2 = px * px + py * py - proj * proj;
+			if(proj > 0 && d2 < c.r * c.r) {
+				range = std::min(range, proj - std::sqrt(c.r * c.r - d2));
+			}
+		}
+		const float u = uniform(generator);
+		if(u < 0.02f) {
+			scan.ranges[i] = std::numeric_limits<float>::infinity();
+		} else if(u < 0.03f) {
+			scan.ranges[i] = std::numeric_limits<float>::quiet_NaN();
+		} else {
+			scan.ranges[i] = range + noise(generator);
+		}
+	}
+}
+
+static sensor_pose_t make_pose(double x, double y, double z, double yaw)
+{
+	sensor_pose_t pose;
+	pose.R[0][0] = std::cos(yaw);
+	pose.R[0][1] = -std::sin(yaw);
+	pose.R[1][0] = std::sin(yaw);
+	pose.R[1][1] = std::cos(yaw);
+	pose.t[0] = x;
+	pose.t[1] = y;
+	pose.t[2] = z;
+	return pose;
+}
+
+int main(int argc, char** argv)
+{
+	const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000;
+	const double resolution = argc > 2 ? std::atof(argv[2]) : 0.02;
+	const double size = argc > 3 ? std::atof(argv[3]) : 5.0;
+	const size_t num_beams = argc > 4 ? std::atoi(argv[4]) : 1081;
+
+	const double obstacle_max_range = 2.5;
+	const double raytrace_max_range = 3.0;
+	const double max_obstacle_height = 2.0;
+
+	std::mt19937 generator(1);
+
+	// two scanners at opposite corners of the robot, like on an MPO-700
+	std::vector<scan_t> scans(2);
+	scans[0].pose = make_pose(0.45, 0.35, 0.2, M_PI / 4);
+	scans[1].pose = make_pose(-0.45, -0.35, 0.2, -3 * M_PI / 4);
+
+	grid_t grid_ref, grid_new;
+	grid_ref.size_x = grid_new.size_x = size / resolution;
+	grid_ref.size_y = grid_new.size_y = size / resolution;
+	grid_ref.resolution = grid_new.resolution = resolution;
+	grid_ref.origin_x = grid_new.origin_x = -size / 2;
+	grid_ref.origin_y = grid_new.origin_y = -size / 2;
+	const size_t num_cells = size_t(grid_ref.size_x) * grid_ref.size_y;
+	std::vector<unsigned char> data_ref(num_cells), data_new(num_cells);
+	grid_ref.data = data_ref.data();
+	grid_new.data = data_new.data();
+
+	std::vector<ScanRaytracer> raytracers(scans.size());
+	std::vector<reference::observation_t> observations(scans.size());
+
+	double time_ref = 0, time_new = 0;
+	size_t num_diff_cells = 0, num_diff_bounds = 0;
+
+	for(int iter = 0; iter < iterations; ++iter)
+	{
+		for(auto& scan : scans) {
+			simulate_scan(scan, num_beams, generator);
+		}
+		std::fill(data_ref.begin(), data_ref.end(), 255);
+		std::fill(data_new.begin(), data_new.end(), 255);
+		bounds_t bounds_ref, bounds_new;
+
+		const auto t0 = std::chrono::steady_clock::now();
+		for(size_t k = 0; k < scans.size(); ++k) {
+			observations[k] = reference::to_observation(scans[k]);
+		}
+		for(size_t k = 0; k < scans.size(); ++k) {
+			reference::raytraceFreespace(grid_ref, observations[k], 0, raytrace_max_range, bounds_ref);
+		}
+		for(size_t k = 0; k < scans.size(); ++k) {
+			reference::mark(grid_ref, observations[k], 0, obstacle_max_range, max_obstacle_height, bounds_ref);
+		}
+
+		const auto t1 = std::chrono::steady_clock::now();
+		for(size_t k = 0; k < scans.size(); ++k) {
+			const auto& scan = scans[k];
+			raytracers[k].set_scan(scan.ranges, scan.angle_min, scan.angle_increment, scan.range_min, scan.range_max,
+									scan.pose, false, 0, 2);
+		}
+		for(size_t k = 0; k < scans.size(); ++k) {
+			raytracers[k].clear(grid_new, 0, raytrace_max_range, bounds_new);
+		}
+		for(size_t k = 0; k < scans.size(); ++k) {
+			raytracers[k].mark(grid_new, 0, obstacle_max_range, max_obstacle_height, bounds_new);
+		}
+		const auto t2 = std::chrono::steady_clock::now();
+
+		time_ref += std::chrono::duration<double>(t1 - t0).count();
+		time_new += std::chrono::duration<double>(t2 - t1).count();
+
+		for(size_t i = 0; i < num_cells; ++i) {
+			num_diff_cells += data_ref[i] != data_new[i];
+		}
+		const double eps = 1e-5;
+		num_diff_bounds += std::abs(bounds_ref.min_x - bounds_new.min_x) > eps || std::abs(bounds_ref.min_y - bounds_new.min_y) > eps
+						|| std::abs(bounds_ref.max_x - bounds_new.max_x) > eps || std::abs(bounds_ref.max_y - bounds_new.max_y) > eps;
+	}
+
+	printf("grid %u x %u cells at %.3f m, %zu scans of %zu beams, %d iterations\n",
+			grid_ref.size_x, grid_ref.size_y, resolution, scans.size(), num_beams, iterations);
+	printf("ObstacleLayer pipeline: %8.3f ms per update\n", 1e3 * time_ref / iterations);
+	printf("ScanRaytracer:          %8.3f ms per update (%.1fx)\n", 1e3 * time_new / iterations, time_ref / time_new);
+	printf("cells different: %zu of %zu, bounds different: %zu of %d updates\n",
+			num_diff_cells, num_cells * iterations, num_diff_bounds, iterations);
+	return 0;
+}
@@ -0,0 +1,109 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef INCLUDE_NEO_COSTMAP_LAYERS_INCREMENTALINFLATIONLAYER_H_
+#define INCLUDE_NEO_COSTMAP_LAYERS_INCREMENTALINFLATIONLAYER_H_
+
+#include <neo_costmap_layers/InflationKernel.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <nav2_costmap_2d/layer.hpp>
+#include <nav2_costmap_2d/layered_costmap.hpp>
+
+#include <limits>
+#include <vector>
+
+
+namespace neo_costmap_layers {
+
+/*
+ * Inflation layer, drop-in replacement for nav2_costmap_2d::InflationLayer with the same
+ * parameters (inflation_radius, cost_scaling_factor, inflate_unknown, inflate_around_unknown)
+ * and the same costs, cell by cell.
+ *
+ * Inflated costs are cached by an InflationKernel and only recomputed around cells whose lethal
+ * status changed since the last update, the rest of the window is just combined with the cache.
+ * Parameter changes at runtime are applied like in the InflationLayer, they reinflate the whole map.
+ */
+class IncrementalInflationLayer : public nav2_costmap_2d::Layer {
+public:
+	IncrementalInflationLayer();
+
+	~IncrementalInflationLayer();
+
+	void onInitialize() override;
+
+	void updateBounds(	double robot_x, double robot_y, double robot_yaw,
+						double* min_x, double* min_y, double* max_x, double* max_y) override;
+
+	void updateCosts(	nav2_costmap_2d::Costmap2D& master_grid,
+						int min_i, int min_j, int max_i, int max_j) override;
+
+	void matchSize() override;
+
+	void onFootprintChanged() override;
+
+	void reset() override;
+
+	bool isClearable() override {
+		return false;
+	}
+
+private:
+	void configure();
+
+	rcl_interfaces::msg::SetParametersResult
+	dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters);
+
+	InflationKernel m_kernel;
+	rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr m_dyn_params_handler;
+
+	double m_inflation_radius = 0.55;
+	double m_inscribed_radius = 0;
+	double m_cost_scaling_factor = 10.0;
+	bool m_inflate_unknown = false;
+	bool m_inflate_around_unknown = false;
+
+	bool m_need_reinflation = false;
+	bool m_need_invalidate = false;		// cache missed updates while disabled
+	double m_last_min_x = -std::numeric_limits<float>::max();
+	double m_last_min_y = -std::numeric_limits<float>::max();
+	double m_last_max_x = std::numeric_limits<float>::max();
+	double m_last_max_y = std::numeric_limits<float>::max();
+
+};
+
+} // neo_costmap_layers
+
+#endif /* INCLUDE_NEO_COSTMAP_LAYERS_INCREMENTALINFLATIONLAYER_H_ */
@@ -0,0 +1,546 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef INCLUDE_NEO_COSTMAP_LAYERS_INFLATIONKERNEL_H_
+#define INCLUDE_NEO_COSTMAP_LAYERS_INFLATIONKERNEL_H_
+
+#include <neo_costmap_layers/ScanRaytracer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+
+namespace neo_costmap_layers {
+
+/*
+ * Inflation of a costmap with the same result as nav2_costmap_2d::InflationLayer, but only
+ * recomputed where the set of lethal cells changed.
+ *
+ * The distance-to-cost kernel (cost and distance level per cell offset) is computed once per
+ * parameter set, with the same formulas as InflationLayer::computeCaches(). The inflated cost
+ * of every cell is kept in a cache, together with the lethal status it was computed from.
+ *
+ * The grid is divided into tiles of TILE_SIZE x TILE_SIZE cells. On every update the lethal
+ * status of the window is compared to the cache, and only the tiles within the inflation
+ * radius of a change are recomputed. The recomputation is the wavefront of the InflationLayer
+ * (cells visited by increasing distance level, source propagated to the 4 neighbors), so that
+ * the cells match bit by bit: the wavefront does not always find the nearest obstacle, a plain
+ * distance transform would differ in a few cells. Afterwards the cached costs are combined with
+ * the window like InflationLayer::updateCosts() does.
+ *
+ * Cells which only lie within the inflation radius of a change outside of the window are
+ * marked outdated instead of being recomputed right away, like the InflationLayer they will
+ * only be updated once they are part of a window again.
+ */
+class InflationKernel {
+public:
+	static constexpr unsigned char FREE_SPACE = 0;
+	static constexpr unsigned char INSCRIBED_INFLATED_OBSTACLE = 253;
+	static constexpr unsigned char LETHAL_OBSTACLE = 254;
+	static constexpr unsigned char NO_INFORMATION = 255;
+
+	static constexpr unsigned int TILE_SHIFT = 4;
+	static constexpr unsigned int TILE_SIZE = 1 << TILE_SHIFT;
+
+	/*
+	 * Sets the cost function, same parameters as the InflationLayer. Invalidates the cache if
+	 * anything changed.
+	 */
+	void configure(	double resolution, double inflation_radius, double inscribed_radius,
+					double cost_scaling_factor, bool inflate_unknown, bool inflate_around_unknown)
+	{
+		if(resolution == m_resolution && inflation_radius == m_inflation_radius && inscribed_radius == m_inscribed_radius
+			&& cost_scaling_factor == m_cost_scaling_factor && inflate_unknown == m_inflate_unknown
+			&& inflate_around_unknown == m_inflate_around_unknown)
+		{
+			return;
+		}
+		m_resolution = resolution;
+		m_inflation_radius = inflation_radius;
+		m_inscribed_radius = inscribed_radius;
+		m_cost_scaling_factor = cost_scaling_factor;
+		m_inflate_unknown = inflate_unknown;
+		m_inflate_around_unknown = inflate_around_unknown;
+
+		// Costmap2D::cellDistance()
+		m_cell_inflation_radius = (unsigned int)std::max(0., std::ceil(inflation_radius / resolution));
+		compute_kernel();
+		invalidate();
+	}
+
+	unsigned int cell_inflation_radius() const {
+		return m_cell_inflation_radius;
+	}
+
+	/*
+	 * Forgets all cached costs, the next update() recomputes its whole window.
+	 */
+	void invalidate()
+	{
+		std::fill(m_lethal.begin(), m_lethal.end(), 0);
+		std::fill(m_tile_valid.begin(), m_tile_valid.end(), 0);
+	}
+
+	/*
+	 * Inflates the window [min_i, max_i) x [min_j, max_j) of the grid, with the same result as
+	 * InflationLayer::updateCosts(). When the origin of the grid moved (rolling window), the cache
+	 * is moved along.
+	 */
+	void update(const grid_t& grid, int min_i, int min_j, int max_i, int max_j)
+	{
+		if(grid.size_x != m_size_x || grid.size_y != m_size_y) {
+			resize(grid.size_x, grid.size_y);
+		}
+		else if(grid.origin_x != m_origin_x || grid.origin_y != m_origin_y) {
+			shift(	std::lround((grid.origin_x - m_origin_x) / grid.resolution),
+					std::lround((grid.origin_y - m_origin_y) / grid.resolution));
+		}
+		m_origin_x = grid.origin_x;
+		m_origin_y = grid.origin_y;
+
+		m_num_recomputed = 0;
+		if(m_cell_inflation_radius == 0 || m_size_x == 0 || m_size_y == 0) {
+			return;
+		}
+		min_i = std::max(min_i, 0);
+		min_j = std::max(min_j, 0);
+		max_i = std::min(max_i, int(m_size_x));
+		max_j = std::min(max_j, int(m_size_y));
+		if(min_i >= max_i || min_j >= max_j) {
+			return;
+		}
+
+		// tiles of the window, and tiles which can influence them
+		const int margin = (m_cell_inflation_radius + TILE_SIZE - 1) >> TILE_SHIFT;
+		const int win_tx0 = min_i >> TILE_SHIFT, win_tx1 = ((max_i - 1) >> TILE_SHIFT) + 1;
+		const int win_ty0 = min_j >> TILE_SHIFT, win_ty1 = ((max_j - 1) >> TILE_SHIFT) + 1;
+		const int ext_tx0 = std::max(win_tx0 - margin, 0), ext_tx1 = std::min(win_tx1 + margin, int(m_tiles_x));
+		const int ext_ty0 = std::max(win_ty0 - margin, 0), ext_ty1 = std::min(win_ty1 + margin, int(m_tiles_y));
+
+		update_lethal(grid, ext_tx0, ext_ty0, ext_tx1, ext_ty1);
+
+		// tiles to recompute: within the radius of a change, or not computed yet
+		std::fill(m_tile_recompute.begin(), m_tile_recompute.end(), 0);
+		for(const unsigned int tile : m_changed_tiles)
+		{
+			const int tx = tile % m_tiles_x;
+			const int ty = tile / m_tiles_x;
+			for(int y = std::max(ty - margin, 0); y < std::min(ty + margin + 1, int(m_tiles_y)); ++y) {
+				for(int x = std::max(tx - margin, 0); x < std::min(tx + margin + 1, int(m_tiles_x)); ++x) {
+					if(x >= win_tx0 && x < win_tx1 && y >= win_ty0 && y < win_ty1) {
+						m_tile_recompute[y * m_tiles_x + x] = 1;
+					} else {
+						m_tile_valid[y * m_tiles_x + x] = 0;
+					}
+				}
+			}
+		}
+		for(int y = win_ty0; y < win_ty1; ++y) {
+			for(int x = win_tx0; x < win_tx1; ++x) {
+				if(!m_tile_valid[y * m_tiles_x + x]) {
+					m_tile_recompute[y * m_tiles_x + x] = 1;
+				}
+			}
+		}
+		recompute(margin, win_tx0, win_ty0, win_tx1, win_ty1);
+
+		apply(grid, min_i, min_j, max_i, max_j);
+	}
+
+	/*
+	 * Number of cells recomputed by the last update().
+	 */
+	size_t num_recomputed() const {
+		return m_num_recomputed;
+	}
+
+	/*
+	 * Cached inflation cost of a cell, 0 if not reached by the inflation.
+	 */
+	unsigned char cost(unsigned int mx, unsigned int my) const {
+		return m_cost[my * m_size_x + mx];
+	}
+
+private:
+	struct cell_t {
+		unsigned int index;
+		unsigned int x, y;
+		unsigned int src_x, src_y;
+	};
+
+	void compute_kernel()
+	{
+		// InflationLayer::computeCaches() and generateIntegerDistances()
+		m_cache_length = m_cell_inflation_radius + 2;
+		m_kernel_cost.assign(m_cache_length * m_cache_length, 0);
+		m_kernel_level.assign(m_cache_length * m_cache_length, -1);
+
+		std::vector<unsigned int> sq_dists;
+		for(unsigned int i = 0; i < m_cache_length; ++i) {
+			for(unsigned int j = 0; j < m_cache_length; ++j) {
+				const double distance = std::hypot(i, j);
+				m_kernel_cost[i * m_cache_length + j] = compute_cost(distance);
+				if(distance <= m_cell_inflation_radius) {
+					sq_dists.push_back(i * i + j * j);
+				}
+			}
+		}
+		std::sort(sq_dists.begin(), sq_dists.end());
+		sq_dists.erase(std::unique(sq_dists.begin(), sq_dists.end()), sq_dists.end());
+
+		for(unsigned int i = 0; i < m_cache_length; ++i) {
+			for(unsigned int j = 0; j < m_cache_length; ++j) {
+				if(std::hypot(i, j) <= m_cell_inflation_radius) {
+					m_kernel_level[i * m_cache_length + j] =
+							std::lower_bound(sq_dists.begin(), sq_dists.end(), i * i + j * j) - sq_dists.begin();
+				}
+			}
+		}
+		m_bins.resize(sq_dists.size());
+	}
+
+	unsigned char compute_cost(double distance) const
+	{
+		// InflationLayer::computeCost()
+		unsigned char cost = 0;
+		if(distance == 0) {
+			cost = LETHAL_OBSTACLE;
+		} else if(distance * m_resolution <= m_inscribed_radius) {
+			cost = INSCRIBED_INFLATED_OBSTACLE;
+		} else {
+			const double factor = std::exp(-1.0 * m_cost_scaling_factor * (distance * m_resolution - m_inscribed_radius));
+			cost = (unsigned char)((INSCRIBED_INFLATED_OBSTACLE - 1) * factor);
+		}
+		return cost;
+	}
+
+	void resize(unsigned int size_x, unsigned int size_y)
+	{
+		m_size_x = size_x;
+		m_size_y = size_y;
+		m_tiles_x = (size_x + TILE_SIZE - 1) >> TILE_SHIFT;
+		m_tiles_y = (size_y + TILE_SIZE - 1) >> TILE_SHIFT;
+		m_lethal.assign(size_t(size_x) * size_y, 0);
+		m_cost.assign(size_t(size_x) * size_y, 0);
+		m_seen.assign(size_t(size_x) * size_y, 0);
+		m_generation = 0;
+		m_tile_valid.assign(m_tiles_x * m_tiles_y, 0);
+		m_tile_recompute.assign(m_tiles_x * m_tiles_y, 0);
+		m_tile_seed.assign(m_tiles_x * m_tiles_y, 0);
+		m_tile_changed.assign(m_tiles_x * m_tiles_y, 0);
+	}
+
+	/*
+	 * Moves the cache by (dx, dy) cells, like Costmap2D::updateOrigin() moves the grid.
+	 */
+	void shift(long dx, long dy)
+	{
+		if(dx == 0 && dy == 0) {
+			return;
+		}
+		shift_cells(m_lethal, dx, dy);
+		shift_cells(m_cost, dx, dy);
+
+		// a tile stays valid if all cells it now holds were in valid tiles before
+		std::vector<uint8_t> valid(m_tile_valid.size(), 0);
+		for(unsigned int ty = 0; ty < m_tiles_y; ++ty) {
+			for(unsigned int tx = 0; tx < m_tiles_x; ++tx)
+			{
+				const long x0 = long(tx << TILE_SHIFT) + dx, x1 = std::min(long((tx + 1) << TILE_SHIFT), long(m_size_x)) - 1 + dx;
+				const long y0 = long(ty << TILE_SHIFT) + dy, y1 = std::min(long((ty + 1) << TILE_SHIFT), long(m_size_y)) - 1 + dy;
+				if(x0 < 0 || y0 < 0 || x1 >= long(m_size_x) || y1 >= long(m_size_y)) {
+					continue;
+				}
+				bool all_valid = true;
+				for(long y = y0 >> TILE_SHIFT; y <= (y1 >> TILE_SHIFT); ++y) {
+					for(long x = x0 >> TILE_SHIFT; x <= (x1 >> TILE_SHIFT); ++x) {
+						all_valid = all_valid && m_tile_valid[y * m_tiles_x + x];
+					}
+				}
+				valid[ty * m_tiles_x + tx] = all_valid;
+			}
+		}
+
+		// obstacles which dropped out of the grid are not seen as a change, so the cells within
+		// the inflation radius of the borders where they left are outdated as well
+		const long margin = (m_cell_inflation_radius + TILE_SIZE - 1) >> TILE_SHIFT;
+		for(unsigned int ty = 0; ty < m_tiles_y; ++ty) {
+			for(unsigned int tx = 0; tx < m_tiles_x; ++tx) {
+				if(	(dx > 0 && long(tx) < margin) || (dx < 0 && long(tx) >= long(m_tiles_x) - margin - 1)
+					|| (dy > 0 && long(ty) < margin) || (dy < 0 && long(ty) >= long(m_tiles_y) - margin - 1))
+				{
+					valid[ty * m_tiles_x + tx] = 0;
+				}
+			}
+		}
+		m_tile_valid = valid;
+	}
+
+	void shift_cells(std::vector<uint8_t>& cells, long dx, long dy)
+	{
+		std::vector<uint8_t> shifted(cells.size(), 0);
+		const long x0 = std::max(-dx, 0L), x1 = std::min(long(m_size_x) - dx, long(m_size_x));
+		const long y0 = std::max(-dy, 0L), y1 = std::min(long(m_size_y) - dy, long(m_size_y));
+		for(long y = y0; y < y1 && x0 < x1; ++y) {
+			std::copy(	cells.begin() + (y + dy) * m_size_x + x0 + dx, cells.begin() + (y + dy) * m_size_x + x1 + dx,
+						shifted.begin() + y * m_size_x + x0);
+		}
+		cells.swap(shifted);
+	}
+
+	/*
+	 * Reads the lethal status of the given tiles from the grid and collects the tiles where it changed.
+	 */
+	void update_lethal(const grid_t& grid, int tx0, int ty0, int tx1, int ty1)
+	{
+		m_changed_tiles.clear();
+		const unsigned int x0 = tx0 << TILE_SHIFT, x1 = std::min(unsigned(tx1) << TILE_SHIFT, m_size_x);
+		const unsigned int y0 = ty0 << TILE_SHIFT, y1 = std::min(unsigned(ty1) << TILE_SHIFT, m_size_y);
+		const unsigned char unknown = m_inflate_around_unknown ? NO_INFORMATION : LETHAL_OBSTACLE;
+
+		for(unsigned int y = y0; y < y1; ++y)
+		{
+			const unsigned char* row = grid.data + size_t(y) * m_size_x;
+			uint8_t* lethal = m_lethal.data() + size_t(y) * m_size_x;
+			uint8_t* changed = m_tile_changed.data() + (y >> TILE_SHIFT) * m_tiles_x;
+			for(unsigned int x = x0; x < x1; ++x)
+			{
+				const uint8_t is_lethal = row[x] == LETHAL_OBSTACLE || row[x] == unknown;
+				if(is_lethal != lethal[x]) {
+					lethal[x] = is_lethal;
+					changed[x >> TILE_SHIFT] = 1;
+				}
+			}
+		}
+		for(unsigned int ty = ty0; ty < unsigned(ty1); ++ty) {
+			for(unsigned int tx = tx0; tx < unsigned(tx1); ++tx) {
+				const unsigned int tile = ty * m_tiles_x + tx;
+				if(m_tile_changed[tile]) {
+					m_tile_changed[tile] = 0;
+					m_changed_tiles.push_back(tile);
+				}
+			}
+		}
+	}
+
+	/*
+	 * Runs the InflationLayer wavefront for all tiles marked in m_tile_recompute, seeded with the
+	 * lethal cells within the inflation radius of them.
+	 */
+	void recompute(int margin, int win_tx0, int win_ty0, int win_tx1, int win_ty1)
+	{
+		std::fill(m_tile_seed.begin(), m_tile_seed.end(), 0);
+		int seed_tx0 = m_tiles_x, seed_tx1 = 0;
+		int seed_ty0 = m_tiles_y, seed_ty1 = 0;
+		for(int ty = win_ty0; ty < win_ty1; ++ty) {
+			for(int tx = win_tx0; tx < win_tx1; ++tx)
+			{
+				if(!m_tile_recompute[ty * m_tiles_x + tx]) {
+					continue;
+				}
+				seed_tx0 = std::min(seed_tx0, std::max(tx - margin, 0));
+				seed_tx1 = std::max(seed_tx1, std::min(tx + margin + 1, int(m_tiles_x)));
+				seed_ty0 = std::min(seed_ty0, std::max(ty - margin, 0));
+				seed_ty1 = std::max(seed_ty1, std::min(ty + margin + 1, int(m_tiles_y)));
+				for(int y = std::max(ty - margin, 0); y < std::min(ty + margin + 1, int(m_tiles_y)); ++y) {
+					for(int x = std::max(tx - margin, 0); x < std::min(tx + margin + 1, int(m_tiles_x)); ++x) {
+						m_tile_seed[y * m_tiles_x + x] = 1;
+					}
+				}
+				const unsigned int x0 = tx << TILE_SHIFT, x1 = std::min(unsigned(tx + 1) << TILE_SHIFT, m_size_x);
+				const unsigned int y0 = ty << TILE_SHIFT, y1 = std::min(unsigned(ty + 1) << TILE_SHIFT, m_size_y);
+				for(unsigned int y = y0; y < y1; ++y) {
+					std::fill(m_cost.begin() + y * m_size_x + x0, m_cost.begin() + y * m_size_x + x1, 0);
+				}
+				m_num_recomputed += (x1 - x0) * (y1 - y0);
+				m_tile_valid[ty * m_tiles_x + tx] = 1;
+			}
+		}
+		if(seed_tx0 >= seed_tx1) {
+			return;
+		}
+
+		if(++m_generation == 0) {
+			std::fill(m_seen.begin(), m_seen.end(), 0);
+			m_generation = 1;
+		}
+
+		// seeds in row major order, like the InflationLayer. Lethal cells surrounded by lethal cells
+		// are not propagated, all their neighbors are seeds themselves so they cannot reach any
+		// other cell. They still get their own cost.
+		auto& seeds = m_bins[0];
+		const unsigned int seed_y1 = std::min(unsigned(seed_ty1) << TILE_SHIFT, m_size_y);
+		for(unsigned int y = seed_ty0 << TILE_SHIFT; y < seed_y1; ++y)
+		{
+			const uint8_t* tile_seed = m_tile_seed.data() + (y >> TILE_SHIFT) * m_tiles_x;
+			const uint8_t* tile_recompute = m_tile_recompute.data() + (y >> TILE_SHIFT) * m_tiles_x;
+			const uint8_t* lethal = m_lethal.data() + size_t(y) * m_size_x;
+			for(unsigned int tx = seed_tx0; tx < unsigned(seed_tx1); ++tx)
+			{
+				if(!tile_seed[tx]) {
+					continue;
+				}
+				const unsigned int x1 = std::min((tx + 1) << TILE_SHIFT, m_size_x);
+				for(unsigned int x = tx << TILE_SHIFT; x < x1; ++x)
+				{
+					if(!lethal[x]) {
+						continue;
+					}
+					const bool interior = (x == 0 || lethal[x - 1]) && (x + 1 == m_size_x || lethal[x + 1])
+							&& (y == 0 || (lethal - m_size_x)[x]) && (y + 1 == m_size_y || (lethal + m_size_x)[x]);
+					const unsigned int index = y * m_size_x + x;
+					if(!interior) {
+						seeds.push_back(cell_t{index, x, y, x, y});
+					} else {
+						m_seen[index] = m_generation;
+						if(tile_recompute[tx]) {
+							m_cost[index] = LETHAL_OBSTACLE;
+						}
+					}
+				}
+			}
+		}
+
+		// process cells by increasing distance level, InflationLayer::updateCosts()
+		for(size_t level = 0; level < m_bins.size(); ++level)
+		{
+			auto& bin = m_bins[level];
+			for(size_t k = 0; k < bin.size(); ++k)
+			{
+				const cell_t cell = bin[k];
+				if(m_seen[cell.index] == m_generation) {
+					continue;
+				}
+				m_seen[cell.index] = m_generation;
+
+				if(m_tile_recompute[(cell.y >> TILE_SHIFT) * m_tiles_x + (cell.x >> TILE_SHIFT)]) {
+					m_cost[cell.index] = m_kernel_cost[offset(cell.x, cell.src_x) * m_cache_length + offset(cell.y, cell.src_y)];
+				}
+				if(cell.x > 0) {
+					enqueue(level, cell.index - 1, cell.x - 1, cell.y, cell.src_x, cell.src_y);
+				}
+				if(cell.y > 0) {
+					enqueue(level, cell.index - m_size_x, cell.x, cell.y - 1, cell.src_x, cell.src_y);
+				}
+				if(cell.x < m_size_x - 1) {
+					enqueue(level, cell.index + 1, cell.x + 1, cell.y, cell.src_x, cell.src_y);
+				}
+				if(cell.y < m_size_y - 1) {
+					enqueue(level, cell.index + m_size_x, cell.x, cell.y + 1, cell.src_x, cell.src_y);
+				}
+			}
+			bin.clear();
+		}
+	}
+
+	inline void enqueue(size_t level, unsigned int index, unsigned int x, unsigned int y, unsigned int src_x, unsigned int src_y)
+	{
+		if(m_seen[index] == m_generation) {
+			return;
+		}
+		// only within the inflation radius, and never into a level which is done already
+		const int next = m_kernel_level[offset(x, src_x) * m_cache_length + offset(y, src_y)];
+		if(next >= int(level)) {
+			m_bins[next].push_back(cell_t{index, x, y, src_x, src_y});
+		}
+	}
+
+	static inline unsigned int offset(unsigned int a, unsigned int b) {
+		return a > b ? a - b : b - a;
+	}
+
+	/*
+	 * Combines the cached costs with the grid, InflationLayer::updateCosts()
+	 */
+	void apply(const grid_t& grid, int min_i, int min_j, int max_i, int max_j) const
+	{
+		for(int y = min_j; y < max_j; ++y)
+		{
+			unsigned char* row = grid.data + size_t(y) * m_size_x;
+			const uint8_t* cost = m_cost.data() + size_t(y) * m_size_x;
+			for(int x = min_i; x < max_i; ++x)
+			{
+				const unsigned char old_cost = row[x];
+				if(old_cost == NO_INFORMATION) {
+					if(m_inflate_unknown ? (cost[x] > FREE_SPACE) : (cost[x] >= INSCRIBED_INFLATED_OBSTACLE)) {
+						row[x] = cost[x];
+					}
+				} else {
+					row[x] = std::max(old_cost, cost[x]);
+				}
+			}
+		}
+	}
+
+	double m_resolution = 0;
+	double m_inflation_radius = -1;
+	double m_inscribed_radius = 0;
+	double m_cost_scaling_factor = 0;
+	bool m_inflate_unknown = false;
+	bool m_inflate_around_unknown = false;
+
+	unsigned int m_cell_inflation_radius = 0;
+	unsigned int m_cache_length = 0;
+	std::vector<unsigned char> m_kernel_cost;		// cost per cell offset (dx, dy)
+	std::vector<int> m_kernel_level;				// distance level per cell offset, -1 outside the radius
+	std::vector<std::vector<cell_t>> m_bins;		// cells to visit per distance level
+
+	unsigned int m_size_x = 0;
+	unsigned int m_size_y = 0;
+	unsigned int m_tiles_x = 0;
+	unsigned int m_tiles_y = 0;
+	double m_origin_x = 0;
+	double m_origin_y = 0;
+
+	std::vector<uint8_t> m_lethal;			// lethal status the costs were computed from
+	std::vector<uint8_t> m_cost;			// cached inflation cost
+	std::vector<uint32_t> m_seen;			// generation in which a cell was visited
+	uint32_t m_generation = 0;
+
+	std::vector<uint8_t> m_tile_valid;
+	std::vector<uint8_t> m_tile_recompute;
+	std::vector<uint8_t> m_tile_seed;
+	std::vector<uint8_t> m_tile_changed;
+	std::vector<unsigned int> m_changed_tiles;
+
+	size_t m_num_recomputed = 0;
+
+};
+
+} // neo_costmap_layers
+
+#endif /* INCLUDE_NEO_COSTMAP_LAYERS_INFLATIONKERNEL_H_ */
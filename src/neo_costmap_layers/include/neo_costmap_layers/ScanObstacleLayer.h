@@ -0,0 +1,138 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef INCLUDE_NEO_COSTMAP_LAYERS_SCANOBSTACLELAYER_H_
+#define INCLUDE_NEO_COSTMAP_LAYERS_SCANOBSTACLELAYER_H_
+
+#include <neo_costmap_layers/ScanRaytracer.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <nav2_costmap_2d/costmap_layer.hpp>
+#include <nav2_costmap_2d/layered_costmap.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <geometry_msgs/msg/point.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace neo_costmap_layers {
+
+/*
+ * Obstacle layer for laser scans, drop-in replacement for nav2_costmap_2d::ObstacleLayer with
+ * "LaserScan" observation sources.
+ *
+ * Scans are not converted to point clouds: the sensor pose is looked up once per scan and the
+ * beams are cleared and marked directly by a ScanRaytracer, with the same result as the
+ * ObstacleLayer. Parameters are the same as well (observation_sources, and per source topic,
+ * sensor_frame, clearing, marking, obstacle_min/max_range, raytrace_min/max_range,
+ * min/max_obstacle_height, inf_is_valid, expected_update_rate, observation_persistence = 0).
+ */
+class ScanObstacleLayer : public nav2_costmap_2d::CostmapLayer {
+public:
+	ScanObstacleLayer();
+
+	~ScanObstacleLayer();
+
+	void onInitialize() override;
+
+	void updateBounds(	double robot_x, double robot_y, double robot_yaw,
+						double* min_x, double* min_y, double* max_x, double* max_y) override;
+
+	void updateCosts(	nav2_costmap_2d::Costmap2D& master_grid,
+						int min_i, int min_j, int max_i, int max_j) override;
+
+	void activate() override;
+
+	void deactivate() override;
+
+	void reset() override;
+
+	bool isClearable() override {
+		return true;
+	}
+
+private:
+	struct source_t {
+		std::string name;
+		std::string topic;
+		std::string sensor_frame;
+		bool clearing = false;
+		bool marking = true;
+		bool inf_is_valid = false;
+		double obstacle_min_range = 0;
+		double obstacle_max_range = 2.5;
+		double raytrace_min_range = 0;
+		double raytrace_max_range = 3.0;
+		double min_obstacle_height = 0;
+		double max_obstacle_height = 2.0;
+		double expected_update_rate = 0;
+
+		std::mutex mutex;
+		sensor_msgs::msg::LaserScan::ConstSharedPtr scan;		// latest scan, not processed yet
+		rclcpp::Time last_updated;
+
+		ScanRaytracer raytracer;		// holds the end points of the last processed scan
+		bool has_points = false;
+
+		rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr subscription;
+	};
+
+	void scan_callback(std::shared_ptr<source_t> source, sensor_msgs::msg::LaserScan::ConstSharedPtr scan);
+
+	/*
+	 * Transforms the latest scan of the source into the global frame, if there is a new one.
+	 */
+	bool process_scan(source_t& source);
+
+	void subscribe();
+
+	grid_t get_grid();
+
+	std::vector<std::shared_ptr<source_t>> m_sources;
+	std::vector<geometry_msgs::msg::Point> m_transformed_footprint;
+	std::string m_global_frame;
+
+	bool m_footprint_clearing_enabled = true;
+	double m_max_obstacle_height = 2.0;
+	int m_combination_method = 1;
+	double m_transform_tolerance = 0.3;
+
+};
+
+} // neo_costmap_layers
+
+#endif /* INCLUDE_NEO_COSTMAP_LAYERS_SCANOBSTACLELAYER_H_ */
@@ -0,0 +1,377 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef INCLUDE_NEO_COSTMAP_LAYERS_SCANRAYTRACER_H_
+#define INCLUDE_NEO_COSTMAP_LAYERS_SCANRAYTRACER_H_
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+
+namespace neo_costmap_layers {
+
+/*
+ * View on a costmap, same layout and conventions as nav2_costmap_2d::Costmap2D.
+ */
+struct grid_t {
+	unsigned char* data = nullptr;
+	unsigned int size_x = 0;
+	unsigned int size_y = 0;
+	double origin_x = 0;
+	double origin_y = 0;
+	double resolution = 1;
+
+	bool world_to_map(double wx, double wy, unsigned int& mx, unsigned int& my) const
+	{
+		if(wx < origin_x || wy < origin_y) {
+			return false;
+		}
+		mx = (int)((wx - origin_x) / resolution);
+		my = (int)((wy - origin_y) / resolution);
+		return mx < size_x && my < size_y;
+	}
+
+	unsigned int cell_distance(double world_dist) const
+	{
+		return (unsigned int)std::max(0., std::ceil(world_dist / resolution));
+	}
+};
+
+struct bounds_t {
+	double min_x = std::numeric_limits<double>::max();
+	double min_y = std::numeric_limits<double>::max();
+	double max_x = std::numeric_limits<double>::lowest();
+	double max_y = std::numeric_limits<double>::lowest();
+
+	void touch(double x, double y)
+	{
+		min_x = std::min(x, min_x);
+		min_y = std::min(y, min_y);
+		max_x = std::max(x, max_x);
+		max_y = std::max(y, max_y);
+	}
+};
+
+/*
+ * Rigid transform from sensor to global frame, rotation R (row major) and translation t.
+ */
+struct sensor_pose_t {
+	double R[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+	double t[3] = {0, 0, 0};
+};
+
+/*
+ * Clears and marks a costmap directly from a laser scan, with the same result as
+ * nav2_costmap_2d::ObstacleLayer fed with the scan projected into a point cloud.
+ *
+ * set_scan() computes the end points of all beams in the global frame from one sensor pose,
+ * using a table of beam directions which is only recomputed when the scan geometry changes.
+ * The end points are kept in separate arrays, so that this is a plain loop the compiler can
+ * vectorize. clear() and mark() then apply them to the grid, as often as needed.
+ *
+ * Unlike the "high fidelity" projection used by the ObstacleLayer, the motion of the sensor
+ * during the scan is not taken into account.
+ */
+class ScanRaytracer {
+public:
+	static constexpr unsigned char FREE_SPACE = 0;
+	static constexpr unsigned char LETHAL_OBSTACLE = 254;
+
+	/*
+	 * Computes the end points of all valid beams in the global frame.
+	 * Beams are valid in [range_min, range_max), like in laser_geometry. With inf_is_valid
+	 * infinite ranges are replaced by range_max - 1e-4, like in nav2's ObstacleLayer.
+	 * Points outside of [min_height, max_height] are dropped, like in nav2's ObservationBuffer.
+	 */
+	void set_scan(	const std::vector<float>& ranges, float angle_min, float angle_increment,
+					float range_min, float range_max, const sensor_pose_t& pose,
+					bool inf_is_valid = false, double min_height = -std::numeric_limits<double>::infinity(),
+					double max_height = std::numeric_limits<double>::infinity())
+	{
+		const size_t num_beams = ranges.size();
+		if(num_beams != m_cos.size() || angle_min != m_angle_min || angle_increment != m_angle_increment) {
+			update_table(num_beams, angle_min, angle_increment);
+		}
+
+		const float R00 = pose.R[0][0], R01 = pose.R[0][1];
+		const float R10 = pose.R[1][0], R11 = pose.R[1][1];
+		const float R20 = pose.R[2][0], R21 = pose.R[2][1];
+		const float tx = pose.t[0], ty = pose.t[1], tz = pose.t[2];
+
+		m_origin_x = pose.t[0];
+		m_origin_y = pose.t[1];
+		m_origin_z = pose.t[2];
+
+		// Points are computed in float in the sensor frame, then transformed in float, same as the
+		// point cloud of laser_geometry transformed by tf2_sensor_msgs. Otherwise end points close
+		// to a cell border could end up in a different cell.
+		m_x.resize(num_beams);
+		m_y.resize(num_beams);
+		m_z.resize(num_beams);
+		m_valid.resize(num_beams);
+		for(size_t i = 0; i < num_beams; ++i)
+		{
+			float range = ranges[i];
+			if(inf_is_valid && std::isinf(range) && range > 0) {
+				range = range_max - 1e-4f;
+			}
+			const float sx = range * m_cos[i];
+			const float sy = range * m_sin[i];
+			m_x[i] = R00 * sx + R01 * sy + tx;
+			m_y[i] = R10 * sx + R11 * sy + ty;
+			m_z[i] = R20 * sx + R21 * sy + tz;
+			m_valid[i] = range >= range_min && range < range_max && m_z[i] >= min_height && m_z[i] <= max_height;
+		}
+
+		// compact the valid points, clear() and mark() only iterate over those
+		m_num_points = 0;
+		for(size_t i = 0; i < num_beams; ++i) {
+			if(m_valid[i]) {
+				m_x[m_num_points] = m_x[i];
+				m_y[m_num_points] = m_y[i];
+				m_z[m_num_points] = m_z[i];
+				m_num_points++;
+			}
+		}
+	}
+
+	/*
+	 * Overrides the origin of the rays, by default the sensor position given to set_scan().
+	 */
+	void set_origin(double x, double y, double z)
+	{
+		m_origin_x = x;
+		m_origin_y = y;
+		m_origin_z = z;
+	}
+
+	size_t num_points() const {
+		return m_num_points;
+	}
+
+	/*
+	 * Clears all cells from the sensor to the end points, like ObstacleLayer::raytraceFreespace().
+	 * Consecutive beams ending in the same cell are only traced once.
+	 */
+	void clear(grid_t& grid, double raytrace_min_range, double raytrace_max_range, bounds_t& bounds) const
+	{
+		const double ox = m_origin_x;
+		const double oy = m_origin_y;
+
+		unsigned int x0, y0;
+		if(!grid.world_to_map(ox, oy, x0, y0)) {
+			return;
+		}
+		const double map_end_x = grid.origin_x + grid.size_x * grid.resolution;
+		const double map_end_y = grid.origin_y + grid.size_y * grid.resolution;
+		const unsigned int cell_max_range = grid.cell_distance(raytrace_max_range);
+		const unsigned int cell_min_range = grid.cell_distance(raytrace_min_range);
+
+		bounds.touch(ox, oy);
+
+		unsigned int last_x1 = UINT_MAX;
+		unsigned int last_y1 = UINT_MAX;
+
+		for(size_t i = 0; i < m_num_points; ++i)
+		{
+			double wx = m_x[i];
+			double wy = m_y[i];
+			const double a = wx - ox;
+			const double b = wy - oy;
+
+			// clip the end point to the map, same as nav2
+			if(wx < grid.origin_x) {
+				const double t = (grid.origin_x - ox) / a;
+				wx = grid.origin_x;
+				wy = oy + b * t;
+			}
+			if(wy < grid.origin_y) {
+				const double t = (grid.origin_y - oy) / b;
+				wx = ox + a * t;
+				wy = grid.origin_y;
+			}
+			if(wx > map_end_x) {
+				const double t = (map_end_x - ox) / a;
+				wx = map_end_x - .001;
+				wy = oy + b * t;
+			}
+			if(wy > map_end_y) {
+				const double t = (map_end_y - oy) / b;
+				wx = ox + a * t;
+				wy = map_end_y - .001;
+			}
+
+			unsigned int x1, y1;
+			if(!grid.world_to_map(wx, wy, x1, y1)) {
+				continue;
+			}
+			if(x1 != last_x1 || y1 != last_y1) {
+				raytrace_line(grid, x0, y0, x1, y1, cell_max_range, cell_min_range);
+				last_x1 = x1;
+				last_y1 = y1;
+			}
+
+			// same as ObstacleLayer::updateRaytraceBounds()
+			const double dx = wx - ox;
+			const double dy = wy - oy;
+			const double full_distance = std::sqrt(dx * dx + dy * dy);
+			if(full_distance < raytrace_min_range) {
+				continue;
+			}
+			const double scale = std::min(1.0, raytrace_max_range / full_distance);
+			bounds.touch(ox + dx * scale, oy + dy * scale);
+		}
+	}
+
+	/*
+	 * Marks the end points as lethal, like ObstacleLayer::updateBounds().
+	 */
+	void mark(	grid_t& grid, double obstacle_min_range, double obstacle_max_range,
+				double max_obstacle_height, bounds_t& bounds) const
+	{
+		const double sq_obstacle_max_range = obstacle_max_range * obstacle_max_range;
+		const double sq_obstacle_min_range = obstacle_min_range * obstacle_min_range;
+
+		for(size_t i = 0; i < m_num_points; ++i)
+		{
+			const double px = m_x[i];
+			const double py = m_y[i];
+			const double pz = m_z[i];
+			if(pz > max_obstacle_height) {
+				continue;
+			}
+			const double sq_dist = (px - m_origin_x) * (px - m_origin_x)
+					+ (py - m_origin_y) * (py - m_origin_y) + (pz - m_origin_z) * (pz - m_origin_z);
+			if(sq_dist >= sq_obstacle_max_range || sq_dist < sq_obstacle_min_range) {
+				continue;
+			}
+			unsigned int mx, my;
+			if(!grid.world_to_map(px, py, mx, my)) {
+				continue;
+			}
+			grid.data[my * grid.size_x + mx] = LETHAL_OBSTACLE;
+			bounds.touch(px, py);
+		}
+	}
+
+private:
+	void update_table(size_t num_beams, float angle_min, float angle_increment)
+	{
+		m_cos.resize(num_beams);
+		m_sin.resize(num_beams);
+		for(size_t i = 0; i < num_beams; ++i) {
+			const double angle = angle_min + double(i) * angle_increment;
+			m_cos[i] = std::cos(angle);
+			m_sin[i] = std::sin(angle);
+		}
+		m_angle_min = angle_min;
+		m_angle_increment = angle_increment;
+	}
+
+	/*
+	 * Same as Costmap2D::raytraceLine() with a MarkCell(FREE_SPACE) action.
+	 */
+	static void raytrace_line(	grid_t& grid, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1,
+								unsigned int max_length, unsigned int min_length)
+	{
+		const int dx_full = x1 - x0;
+		const int dy_full = y1 - y0;
+		const double dist = std::sqrt(double(dx_full) * dx_full + double(dy_full) * dy_full);
+		if(dist < min_length) {
+			return;
+		}
+		unsigned int min_x0 = x0;
+		unsigned int min_y0 = y0;
+		if(dist > 0.0) {
+			min_x0 = (unsigned int)(x0 + dx_full / dist * min_length);
+			min_y0 = (unsigned int)(y0 + dy_full / dist * min_length);
+		}
+		const unsigned int offset = min_y0 * grid.size_x + min_x0;
+
+		const int dx = x1 - min_x0;
+		const int dy = y1 - min_y0;
+		const unsigned int abs_dx = std::abs(dx);
+		const unsigned int abs_dy = std::abs(dy);
+		const int offset_dx = dx > 0 ? 1 : -1;
+		const int offset_dy = (dy > 0 ? 1 : -1) * int(grid.size_x);
+		const double scale = (dist == 0.0) ? 1.0 : std::min(1.0, max_length / dist);
+
+		if(abs_dx >= abs_dy) {
+			bresenham(grid.data, abs_dx, abs_dy, abs_dx / 2, offset_dx, offset_dy, offset, (unsigned int)(scale * abs_dx));
+		} else {
+			bresenham(grid.data, abs_dy, abs_dx, abs_dy / 2, offset_dy, offset_dx, offset, (unsigned int)(scale * abs_dy));
+		}
+	}
+
+	static void bresenham(	unsigned char* data, unsigned int abs_da, unsigned int abs_db, int error_b,
+							int offset_a, int offset_b, unsigned int offset, unsigned int max_length)
+	{
+		const unsigned int end = std::min(max_length, abs_da);
+		for(unsigned int i = 0; i < end; ++i) {
+			data[offset] = FREE_SPACE;
+			offset += offset_a;
+			error_b += abs_db;
+			if((unsigned int)error_b >= abs_da) {
+				offset += offset_b;
+				error_b -= abs_da;
+			}
+		}
+		data[offset] = FREE_SPACE;
+	}
+
+	std::vector<double> m_cos;			// beam directions in the sensor frame
+	std::vector<double> m_sin;
+	float m_angle_min = 0;
+	float m_angle_increment = 0;
+
+	std::vector<float> m_x;				// end points in the global frame
+	std::vector<float> m_y;
+	std::vector<float> m_z;
+	std::vector<uint8_t> m_valid;
+	size_t m_num_points = 0;
+
+	double m_origin_x = 0;
+	double m_origin_y = 0;
+	double m_origin_z = 0;
+
+};
+
+} // neo_costmap_layers
+
+#endif /* INCLUDE_NEO_COSTMAP_LAYERS_SCANRAYTRACER_H_ */
@@ -0,0 +1,217 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <neo_costmap_layers/IncrementalInflationLayer.h>
+
+#include <nav2_costmap_2d/costmap_2d.hpp>
+#include <pluginlib/class_list_macros.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+
+namespace neo_costmap_layers {
+
+IncrementalInflationLayer::IncrementalInflationLayer()
+{
+}
+
+IncrementalInflationLayer::~IncrementalInflationLayer()
+{
+	m_dyn_params_handler.reset();
+}
+
+void IncrementalInflationLayer::onInitialize()
+{
+	declareParameter("enabled", rclcpp::ParameterValue(true));
+	declareParameter("inflation_radius", rclcpp::ParameterValue(0.55));
+	declareParameter("cost_scaling_factor", rclcpp::ParameterValue(10.0));
+	declareParameter("inflate_unknown", rclcpp::ParameterValue(false));
+	declareParameter("inflate_around_unknown", rclcpp::ParameterValue(false));
+
+	auto node = node_.lock();
+	if(!node) {
+		throw std::runtime_error("IncrementalInflationLayer: failed to lock node");
+	}
+	node->get_parameter(name_ + ".enabled", enabled_);
+	node->get_parameter(name_ + ".inflation_radius", m_inflation_radius);
+	node->get_parameter(name_ + ".cost_scaling_factor", m_cost_scaling_factor);
+	node->get_parameter(name_ + ".inflate_unknown", m_inflate_unknown);
+	node->get_parameter(name_ + ".inflate_around_unknown", m_inflate_around_unknown);
+
+	current_ = true;
+	m_need_reinflation = false;
+	matchSize();
+
+	m_dyn_params_handler = node->add_on_set_parameters_callback(
+			std::bind(&IncrementalInflationLayer::dynamicParametersCallback, this, std::placeholders::_1));
+
+	RCLCPP_INFO(logger_, "IncrementalInflationLayer: inflation_radius=%f, cost_scaling_factor=%f",
+			m_inflation_radius, m_cost_scaling_factor);
+}
+
+rcl_interfaces::msg::SetParametersResult
+IncrementalInflationLayer::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters)
+{
+	// same as InflationLayer::dynamicParametersCallback()
+	std::lock_guard<nav2_costmap_2d::Costmap2D::mutex_t> guard(*layered_costmap_->getCostmap()->getMutex());
+	bool need_configure = false;
+
+	for(const auto& parameter : parameters)
+	{
+		const auto& type = parameter.get_type();
+		const auto& name = parameter.get_name();
+
+		if(type == rclcpp::ParameterType::PARAMETER_DOUBLE) {
+			if(name == name_ + ".inflation_radius" && m_inflation_radius != parameter.as_double()) {
+				m_inflation_radius = parameter.as_double();
+				need_configure = true;
+			} else if(name == name_ + ".cost_scaling_factor" && m_cost_scaling_factor != parameter.as_double()) {
+				m_cost_scaling_factor = parameter.as_double();
+				need_configure = true;
+			}
+		} else if(type == rclcpp::ParameterType::PARAMETER_BOOL) {
+			if(name == name_ + ".enabled" && enabled_ != parameter.as_bool()) {
+				enabled_ = parameter.as_bool();
+				m_need_reinflation = true;
+				current_ = false;
+			} else if(name == name_ + ".inflate_unknown" && m_inflate_unknown != parameter.as_bool()) {
+				m_inflate_unknown = parameter.as_bool();
+				need_configure = true;
+			} else if(name == name_ + ".inflate_around_unknown" && m_inflate_around_unknown != parameter.as_bool()) {
+				m_inflate_around_unknown = parameter.as_bool();
+				need_configure = true;
+			}
+		}
+	}
+
+	if(need_configure) {
+		// new kernel, the cached costs are outdated everywhere
+		matchSize();
+		m_need_reinflation = true;
+	}
+
+	rcl_interfaces::msg::SetParametersResult result;
+	result.successful = true;
+	return result;
+}
+
+void IncrementalInflationLayer::configure()
+{
+	const nav2_costmap_2d::Costmap2D* costmap = layered_costmap_->getCostmap();
+	m_kernel.configure(	costmap->getResolution(), m_inflation_radius, m_inscribed_radius, m_cost_scaling_factor,
+						m_inflate_unknown, m_inflate_around_unknown);
+}
+
+void IncrementalInflationLayer::matchSize()
+{
+	configure();
+	m_kernel.invalidate();
+}
+
+void IncrementalInflationLayer::onFootprintChanged()
+{
+	m_inscribed_radius = layered_costmap_->getInscribedRadius();
+	configure();
+	m_need_reinflation = true;
+
+	RCLCPP_DEBUG(logger_, "IncrementalInflationLayer::onFootprintChanged(): num footprint points: %zu,"
+			" inscribed_radius = %.3f, inflation_radius = %.3f",
+			layered_costmap_->getFootprint().size(), m_inscribed_radius, m_inflation_radius);
+}
+
+void IncrementalInflationLayer::reset()
+{
+	matchSize();
+	current_ = true;
+}
+
+void IncrementalInflationLayer::updateBounds(	double /*robot_x*/, double /*robot_y*/, double /*robot_yaw*/,
+												double* min_x, double* min_y, double* max_x, double* max_y)
+{
+	// same as the InflationLayer: last and current bounds, plus the inflation radius
+	if(m_need_reinflation) {
+		m_last_min_x = *min_x;
+		m_last_min_y = *min_y;
+		m_last_max_x = *max_x;
+		m_last_max_y = *max_y;
+		*min_x = -std::numeric_limits<float>::max();
+		*min_y = -std::numeric_limits<float>::max();
+		*max_x = std::numeric_limits<float>::max();
+		*max_y = std::numeric_limits<float>::max();
+		m_need_reinflation = false;
+	} else {
+		const double tmp_min_x = m_last_min_x;
+		const double tmp_min_y = m_last_min_y;
+		const double tmp_max_x = m_last_max_x;
+		const double tmp_max_y = m_last_max_y;
+		m_last_min_x = *min_x;
+		m_last_min_y = *min_y;
+		m_last_max_x = *max_x;
+		m_last_max_y = *max_y;
+		*min_x = std::min(tmp_min_x, *min_x) - m_inflation_radius;
+		*min_y = std::min(tmp_min_y, *min_y) - m_inflation_radius;
+		*max_x = std::max(tmp_max_x, *max_x) + m_inflation_radius;
+		*max_y = std::max(tmp_max_y, *max_y) + m_inflation_radius;
+	}
+}
+
+void IncrementalInflationLayer::updateCosts(	nav2_costmap_2d::Costmap2D& master_grid,
+												int min_i, int min_j, int max_i, int max_j)
+{
+	if(!enabled_) {
+		m_need_invalidate = true;
+		return;
+	}
+	if(m_need_invalidate) {
+		// the master grid changed without us looking
+		m_kernel.invalidate();
+		m_need_invalidate = false;
+	}
+
+	grid_t grid;
+	grid.data = master_grid.getCharMap();
+	grid.size_x = master_grid.getSizeInCellsX();
+	grid.size_y = master_grid.getSizeInCellsY();
+	grid.origin_x = master_grid.getOriginX();
+	grid.origin_y = master_grid.getOriginY();
+	grid.resolution = master_grid.getResolution();
+
+	m_kernel.update(grid, min_i, min_j, max_i, max_j);
+}
+
+} // neo_costmap_layers
+
+PLUGINLIB_EXPORT_CLASS(neo_costmap_layers::IncrementalInflationLayer, nav2_costmap_2d::Layer)
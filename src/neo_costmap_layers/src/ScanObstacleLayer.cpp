@@ -0,0 +1,339 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2022, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <neo_costmap_layers/ScanObstacleLayer.h>
+
+#include <nav2_costmap_2d/cost_values.hpp>
+#include <nav2_costmap_2d/footprint.hpp>
+#include <pluginlib/class_list_macros.hpp>
+#include <tf2/LinearMath/Transform.h>
+#include <tf2/time.h>
+#include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
+
+#include <sstream>
+
+
+namespace neo_costmap_layers {
+
+ScanObstacleLayer::ScanObstacleLayer()
+{
+	costmap_ = nullptr;		// this is the unsigned char* member of parent class Costmap2D
+}
+
+ScanObstacleLayer::~ScanObstacleLayer()
+{
+}
+
+void ScanObstacleLayer::onInitialize()
+{
+	declareParameter("enabled", rclcpp::ParameterValue(true));
+	declareParameter("footprint_clearing_enabled", rclcpp::ParameterValue(true));
+	declareParameter("max_obstacle_height", rclcpp::ParameterValue(2.0));
+	declareParameter("combination_method", rclcpp::ParameterValue(1));
+	declareParameter("observation_sources", rclcpp::ParameterValue(std::string("")));
+
+	auto node = node_.lock();
+	if(!node) {
+		throw std::runtime_error("ScanObstacleLayer: failed to lock node");
+	}
+
+	bool track_unknown_space = false;
+	std::string sources_string;
+	node->get_parameter(name_ + ".enabled", enabled_);
+	node->get_parameter(name_ + ".footprint_clearing_enabled", m_footprint_clearing_enabled);
+	node->get_parameter(name_ + ".max_obstacle_height", m_max_obstacle_height);
+	node->get_parameter(name_ + ".combination_method", m_combination_method);
+	node->get_parameter(name_ + ".observation_sources", sources_string);
+	node->get_parameter("track_unknown_space", track_unknown_space);
+	node->get_parameter("transform_tolerance", m_transform_tolerance);
+
+	rolling_window_ = layered_costmap_->isRolling();
+	default_value_ = track_unknown_space ? nav2_costmap_2d::NO_INFORMATION : nav2_costmap_2d::FREE_SPACE;
+	matchSize();
+	current_ = true;
+	m_global_frame = layered_costmap_->getGlobalFrameID();
+
+	std::stringstream ss(sources_string);
+	std::string name;
+	while(ss >> name)
+	{
+		auto source = std::make_shared<source_t>();
+		source->name = name;
+		const std::string prefix = name + ".";
+
+		declareParameter(prefix + "topic", rclcpp::ParameterValue(name));
+		declareParameter(prefix + "sensor_frame", rclcpp::ParameterValue(std::string("")));
+		declareParameter(prefix + "data_type", rclcpp::ParameterValue(std::string("LaserScan")));
+		declareParameter(prefix + "clearing", rclcpp::ParameterValue(false));
+		declareParameter(prefix + "marking", rclcpp::ParameterValue(true));
+		declareParameter(prefix + "inf_is_valid", rclcpp::ParameterValue(false));
+		declareParameter(prefix + "obstacle_min_range", rclcpp::ParameterValue(0.0));
+		declareParameter(prefix + "obstacle_max_range", rclcpp::ParameterValue(2.5));
+		declareParameter(prefix + "raytrace_min_range", rclcpp::ParameterValue(0.0));
+		declareParameter(prefix + "raytrace_max_range", rclcpp::ParameterValue(3.0));
+		declareParameter(prefix + "min_obstacle_height", rclcpp::ParameterValue(0.0));
+		declareParameter(prefix + "max_obstacle_height", rclcpp::ParameterValue(2.0));
+		declareParameter(prefix + "expected_update_rate", rclcpp::ParameterValue(0.0));
+
+		std::string data_type;
+		node->get_parameter(name_ + "." + prefix + "topic", source->topic);
+		node->get_parameter(name_ + "." + prefix + "sensor_frame", source->sensor_frame);
+		node->get_parameter(name_ + "." + prefix + "data_type", data_type);
+		node->get_parameter(name_ + "." + prefix + "clearing", source->clearing);
+		node->get_parameter(name_ + "." + prefix + "marking", source->marking);
+		node->get_parameter(name_ + "." + prefix + "inf_is_valid", source->inf_is_valid);
+		node->get_parameter(name_ + "." + prefix + "obstacle_min_range", source->obstacle_min_range);
+		node->get_parameter(name_ + "." + prefix + "obstacle_max_range", source->obstacle_max_range);
+		node->get_parameter(name_ + "." + prefix + "raytrace_min_range", source->raytrace_min_range);
+		node->get_parameter(name_ + "." + prefix + "raytrace_max_range", source->raytrace_max_range);
+		node->get_parameter(name_ + "." + prefix + "min_obstacle_height", source->min_obstacle_height);
+		node->get_parameter(name_ + "." + prefix + "max_obstacle_height", source->max_obstacle_height);
+		node->get_parameter(name_ + "." + prefix + "expected_update_rate", source->expected_update_rate);
+
+		if(data_type != "LaserScan") {
+			RCLCPP_ERROR(logger_, "ScanObstacleLayer: source %s has data_type %s, only LaserScan is supported",
+					name.c_str(), data_type.c_str());
+			throw std::runtime_error("ScanObstacleLayer: unsupported data_type " + data_type);
+		}
+		source->last_updated = clock_->now();
+
+		RCLCPP_INFO(logger_, "ScanObstacleLayer: created source %s on topic %s (clearing=%d, marking=%d)",
+				name.c_str(), source->topic.c_str(), int(source->clearing), int(source->marking));
+		m_sources.push_back(source);
+	}
+	subscribe();
+}
+
+void ScanObstacleLayer::subscribe()
+{
+	auto node = node_.lock();
+	if(!node) {
+		return;
+	}
+	for(const auto& source : m_sources) {
+		std::weak_ptr<source_t> weak_source = source;
+		source->subscription = node->create_subscription<sensor_msgs::msg::LaserScan>(
+				source->topic, rclcpp::SensorDataQoS(),
+				[this, weak_source](sensor_msgs::msg::LaserScan::ConstSharedPtr scan) {
+					if(auto source = weak_source.lock()) {
+						scan_callback(source, scan);
+					}
+				});
+	}
+}
+
+void ScanObstacleLayer::activate()
+{
+	for(const auto& source : m_sources) {
+		if(!source->subscription) {
+			subscribe();
+			break;
+		}
+	}
+	reset();
+}
+
+void ScanObstacleLayer::deactivate()
+{
+	for(const auto& source : m_sources) {
+		source->subscription.reset();
+	}
+}
+
+void ScanObstacleLayer::reset()
+{
+	resetMaps();
+	for(const auto& source : m_sources) {
+		std::lock_guard<std::mutex> lock(source->mutex);
+		source->last_updated = clock_->now();
+	}
+	current_ = true;
+}
+
+void ScanObstacleLayer::scan_callback(std::shared_ptr<source_t> source, sensor_msgs::msg::LaserScan::ConstSharedPtr scan)
+{
+	std::lock_guard<std::mutex> lock(source->mutex);
+	source->scan = scan;
+	source->last_updated = clock_->now();
+}
+
+bool ScanObstacleLayer::process_scan(source_t& source)
+{
+	sensor_msgs::msg::LaserScan::ConstSharedPtr scan;
+	{
+		std::lock_guard<std::mutex> lock(source.mutex);
+		scan = source.scan;
+	}
+	if(!scan) {
+		return false;
+	}
+
+	// one lookup per scan, instead of one transform per point
+	tf2::Transform sensor_to_global;
+	tf2::Vector3 origin;
+	try {
+		const auto stamp = tf2_ros::fromMsg(scan->header.stamp);
+		tf2::fromMsg(tf_->lookupTransform(m_global_frame, scan->header.frame_id, stamp).transform, sensor_to_global);
+		origin = sensor_to_global.getOrigin();
+
+		if(!source.sensor_frame.empty() && source.sensor_frame != scan->header.frame_id) {
+			tf2::Transform origin_to_global;
+			tf2::fromMsg(tf_->lookupTransform(m_global_frame, source.sensor_frame, stamp).transform, origin_to_global);
+			origin = origin_to_global.getOrigin();
+		}
+	}
+	catch(const tf2::TransformException& ex) {
+		// transform might not be available yet, try again in the next cycle (same as a tf2_ros::MessageFilter)
+		if((clock_->now() - rclcpp::Time(scan->header.stamp)).seconds() <= m_transform_tolerance) {
+			return false;
+		}
+		RCLCPP_WARN_THROTTLE(logger_, *clock_, 5000, "ScanObstacleLayer: dropping scan of %s: %s",
+				source.name.c_str(), ex.what());
+		std::lock_guard<std::mutex> lock(source.mutex);
+		if(source.scan == scan) {
+			source.scan = nullptr;
+		}
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> lock(source.mutex);
+		if(source.scan == scan) {
+			source.scan = nullptr;
+		}
+	}
+
+	sensor_pose_t pose;
+	const tf2::Matrix3x3& basis = sensor_to_global.getBasis();
+	for(int j = 0; j < 3; ++j) {
+		for(int i = 0; i < 3; ++i) {
+			pose.R[j][i] = basis[j][i];
+		}
+	}
+	pose.t[0] = sensor_to_global.getOrigin().x();
+	pose.t[1] = sensor_to_global.getOrigin().y();
+	pose.t[2] = sensor_to_global.getOrigin().z();
+
+	source.raytracer.set_scan(	scan->ranges, scan->angle_min, scan->angle_increment, scan->range_min, scan->range_max,
+								pose, source.inf_is_valid, source.min_obstacle_height, source.max_obstacle_height);
+	source.raytracer.set_origin(origin.x(), origin.y(), origin.z());
+	source.has_points = true;
+	return true;
+}
+
+grid_t ScanObstacleLayer::get_grid()
+{
+	grid_t grid;
+	grid.data = costmap_;
+	grid.size_x = size_x_;
+	grid.size_y = size_y_;
+	grid.origin_x = origin_x_;
+	grid.origin_y = origin_y_;
+	grid.resolution = resolution_;
+	return grid;
+}
+
+void ScanObstacleLayer::updateBounds(	double robot_x, double robot_y, double robot_yaw,
+										double* min_x, double* min_y, double* max_x, double* max_y)
+{
+	if(rolling_window_) {
+		updateOrigin(robot_x - getSizeInMetersX() / 2, robot_y - getSizeInMetersY() / 2);
+	}
+	if(!enabled_) {
+		return;
+	}
+	useExtraBounds(min_x, min_y, max_x, max_y);
+
+	bool current = true;
+	const auto now = clock_->now();
+	for(const auto& source : m_sources)
+	{
+		process_scan(*source);
+
+		std::lock_guard<std::mutex> lock(source->mutex);
+		if(source->expected_update_rate > 0) {
+			current = current && (now - source->last_updated).seconds() <= 1 / source->expected_update_rate;
+		}
+	}
+	current_ = current;
+
+	// clear all, then mark all, same order as the ObstacleLayer
+	grid_t grid = get_grid();
+	bounds_t bounds;
+	for(const auto& source : m_sources) {
+		if(source->clearing && source->has_points) {
+			source->raytracer.clear(grid, source->raytrace_min_range, source->raytrace_max_range, bounds);
+		}
+	}
+	for(const auto& source : m_sources) {
+		if(source->marking && source->has_points) {
+			source->raytracer.mark(grid, source->obstacle_min_range, source->obstacle_max_range, m_max_obstacle_height, bounds);
+		}
+	}
+	if(bounds.min_x <= bounds.max_x && bounds.min_y <= bounds.max_y) {
+		touch(bounds.min_x, bounds.min_y, min_x, min_y, max_x, max_y);
+		touch(bounds.max_x, bounds.max_y, min_x, min_y, max_x, max_y);
+	}
+
+	if(m_footprint_clearing_enabled) {
+		nav2_costmap_2d::transformFootprint(robot_x, robot_y, robot_yaw, getFootprint(), m_transformed_footprint);
+		for(const auto& point : m_transformed_footprint) {
+			touch(point.x, point.y, min_x, min_y, max_x, max_y);
+		}
+	}
+}
+
+void ScanObstacleLayer::updateCosts(	nav2_costmap_2d::Costmap2D& master_grid,
+										int min_i, int min_j, int max_i, int max_j)
+{
+	if(!enabled_) {
+		return;
+	}
+	if(m_footprint_clearing_enabled) {
+		setConvexPolygonCost(m_transformed_footprint, nav2_costmap_2d::FREE_SPACE);
+	}
+	switch(m_combination_method) {
+		case 0:
+			updateWithOverwrite(master_grid, min_i, min_j, max_i, max_j);
+			break;
+		case 1:
+			updateWithMax(master_grid, min_i, min_j, max_i, max_j);
+			break;
+		default:
+			break;
+	}
+}
+
+} // neo_costmap_layers
+
+PLUGINLIB_EXPORT_CLASS(neo_costmap_layers::ScanObstacleLayer, nav2_costmap_2d::Layer)
@@ -56,6 +56,9 @@
 #include "nav2_util/odometry_utils.hpp"
 #include "geometry_msgs/msg/pose2_d.hpp"
 #include "geometry_msgs/msg/vector3_stamped.hpp"
+#include <tf2/LinearMath/Transform.h>
+
+#include "PathSpline.h"
 
 
 namespace neo_local_planner {
@@ -143,6 +146,12 @@ public:
 
 	bool reset_lastvel(nav_msgs::msg::Path m_global_plan, nav_msgs::msg::Path plan);
 
+	/*
+	 * Returns how long the cached costmap evaluation may be reused [s], depending on the
+	 * current speed [m/s] and the distance to the last obstacle found.
+	 */
+	double get_evaluation_interval(double speed) const;
+
 private:
 	std::shared_ptr<tf2_ros::Buffer> tf_;
 	std::string plugin_name_;
@@ -152,6 +161,8 @@ private:
 	tf2_ros::Buffer* m_tf = 0;
 	nav2_costmap_2d::Costmap2DROS* m_cost_map;
 	nav_msgs::msg::Path m_global_plan;
+	PathSpline m_plan_spline;			// fitted on m_global_plan, in the global frame
+	double m_last_target_s = -1;		// arc length of the last target on m_plan_spline, -1 if none
 	rclcpp::Clock::SharedPtr clock_;
 
 	std::mutex m_mutex;
@@ -185,6 +196,27 @@ private:
 	double m_last_control_values[3] = {};
 	geometry_msgs::msg::Twist m_last_cmd_vel;
 
+	/*
+	 * Result of the last full costmap evaluation (cost gradients and obstacle walk),
+	 * reused in between when adaptive_evaluation is enabled.
+	 */
+	struct evaluation_t {
+		bool valid = false;
+		rclcpp::Time time;
+		tf2::Transform pose;			// predicted pose it was computed for, in local frame
+		double center_cost = 0;
+		double delta_cost_x = 0;
+		double delta_cost_y = 0;
+		double delta_cost_yaw = 0;
+		bool have_obstacle = false;
+		double obstacle_dist = 0;		// without min_stop_dist
+		double obstacle_cost = 0;
+	};
+
+	evaluation_t m_evaluation;
+	uint64_t m_num_evaluations = 0;			// full evaluations, for the debug log
+	uint64_t m_num_reused_evaluations = 0;
+
 protected:
 	double acc_lim_x = 0;
 	double acc_lim_y = 0;
@@ -231,6 +263,13 @@ protected:
 	double max_backup_dist = 0.0;
 	double min_stop_dist = 0.0;
 	double emergency_acc_lim_x = 0.0;
+	double spline_resolution = 0.0;
+	bool adaptive_evaluation = false;
+	double min_evaluation_rate = 0.0;
+	double adaptive_full_speed = 0.0;
+	double adaptive_obstacle_dist = 0.0;
+	double adaptive_max_move = 0.0;
+	double max_obstacle_step = 0.0;
 	bool enable_software_stop = false;
 	bool m_reset_lastvel = false;
 	bool m_allow_reversing = false;
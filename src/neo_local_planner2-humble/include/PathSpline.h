@@ -0,0 +1,281 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef INCLUDE_PATHSPLINE_H_
+#define INCLUDE_PATHSPLINE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace neo_local_planner {
+
+/*
+ * Chain of cubic splines through a path, parameterized by arc length.
+ *
+ * The path is resampled at a fixed arc length step h, then one cubic per step is fitted with
+ * the conditions of symbolics/spline_solve.cpp: continuous position, velocity and acceleration
+ * at every knot and zero acceleration at both ends. For N segments this is a tridiagonal
+ * system which is solved in O(N) once per path.
+ *
+ * Since the knots are equidistant, evaluating position or heading at an arc length
+ * is O(1): the segment is floor(s / h).
+ */
+class PathSpline {
+public:
+	struct point_t {
+		double x = 0;
+		double y = 0;
+		double yaw = 0;			// heading of the path [rad]
+	};
+
+	/*
+	 * Fits the spline through the given points (x, y), resampled every 'resolution' meters.
+	 */
+	void fit(const std::vector<double>& path_x, const std::vector<double>& path_y, double resolution)
+	{
+		m_coeff_x.clear();
+		m_coeff_y.clear();
+		m_length = 0;
+		m_step = 1;
+
+		const size_t num_points = std::min(path_x.size(), path_y.size());
+		if(num_points == 0) {
+			return;
+		}
+
+		// cumulative arc length of the polyline
+		std::vector<double> arc(num_points, 0);
+		for(size_t i = 1; i < num_points; ++i) {
+			arc[i] = arc[i - 1] + ::hypot(path_x[i] - path_x[i - 1], path_y[i] - path_y[i - 1]);
+		}
+		m_length = arc.back();
+
+		if(m_length < 1e-6 || resolution <= 0) {
+			// single point, constant spline
+			m_length = 0;
+			m_coeff_x.push_back({0, 0, 0, path_x.back()});
+			m_coeff_y.push_back({0, 0, 0, path_y.back()});
+			return;
+		}
+
+		// resample at equidistant knots
+		const size_t num_segments = std::max<size_t>(size_t(std::ceil(m_length / resolution)), 1);
+		m_step = m_length / num_segments;
+
+		std::vector<double> knot_x(num_segments + 1);
+		std::vector<double> knot_y(num_segments + 1);
+		size_t j = 0;
+		for(size_t k = 0; k <= num_segments; ++k)
+		{
+			const double s = std::min(k * m_step, m_length);
+			while(j + 2 < num_points && arc[j + 1] < s) {
+				j++;
+			}
+			const double len = arc[j + 1] - arc[j];
+			const double t = len > 0 ? std::min(std::max((s - arc[j]) / len, 0.), 1.) : 0;
+			knot_x[k] = path_x[j] + t * (path_x[j + 1] - path_x[j]);
+			knot_y[k] = path_y[j] + t * (path_y[j + 1] - path_y[j]);
+		}
+
+		m_coeff_x = solve(knot_x, m_step);
+		m_coeff_y = solve(knot_y, m_step);
+	}
+
+	bool empty() const {
+		return m_coeff_x.empty();
+	}
+
+	/*
+	 * Returns the total arc length [m].
+	 */
+	double length() const {
+		return m_length;
+	}
+
+	/*
+	 * Evaluates position and heading at arc length s (clamped to [0, length]).
+	 */
+	point_t evaluate(double s) const
+	{
+		point_t out;
+		if(empty()) {
+			return out;
+		}
+		double t = 0;
+		const size_t i = segment(s, t);
+		const coeff_t& cx = m_coeff_x[i];
+		const coeff_t& cy = m_coeff_y[i];
+
+		out.x = ((cx.a * t + cx.b) * t + cx.c) * t + cx.d;
+		out.y = ((cy.a * t + cy.b) * t + cy.c) * t + cy.d;
+
+		const double dx = (3 * cx.a * t + 2 * cx.b) * t + cx.c;
+		const double dy = (3 * cy.a * t + 2 * cy.b) * t + cy.c;
+		out.yaw = ::atan2(dy, dx);
+		return out;
+	}
+
+	/*
+	 * Returns the arc length of the point on the path closest to (x, y).
+	 * Only the knots within +/- search_dist of 'hint' are searched, unless hint < 0 or
+	 * the path is further away than search_dist, in which case the whole path is searched.
+	 */
+	double project(double x, double y, double hint, double search_dist) const
+	{
+		if(empty() || m_length == 0) {
+			return 0;
+		}
+		const size_t num_knots = m_coeff_x.size() + 1;
+
+		double best_dist = std::numeric_limits<double>::infinity();
+		size_t best = 0;
+		if(hint >= 0)
+		{
+			const double begin = std::max(hint - search_dist, 0.) / m_step;
+			const double end = std::min(hint + search_dist, m_length) / m_step;
+			best = closest_knot(x, y, size_t(begin), std::min(size_t(std::ceil(end)) + 1, num_knots), best_dist);
+		}
+		if(!(best_dist <= search_dist)) {
+			best = closest_knot(x, y, 0, num_knots, best_dist);
+		}
+
+		// refine on the chords to the neighbor knots
+		double best_s = best * m_step;
+		for(const size_t i : {best > 0 ? best - 1 : best, best})
+		{
+			if(i + 1 >= num_knots) {
+				continue;
+			}
+			const double x0 = m_coeff_x[i].d, y0 = m_coeff_y[i].d;
+			const double x1 = knot(m_coeff_x, i + 1), y1 = knot(m_coeff_y, i + 1);
+			const double len2 = (x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0);
+			if(len2 <= 0) {
+				continue;
+			}
+			const double t = std::min(std::max(((x - x0) * (x1 - x0) + (y - y0) * (y1 - y0)) / len2, 0.), 1.);
+			const double dist = ::hypot(x0 + t * (x1 - x0) - x, y0 + t * (y1 - y0) - y);
+			if(dist < best_dist) {
+				best_dist = dist;
+				best_s = (i + t) * m_step;
+			}
+		}
+		return std::min(best_s, m_length);
+	}
+
+private:
+	struct coeff_t {
+		double a, b, c, d;		// a * t^3 + b * t^2 + c * t + d, with t in [0, h]
+	};
+
+	/*
+	 * Solves for the cubic coefficients of one axis (natural spline, uniform step h).
+	 */
+	static std::vector<coeff_t> solve(const std::vector<double>& p, const double h)
+	{
+		const size_t n = p.size() - 1;		// number of segments
+		std::vector<double> m(n + 1, 0);	// second derivatives at the knots, zero at both ends
+
+		if(n >= 2)
+		{
+			// m[i-1] + 4 m[i] + m[i+1] = 6 (p[i+1] - 2 p[i] + p[i-1]) / h^2, Thomas algorithm
+			std::vector<double> c_prime(n, 0);
+			std::vector<double> d_prime(n, 0);
+			for(size_t i = 1; i < n; ++i)
+			{
+				const double rhs = 6 * (p[i + 1] - 2 * p[i] + p[i - 1]) / (h * h);
+				const double denom = 4 - c_prime[i - 1];
+				c_prime[i] = 1 / denom;
+				d_prime[i] = (rhs - d_prime[i - 1]) / denom;
+			}
+			for(size_t i = n - 1; i >= 1; --i) {
+				m[i] = d_prime[i] - c_prime[i] * m[i + 1];
+			}
+		}
+
+		std::vector<coeff_t> coeff(n);
+		for(size_t i = 0; i < n; ++i)
+		{
+			coeff[i].a = (m[i + 1] - m[i]) / (6 * h);
+			coeff[i].b = m[i] / 2;
+			coeff[i].c = (p[i + 1] - p[i]) / h - h * (2 * m[i] + m[i + 1]) / 6;
+			coeff[i].d = p[i];
+		}
+		return coeff;
+	}
+
+	size_t segment(double s, double& t) const
+	{
+		s = std::min(std::max(s, 0.), m_length);
+		const size_t i = std::min(size_t(s / m_step), m_coeff_x.size() - 1);
+		t = s - i * m_step;
+		return i;
+	}
+
+	double knot(const std::vector<coeff_t>& coeff, const size_t k) const
+	{
+		if(k < coeff.size()) {
+			return coeff[k].d;
+		}
+		const coeff_t& c = coeff.back();
+		return ((c.a * m_step + c.b) * m_step + c.c) * m_step + c.d;
+	}
+
+	size_t closest_knot(double x, double y, size_t begin, size_t end, double& best_dist) const
+	{
+		size_t best = begin;
+		best_dist = std::numeric_limits<double>::infinity();
+		for(size_t k = begin; k < end; ++k)
+		{
+			const double dist = ::hypot(knot(m_coeff_x, k) - x, knot(m_coeff_y, k) - y);
+			if(dist < best_dist) {
+				best_dist = dist;
+				best = k;
+			}
+		}
+		return best;
+	}
+
+	std::vector<coeff_t> m_coeff_x;
+	std::vector<coeff_t> m_coeff_y;
+	double m_length = 0;
+	double m_step = 1;
+
+};
+
+} // neo_local_planner
+
+#endif /* INCLUDE_PATHSPLINE_H_ */
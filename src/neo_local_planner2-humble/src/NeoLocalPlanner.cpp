@@ -44,6 +44,7 @@
 #include "pluginlib/class_list_macros.hpp"
 #include <algorithm>
 #include <tf2_eigen/tf2_eigen.hpp>
+#include <neo_tracetools/tracetools.h>
 
 using rcl_interfaces::msg::ParameterType;
 namespace neo_local_planner {
@@ -55,56 +56,6 @@ tf2::Quaternion createQuaternionFromYaw(double yaw)
 	return q;
 }
 
-std::vector<tf2::Transform>::const_iterator find_closest_point(	std::vector<tf2::Transform>::const_iterator begin,
-															std::vector<tf2::Transform>::const_iterator end,
-															const tf2::Vector3& pos,
-															double* actual_dist = 0)
-{
-	auto iter_short = begin;
-	double dist_short = std::numeric_limits<double>::infinity();
-
-	for(auto iter = iter_short; iter != end; ++iter)
-	{
-		const double dist = (iter->getOrigin() - pos).length();
-		if(dist < dist_short)
-		{
-			dist_short = dist;
-			iter_short = iter;
-		}
-	}
-	if(actual_dist) {
-		*actual_dist = dist_short;
-	}
-	return iter_short;
-}
-
-std::vector<tf2::Transform>::const_iterator move_along_path(	std::vector<tf2::Transform>::const_iterator begin,
-														std::vector<tf2::Transform>::const_iterator end,
-														const double dist, double* actual_dist = 0)
-{
-	auto iter = begin;
-	auto iter_prev = iter;
-	double dist_left = dist;
-
-	while(iter != end)
-	{
-		const double dist = (iter->getOrigin() - iter_prev->getOrigin()).length();
-		dist_left -= dist;
-		if(dist_left <= 0) {
-			break;
-		}
-		iter_prev = iter;
-		iter++;
-	}
-	if(iter == end) {
-		iter = iter_prev;		// targeting final pose
-	}
-	if(actual_dist) {
-		*actual_dist = dist - dist_left;
-	}
-	return iter;
-}
-
 std::vector<std::pair <int,int> > get_line_cells(
 								nav2_costmap_2d::Costmap2D* cost_map,
 								const tf2::Vector3& world_pos_0,
@@ -168,6 +119,19 @@ double compute_max_line_cost(	nav2_costmap_2d::Costmap2D* cost_map_,
 	return max_cost / 255.;
 }
 
+double NeoLocalPlanner::get_evaluation_interval(double speed) const
+{
+	if(min_evaluation_rate <= 0 || adaptive_full_speed <= 0) {
+		return 0;
+	}
+	// evaluate every cycle at full speed or right before an obstacle, at min_evaluation_rate when standing still
+	double urgency = fmin(fabs(speed) / adaptive_full_speed, 1);
+	if(m_evaluation.have_obstacle && adaptive_obstacle_dist > 0) {
+		urgency = fmax(urgency, 1 - fmin(fmax(m_evaluation.obstacle_dist - min_stop_dist, 0) / adaptive_obstacle_dist, 1));
+	}
+	return (1 - urgency) / min_evaluation_rate;
+}
+
 geometry_msgs::msg::TwistStamped NeoLocalPlanner::computeVelocityCommands(
   const geometry_msgs::msg::PoseStamped & position,
   const geometry_msgs::msg::Twist & speed,
@@ -175,13 +139,16 @@ geometry_msgs::msg::TwistStamped NeoLocalPlanner::computeVelocityCommands(
 {
 	std::lock_guard<std::mutex> lock_reinit(m_mutex);
 
+	NEO_TRACE_SCOPE("neo_local_planner", "computeVelocityCommands", neo_tracetools::stamp_ns(position.header.stamp));
+
 	geometry_msgs::msg::Twist cmd_vel;
 	geometry_msgs::msg::TwistStamped cmd_vel_final;
 
-	if(m_global_plan.poses.empty())
+	if(m_global_plan.poses.empty() || m_plan_spline.empty())
 	{
 		RCLCPP_WARN_THROTTLE(logger_, *clock_, 1.0, 
 			"Global Plan is empty");
+		return cmd_vel_final;
 	}
 
 	// compute delta time
@@ -208,22 +175,19 @@ geometry_msgs::msg::TwistStamped NeoLocalPlanner::computeVelocityCommands(
 			"lookupTransform(m_base_frame, m_global_frame) failed");
 	}
 
-	// transform plan to local frame (odom)
-	std::vector<tf2::Transform> local_plan;
-	std::vector<tf2::Transform> transformed_plan;
-
-	for(const auto& pose : m_global_plan.poses)
+	// the plan is only used through m_plan_spline (global frame), transform the goal to local frame (odom)
+	NEO_TRACEPOINT(phase, "neo_local_planner", "transform", 0);
+	tf2::Transform local_goal;
 	{
-		tf2::Transform pose_;
-		tf2::Transform robot_pose_;
-		tf2::fromMsg(pose.pose, pose_);
-		tf2::fromMsg(pose.pose, robot_pose_);
-		local_plan.push_back(global_to_local * pose_);
-		transformed_plan.push_back(global_to_robot * robot_pose_);
+		tf2::Transform goal_;
+		tf2::fromMsg(m_global_plan.poses.back().pose, goal_);
+		local_goal = global_to_local * goal_;
 	}
 
 	if(m_allow_reversing and count<=1) {
-		auto point_1 = tf2::toMsg(transformed_plan[5]);
+		tf2::Transform pose_;
+		tf2::fromMsg(m_global_plan.poses[std::min<size_t>(5, m_global_plan.poses.size() - 1)].pose, pose_);
+		auto point_1 = tf2::toMsg(global_to_robot * pose_);
 
 		// Estimate if the robot has travelled and then determine if the path is reversed! ToDo
 		// Just checks if the goal is in the rear end of the robot
@@ -269,89 +233,157 @@ geometry_msgs::msg::TwistStamped NeoLocalPlanner::computeVelocityCommands(
 
 	const tf2::Transform actual_pose = tf2::Transform(createQuaternionFromYaw(actual_yaw), actual_pos);
 
-	// compute cost gradients
 	const double delta_x = 0.3;
 	const double delta_y = 0.2;
 	const double delta_yaw = 0.1;
 
-	const double center_cost = get_cost(costmap_, actual_pos);
-	const double delta_cost_x = (
-		compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(delta_x, 0, 0)) -
-		compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(-delta_x, 0, 0)))
-		/ delta_x;
-
-	const double delta_cost_y = (
-		compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(cost_y_lookahead_dist, delta_y, 0)) -
-		compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(cost_y_lookahead_dist, -delta_y, 0)))
-		/ delta_y;
-
-	const double delta_cost_yaw = (
-		(
-			compute_avg_line_cost(costmap_,	actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(delta_yaw)) * tf2::Vector3(delta_x, 0, 0)),
-												actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(delta_yaw)) * tf2::Vector3(-delta_x, 0, 0)))
-		) - (
-			compute_avg_line_cost(costmap_,	actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(-delta_yaw)) * tf2::Vector3(delta_x, 0, 0)),
-												actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(-delta_yaw)) * tf2::Vector3(-delta_x, 0, 0)))
-		)) / (2 * delta_yaw);
-
-	// fill local plan later
-	nav_msgs::msg::Path local_path;
-	local_path.header.frame_id = m_local_frame;
-	local_path.header.stamp = m_odometry->header.stamp;
-
-	// compute obstacle distance
+	// decide if the costmap needs to be evaluated again, otherwise reuse the last results
+	const double start_speed = ::hypot(start_vel_x, start_vel_y);
+	bool full_evaluation = true;
+	if(adaptive_evaluation && m_evaluation.valid)
+	{
+		const double moved = (actual_pos - m_evaluation.pose.getOrigin()).length();
+		const double turned = fabs(angles::shortest_angular_distance(
+				tf2::getYaw(m_evaluation.pose.getRotation()), actual_yaw));
+
+		full_evaluation = (time_now - m_evaluation.time).seconds() >= get_evaluation_interval(start_speed)
+				|| moved > adaptive_max_move || turned > 0.5 * delta_yaw;
+	}
+
+	double center_cost = 0;
+	double delta_cost_x = 0;
+	double delta_cost_y = 0;
+	double delta_cost_yaw = 0;
 	bool have_obstacle = false;
 	double obstacle_dist = 0;
 	double obstacle_cost = 0;
-	{
-		const double delta_move = 0.05;
-		const double delta_time = fabs(start_vel_x) > trans_stopped_vel ? (delta_move / fabs(start_vel_x)) : 0;
-
-		tf2::Transform pose = actual_pose;
-		tf2::Transform last_pose = pose;
 
-		while(obstacle_dist < 10)
+	if(full_evaluation)
+	{
+		// compute cost gradients
+		NEO_TRACEPOINT(phase, "neo_local_planner", "cost_gradients", 0);
+
+		center_cost = get_cost(costmap_, actual_pos);
+		delta_cost_x = (
+			compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(delta_x, 0, 0)) -
+			compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(-delta_x, 0, 0)))
+			/ delta_x;
+
+		delta_cost_y = (
+			compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(cost_y_lookahead_dist, delta_y, 0)) -
+			compute_avg_line_cost(costmap_, actual_pos, actual_pose * tf2::Vector3(cost_y_lookahead_dist, -delta_y, 0)))
+			/ delta_y;
+
+		delta_cost_yaw = (
+			(
+				compute_avg_line_cost(costmap_,	actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(delta_yaw)) * tf2::Vector3(delta_x, 0, 0)),
+													actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(delta_yaw)) * tf2::Vector3(-delta_x, 0, 0)))
+			) - (
+				compute_avg_line_cost(costmap_,	actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(-delta_yaw)) * tf2::Vector3(delta_x, 0, 0)),
+													actual_pose * (tf2::Matrix3x3(createQuaternionFromYaw(-delta_yaw)) * tf2::Vector3(-delta_x, 0, 0)))
+			)) / (2 * delta_yaw);
+
+		// fill local plan later
+		nav_msgs::msg::Path local_path;
+		local_path.header.frame_id = m_local_frame;
+		local_path.header.stamp = m_odometry->header.stamp;
+
+		// compute obstacle distance
+		NEO_TRACEPOINT(phase, "neo_local_planner", "obstacle_distance", 0);
 		{
-			const double cost = compute_max_line_cost(costmap_, last_pose.getOrigin(), pose.getOrigin());
-
-			bool is_contained = false;
-			{
-				unsigned int dummy[2] = {};
-				is_contained = costmap_->worldToMap(pose.getOrigin().x(), pose.getOrigin().y(), dummy[0], dummy[1]);
+			// when slow, walk with larger steps and refine the step that hits an obstacle
+			const double min_delta_move = 0.05;
+			double delta_move = min_delta_move;
+			if(adaptive_evaluation && adaptive_full_speed > 0) {
+				delta_move += fmax(max_obstacle_step - min_delta_move, 0) * (1 - fmin(start_speed / adaptive_full_speed, 1));
 			}
-			have_obstacle = cost >= max_cost;
-			obstacle_cost = fmax(obstacle_cost, cost);
 
-			{
-				geometry_msgs::msg::PoseStamped tmp;
-				auto tmp1 = tf2::toMsg(pose);
-				tmp.header = position.header;
-				tmp.pose.position.x = tmp1.translation.x;
-				tmp.pose.position.y = tmp1.translation.y;
-				tmp.pose.position.z = tmp1.translation.z;
-				tmp.pose.orientation.x = tmp1.rotation.x;
-				tmp.pose.orientation.y = tmp1.rotation.y;
-				tmp.pose.orientation.z = tmp1.rotation.z;
-				tmp.pose.orientation.w = tmp1.rotation.w;
-				local_path.poses.push_back(tmp);
-			}
-			if(!is_contained || have_obstacle) {
-				break;
-			}
+			tf2::Transform pose = actual_pose;
+			tf2::Transform last_pose = pose;
 
-			last_pose = pose;
-			if(!m_allow_reversing) {
-				pose = tf2::Transform(createQuaternionFromYaw(tf2::getYaw(pose.getRotation()) + start_yawrate * delta_time),
-						pose * tf2::Vector3(delta_move, 0, 0));	
-			}	else {
-				pose = tf2::Transform(createQuaternionFromYaw(tf2::getYaw(pose.getRotation()) + start_yawrate * delta_time),
-						pose * tf2::Vector3(m_robot_direction * delta_move, 0, 0));	
-			}
+			auto move = [&](const tf2::Transform& pose_) -> tf2::Transform {
+				const double delta_time = fabs(start_vel_x) > trans_stopped_vel ? (delta_move / fabs(start_vel_x)) : 0;
+				return tf2::Transform(createQuaternionFromYaw(tf2::getYaw(pose_.getRotation()) + start_yawrate * delta_time),
+							pose_ * tf2::Vector3((m_allow_reversing ? m_robot_direction : 1.0) * delta_move, 0, 0));
+			};
 
-			obstacle_dist += delta_move;
+			while(obstacle_dist < 10)
+			{
+				const double cost = compute_max_line_cost(costmap_, last_pose.getOrigin(), pose.getOrigin());
+
+				bool is_contained = false;
+				{
+					unsigned int dummy[2] = {};
+					is_contained = costmap_->worldToMap(pose.getOrigin().x(), pose.getOrigin().y(), dummy[0], dummy[1]);
+				}
+				have_obstacle = cost >= max_cost;
+				obstacle_cost = fmax(obstacle_cost, cost);
+
+				if(have_obstacle && delta_move > min_delta_move && obstacle_dist > 0)
+				{
+					// walk the last step again at full resolution
+					obstacle_dist -= delta_move;
+					delta_move = min_delta_move;
+					pose = move(last_pose);
+					obstacle_dist += delta_move;
+					continue;
+				}
+
+				{
+					geometry_msgs::msg::PoseStamped tmp;
+					auto tmp1 = tf2::toMsg(pose);
+					tmp.header = position.header;
+					tmp.pose.position.x = tmp1.translation.x;
+					tmp.pose.position.y = tmp1.translation.y;
+					tmp.pose.position.z = tmp1.translation.z;
+					tmp.pose.orientation.x = tmp1.rotation.x;
+					tmp.pose.orientation.y = tmp1.rotation.y;
+					tmp.pose.orientation.z = tmp1.rotation.z;
+					tmp.pose.orientation.w = tmp1.rotation.w;
+					local_path.poses.push_back(tmp);
+				}
+				if(!is_contained || have_obstacle) {
+					break;
+				}
+
+				last_pose = pose;
+				pose = move(pose);
+
+				obstacle_dist += delta_move;
+			}
 		}
+		m_local_plan_pub->publish(local_path);
+
+		m_evaluation.valid = true;
+		m_evaluation.time = time_now;
+		m_evaluation.pose = actual_pose;
+		m_evaluation.center_cost = center_cost;
+		m_evaluation.delta_cost_x = delta_cost_x;
+		m_evaluation.delta_cost_y = delta_cost_y;
+		m_evaluation.delta_cost_yaw = delta_cost_yaw;
+		m_evaluation.have_obstacle = have_obstacle;
+		m_evaluation.obstacle_dist = obstacle_dist;
+		m_evaluation.obstacle_cost = obstacle_cost;
+		m_num_evaluations++;
+	}
+	else
+	{
+		// reuse last evaluation, assume we moved straight towards the obstacle since then
+		NEO_TRACEPOINT(phase, "neo_local_planner", "reuse_evaluation", 0);
+		center_cost = m_evaluation.center_cost;
+		delta_cost_x = m_evaluation.delta_cost_x;
+		delta_cost_y = m_evaluation.delta_cost_y;
+		delta_cost_yaw = m_evaluation.delta_cost_yaw;
+		have_obstacle = m_evaluation.have_obstacle;
+		obstacle_dist = m_evaluation.obstacle_dist - (actual_pos - m_evaluation.pose.getOrigin()).length();
+		obstacle_cost = m_evaluation.obstacle_cost;
+		m_num_reused_evaluations++;
+	}
+
+	if(adaptive_evaluation) {
+		RCLCPP_DEBUG_THROTTLE(logger_, *clock_, 10000, "Costmap evaluations: %llu full, %llu reused",
+				(unsigned long long)m_num_evaluations, (unsigned long long)m_num_reused_evaluations);
 	}
-	m_local_plan_pub->publish(local_path);
 
 	obstacle_dist -= min_stop_dist;
 
@@ -361,39 +393,37 @@ geometry_msgs::msg::TwistStamped NeoLocalPlanner::computeVelocityCommands(
 	const double max_trans_vel = fmax(max_vel_trans * (max_cost - center_cost) / max_cost, min_vel_trans);
 	const double max_rot_vel = fmax(max_vel_theta * (max_cost - center_cost) / max_cost, min_vel_theta);
 
-	// find closest point on path to future position
-	auto iter_target = find_closest_point(local_plan.cbegin(), local_plan.cend(), actual_pos);
+	// find closest point on path to future position, searching around the last target first
+	const tf2::Vector3 global_actual_pos = global_to_local.inverse() * actual_pos;
+	const double target_s = m_plan_spline.project(global_actual_pos.x(), global_actual_pos.y(),
+										m_last_target_s, max_goal_dist + lookahead_dist + 1.0);
+	m_last_target_s = target_s;
 
-	// check if goal target
-	bool is_goal_target = false;
-	{
-		// check if goal is within reach
-		auto iter_next = move_along_path(iter_target, local_plan.cend(), max_goal_dist);
-		is_goal_target = iter_next + 1 >= local_plan.cend();
+	// check if goal is within reach
+	const bool is_goal_target = target_s + max_goal_dist >= m_plan_spline.length();
 
-		if(is_goal_target)
-		{
-			// go straight to goal
-			iter_target = iter_next;
-		}
-	}
-	// figure out target orientation
+	// figure out target position and orientation
+	tf2::Vector3 target_pos;
 	double target_yaw = 0;
 	if(is_goal_target)
 	{
-		// take goal orientation
-		target_yaw = tf2::getYaw(iter_target->getRotation());
+		// go straight to goal, take goal orientation
+		target_pos = local_goal.getOrigin();
+		target_yaw = tf2::getYaw(local_goal.getRotation());
 	}
 	else
 	{
 		// compute path based target orientation
-		auto iter_next = move_along_path(iter_target, local_plan.cend(), lookahead_dist);
-		target_yaw = ::atan2(	iter_next->getOrigin().y() - iter_target->getOrigin().y(),
-								iter_next->getOrigin().x() - iter_target->getOrigin().x());
+		const PathSpline::point_t target = m_plan_spline.evaluate(target_s);
+		const PathSpline::point_t next = m_plan_spline.evaluate(target_s + lookahead_dist);
+		target_pos = global_to_local * tf2::Vector3(target.x, target.y, 0);
+		const tf2::Vector3 next_pos = global_to_local * tf2::Vector3(next.x, next.y, 0);
+		if((next_pos - target_pos).length() > 1e-3) {
+			target_yaw = ::atan2(next_pos.y() - target_pos.y(), next_pos.x() - target_pos.x());
+		} else {
+			target_yaw = target.yaw + tf2::getYaw(global_to_local.getRotation());
+		}
 	}
-
-	// get target position
-	const tf2::Vector3 target_pos = iter_target->getOrigin();
 	double yaw_error = 0.0;
 
 	if(m_robot_direction==1 or is_goal_target) {
@@ -412,7 +442,8 @@ geometry_msgs::msg::TwistStamped NeoLocalPlanner::computeVelocityCommands(
 	}
 
 	// compute errors
-	const double goal_dist = (local_plan.back().getOrigin() - actual_pos).length();
+	NEO_TRACEPOINT(phase, "neo_local_planner", "control", 0);
+	const double goal_dist = (local_goal.getOrigin() - actual_pos).length();
 	const tf2::Vector3 pos_error = tf2::Transform(createQuaternionFromYaw(actual_yaw), actual_pos).inverse() * target_pos;
 
 	// compute control values
@@ -610,6 +641,7 @@ geometry_msgs::msg::TwistStamped NeoLocalPlanner::computeVelocityCommands(
 	is_emergency_brake = is_emergency_brake && fabs(control_vel_x) >= 0;
 
 	// apply low pass filter
+	NEO_TRACEPOINT(phase, "neo_local_planner", "limits", 0);
 
 	control_vel_x = control_vel_x * low_pass_gain + m_last_control_values[0] * (1 - low_pass_gain);
 	control_vel_y = control_vel_y * low_pass_gain + m_last_control_values[1] * (1 - low_pass_gain);
@@ -687,6 +719,7 @@ void NeoLocalPlanner::deactivate()
 {
 	m_local_plan_pub->on_deactivate();
 	dyn_params_handler_.reset();
+	m_evaluation.valid = false;
 }
 
 rcl_interfaces::msg::SetParametersResult
@@ -773,9 +806,27 @@ NeoLocalPlanner::dynamicParametersCallback(
         min_stop_dist = parameter.as_double();
       } else if (param_name == plugin_name_ + ".emergency_acc_lim_x") {
         emergency_acc_lim_x = parameter.as_double(); 
+      } else if (param_name == plugin_name_ + ".spline_resolution") {
+        spline_resolution = parameter.as_double();
+      } else if (param_name == plugin_name_ + ".min_evaluation_rate") {
+        min_evaluation_rate = parameter.as_double();
+      } else if (param_name == plugin_name_ + ".adaptive_full_speed") {
+        adaptive_full_speed = parameter.as_double();
+      } else if (param_name == plugin_name_ + ".adaptive_obstacle_dist") {
+        adaptive_obstacle_dist = parameter.as_double();
+      } else if (param_name == plugin_name_ + ".adaptive_max_move") {
+        adaptive_max_move = parameter.as_double();
+      } else if (param_name == plugin_name_ + ".max_obstacle_step") {
+        max_obstacle_step = parameter.as_double();
+      }
+    } else if (param_type == ParameterType::PARAMETER_BOOL) {
+      if (param_name == plugin_name_ + ".adaptive_evaluation") {
+        adaptive_evaluation = parameter.as_bool();
       }
     }
   }
+  // costs and obstacle distance depend on the parameters
+  m_evaluation.valid = false;
   result.successful = true;
   return result;
 }
@@ -801,8 +852,22 @@ bool NeoLocalPlanner::reset_lastvel(nav_msgs::msg::Path m_global_plan, nav_msgs:
 
 void NeoLocalPlanner::setPlan(const nav_msgs::msg::Path & plan)
 {
+	std::lock_guard<std::mutex> lock_reinit(m_mutex);
+
 	m_reset_lastvel = reset_lastvel(m_global_plan, plan);
 	m_global_plan = plan;
+
+	// fit the splines once, the control loop only evaluates them
+	std::vector<double> path_x, path_y;
+	path_x.reserve(plan.poses.size());
+	path_y.reserve(plan.poses.size());
+	for(const auto& pose : plan.poses) {
+		path_x.push_back(pose.pose.position.x);
+		path_y.push_back(pose.pose.position.y);
+	}
+	m_plan_spline.fit(path_x, path_y, spline_resolution);
+	m_last_target_s = -1;
+	m_evaluation.valid = false;
 }
 
 void NeoLocalPlanner::setSpeedLimit(
@@ -856,6 +921,13 @@ void NeoLocalPlanner::configure(const rclcpp_lifecycle::LifecycleNode::WeakPtr &
 	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".max_backup_dist", rclcpp::ParameterValue(0.2));
 	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".min_stop_dist",rclcpp::ParameterValue(0.2));
 	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".emergency_acc_lim_x",rclcpp::ParameterValue(0.2));
+	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".spline_resolution",rclcpp::ParameterValue(0.2));
+	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".adaptive_evaluation", rclcpp::ParameterValue(false));
+	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".min_evaluation_rate",rclcpp::ParameterValue(5.0));
+	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".adaptive_full_speed",rclcpp::ParameterValue(0.3));
+	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".adaptive_obstacle_dist",rclcpp::ParameterValue(1.0));
+	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".adaptive_max_move",rclcpp::ParameterValue(0.05));
+	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".max_obstacle_step",rclcpp::ParameterValue(0.2));
 	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".differential_drive", rclcpp::ParameterValue(true));
 	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".constrain_final", rclcpp::ParameterValue(false));
 	nav2_util::declare_parameter_if_not_declared(node,plugin_name_ + ".allow_reversing", rclcpp::ParameterValue(false));
@@ -903,6 +975,13 @@ void NeoLocalPlanner::configure(const rclcpp_lifecycle::LifecycleNode::WeakPtr &
 	node->get_parameter_or(plugin_name_ + ".max_backup_dist", max_backup_dist, 0.5);
 	node->get_parameter_or(plugin_name_ + ".min_stop_dist", min_stop_dist, 0.5);
 	node->get_parameter_or(plugin_name_ + ".emergency_acc_lim_x", emergency_acc_lim_x, 0.5);
+	node->get_parameter_or(plugin_name_ + ".spline_resolution", spline_resolution, 0.2);
+	node->get_parameter_or(plugin_name_ + ".adaptive_evaluation", adaptive_evaluation, false);
+	node->get_parameter_or(plugin_name_ + ".min_evaluation_rate", min_evaluation_rate, 5.0);
+	node->get_parameter_or(plugin_name_ + ".adaptive_full_speed", adaptive_full_speed, 0.3);
+	node->get_parameter_or(plugin_name_ + ".adaptive_obstacle_dist", adaptive_obstacle_dist, 1.0);
+	node->get_parameter_or(plugin_name_ + ".adaptive_max_move", adaptive_max_move, 0.05);
+	node->get_parameter_or(plugin_name_ + ".max_obstacle_step", max_obstacle_step, 0.2);
 	node->get_parameter_or(plugin_name_ + ".differential_drive", differential_drive, true);
 	node->get_parameter_or(plugin_name_ + ".allow_reversing", m_allow_reversing, false);
 	node->get_parameter_or(plugin_name_ + ".constrain_final", constrain_final, false);
@@ -0,0 +1,149 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016, Neobotix GmbH
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the Neobotix nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "PathSpline.h"
+
+#include <cmath>
+#include <vector>
+
+using neo_local_planner::PathSpline;
+
+
+TEST(PathSpline, Empty)
+{
+	PathSpline spline;
+	spline.fit({}, {}, 0.1);
+	EXPECT_TRUE(spline.empty());
+	EXPECT_EQ(spline.length(), 0);
+	EXPECT_EQ(spline.project(1, 1, -1, 1), 0);
+}
+
+TEST(PathSpline, SinglePoint)
+{
+	PathSpline spline;
+	spline.fit({1, 1}, {2, 2}, 0.1);
+	ASSERT_FALSE(spline.empty());
+	EXPECT_EQ(spline.length(), 0);
+
+	const PathSpline::point_t p = spline.evaluate(0.5);
+	EXPECT_DOUBLE_EQ(p.x, 1);
+	EXPECT_DOUBLE_EQ(p.y, 2);
+	EXPECT_EQ(spline.project(3, 3, -1, 1), 0);
+}
+
+TEST(PathSpline, StraightLine)
+{
+	PathSpline spline;
+	spline.fit({0, 0.5, 2}, {0, 0, 0}, 0.1);
+	EXPECT_NEAR(spline.length(), 2, 1e-12);
+
+	for(double s = 0; s <= 2; s += 0.05)
+	{
+		const PathSpline::point_t p = spline.evaluate(s);
+		EXPECT_NEAR(p.x, s, 1e-9);
+		EXPECT_NEAR(p.y, 0, 1e-9);
+		EXPECT_NEAR(p.yaw, 0, 1e-9);
+	}
+
+	// clamped to the ends
+	EXPECT_NEAR(spline.evaluate(-1).x, 0, 1e-9);
+	EXPECT_NEAR(spline.evaluate(5).x, 2, 1e-9);
+}
+
+TEST(PathSpline, PassesThroughKnots)
+{
+	// L-shape of length 2, resampled every 0.5 m
+	PathSpline spline;
+	spline.fit({0, 1, 1}, {0, 0, 1}, 0.5);
+	EXPECT_NEAR(spline.length(), 2, 1e-12);
+
+	const double knot_x[] = {0, 0.5, 1, 1, 1};
+	const double knot_y[] = {0, 0, 0, 0.5, 1};
+	for(int k = 0; k < 5; ++k)
+	{
+		const PathSpline::point_t p = spline.evaluate(k * 0.5);
+		EXPECT_NEAR(p.x, knot_x[k], 1e-9) << "knot " << k;
+		EXPECT_NEAR(p.y, knot_y[k], 1e-9) << "knot " << k;
+	}
+}
+
+TEST(PathSpline, Circle)
+{
+	// quarter of the unit circle, counter clockwise
+	std::vector<double> path_x, path_y;
+	for(int i = 0; i <= 100; ++i) {
+		path_x.push_back(::cos(i * M_PI / 200));
+		path_y.push_back(::sin(i * M_PI / 200));
+	}
+	PathSpline spline;
+	spline.fit(path_x, path_y, 0.05);
+	EXPECT_NEAR(spline.length(), M_PI / 2, 1e-3);
+
+	for(double s = 0.1; s < 1.5; s += 0.1)
+	{
+		const PathSpline::point_t p = spline.evaluate(s);
+		const double angle = ::atan2(p.y, p.x);
+		EXPECT_NEAR(::hypot(p.x, p.y), 1, 1e-3);
+		EXPECT_NEAR(angle, s, 1e-3);
+		EXPECT_NEAR(p.yaw, angle + M_PI / 2, 1e-2);
+	}
+}
+
+TEST(PathSpline, Project)
+{
+	PathSpline spline;
+	spline.fit({0, 1, 1}, {0, 0, 1}, 0.1);
+
+	// whole path
+	EXPECT_NEAR(spline.project(0.3, -0.2, -1, 0.5), 0.3, 1e-9);
+	EXPECT_NEAR(spline.project(1.4, 0.6, -1, 0.5), 1.6, 1e-9);
+
+	// clamped to the ends
+	EXPECT_NEAR(spline.project(-1, 0, -1, 0.5), 0, 1e-9);
+	EXPECT_NEAR(spline.project(1, 3, -1, 0.5), 2, 1e-9);
+
+	// hint close by
+	EXPECT_NEAR(spline.project(0.7, 0.1, 0.6, 0.5), 0.7, 1e-9);
+
+	// hint too far away, falls back to the whole path
+	EXPECT_NEAR(spline.project(1.1, 0.9, 0.1, 0.3), 1.9, 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,188 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_LOCALIZATION_LIVEMAP_H_
+#define INCLUDE_NEO_LOCALIZATION_LIVEMAP_H_
+
+#include <neo_localization/GridMap.h>
+#include <neo_localization/Util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+
+/*
+ * Low resolution layer of recent scan evidence, covering a fixed size window of the world map.
+ *
+ * Points of well localized scans are added with GridMap::bilinear_summation(), so an update is
+ * O(points). All cells decay by a common factor per update, which is applied lazily by scaling
+ * the values added instead of the whole grid, i.e. the real value of a cell is m_grid * m_gain.
+ * Memory is bounded by the window size, cells leaving the window when it moves are dropped.
+ */
+class LiveMap {
+public:
+  /*
+   * @param size Size of the window in pixels
+   * @param scale Size of one pixel in meters
+   */
+  LiveMap(int size, float scale)
+    : m_grid(size, size, scale)
+  {
+    reset();
+  }
+
+  /*
+   * Removes all evidence.
+   */
+  void reset()
+  {
+    m_grid.clear(0);
+    m_gain = 1;
+  }
+
+  float scale() const {
+    return m_grid.scale();
+  }
+
+  int size() const {
+    return m_grid.size_x();
+  }
+
+  /*
+   * Moves the window so that its lower left corner is close to (x, y) in world coordinates [m].
+   * The evidence inside the overlapping area is kept.
+   */
+  void move_to(double x, double y)
+  {
+    const int64_t new_x = std::floor(x / scale());
+    const int64_t new_y = std::floor(y / scale());
+    const int64_t dx = new_x - m_origin_x;
+    const int64_t dy = new_y - m_origin_y;
+    if(dx == 0 && dy == 0) {
+      return;
+    }
+    const int size = m_grid.size_x();
+    if(std::abs(dx) >= size || std::abs(dy) >= size) {
+      m_grid.clear(0);
+    } else {
+      GridMap<float> tmp(m_grid);
+      for(int v = 0; v < size; ++v) {
+        for(int u = 0; u < size; ++u) {
+          const int64_t u_ = u + dx;
+          const int64_t v_ = v + dy;
+          m_grid(u, v) = (u_ >= 0 && u_ < size && v_ >= 0 && v_ < size) ? tmp(u_, v_) : 0;
+        }
+      }
+    }
+    m_origin_x = new_x;
+    m_origin_y = new_y;
+  }
+
+  /*
+   * Decays all evidence by 'decay', then adds 'gain' for every point (x, y) in world coordinates [m].
+   * Cells saturate at 'max_value'.
+   */
+  void integrate(const std::vector<Matrix<double, 2, 1>>& points, float gain, float decay, float max_value)
+  {
+    m_gain *= decay;
+    if(m_gain < 1e-3f) {
+      normalize();
+    }
+    const float value = gain / m_gain;
+    const float max_stored = max_value / m_gain;
+    const int size = m_grid.size_x();
+
+    for(const auto& point : points)
+    {
+      const float u = m_grid.world_to_grid(point[0] - m_origin_x * double(scale()));
+      const float v = m_grid.world_to_grid(point[1] - m_origin_y * double(scale()));
+      if(u < 0 || v < 0 || u >= size - 1 || v >= size - 1) {
+        continue;
+      }
+      m_grid.bilinear_summation(u, v, value);
+
+      // saturate, so that evidence of an obstacle which was removed does not take forever to decay
+      const int u0 = u;
+      const int v0 = v;
+      for(int j = 0; j <= 1; ++j) {
+        for(int i = 0; i <= 1; ++i) {
+          float& cell = m_grid(u0 + i, v0 + j);
+          cell = std::min(cell, max_stored);
+        }
+      }
+    }
+  }
+
+  /*
+   * Returns the evidence at (x, y) in world coordinates [m], zero outside of the window.
+   */
+  float lookup(double x, double y) const
+  {
+    const float u = m_grid.world_to_grid(x - m_origin_x * double(scale()));
+    const float v = m_grid.world_to_grid(y - m_origin_y * double(scale()));
+    const int size = m_grid.size_x();
+    if(u < -0.5f || v < -0.5f || u > size - 0.5f || v > size - 0.5f) {
+      return 0;
+    }
+    return m_grid.bilinear_lookup(u, v) * m_gain;
+  }
+
+  /*
+   * Blends the evidence into the given map tile, using max(tile, weight * evidence).
+   * (tile_x, tile_y) is the lower left corner of the tile in world coordinates [m].
+   */
+  void blend(GridMap<float>& tile, double tile_x, double tile_y, float weight) const
+  {
+    const double tile_scale = tile.scale();
+    for(int y = 0; y < tile.size_y(); ++y) {
+      for(int x = 0; x < tile.size_x(); ++x) {
+        const float value = weight * lookup(tile_x + (x + 0.5) * tile_scale, tile_y + (y + 0.5) * tile_scale);
+        tile(x, y) = std::max(tile(x, y), value);
+      }
+    }
+  }
+
+private:
+  /*
+   * Applies the pending decay to all cells.
+   */
+  void normalize()
+  {
+    for(size_t i = 0; i < m_grid.num_cells(); ++i) {
+      m_grid[i] *= m_gain;
+    }
+    m_gain = 1;
+  }
+
+  GridMap<float> m_grid;
+  float m_gain = 1;         // real value = stored value * m_gain
+  int64_t m_origin_x = 0;     // window origin in pixels
+  int64_t m_origin_y = 0;
+
+};
+
+
+#endif /* INCLUDE_NEO_LOCALIZATION_LIVEMAP_H_ */
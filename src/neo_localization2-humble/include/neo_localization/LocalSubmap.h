@@ -0,0 +1,176 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_LOCALIZATION_LOCALSUBMAP_H_
+#define INCLUDE_NEO_LOCALIZATION_LOCALSUBMAP_H_
+
+#include <neo_localization/GridMap.h>
+#include <neo_localization/Solver.h>
+#include <neo_localization/Util.h>
+
+#include <angles/angles.h>
+
+#include <cmath>
+#include <deque>
+#include <vector>
+
+
+/*
+ * Rolling submap built from the last scans, used to keep tracking when the map does not match.
+ *
+ * Scans are added as keyframes at their (map frame) pose, the oldest keyframe is dropped when
+ * the maximum is reached. The grid is rendered like a map tile, ie. occupied cells are set to 1
+ * and then smoothed num_smooth times, so that the Solver can match against it unchanged.
+ * It is only rendered again when a keyframe was added or the robot moved away from its center.
+ */
+class LocalSubmap {
+public:
+  /*
+   * @param size Size of the submap in pixels
+   * @param scale Size of one pixel in meters
+   * @param max_scans Maximum number of keyframes
+   * @param num_smooth Number of smoothing iterations
+   */
+  LocalSubmap(int size, float scale, int max_scans, int num_smooth)
+    : m_grid(size, size, scale),
+      m_max_scans(max_scans),
+      m_num_smooth(num_smooth)
+  {
+    reset();
+  }
+
+  /*
+   * Removes all keyframes.
+   */
+  void reset()
+  {
+    m_scans.clear();
+    m_grid.clear(0);
+    m_dirty = false;
+  }
+
+  size_t num_scans() const {
+    return m_scans.size();
+  }
+
+  /*
+   * Returns true if the pose [x, y, yaw] is far enough from the last keyframe to add a new one.
+   */
+  bool need_keyframe(const Matrix<double, 3, 1>& pose, double min_dist, double min_yaw) const
+  {
+    if(m_scans.empty()) {
+      return true;
+    }
+    const auto& last = m_scans.back().pose;
+    return (pose.get<2>() - last.get<2>()).norm() >= min_dist
+        || fabs(angles::shortest_angular_distance(last[2], pose[2])) >= min_yaw;
+  }
+
+  /*
+   * Adds a keyframe, points are given relative to the pose [x, y, yaw] in map frame.
+   */
+  void add_scan(const std::vector<scan_point_t>& points, const Matrix<double, 3, 1>& pose)
+  {
+    if(m_scans.size() >= size_t(m_max_scans)) {
+      m_scans.pop_front();
+    }
+    m_scans.emplace_back();
+    auto& scan = m_scans.back();
+    scan.pose = pose;
+
+    const Matrix<double, 3, 3> P = transform2(pose);
+    scan.points.reserve(points.size());
+    for(const auto& point : points) {
+      const auto q = (P * Matrix<double, 3, 1>{point.x, point.y, 1}).project();
+      scan.points.emplace_back(Matrix<double, 2, 1>{q[0], q[1]});
+    }
+    m_dirty = true;
+  }
+
+  /*
+   * Renders the grid around (x, y) in map frame if needed, returns the grid.
+   * Its lower left corner in map frame is given by origin_x() and origin_y().
+   */
+  const GridMap<float>& update(double x, double y)
+  {
+    const double half_size = 0.5 * m_grid.size_x() * m_grid.scale();
+    const double dist = Matrix<double, 2, 1>{x - (m_origin_x + half_size), y - (m_origin_y + half_size)}.norm();
+    if(m_dirty || dist > 0.5 * half_size) {
+      render(x - half_size, y - half_size);
+    }
+    return m_grid;
+  }
+
+  const GridMap<float>& grid() const {
+    return m_grid;
+  }
+
+  double origin_x() const {
+    return m_origin_x;
+  }
+
+  double origin_y() const {
+    return m_origin_y;
+  }
+
+private:
+  struct keyframe_t {
+    Matrix<double, 3, 1> pose;            // [x, y, yaw] in map frame
+    std::vector<Matrix<double, 2, 1>> points;   // in map frame
+  };
+
+  void render(double origin_x, double origin_y)
+  {
+    m_origin_x = origin_x;
+    m_origin_y = origin_y;
+    m_grid.clear(0);
+
+    const int size = m_grid.size_x();
+    for(const auto& scan : m_scans) {
+      for(const auto& point : scan.points) {
+        const int u = std::floor((point[0] - origin_x) * m_grid.inv_scale());
+        const int v = std::floor((point[1] - origin_y) * m_grid.inv_scale());
+        if(u >= 0 && v >= 0 && u < size && v < size) {
+          m_grid(u, v) = 1;
+        }
+      }
+    }
+    for(int i = 0; i < m_num_smooth; ++i) {
+      m_grid.smooth_33_1();
+    }
+    m_dirty = false;
+  }
+
+  GridMap<float> m_grid;
+  std::deque<keyframe_t> m_scans;
+  int m_max_scans = 0;
+  int m_num_smooth = 0;
+  bool m_dirty = false;
+  double m_origin_x = 0;      // lower left corner of the grid in map frame [m]
+  double m_origin_y = 0;
+
+};
+
+
+#endif /* INCLUDE_NEO_LOCALIZATION_LOCALSUBMAP_H_ */
@@ -0,0 +1,1376 @@
+/*
+MIT License
+
+Copyright (c) 2020 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_LOCALIZATION_NEOLOCALIZATIONNODE_H_
+#define INCLUDE_NEO_LOCALIZATION_NEOLOCALIZATIONNODE_H_
+
+#include <neo_localization/Util.h>
+#include <neo_localization/Convert.h>
+#include <neo_localization/Solver.h>
+#include <neo_localization/GridMap.h>
+#include <neo_localization/LiveMap.h>
+#include <neo_localization/LocalSubmap.h>
+#include <neo_localization/ThreadPool.h>
+#include <neo_localization/TileCache.h>
+#include <neo_localization/TilePrefetcher.h>
+#include <neo_tracetools/tracetools.h>
+
+#include "rclcpp/rclcpp.hpp"
+#include <rclcpp/node_options.hpp>
+
+#include <angles/angles.h>
+#include <nav_msgs/msg/odometry.h>
+#include <nav_msgs/msg/occupancy_grid.h>
+#include <nav_msgs/msg/path.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <std_srvs/srv/empty.hpp>
+#include <geometry_msgs/msg/quaternion.h>
+#include <geometry_msgs/msg/pose_array.hpp>
+#include <geometry_msgs/msg/transform_stamped.h>
+#include <geometry_msgs/msg/pose_with_covariance_stamped.h>
+#include <tf2_ros/transform_listener.h>
+#include <tf2_ros/transform_broadcaster.h>
+#include <tf2/LinearMath/Transform.h>
+#include <tf2_ros/buffer.h>
+#include <tf2_ros/create_timer_ros.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+
+/*
+ * Coordinate systems:
+ * - Sensor in [meters, rad], aka. "laserX"
+ * - Base Link in [meters, rad], aka. "base_link"
+ * - Odometry in [meters, rad], aka. "odom"
+ * - Map in [meters, rad], aka. "map"
+ * - World Grid in [meters, rad], aka. "world"
+ * - Tile Grid in [meters, rad], aka. "grid"
+ * - World Grid in [pixels]
+ * - Tile Grid in [pixels]
+ *
+ */
+
+/*
+ * State shared by several localization instances running in one process on the same map.
+ */
+struct NeoLocalizationShared {
+  std::unique_ptr<ThreadPool> pool;   // runs loc_update() and update_map() of all instances
+  TileCache tiles;            // smoothed map tiles, shared between instances
+  int tile_step = 0;          // tile origins are multiples of this [pixels], 0 = map_size / 4
+};
+
+
+class NeoLocalizationNode : public rclcpp::Node {
+public:
+  /*
+   * Standalone mode if 'shared' is null: subscribes to the map and runs its own map update thread.
+   * Otherwise the map is given via set_map() and all updates run on the shared thread pool.
+   */
+  explicit NeoLocalizationNode(const std::string& node_namespace = "",
+                 std::shared_ptr<NeoLocalizationShared> shared = nullptr)
+    : Node("neo_localization_node", node_namespace),
+      m_shared(shared)
+  {
+    this->declare_parameter<bool>("broadcast_tf", true);
+    this->get_parameter_or("broadcast_tf", m_broadcast_tf, true);
+
+    this->declare_parameter<std::string>("base_frame", "base_link");
+    this->get_parameter("base_frame", m_base_frame);
+
+    this->declare_parameter<std::string>("odom_frame", "odom");
+    this->get_parameter("odom_frame", m_odom_frame);
+
+    this->declare_parameter<std::string>("map_frame", "map");
+    this->get_parameter("map_frame", m_map_frame);
+
+    this->declare_parameter<std::string>("map_topic", "map");
+    this->get_parameter("map_topic", m_map_topic);
+
+    this->declare_parameter<int>("map_size", 1000);
+    this->get_parameter("map_size", m_map_size);
+
+    this->declare_parameter<int>("map_downscale", 0);
+    this->get_parameter("map_downscale", m_map_downscale);
+
+    this->declare_parameter<int>("num_smooth", 5);
+    this->get_parameter("num_smooth", m_num_smooth);
+
+    this->declare_parameter<int>("sample_rate", 5);
+    this->get_parameter("sample_rate", m_sample_rate);
+
+    this->declare_parameter<int>("solver_iterations", 5);
+    this->get_parameter("solver_iterations", m_solver_iterations);
+
+    this->declare_parameter<int>("min_points", 5);
+    this->get_parameter("min_points", m_min_points);
+
+    this->declare_parameter<double>("map_update_rate", 0.5);
+    this->get_parameter("map_update_rate", m_map_update_rate);
+
+    this->declare_parameter<int>("loc_update_time", 100.);
+    this->get_parameter("loc_update_time", m_loc_update_time_ms);
+
+    this->declare_parameter<double>("min_score", 0.2);
+    this->get_parameter("min_score", m_min_score);
+
+    this->declare_parameter<double>("solver_gain", 0.1);
+    this->get_parameter("solver_gain", m_solver.gain);
+
+    this->declare_parameter<double>("solver_damping", 1000);
+    this->get_parameter("solver_damping", m_solver.damping);
+
+    this->declare_parameter<double>("update_gain", 0.5);
+    this->get_parameter("update_gain", m_update_gain);
+
+    this->declare_parameter<double>("confidence_gain", 0.01);
+    this->get_parameter("confidence_gain", m_confidence_gain);
+
+    this->declare_parameter<double>("odometry_std_xy", 0.01);
+    this->get_parameter("odometry_std_xy", m_odometry_std_xy);
+
+    this->declare_parameter<double>("odometry_std_yaw", 0.01);
+    this->get_parameter("odometry_std_yaw", m_odometry_std_yaw);
+
+    this->declare_parameter<double>("min_sample_std_xy", 0.025);
+    this->get_parameter("min_sample_std_xy", m_min_sample_std_xy);
+
+    this->declare_parameter<double>("min_sample_std_yaw", 0.025);
+    this->get_parameter("min_sample_std_yaw", m_min_sample_std_yaw);
+
+    this->declare_parameter<double>("max_sample_std_xy", 0.5);
+    this->get_parameter("max_sample_std_xy", m_max_sample_std_xy);
+
+    this->declare_parameter<double>("max_sample_std_yaw", 0.5);
+    this->get_parameter("max_sample_std_yaw", m_max_sample_std_yaw);
+
+    this->declare_parameter<double>("constrain_threshold", 0.1);
+    this->get_parameter("constrain_threshold", m_constrain_threshold);
+
+    this->declare_parameter<double>("constrain_threshold_yaw", 0.2);
+    this->get_parameter("constrain_threshold_yaw", m_constrain_threshold_yaw);
+
+    this->declare_parameter<double>("transform_timeout", 0.2);
+    this->get_parameter("transform_timeout", m_transform_timeout);
+
+    this->declare_parameter<std::string>("scan_topic", "scan");
+    this->get_parameter("scan_topic", m_scan_topic);
+
+    this->declare_parameter<std::string>("initialpose", "initialpose");
+    this->get_parameter("initialpose", m_initial_pose);
+
+    this->declare_parameter<std::string>("map_tile", "map_tile");
+    this->get_parameter("map_tile", m_map_tile);
+
+    this->declare_parameter<std::string>("map_pose", "map_pose");
+    this->get_parameter("map_pose", m_map_pose);
+
+    this->declare_parameter<std::string>("particle_cloud", "particlecloud");
+    this->get_parameter("particle_cloud", m_particle_cloud);
+
+    this->declare_parameter<std::string>("amcl_pose", "amcl_pose");
+    this->get_parameter("amcl_pose", m_amcl_pose);
+
+    this->declare_parameter<bool>("broadcast_info", false);
+    this->get_parameter("broadcast_info", m_broadcast_info);
+
+    this->declare_parameter<bool>("live_map", false);
+    this->get_parameter("live_map", m_live_map_enable);
+
+    this->declare_parameter<int>("live_map_downscale", 2);
+    this->get_parameter("live_map_downscale", m_live_map_downscale);
+
+    this->declare_parameter<double>("live_map_gain", 0.05);
+    this->get_parameter("live_map_gain", m_live_map_gain);
+
+    this->declare_parameter<double>("live_map_decay", 0.995);
+    this->get_parameter("live_map_decay", m_live_map_decay);
+
+    this->declare_parameter<double>("live_map_weight", 0.8);
+    this->get_parameter("live_map_weight", m_live_map_weight);
+
+    this->declare_parameter<double>("live_map_min_score", 0.5);
+    this->get_parameter("live_map_min_score", m_live_map_min_score);
+
+    this->declare_parameter<bool>("local_tracking", false);
+    this->get_parameter("local_tracking", m_local_tracking_enable);
+
+    this->declare_parameter<double>("local_tracking_range", 8.0);
+    this->get_parameter("local_tracking_range", m_local_tracking_range);
+
+    this->declare_parameter<int>("local_tracking_scans", 20);
+    this->get_parameter("local_tracking_scans", m_local_tracking_scans);
+
+    this->declare_parameter<double>("local_tracking_keyframe_dist", 0.25);
+    this->get_parameter("local_tracking_keyframe_dist", m_local_tracking_keyframe_dist);
+
+    this->declare_parameter<double>("local_tracking_keyframe_yaw", 0.2);
+    this->get_parameter("local_tracking_keyframe_yaw", m_local_tracking_keyframe_yaw);
+
+    this->declare_parameter<double>("local_tracking_min_score", 0.1);
+    this->get_parameter("local_tracking_min_score", m_local_tracking_min_score);
+
+    this->declare_parameter<int>("local_tracking_enter_count", 3);
+    this->get_parameter("local_tracking_enter_count", m_local_tracking_enter_count);
+
+    this->declare_parameter<int>("local_tracking_exit_count", 3);
+    this->get_parameter("local_tracking_exit_count", m_local_tracking_exit_count);
+
+    this->declare_parameter<bool>("prefetch_tiles", false);
+    this->get_parameter("prefetch_tiles", m_prefetch_enable);
+
+    this->declare_parameter<std::string>("prefetch_plan_topic", "plan");
+    this->get_parameter("prefetch_plan_topic", m_prefetch_plan_topic);
+
+    this->declare_parameter<double>("prefetch_distance", 30.0);
+    this->get_parameter("prefetch_distance", m_prefetch_distance);
+
+    this->declare_parameter<double>("prefetch_memory", 64.0);
+    this->get_parameter("prefetch_memory", m_prefetch_memory);
+
+    if(!m_shared) {
+      m_map_update_thread = std::thread(&NeoLocalizationNode::update_loop, this);
+    }
+
+    m_tf_broadcaster = std::make_shared<tf2_ros::TransformBroadcaster>(this);
+
+    m_sub_scan_topic = this->create_subscription<sensor_msgs::msg::LaserScan>(m_scan_topic, rclcpp::SensorDataQoS(), std::bind(&NeoLocalizationNode::scan_callback, this, std::placeholders::_1));
+    if(!m_shared) {
+      m_sub_map_topic = this->create_subscription<nav_msgs::msg::OccupancyGrid>("/map", rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(), std::bind(&NeoLocalizationNode::map_callback, this, std::placeholders::_1));
+    }
+    m_sub_pose_estimate = this->create_subscription<geometry_msgs::msg::PoseWithCovarianceStamped>(m_initial_pose, 1, std::bind(&NeoLocalizationNode::pose_callback, this, std::placeholders::_1));
+
+    if(m_prefetch_enable) {
+      m_sub_plan = this->create_subscription<nav_msgs::msg::Path>(m_prefetch_plan_topic, 1, std::bind(&NeoLocalizationNode::plan_callback, this, std::placeholders::_1));
+    }
+
+    if(m_live_map_enable) {
+      m_srv_reset_live_map = this->create_service<std_srvs::srv::Empty>("~/reset_live_map",
+          std::bind(&NeoLocalizationNode::reset_live_map_callback, this, std::placeholders::_1, std::placeholders::_2));
+    }
+
+    m_pub_map_tile = this->create_publisher<nav_msgs::msg::OccupancyGrid>(m_map_tile, 1);
+    m_pub_loc_pose = this->create_publisher<geometry_msgs::msg::PoseWithCovarianceStamped>(m_amcl_pose, 10);
+    m_pub_loc_pose_2 = this->create_publisher<geometry_msgs::msg::PoseWithCovarianceStamped>(m_map_pose, 10);
+    m_pub_pose_array = this->create_publisher<geometry_msgs::msg::PoseArray>(m_particle_cloud, 10);
+
+    if(m_shared) {
+      m_loc_update_timer = create_wall_timer(
+                  std::chrono::milliseconds(m_loc_update_time_ms), std::bind(&NeoLocalizationNode::post_loc_update, this));
+      m_map_update_timer = create_wall_timer(
+                  std::chrono::duration<double>(1 / m_map_update_rate), std::bind(&NeoLocalizationNode::post_update_map, this));
+    } else {
+      m_loc_update_timer = create_wall_timer(
+                  std::chrono::milliseconds(m_loc_update_time_ms), std::bind(&NeoLocalizationNode::loc_update, this));
+    }
+
+
+    buffer = std::make_unique<tf2_ros::Buffer>(this->get_clock());
+
+    transform_listener_ = std::make_shared<tf2_ros::TransformListener>(*buffer);
+
+    std::string robot_namespace(this->get_namespace());
+
+    // removing the unnecessary "/" from the namespace
+    robot_namespace.erase(std::remove(robot_namespace.begin(), robot_namespace.end(), '/'), 
+    robot_namespace.end());
+
+    m_base_frame = robot_namespace + m_base_frame;
+    m_odom_frame = robot_namespace + m_odom_frame;
+  }
+
+  ~NeoLocalizationNode()
+  {
+    if(m_map_update_thread.joinable()) {
+      m_map_update_signal.notify_all();
+      m_map_update_thread.join();
+    }
+  }
+
+  /*
+   * Stores the given map, the message is shared and not copied.
+   */
+  void set_map(nav_msgs::msg::OccupancyGrid::ConstSharedPtr ros_map)
+  {
+    std::lock_guard<std::mutex> lock(m_node_mutex);
+    map_received_ = true;
+
+    RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationNode: Got new map with dimensions " << ros_map->info.width << " x " << ros_map->info.height
+        << " and cell size " << ros_map->info.resolution);
+
+    {
+      tf2::Transform tmp;
+      tf2::fromMsg(ros_map->info.origin, tmp);
+      m_world_to_map = convert_transform_25(tmp);
+    }
+    m_world = ros_map;
+    // reset particle spread to maximum
+    m_sample_std_xy = m_max_sample_std_xy;
+    m_sample_std_yaw = m_max_sample_std_yaw;
+
+    if(m_live_map_enable) {
+      // live map covers the same area as a map tile
+      const int downscale = std::max(m_live_map_downscale, 0);
+      m_live_map = std::make_unique<LiveMap>(std::max(m_map_size >> downscale, 2), ros_map->info.resolution * (1 << downscale));
+    }
+
+    if(m_local_tracking_enable) {
+      // same resolution as a map tile
+      const float scale = ros_map->info.resolution * (1 << std::max(m_map_downscale, 0));
+      const int size = std::max(int(2 * m_local_tracking_range / scale), 2);
+      m_local_submap = std::make_unique<LocalSubmap>(size, scale, std::max(m_local_tracking_scans, 1), m_num_smooth);
+    }
+    reset_local_tracking();
+
+    if(m_prefetch_enable) {
+      init_prefetcher(ros_map->info.resolution);
+    }
+  }
+
+  struct latency_t {
+    uint64_t num_updates = 0;
+    uint64_t num_skipped = 0;   // timer ticks skipped because the previous update was still pending
+    double mean = 0;            // [s] from posting loc_update() until it finished
+    double max = 0;             // [s]
+  };
+
+  /*
+   * Returns the loc_update() latency statistics since the last call (shared mode only).
+   */
+  latency_t get_latency()
+  {
+    std::lock_guard<std::mutex> lock(m_latency_mutex);
+    latency_t out = m_latency;
+    if(out.num_updates) {
+      out.mean /= out.num_updates;
+    }
+    m_latency = latency_t();
+    return out;
+  }
+
+protected:
+
+  /*
+   * Computes localization update for a single laser scan.
+   */
+  void scan_callback(const sensor_msgs::msg::LaserScan::SharedPtr scan)
+  {
+
+    std::lock_guard<std::mutex> lock(m_node_mutex);
+
+    if(!map_received_) {
+      RCLCPP_INFO_ONCE(this->get_logger(), "no map");
+      return;
+    }
+    RCLCPP_INFO_ONCE(this->get_logger(), "map_received");
+    scan->header.frame_id = m_ns + scan->header.frame_id;
+    m_scan_buffer[scan->header.frame_id] = scan;
+
+    NEO_TRACEPOINT(message, "neo_localization", "receive", "scan", neo_tracetools::stamp_ns(scan->header.stamp));
+  }
+
+  /*
+   * Convert/Transform a scan from ROS format to a specified base frame.
+   */
+  std::vector<scan_point_t> convert_scan(const sensor_msgs::msg::LaserScan::SharedPtr scan, const Matrix<double, 4, 4>& odom_to_base)
+  {
+    std::vector<scan_point_t> points;
+    tf2::Stamped<tf2::Transform> base_to_odom;
+    tf2::Stamped<tf2::Transform> sensor_to_base;
+    bool callback_timeout = false;
+    try {
+      auto tempTransform = buffer->lookupTransform(m_base_frame, scan->header.frame_id, tf2::TimePointZero);
+      tf2::fromMsg(tempTransform, sensor_to_base);
+
+    } catch(const std::exception& ex) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "NeoLocalizationNode: lookupTransform(scan->header.frame_id, m_base_frame) failed: " << ex.what());
+      return points;
+    }
+    try {
+      auto tempTransform = buffer->lookupTransform(m_odom_frame, m_base_frame, scan->header.stamp);
+      tf2::fromMsg(tempTransform, base_to_odom);
+      } catch(const std::exception& ex) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "NeoLocalizationNode: lookupTransform(m_base_frame, m_odom_frame) failed: " << ex.what());
+      return points;
+    }
+    
+    const Matrix<double, 4, 4> S = convert_transform_3(sensor_to_base);
+    const Matrix<double, 4, 4> L = convert_transform_25(base_to_odom);
+
+    // precompute transformation matrix from sensor to requested base
+    const Matrix<double, 4, 4> T = odom_to_base * L * S;
+
+    for(size_t i = 0; i < scan->ranges.size(); ++i)
+    {
+      if(scan->ranges[i] <= scan->range_min || scan->ranges[i] >= scan->range_max) {
+        continue; // no actual measurement
+      }
+
+      // transform sensor points into base coordinate system
+      const Matrix<double, 3, 1> scan_pos = (T * rotate3_z<double>(scan->angle_min + i * scan->angle_increment)
+                          * Matrix<double, 4, 1>{scan->ranges[i], 0, 0, 1}).project();
+      scan_point_t point;
+      point.x = scan_pos[0];
+      point.y = scan_pos[1];
+      points.emplace_back(point);
+    }
+    return points;
+  }
+
+  void loc_update()
+  {
+    std::lock_guard<std::mutex> lock(m_node_mutex);
+    if(!map_received_ || m_scan_buffer.empty() || !m_initialized) {
+      return;
+    }
+
+    NEO_TRACE_SCOPE("neo_localization", "loc_update", 0);
+
+    tf2::Stamped<tf2::Transform> base_to_odom;
+
+    try {
+      auto tempTransform = buffer->lookupTransform(m_odom_frame, m_base_frame, tf2::TimePointZero);
+      tf2::fromMsg(tempTransform, base_to_odom);
+    } catch(const std::exception& ex) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "NeoLocalizationNode: lookup Transform(m_base_frame, m_odom_frame) failed: " << ex.what());
+      return;
+    }
+    
+    tf2::Transform base_to_odom_ws(base_to_odom.getRotation(), base_to_odom.getOrigin());
+    
+    const Matrix<double, 4, 4> L = convert_transform_25(base_to_odom_ws);
+    const Matrix<double, 4, 4> T = translate25(m_offset_x, m_offset_y) * rotate25_z(m_offset_yaw);    // odom to map
+
+    const Matrix<double, 3, 1> odom_pose = (L * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+    const double dist_moved = (odom_pose - m_last_odom_pose).get<2>().norm();
+    const double rad_rotated = fabs(angles::normalize_angle(odom_pose[2] - m_last_odom_pose[2]));
+
+    std::vector<scan_point_t> points;
+
+    RCLCPP_INFO_ONCE(this->get_logger(), "map_received");
+    NEO_TRACEPOINT(phase, "neo_localization", "convert_scans", 0);
+    // convert all scans to current base frame
+    for(const auto& scan : m_scan_buffer)
+    {
+      NEO_TRACEPOINT(message, "neo_localization", "consume", "scan", neo_tracetools::stamp_ns(scan.second->header.stamp));
+
+      auto scan_points = convert_scan(scan.second, L.inverse());
+
+      points.insert(points.end(), scan_points.begin(), scan_points.end());
+    }
+
+    // // check for number of points
+    if(points.size() < m_min_points)
+    {
+      RCLCPP_WARN_STREAM(this->get_logger(),"NeoLocalizationNode: Number of points too low: " << points.size());
+      return;
+    }
+
+    geometry_msgs::msg::PoseArray pose_array;
+    pose_array.header.stamp = tf2_ros::toMsg(base_to_odom.stamp_);
+    pose_array.header.frame_id = m_map_frame;
+
+    // calc predicted grid pose based on odometry
+
+    const Matrix<double, 3, 1> grid_pose = (m_grid_to_map.inverse() * T * L * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+
+    // switch to the next (prefetched) tile as soon as we leave the current one, instead of waiting for the timer
+    if(m_prefetcher && !m_tile_switch_requested)
+    {
+      const double world_scale = m_world->info.resolution;
+      const double tile_center = (m_map_size / 2) * world_scale;
+      const double max_dist = 0.55 * get_tile_step() * world_scale;
+      if(std::max(fabs(grid_pose[0] - tile_center), fabs(grid_pose[1] - tile_center)) > max_dist) {
+        request_map_update();
+      }
+    }
+
+    // while tracking on the local submap the map is only checked for recovery, no samples are solved
+    if(m_tracking_active && track_local_submap(points, L, T, grid_pose, tf2_ros::toMsg(base_to_odom.stamp_), dist_moved, rad_rotated))
+    {
+      m_last_odom_pose = odom_pose;
+      m_scan_buffer.clear();
+      return;
+    }
+    // setup distributions
+    std::normal_distribution<double> dist_x(grid_pose[0], m_sample_std_xy);
+    std::normal_distribution<double> dist_y(grid_pose[1], m_sample_std_xy);
+    std::normal_distribution<double> dist_yaw(grid_pose[2], m_sample_std_yaw);
+
+    // solve odometry prediction first
+    NEO_TRACEPOINT(phase, "neo_localization", "solve_prediction", 0);
+    m_solver.pose_x = grid_pose[0];
+    m_solver.pose_y = grid_pose[1];
+    m_solver.pose_yaw = grid_pose[2];
+
+    for(int iter = 0; iter < m_solver_iterations; ++iter) {
+      m_solver.solve<float>(*m_map, points);
+    }
+
+    double best_x = m_solver.pose_x;
+    double best_y = m_solver.pose_y;
+    double best_yaw = m_solver.pose_yaw;
+    double best_score = m_solver.r_norm;
+
+    std::vector<Matrix<double, 3, 1>> seeds(m_sample_rate);
+    std::vector<Matrix<double, 3, 1>> samples(m_sample_rate);
+    std::vector<double> sample_errors(m_sample_rate);
+
+    NEO_TRACEPOINT(phase, "neo_localization", "solve_samples", 0);
+
+    for(int i = 0; i < m_sample_rate; ++i)
+    {
+      // generate new sample
+      m_solver.pose_x = dist_x(m_generator);
+      m_solver.pose_y = dist_y(m_generator);
+      m_solver.pose_yaw = dist_yaw(m_generator);
+
+      seeds[i] = Matrix<double, 3, 1>{m_solver.pose_x, m_solver.pose_y, m_solver.pose_yaw};
+
+      // solve sample
+      for(int iter = 0; iter < m_solver_iterations; ++iter) {
+        m_solver.solve<float>(*m_map, points);
+      }
+
+      // save sample
+      const auto sample = Matrix<double, 3, 1>{m_solver.pose_x, m_solver.pose_y, m_solver.pose_yaw};
+      samples[i] = sample;
+      sample_errors[i] = m_solver.r_norm;
+
+      // check if sample is better
+      if(m_solver.r_norm > best_score) {
+        best_x = m_solver.pose_x;
+        best_y = m_solver.pose_y;
+        best_yaw = m_solver.pose_yaw;
+        best_score = m_solver.r_norm;
+      }
+
+      // add to visualization
+      {
+        const Matrix<double, 3, 1> map_pose = (m_grid_to_map * sample.extend()).project();
+        tf2::Quaternion tmp;
+        geometry_msgs::msg::Pose pose;
+        pose.position.x = map_pose[0];
+        pose.position.y = map_pose[1];
+        tmp.setRPY( 0, 0, map_pose[2]);
+        auto tmp_msg = tf2::toMsg(tmp);
+        pose.orientation = tmp_msg;
+        pose_array.poses.push_back(pose);
+      }
+    }
+
+    // compute covariances
+    NEO_TRACEPOINT(phase, "neo_localization", "covariance", 0);
+    double mean_score = 0;
+    Matrix<double, 3, 1> mean_xyw;
+    Matrix<double, 3, 1> seed_mean_xyw;
+    const double var_error = compute_variance(sample_errors, mean_score);
+    const Matrix<double, 3, 3> var_xyw = compute_covariance(samples, mean_xyw);
+    const Matrix<double, 3, 3> grad_var_xyw =
+        compute_virtual_scan_covariance_xyw(m_map, points, Matrix<double, 3, 1>{best_x, best_y, best_yaw});
+
+    // compute gradient characteristic
+    std::array<Matrix<double, 2, 1>, 2> grad_eigen_vectors;
+    const Matrix<double, 2, 1> grad_eigen_values = compute_eigenvectors_2(grad_var_xyw.get<2, 2>(), grad_eigen_vectors);
+    const Matrix<double, 3, 1> grad_std_uvw{sqrt(grad_eigen_values[0]), sqrt(grad_eigen_values[1]), sqrt(grad_var_xyw(2, 2))};
+
+    // decide if we have 3D, 2D, 1D or 0D localization
+    int mode = 0;
+    if(best_score > m_min_score) {
+      if(grad_std_uvw[0] > m_constrain_threshold) {
+        if(grad_std_uvw[1] > m_constrain_threshold) {
+          mode = 3; // 2D position + rotation
+        } else if(grad_std_uvw[2] > m_constrain_threshold_yaw) {
+          mode = 2; // 1D position + rotation
+        } else {
+          mode = 1; // 1D position only
+        }
+      }
+    }
+
+    NEO_TRACEPOINT(phase, "neo_localization", "update", 0);
+
+    // add the scan to the live map if we are well localized
+    if(m_live_map && mode >= 3 && best_score >= m_live_map_min_score)
+    {
+      const double cos_yaw = cos(best_yaw);
+      const double sin_yaw = sin(best_yaw);
+      std::vector<Matrix<double, 2, 1>> world_points(points.size());
+      for(size_t i = 0; i < points.size(); ++i) {
+        world_points[i] = Matrix<double, 2, 1>{
+            m_tile_offset_x + best_x + cos_yaw * points[i].x - sin_yaw * points[i].y,
+            m_tile_offset_y + best_y + sin_yaw * points[i].x + cos_yaw * points[i].y};
+      }
+      m_live_map->integrate(world_points, m_live_map_gain, m_live_map_decay, 1);
+    }
+
+    if(mode > 0)
+    {
+      double new_grid_x = best_x;
+      double new_grid_y = best_y;
+      double new_grid_yaw = best_yaw;
+
+      if(mode < 3)
+      {
+        // constrain update to the good direction (ie. in direction of the eigen vector with the smaller sigma)
+        const auto delta = Matrix<double, 2, 1>{best_x, best_y} - Matrix<double, 2, 1>{grid_pose[0], grid_pose[1]};
+        const auto dist = grad_eigen_vectors[0].dot(delta);
+        new_grid_x = grid_pose[0] + dist * grad_eigen_vectors[0][0];
+        new_grid_y = grid_pose[1] + dist * grad_eigen_vectors[0][1];
+      }
+      if(mode < 2) {
+        new_grid_yaw = grid_pose[2];  // keep old orientation
+      }
+
+      // use best sample for update
+      Matrix<double, 4, 4> grid_pose_new = translate25(new_grid_x, new_grid_y) * rotate25_z(new_grid_yaw);
+
+      // compute new odom to map offset from new grid pose
+      const Matrix<double, 3, 1> new_offset =
+          (m_grid_to_map * grid_pose_new * L.inverse() * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+
+      // apply new offset with an exponential low pass filter
+      m_offset_x += (new_offset[0] - m_offset_x) * m_update_gain;
+      m_offset_y += (new_offset[1] - m_offset_y) * m_update_gain;
+      m_offset_yaw += angles::shortest_angular_distance(m_offset_yaw, new_offset[2]) * m_update_gain;
+    }
+    m_offset_time = tf2_ros::toMsg(base_to_odom.stamp_);
+
+    // update particle spread depending on mode
+    if(mode >= 3) {
+      m_sample_std_xy *= (1 - m_confidence_gain);
+    } else {
+      m_sample_std_xy += dist_moved * m_odometry_std_xy;
+    }
+    if(mode >= 2) {
+      m_sample_std_yaw *= (1 - m_confidence_gain);
+    } else {
+      m_sample_std_yaw += rad_rotated * m_odometry_std_yaw;
+    }
+
+    // limit particle spread
+    m_sample_std_xy = fmin(fmax(m_sample_std_xy, m_min_sample_std_xy), m_max_sample_std_xy);
+    m_sample_std_yaw = fmin(fmax(m_sample_std_yaw, m_min_sample_std_yaw), m_max_sample_std_yaw);
+
+    // publish new transform and pose
+    const Matrix<double, 3, 1> new_map_pose = publish_pose(L, var_xyw);
+
+    // feed the local submap while well localized, switch to it when the map does not match anymore
+    if(m_local_submap)
+    {
+      if(mode >= 3) {
+        m_tracking_fail_count = 0;
+        if(m_local_submap->need_keyframe(new_map_pose, m_local_tracking_keyframe_dist, m_local_tracking_keyframe_yaw)) {
+          m_local_submap->add_scan(points, new_map_pose);
+        }
+      }
+      else if(mode == 0 && ++m_tracking_fail_count >= m_local_tracking_enter_count && m_local_submap->num_scans() > 0)
+      {
+        m_tracking_active = true;
+        m_tracking_recover_count = 0;
+        RCLCPP_WARN_STREAM(this->get_logger(), "NeoLocalizationNode: Map does not match (score=" << float(best_score)
+            << "), tracking on local submap with " << m_local_submap->num_scans() << " scans");
+      }
+    }
+
+    // publish visualization
+    m_pub_pose_array->publish(pose_array);
+
+    // keep last odom pose
+    m_last_odom_pose = odom_pose;
+
+    if(m_broadcast_info == true) {
+      if(update_counter++ % 10 == 0) {
+        RCLCPP_INFO_STREAM(this->get_logger(),  "NeoLocalizationNode: score=" << float(best_score) << ", grad_uvw=[" << float(grad_std_uvw[0]) << ", " << float(grad_std_uvw[1])
+          << ", " << float(grad_std_uvw[2]) << "], std_xy=" << float(m_sample_std_xy) << " m, std_yaw=" << float(m_sample_std_yaw)
+          << " rad, mode=" << mode << "D, " << m_scan_buffer.size() << " scans");
+      }
+    }
+
+    // clear scan buffer
+    m_scan_buffer.clear();
+  }
+
+  /*
+   * Localization update on the local submap, used while the map does not match.
+   * Returns false if the map matches again, in which case the regular update should be done.
+   */
+  bool track_local_submap(const std::vector<scan_point_t>& points, const Matrix<double, 4, 4>& L, const Matrix<double, 4, 4>& T,
+              const Matrix<double, 3, 1>& grid_pose, const builtin_interfaces::msg::Time& stamp,
+              const double dist_moved, const double rad_rotated)
+  {
+    NEO_TRACEPOINT(phase, "neo_localization", "track_local_submap", 0);
+
+    // check if the map matches again, starting from the odometry prediction only
+    m_solver.pose_x = grid_pose[0];
+    m_solver.pose_y = grid_pose[1];
+    m_solver.pose_yaw = grid_pose[2];
+    for(int iter = 0; iter < m_solver_iterations; ++iter) {
+      m_solver.solve<float>(*m_map, points);
+    }
+    const double map_score = m_solver.r_norm;
+
+    if(map_score > m_min_score) {
+      if(++m_tracking_recover_count >= m_local_tracking_exit_count) {
+        m_tracking_active = false;
+        m_tracking_fail_count = 0;
+        RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationNode: Map matches again (score=" << float(map_score)
+            << "), back to map localization");
+        return false;
+      }
+    } else {
+      m_tracking_recover_count = 0;
+    }
+
+    // match against the submap, which is in map frame
+    const Matrix<double, 3, 1> map_pose = (T * L * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+    const GridMap<float>& submap = m_local_submap->update(map_pose[0], map_pose[1]);
+
+    m_solver.pose_x = map_pose[0] - m_local_submap->origin_x();
+    m_solver.pose_y = map_pose[1] - m_local_submap->origin_y();
+    m_solver.pose_yaw = map_pose[2];
+    for(int iter = 0; iter < m_solver_iterations; ++iter) {
+      m_solver.solve<float>(submap, points);
+    }
+    const double score = m_solver.r_norm;
+
+    if(score > m_local_tracking_min_score)
+    {
+      const Matrix<double, 4, 4> map_pose_new =
+          translate25(m_solver.pose_x + m_local_submap->origin_x(), m_solver.pose_y + m_local_submap->origin_y()) * rotate25_z(m_solver.pose_yaw);
+
+      // compute new odom to map offset, same low pass as for the map
+      const Matrix<double, 3, 1> new_offset = (map_pose_new * L.inverse() * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+      m_offset_x += (new_offset[0] - m_offset_x) * m_update_gain;
+      m_offset_y += (new_offset[1] - m_offset_y) * m_update_gain;
+      m_offset_yaw += angles::shortest_angular_distance(m_offset_yaw, new_offset[2]) * m_update_gain;
+    }
+    m_offset_time = stamp;
+
+    // the submap drifts, so the spread grows like without any localization
+    m_sample_std_xy = fmin(fmax(m_sample_std_xy + dist_moved * m_odometry_std_xy, m_min_sample_std_xy), m_max_sample_std_xy);
+    m_sample_std_yaw = fmin(fmax(m_sample_std_yaw + rad_rotated * m_odometry_std_yaw, m_min_sample_std_yaw), m_max_sample_std_yaw);
+
+    Matrix<double, 3, 3> var_xyw;
+    var_xyw(0, 0) = m_sample_std_xy * m_sample_std_xy;
+    var_xyw(1, 1) = m_sample_std_xy * m_sample_std_xy;
+    var_xyw(2, 2) = m_sample_std_yaw * m_sample_std_yaw;
+    const Matrix<double, 3, 1> new_map_pose = publish_pose(L, var_xyw);
+
+    // extend the submap as we go
+    if(score > m_local_tracking_min_score &&
+      m_local_submap->need_keyframe(new_map_pose, m_local_tracking_keyframe_dist, m_local_tracking_keyframe_yaw))
+    {
+      m_local_submap->add_scan(points, new_map_pose);
+    }
+
+    if(m_broadcast_info == true) {
+      if(update_counter++ % 10 == 0) {
+        RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationNode: tracking on local submap, score=" << float(score)
+          << ", map_score=" << float(map_score) << ", std_xy=" << float(m_sample_std_xy) << " m, std_yaw=" << float(m_sample_std_yaw)
+          << " rad, " << m_local_submap->num_scans() << " keyframes");
+      }
+    }
+    return true;
+  }
+
+  /*
+   * Publishes the current offset on tf and the resulting pose, returns the pose [x, y, yaw] in map frame.
+   */
+  Matrix<double, 3, 1> publish_pose(const Matrix<double, 4, 4>& L, const Matrix<double, 3, 3>& var_xyw)
+  {
+    broadcast();
+
+    const Matrix<double, 3, 1> new_map_pose = (translate25(m_offset_x, m_offset_y) * rotate25_z(m_offset_yaw) *
+                          L * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+    tf2::Quaternion myQuaternion;
+    // publish localization pose
+    geometry_msgs::msg::PoseWithCovarianceStamped loc_pose;
+    loc_pose.header.stamp = m_offset_time;
+    loc_pose.header.frame_id = m_map_frame;
+    loc_pose.pose.pose.position.x = new_map_pose[0];
+    loc_pose.pose.pose.position.y = new_map_pose[1];
+    loc_pose.pose.pose.position.z = 0;
+    myQuaternion.setRPY(0, 0, new_map_pose[2]);
+    auto temp_quat = tf2::toMsg(myQuaternion);
+    loc_pose.pose.pose.orientation = temp_quat;
+    for(int j = 0; j < 3; ++j) {
+      for(int i = 0; i < 3; ++i) {
+        const int i_ = (i == 2 ? 5 : i);
+        const int j_ = (j == 2 ? 5 : j);
+        loc_pose.pose.covariance[j_ * 6 + i_] = var_xyw(i, j);
+      }
+    }
+    NEO_TRACEPOINT(message, "neo_localization", "publish", "amcl_pose", neo_tracetools::stamp_ns(m_offset_time));
+    m_pub_loc_pose->publish(loc_pose);
+    m_pub_loc_pose_2->publish(loc_pose);
+    return new_map_pose;
+  }
+
+  /*
+   * Drops the local submap and goes back to map localization.
+   */
+  void reset_local_tracking()
+  {
+    if(m_local_submap) {
+      m_local_submap->reset();
+    }
+    m_tracking_active = false;
+    m_tracking_fail_count = 0;
+    m_tracking_recover_count = 0;
+  }
+
+  /*
+   * Resets localization to given position.
+   */
+  void pose_callback(const geometry_msgs::msg::PoseWithCovarianceStamped::SharedPtr pose)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_node_mutex);
+
+      if(pose->header.frame_id != m_map_frame) {
+        RCLCPP_WARN_STREAM(this->get_logger(), "NeoLocalizationNode: Invalid pose estimate frame");
+        return;
+      }
+
+      tf2::Stamped<tf2::Transform> base_to_odom;
+      tf2::Transform map_pose;
+      tf2::fromMsg(pose->pose.pose, map_pose);
+
+      RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationNode: Got new map pose estimate: x=" << map_pose.getOrigin()[0]
+              << " m, y=" <<  map_pose.getOrigin()[1] );
+
+      try {
+        auto tempTransform = buffer->lookupTransform(m_odom_frame, m_base_frame, tf2::TimePointZero);
+        tf2::convert(tempTransform, base_to_odom);
+      } catch(const std::exception& ex) {
+        RCLCPP_WARN_STREAM(this->get_logger(),"NeoLocalizationNode: lookupTransform(m_base_frame, m_odom_frame) failed: "<< ex.what());
+        return;
+      }
+
+      const Matrix<double, 4, 4> L = convert_transform_25(base_to_odom);
+
+      // compute new odom to map offset
+      const Matrix<double, 3, 1> new_offset =
+          (convert_transform_25(map_pose) * L.inverse() * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+
+      // set new offset based on given position
+      m_offset_x = new_offset[0];
+      m_offset_y = new_offset[1];
+      m_offset_yaw = new_offset[2];
+
+      // reset particle spread to maximum
+      m_sample_std_xy = m_max_sample_std_xy;
+      m_sample_std_yaw = m_max_sample_std_yaw;
+
+      // the submap was built at the old position
+      reset_local_tracking();
+
+      broadcast();
+    }
+
+    // get a new map tile immediately
+    update_map();
+  }
+
+  /*
+   * Removes all evidence from the live map, the next map tile will be without it.
+   */
+  void reset_live_map_callback(const std::shared_ptr<std_srvs::srv::Empty::Request> /*request*/,
+                 std::shared_ptr<std_srvs::srv::Empty::Response> /*response*/)
+  {
+    std::lock_guard<std::mutex> lock(m_node_mutex);
+    if(m_live_map) {
+      m_live_map->reset();
+      RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationNode: Live map reset");
+    }
+  }
+
+  /*
+   * Stores the given map.
+   */
+  void map_callback(const nav_msgs::msg::OccupancyGrid::SharedPtr ros_map)
+  {
+    set_map(ros_map);
+  }
+
+  /*
+   * Posts loc_update() to the shared thread pool, unless the previous one is still pending.
+   */
+  void post_loc_update()
+  {
+    if(m_loc_update_pending.exchange(true)) {
+      std::lock_guard<std::mutex> lock(m_latency_mutex);
+      m_latency.num_skipped++;
+      return;
+    }
+    const auto time_posted = std::chrono::steady_clock::now();
+    const std::weak_ptr<rclcpp::Node> weak_node = weak_from_this();
+
+    m_shared->pool->post([weak_node, time_posted]() {
+      auto node = std::static_pointer_cast<NeoLocalizationNode>(weak_node.lock());
+      if(!node) {
+        return;
+      }
+      try {
+        node->loc_update();
+      }
+      catch(const std::exception& ex) {
+        RCLCPP_WARN_STREAM(node->get_logger(), "NeoLocalizationNode: loc_update() failed: " << ex.what());
+      }
+      const double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_posted).count();
+      {
+        std::lock_guard<std::mutex> lock(node->m_latency_mutex);
+        node->m_latency.num_updates++;
+        node->m_latency.mean += latency;
+        node->m_latency.max = std::max(node->m_latency.max, latency);
+      }
+      node->m_loc_update_pending = false;
+    });
+  }
+
+  /*
+   * Stores the global plan as the route to prefetch map tiles along.
+   */
+  void plan_callback(const nav_msgs::msg::Path::SharedPtr plan)
+  {
+    std::shared_ptr<TilePrefetcher> prefetcher;
+    nav_msgs::msg::OccupancyGrid::ConstSharedPtr world;
+    std::vector<std::pair<double, double>> route;
+    {
+      std::lock_guard<std::mutex> lock(m_node_mutex);
+      if(!m_prefetcher || !m_world) {
+        return;
+      }
+      if(!plan->poses.empty() && plan->header.frame_id != m_map_frame) {
+        RCLCPP_WARN_STREAM(this->get_logger(), "NeoLocalizationNode: Invalid plan frame '" << plan->header.frame_id << "', not prefetching");
+        return;
+      }
+      const Matrix<double, 4, 4> map_to_world = m_world_to_map.inverse();
+      const double world_scale = m_world->info.resolution;
+      for(const auto& pose : plan->poses) {
+        const auto world_pos = (map_to_world * Matrix<double, 4, 1>{pose.pose.position.x, pose.pose.position.y, 0, 1}).project();
+        route.emplace_back(world_pos[0] / world_scale, world_pos[1] / world_scale);
+      }
+      prefetcher = m_prefetcher;
+      world = m_world;
+    }
+    prefetcher->set_route(world, route);
+  }
+
+  /*
+   * Tile origins are multiples of this [pixels] when tiles are shared or prefetched.
+   */
+  int get_tile_step() const
+  {
+    return m_shared && m_shared->tile_step > 0 ? m_shared->tile_step : std::max(m_map_size / 4, 1);
+  }
+
+  /*
+   * Creates the tile prefetcher for a new map, the route is cleared.
+   */
+  void init_prefetcher(const double world_scale)
+  {
+    const size_t tile_size = size_t(std::max(m_map_size >> std::max(m_map_downscale, 0), 1));
+    const size_t tile_bytes = tile_size * tile_size * sizeof(float);
+    const size_t max_tiles = std::max<size_t>(size_t(m_prefetch_memory * 1e6 / tile_bytes), 1);
+
+    TilePrefetcher::compute_func_t compute;
+    TilePrefetcher::post_func_t post;
+    const int map_size = m_map_size;
+    const int map_downscale = m_map_downscale;
+    const int num_smooth = m_num_smooth;
+    if(m_shared) {
+      // go through the shared cache, so that other robots can use the tiles as well
+      const std::shared_ptr<NeoLocalizationShared> shared = m_shared;
+      compute = [shared, map_size, map_downscale, num_smooth](const TilePrefetcher::world_ptr_t& world, int tile_x, int tile_y) {
+        return shared->tiles.get(world, tile_x, tile_y, map_size, map_downscale, num_smooth);
+      };
+      post = [shared](std::function<void()> task) {
+        if(shared->pool) {
+          shared->pool->post(std::move(task));
+        }
+      };
+    } else {
+      if(!m_prefetch_pool) {
+        m_prefetch_pool = std::make_unique<ThreadPool>(1);
+      }
+      ThreadPool* pool = m_prefetch_pool.get();
+      compute = [map_size, map_downscale, num_smooth](const TilePrefetcher::world_ptr_t& world, int tile_x, int tile_y) {
+        return TilePrefetcher::tile_ptr_t(extract_map_tile(*world, tile_x, tile_y, map_size, map_downscale, num_smooth));
+      };
+      post = [pool](std::function<void()> task) {
+        pool->post(std::move(task));
+      };
+    }
+    m_prefetcher = std::make_shared<TilePrefetcher>(m_map_size, get_tile_step(), m_prefetch_distance / world_scale,
+                            max_tiles, compute, post);
+
+    RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationNode: Prefetching up to " << max_tiles << " map tiles within "
+        << m_prefetch_distance << " m along the route");
+  }
+
+  /*
+   * Runs update_map() as soon as possible.
+   */
+  void request_map_update()
+  {
+    if(m_shared) {
+      m_tile_switch_requested = true;
+      post_update_map();
+    } else {
+      std::lock_guard<std::mutex> lock(m_map_update_mutex);
+      m_tile_switch_requested = true;
+      m_map_update_signal.notify_all();
+    }
+  }
+
+  /*
+   * Posts update_map() to the shared thread pool, unless the previous one is still pending.
+   */
+  void post_update_map()
+  {
+    if(m_map_update_pending.exchange(true)) {
+      return;
+    }
+    const std::weak_ptr<rclcpp::Node> weak_node = weak_from_this();
+
+    m_shared->pool->post([weak_node]() {
+      auto node = std::static_pointer_cast<NeoLocalizationNode>(weak_node.lock());
+      if(!node) {
+        return;
+      }
+      try {
+        node->update_map();
+      }
+      catch(const std::exception& ex) {
+        RCLCPP_WARN_STREAM(node->get_logger(), "NeoLocalizationNode: update_map() failed: " << ex.what());
+      }
+      node->m_map_update_pending = false;
+    });
+  }
+
+  /*
+   * Extracts a new map tile around current position.
+   */
+  void update_map()
+  {
+    NEO_TRACE_SCOPE("neo_localization", "update_map", 0);
+
+    Matrix<double, 4, 4> world_to_map;      // transformation from original grid map (integer coords) to "map frame"
+    Matrix<double, 3, 1> world_pose;      // pose in the original (integer coords) grid map (not map tile)
+    nav_msgs::msg::OccupancyGrid::ConstSharedPtr world;
+    std::shared_ptr<TilePrefetcher> prefetcher;
+    {
+      std::lock_guard<std::mutex> lock(m_node_mutex);
+      m_tile_switch_requested = false;
+      if(!m_world) {
+        return;
+      }
+
+      tf2::Stamped<tf2::Transform> base_to_odom;
+      try {
+        auto tempTransform = buffer->lookupTransform(m_odom_frame, m_base_frame, tf2::TimePointZero);
+        tf2::fromMsg(tempTransform, base_to_odom);
+      } catch(const std::exception& ex) {
+        RCLCPP_WARN_STREAM(this->get_logger(),"NeoLocalizationNode: lookupTransform(m_base_frame, m_odom_frame) failed: " << ex.what());
+        return;
+      }
+
+      const Matrix<double, 4, 4> L = convert_transform_25(base_to_odom);
+      const Matrix<double, 4, 4> T = translate25(m_offset_x, m_offset_y) * rotate25_z(m_offset_yaw);    // odom to map
+      world_pose = (m_world_to_map.inverse() * T * L * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+
+      world = m_world;
+      world_to_map = m_world_to_map;
+      prefetcher = m_prefetcher;
+    }
+
+    // compute tile origin in pixel coords
+    const double world_scale = world->info.resolution;
+    int tile_x = int(world_pose[0] / world_scale) - m_map_size / 2;
+    int tile_y = int(world_pose[1] / world_scale) - m_map_size / 2;
+
+    std::shared_ptr<const GridMap<float>> map;
+
+    NEO_TRACEPOINT(phase, "neo_localization", "extract_tile", 0);
+    if(m_shared || prefetcher)
+    {
+      // snap tile to a coarse grid, so that robots close to each other use the same tile
+      // and the tiles along the route are known in advance
+      const int tile_step = get_tile_step();
+      tile_x = snap_tile_origin(tile_x, tile_step);
+      tile_y = snap_tile_origin(tile_y, tile_step);
+    }
+    if(prefetcher)
+    {
+      prefetcher->update(world, world_pose[0] / world_scale, world_pose[1] / world_scale);
+      map = prefetcher->get(world, tile_x, tile_y);
+    }
+    if(!map)
+    {
+      if(m_shared) {
+        map = m_shared->tiles.get(world, tile_x, tile_y, m_map_size, m_map_downscale, m_num_smooth);
+      } else {
+        map = extract_map_tile(*world, tile_x, tile_y, m_map_size, m_map_downscale, m_num_smooth);
+      }
+      if(prefetcher) {
+        prefetcher->put(world, tile_x, tile_y, map);
+      }
+    }
+
+    // blend in the live map (the tile may be shared, so we work on a copy)
+    std::unique_ptr<LiveMap> live_map;
+    {
+      std::lock_guard<std::mutex> lock(m_node_mutex);
+      if(m_live_map) {
+        m_live_map->move_to(tile_x * world_scale, tile_y * world_scale);
+        live_map = std::make_unique<LiveMap>(*m_live_map);
+      }
+    }
+    if(live_map) {
+      NEO_TRACEPOINT(phase, "neo_localization", "blend_live_map", 0);
+      auto blended = std::make_shared<GridMap<float>>(*map);
+      live_map->blend(*blended, tile_x * world_scale, tile_y * world_scale, m_live_map_weight);
+      map = blended;
+    }
+
+    // update map
+    Matrix<double, 3, 1> tile_origin;
+    Matrix<double, 3, 1> tile_center;
+    {
+      std::lock_guard<std::mutex> lock(m_node_mutex);
+      m_map = map;
+      m_grid_to_map = world_to_map * translate25<double>(tile_x * world_scale, tile_y * world_scale);
+      m_tile_offset_x = tile_x * world_scale;
+      m_tile_offset_y = tile_y * world_scale;
+      m_initialized = true;
+
+      // pose_callback() may move m_grid_to_map as soon as we release the lock
+      tile_origin = (m_grid_to_map * Matrix<double, 4, 1>{0, 0, 0, 1}).project();
+      tile_center = (m_grid_to_map * Matrix<double, 4, 1>{ map->scale() * map->size_x() / 2,
+                                    map->scale() * map->size_y() / 2, 0, 1}).project();
+    }
+
+    NEO_TRACEPOINT(phase, "neo_localization", "publish_tile", 0);
+    // publish new map tile for visualization
+    tf2::Quaternion myQuaternion;
+    nav_msgs::msg::OccupancyGrid ros_grid;
+    ros_grid.header.stamp = m_offset_time;
+    ros_grid.header.frame_id = m_map_frame;
+    ros_grid.info.resolution = map->scale();
+    ros_grid.info.width = map->size_x();
+    ros_grid.info.height = map->size_y();
+    ros_grid.info.origin.position.x = tile_origin[0];
+    ros_grid.info.origin.position.y = tile_origin[1];
+    tf2::Quaternion Quaternion1;
+    myQuaternion.setRPY( 0, 0, tile_origin[2]);
+    ros_grid.info.origin.orientation = tf2::toMsg(myQuaternion);
+    ros_grid.data.resize(map->num_cells());
+    for(int y = 0; y < map->size_y(); ++y) {
+      for(int x = 0; x < map->size_x(); ++x) {
+        ros_grid.data[y * map->size_x() + x] = (*map)(x, y) * 100.f;
+      }
+    }
+    m_pub_map_tile->publish(ros_grid);
+
+  }
+
+  /*
+   * Asynchronous map update loop, running in separate thread.
+   */
+  void update_loop()
+  {
+    RCLCPP_INFO_ONCE(this->get_logger(),"NeoLocalizationNode: Activating map update loop");
+
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>(1 / m_map_update_rate));
+    while(rclcpp::ok()) {
+      const auto next_update = std::chrono::steady_clock::now() + period;
+      try {
+        update_map(); // get a new map tile periodically
+      }
+      catch(const std::exception& ex) {
+        RCLCPP_WARN_STREAM(this->get_logger(),"NeoLocalizationNode: update_map() failed:");
+      }
+      // wake up early when the robot leaves the current tile
+      std::unique_lock<std::mutex> lock(m_map_update_mutex);
+      m_map_update_signal.wait_until(lock, next_update, [this] { return m_tile_switch_requested || !rclcpp::ok(); });
+    }
+  }
+
+  /*
+   * Publishes "map" frame on tf_->
+   */
+  void broadcast()
+  {
+    if(m_broadcast_tf)
+    {
+      // compose and publish transform for tf package
+      geometry_msgs::msg::TransformStamped pose;
+      // compose header
+      // Adding an expiry time of the frame. Same procedure followed in nav2_amcl
+      m_offset_time.nanosec = m_offset_time.nanosec + 1000000000;
+      pose.header.stamp = m_offset_time;
+      pose.header.frame_id = m_map_frame;
+      pose.child_frame_id = m_odom_frame;
+      // compose data container
+      pose.transform.translation.x = m_offset_x;
+      pose.transform.translation.y = m_offset_y;
+      pose.transform.translation.z = 0;
+      tf2::Quaternion myQuaternion;
+      myQuaternion.setRPY( 0, 0, m_offset_yaw);
+      pose.transform.rotation = tf2::toMsg(myQuaternion);
+
+      // publish the transform
+      m_tf_broadcaster->sendTransform(pose);
+    }
+  }
+
+private:
+  std::mutex m_node_mutex;
+
+  rclcpp::Publisher<nav_msgs::msg::OccupancyGrid>::SharedPtr m_pub_map_tile;
+  rclcpp::Publisher<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr m_pub_loc_pose;
+  rclcpp::Publisher<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr m_pub_loc_pose_2;
+  rclcpp::Publisher<geometry_msgs::msg::PoseArray>::SharedPtr m_pub_pose_array;
+
+  rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr m_sub_map_topic;
+  rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr m_sub_scan_topic;
+  rclcpp::Subscription<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr m_sub_pose_estimate;
+  rclcpp::Subscription<nav_msgs::msg::Path>::SharedPtr m_sub_plan;
+  std::shared_ptr<tf2_ros::TransformBroadcaster> m_tf_broadcaster;
+
+  bool m_broadcast_tf = false;
+  bool m_initialized = false;
+  std::string m_base_frame;
+  std::string m_odom_frame;
+  std::string m_map_frame;
+  std::string m_map_topic;
+  std::string m_scan_topic;
+  std::string m_initial_pose;
+  std::string m_map_tile;
+  std::string m_map_pose;
+  std::string m_particle_cloud;
+  std::string m_amcl_pose;
+  std::string m_ns = "";
+
+  int m_map_size = 0;
+  int m_map_downscale = 0;
+  int m_num_smooth = 0;
+  int m_solver_iterations = 0;
+  int m_sample_rate = 0;
+  int m_min_points = 0;
+  double m_update_gain = 0;
+  double m_confidence_gain = 0;
+  double m_min_score = 0;
+  double m_odometry_std_xy = 0;     // odometry xy error in meter per meter driven
+  double m_odometry_std_yaw = 0;      // odometry yaw error in rad per rad rotated
+  double m_min_sample_std_xy = 0;
+  double m_min_sample_std_yaw = 0;
+  double m_max_sample_std_xy = 0;
+  double m_max_sample_std_yaw = 0;
+  double m_constrain_threshold = 0;
+  double m_constrain_threshold_yaw = 0;
+  int m_loc_update_time_ms = 0;
+  double m_map_update_rate = 0;
+  double m_transform_timeout = 0;
+
+  builtin_interfaces::msg::Time m_offset_time;
+  double m_offset_x = 0;          // current x offset between odom and map
+  double m_offset_y = 0;          // current y offset between odom and map
+  double m_offset_yaw = 0;        // current yaw offset between odom and map
+  double m_sample_std_xy = 0;       // current sample spread in xy
+  double m_sample_std_yaw = 0;      // current sample spread in yaw
+  std::unique_ptr<tf2_ros::Buffer> buffer;
+  std::shared_ptr<tf2_ros::TransformListener> transform_listener_{nullptr};
+
+  Matrix<double, 3, 1> m_last_odom_pose;
+  Matrix<double, 4, 4> m_grid_to_map;
+  Matrix<double, 4, 4> m_world_to_map;
+  std::shared_ptr<const GridMap<float>> m_map;      // map tile
+  double m_tile_offset_x = 0;       // origin of map tile in world grid [m]
+  double m_tile_offset_y = 0;
+  nav_msgs::msg::OccupancyGrid::ConstSharedPtr m_world;   // whole map
+  bool map_received_ = false;
+
+  int64_t update_counter = 0;
+  std::map<std::string, sensor_msgs::msg::LaserScan::SharedPtr> m_scan_buffer;
+
+  Solver m_solver;
+  std::mt19937 m_generator;
+  std::thread m_map_update_thread;
+  std::mutex m_map_update_mutex;
+  std::condition_variable m_map_update_signal;
+  bool m_broadcast_info;
+  rclcpp::TimerBase::SharedPtr m_loc_update_timer;
+
+  std::shared_ptr<NeoLocalizationShared> m_shared;
+  rclcpp::TimerBase::SharedPtr m_map_update_timer;
+  std::atomic<bool> m_loc_update_pending {false};
+  std::atomic<bool> m_map_update_pending {false};
+  std::mutex m_latency_mutex;
+  latency_t m_latency;
+
+  bool m_live_map_enable = false;
+  int m_live_map_downscale = 0;
+  double m_live_map_gain = 0;         // evidence added per scan point
+  double m_live_map_decay = 0;        // evidence decay per localization update
+  double m_live_map_weight = 0;       // blend weight of saturated evidence into map tile
+  double m_live_map_min_score = 0;
+  std::unique_ptr<LiveMap> m_live_map;
+  rclcpp::Service<std_srvs::srv::Empty>::SharedPtr m_srv_reset_live_map;
+
+  bool m_local_tracking_enable = false;
+  double m_local_tracking_range = 0;      // half size of the submap [m]
+  int m_local_tracking_scans = 0;         // max. number of keyframes
+  double m_local_tracking_keyframe_dist = 0;
+  double m_local_tracking_keyframe_yaw = 0;
+  double m_local_tracking_min_score = 0;
+  int m_local_tracking_enter_count = 0;     // updates without map match before switching to the submap
+  int m_local_tracking_exit_count = 0;      // updates with map match before switching back
+  std::unique_ptr<LocalSubmap> m_local_submap;
+  bool m_tracking_active = false;
+  int m_tracking_fail_count = 0;
+  int m_tracking_recover_count = 0;
+
+  bool m_prefetch_enable = false;
+  std::string m_prefetch_plan_topic;
+  double m_prefetch_distance = 0;         // lookahead along the route [m]
+  double m_prefetch_memory = 0;           // max. size of the prefetched tiles [MB]
+  std::unique_ptr<ThreadPool> m_prefetch_pool;    // standalone mode only
+  std::shared_ptr<TilePrefetcher> m_prefetcher;
+  std::atomic<bool> m_tile_switch_requested {false};
+
+};
+
+
+#endif /* INCLUDE_NEO_LOCALIZATION_NEOLOCALIZATIONNODE_H_ */
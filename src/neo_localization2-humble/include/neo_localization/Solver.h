@@ -28,6 +28,7 @@ SOFTWARE.
 #include <neo_common2/Matrix.h>
 #include <neo_localization/Util.h>
 #include <neo_localization/GridMap.h>
+#include <neo_tracetools/tracetools.h>
 
 #include <vector>
 
@@ -62,6 +63,7 @@ public:
   void solve( const GridMap<T>& grid,
         const std::vector<scan_point_t>& points)
   {
+    NEO_TRACE_SCOPE("neo_localization", "solve", 0);
     reset();
 
     // compute transformation matrix first
@@ -95,6 +97,7 @@ public:
   void solve( const MultiGridMap<T>& multi_grid,
         const std::vector<scan_point_ex_t>& points)
   {
+    NEO_TRACE_SCOPE("neo_localization", "solve", 0);
     reset();
 
     // compute transformation matrix first
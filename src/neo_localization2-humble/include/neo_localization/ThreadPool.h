@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_LOCALIZATION_THREADPOOL_H_
+#define INCLUDE_NEO_LOCALIZATION_THREADPOOL_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+
+/*
+ * Fixed number of worker threads processing a FIFO queue of tasks.
+ */
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t num_threads)
+  {
+    num_threads = std::max<size_t>(num_threads, 1);
+    for(size_t i = 0; i < num_threads; ++i) {
+      m_threads.emplace_back(&ThreadPool::run, this);
+    }
+  }
+
+  /*
+   * Finishes all queued tasks, then joins the workers.
+   */
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_do_run = false;
+    }
+    m_signal.notify_all();
+    for(auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void post(std::function<void()> task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.push(std::move(task));
+    }
+    m_signal.notify_one();
+  }
+
+  size_t num_threads() const {
+    return m_threads.size();
+  }
+
+  size_t queue_size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+  }
+
+private:
+  void run()
+  {
+    while(true)
+    {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_signal.wait(lock, [this] { return !m_do_run || !m_queue.empty(); });
+        if(m_queue.empty()) {
+          return;
+        }
+        task = std::move(m_queue.front());
+        m_queue.pop();
+      }
+      task();
+    }
+  }
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_signal;
+  std::queue<std::function<void()>> m_queue;
+  std::vector<std::thread> m_threads;
+  bool m_do_run = true;
+
+};
+
+
+#endif /* INCLUDE_NEO_LOCALIZATION_THREADPOOL_H_ */
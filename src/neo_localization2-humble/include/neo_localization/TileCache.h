@@ -0,0 +1,191 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_LOCALIZATION_TILECACHE_H_
+#define INCLUDE_NEO_LOCALIZATION_TILECACHE_H_
+
+#include <neo_localization/GridMap.h>
+
+#include <nav_msgs/msg/occupancy_grid.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+
+/*
+ * Extracts a map tile of size map_size x map_size pixels at pixel offset (tile_x, tile_y)
+ * from the world map, converts it to occupancy between 0 and 1, then downscales and
+ * smoothes it.
+ */
+inline std::shared_ptr<GridMap<float>> extract_map_tile( const nav_msgs::msg::OccupancyGrid& world,
+                              int tile_x, int tile_y, int map_size, int map_downscale, int num_smooth)
+{
+  auto map = std::make_shared<GridMap<float>>(map_size, map_size, world.info.resolution);
+
+  // extract tile and convert to our format (occupancy between 0 and 1)
+  for(int y = 0; y < map->size_y(); ++y) {
+    for(int x = 0; x < map->size_x(); ++x) {
+      const int x_ = std::min(std::max(tile_x + x, 0), int(world.info.width) - 1);
+      const int y_ = std::min(std::max(tile_y + y, 0), int(world.info.height) - 1);
+      const auto cell = world.data[y_ * world.info.width + x_];
+      if(cell >= 0) {
+        (*map)(x, y) = fminf(cell / 100.f, 1.f);
+      } else {
+        (*map)(x, y) = 0;
+      }
+    }
+  }
+
+  // optionally downscale map
+  for(int i = 0; i < map_downscale; ++i) {
+    map = map->downscale();
+  }
+
+  // smooth map
+  for(int i = 0; i < num_smooth; ++i) {
+    map->smooth_33_1();
+  }
+  return map;
+}
+
+
+/*
+ * Cache of smoothed map tiles, shared by several localization instances on the same map.
+ *
+ * Tiles are immutable and reference counted: the cache only keeps weak pointers, so a tile
+ * is freed as soon as no instance uses it anymore. A tile requested by several instances at
+ * the same time is only computed once.
+ */
+class TileCache {
+public:
+  typedef std::shared_ptr<const GridMap<float>> tile_ptr_t;
+
+  /*
+   * Returns the tile at (tile_x, tile_y) of the given world map, computing it if needed.
+   */
+  tile_ptr_t get(  std::shared_ptr<const nav_msgs::msg::OccupancyGrid> world,
+          int tile_x, int tile_y, int map_size, int map_downscale, int num_smooth)
+  {
+    const key_t key{world.get(), tile_x, tile_y, map_size, map_downscale, num_smooth};
+
+    std::promise<tile_ptr_t> promise;
+    std::shared_future<tile_ptr_t> pending;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if(world != m_world) {
+        // new map, all tiles are outdated
+        m_tiles.clear();
+        m_world = world;
+      }
+      auto& entry = m_tiles[key];
+      if(auto tile = entry.tile.lock()) {
+        m_num_hits++;
+        return tile;
+      }
+      if(entry.pending.valid()) {
+        pending = entry.pending;    // somebody else is computing it
+      } else {
+        entry.pending = promise.get_future().share();
+        m_num_misses++;
+      }
+    }
+    if(pending.valid()) {
+      m_num_hits++;
+      return pending.get();
+    }
+
+    tile_ptr_t tile;
+    try {
+      tile = extract_map_tile(*world, tile_x, tile_y, map_size, map_downscale, num_smooth);
+    } catch(...) {
+      promise.set_exception(std::current_exception());
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tiles.erase(key);
+      throw;
+    }
+    promise.set_value(tile);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto iter = m_tiles.find(key);
+      if(iter != m_tiles.end()) {
+        iter->second.tile = tile;
+        iter->second.pending = std::shared_future<tile_ptr_t>();
+      }
+      // drop expired entries
+      for(auto it = m_tiles.begin(); it != m_tiles.end();) {
+        if(it->second.tile.expired() && !it->second.pending.valid()) {
+          it = m_tiles.erase(it);
+        } else {
+          it++;
+        }
+      }
+    }
+    return tile;
+  }
+
+  /*
+   * Number of tiles currently alive.
+   */
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for(const auto& entry : m_tiles) {
+      count += entry.second.tile.expired() ? 0 : 1;
+    }
+    return count;
+  }
+
+  uint64_t num_hits() const {
+    return m_num_hits;
+  }
+
+  uint64_t num_misses() const {
+    return m_num_misses;
+  }
+
+private:
+  typedef std::tuple<const void*, int, int, int, int, int> key_t;
+
+  struct entry_t {
+    std::weak_ptr<const GridMap<float>> tile;
+    std::shared_future<tile_ptr_t> pending;
+  };
+
+  mutable std::mutex m_mutex;
+  std::shared_ptr<const nav_msgs::msg::OccupancyGrid> m_world;
+  std::map<key_t, entry_t> m_tiles;
+  std::atomic<uint64_t> m_num_hits {0};
+  std::atomic<uint64_t> m_num_misses {0};
+
+};
+
+
+#endif /* INCLUDE_NEO_LOCALIZATION_TILECACHE_H_ */
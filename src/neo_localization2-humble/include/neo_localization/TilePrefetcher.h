@@ -0,0 +1,378 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_LOCALIZATION_TILEPREFETCHER_H_
+#define INCLUDE_NEO_LOCALIZATION_TILEPREFETCHER_H_
+
+#include <neo_localization/GridMap.h>
+
+#include <nav_msgs/msg/occupancy_grid.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+
+/*
+ * Snaps a tile origin [pixels] to a multiple of tile_step.
+ */
+inline int snap_tile_origin(int tile_origin, int tile_step)
+{
+  return int(std::lround(double(tile_origin) / tile_step)) * tile_step;
+}
+
+
+/*
+ * Computes map tiles along the route of the robot in the background, before they are needed.
+ *
+ * Tile origins are snapped to multiples of tile_step, so the robot changes tiles at known
+ * positions along the route. The tiles the robot still has to pass within the lookahead are
+ * computed one after the other, nearest first, and at most max_tiles are kept. Tiles the robot
+ * has passed, or which are no longer on the route, are dropped.
+ */
+class TilePrefetcher : public std::enable_shared_from_this<TilePrefetcher> {
+public:
+  typedef std::shared_ptr<const GridMap<float>> tile_ptr_t;
+  typedef std::shared_ptr<const nav_msgs::msg::OccupancyGrid> world_ptr_t;
+
+  // computes the tile at the given (snapped) origin [pixels]
+  typedef std::function<tile_ptr_t(const world_ptr_t& world, int tile_x, int tile_y)> compute_func_t;
+
+  // runs a task in the background
+  typedef std::function<void(std::function<void()>)> post_func_t;
+
+  /*
+   * map_size is the tile size in pixels of the world map, lookahead is in pixels as well.
+   */
+  TilePrefetcher(int map_size, int tile_step, double lookahead, size_t max_tiles,
+          compute_func_t compute_func, post_func_t post_func)
+    : m_map_size(map_size),
+      m_tile_step(std::max(tile_step, 1)),
+      m_lookahead(lookahead),
+      m_max_tiles(std::max<size_t>(max_tiles, 1)),
+      m_compute(std::move(compute_func)),
+      m_post(std::move(post_func))
+  {
+  }
+
+  TilePrefetcher(const TilePrefetcher&) = delete;
+  TilePrefetcher& operator=(const TilePrefetcher&) = delete;
+
+  /*
+   * Returns the tile origin [pixels] for the given position [pixels] in the world map.
+   */
+  std::pair<int, int> tile_origin(double x, double y) const
+  {
+    return std::make_pair(snap_tile_origin(int(x) - m_map_size / 2, m_tile_step),
+                snap_tile_origin(int(y) - m_map_size / 2, m_tile_step));
+  }
+
+  /*
+   * Sets a new route, as positions [pixels] in the given world map.
+   * Tiles which are on the new route as well are kept.
+   */
+  void set_route(world_ptr_t world, const std::vector<std::pair<double, double>>& route)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    set_world(world);
+
+    m_route.clear();
+    m_route_tiles.clear();
+    m_progress = 0;
+    m_have_progress = false;
+
+    // sample the route densely enough to not skip a tile
+    const double max_step = 0.25 * m_tile_step;
+    double dist = 0;
+    for(size_t i = 0; i < route.size(); ++i)
+    {
+      route_point_t point;
+      point.x = route[i].first;
+      point.y = route[i].second;
+      int num_steps = 1;
+      if(!m_route.empty()) {
+        const double length = std::hypot(point.x - m_route.back().x, point.y - m_route.back().y);
+        num_steps = std::max(int(std::ceil(length / max_step)), 1);
+      }
+      const route_point_t prev = m_route.empty() ? point : m_route.back();
+      for(int k = 1; k <= num_steps; ++k)
+      {
+        route_point_t sample;
+        sample.x = prev.x + (point.x - prev.x) * k / num_steps;
+        sample.y = prev.y + (point.y - prev.y) * k / num_steps;
+        if(!m_route.empty()) {
+          dist += std::hypot(sample.x - m_route.back().x, sample.y - m_route.back().y);
+        }
+        sample.dist = dist;
+        m_route.push_back(sample);
+
+        const auto key = tile_origin(sample.x, sample.y);
+        if(m_route_tiles.empty() || m_route_tiles.back().key != key) {
+          route_tile_t tile;
+          tile.key = key;
+          tile.begin = dist;
+          m_route_tiles.push_back(tile);
+        }
+      }
+    }
+    update_wanted();
+  }
+
+  /*
+   * Removes the route and all prefetched tiles.
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_route.clear();
+    m_route_tiles.clear();
+    m_have_progress = false;
+    m_tiles.clear();
+    m_wanted.clear();
+  }
+
+  /*
+   * Updates the progress along the route with the current position [pixels] in the world map,
+   * drops passed tiles and starts computing the next ones.
+   */
+  void update(world_ptr_t world, double x, double y)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    set_world(world);
+    if(m_route.empty()) {
+      return;
+    }
+
+    // search ahead of the last position first, so that loops in the route do not confuse us
+    size_t best = find_closest(x, y, m_have_progress ? m_progress : 0, m_have_progress ? m_map_size : -1);
+    if(m_have_progress && std::hypot(m_route[best].x - x, m_route[best].y - y) > m_tile_step) {
+      best = find_closest(x, y, 0, -1);   // not on the route anymore
+    }
+    m_progress = best;
+    m_have_progress = true;
+    update_wanted();
+  }
+
+  /*
+   * Returns the tile at the given origin if it has been prefetched, otherwise null.
+   */
+  tile_ptr_t get(world_ptr_t world, int tile_x, int tile_y)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(world != m_world) {
+      m_num_misses++;
+      return nullptr;
+    }
+    auto iter = m_tiles.find(std::make_pair(tile_x, tile_y));
+    if(iter != m_tiles.end() && iter->second) {
+      m_num_hits++;
+      return iter->second;
+    }
+    m_num_misses++;
+    return nullptr;
+  }
+
+  /*
+   * Keeps a tile which had to be computed in the foreground, if it is on the route.
+   */
+  void put(world_ptr_t world, int tile_x, int tile_y, tile_ptr_t tile)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const key_t key(tile_x, tile_y);
+    if(world == m_world && std::find(m_wanted.begin(), m_wanted.end(), key) != m_wanted.end()) {
+      m_tiles[key] = tile;
+    }
+  }
+
+  /*
+   * Number of tiles currently prefetched.
+   */
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for(const auto& entry : m_tiles) {
+      count += entry.second ? 1 : 0;
+    }
+    return count;
+  }
+
+  uint64_t num_hits() const {
+    return m_num_hits;
+  }
+
+  uint64_t num_misses() const {
+    return m_num_misses;
+  }
+
+private:
+  typedef std::pair<int, int> key_t;
+
+  struct route_point_t {
+    double x = 0;     // [pixels]
+    double y = 0;
+    double dist = 0;  // along the route [pixels]
+  };
+
+  struct route_tile_t {
+    key_t key;
+    double begin = 0; // where the route enters the tile [pixels]
+  };
+
+  void set_world(const world_ptr_t& world)
+  {
+    if(world != m_world) {
+      // new map, all tiles are outdated
+      m_tiles.clear();
+      m_world = world;
+    }
+  }
+
+  /*
+   * Returns the route point closest to (x, y), starting at the given index,
+   * up to the given distance along the route (negative = all).
+   */
+  size_t find_closest(double x, double y, size_t start, double range) const
+  {
+    size_t best = start;
+    double best_dist = std::numeric_limits<double>::infinity();
+    for(size_t i = start; i < m_route.size(); ++i)
+    {
+      if(range >= 0 && m_route[i].dist > m_route[start].dist + range) {
+        break;
+      }
+      const double dist = std::hypot(m_route[i].x - x, m_route[i].y - y);
+      if(dist < best_dist) {
+        best = i;
+        best_dist = dist;
+      }
+    }
+    return best;
+  }
+
+  /*
+   * Selects the tiles ahead, drops all others and schedules the next computation.
+   */
+  void update_wanted()
+  {
+    const double position = m_have_progress ? m_route[m_progress].dist : 0;
+
+    m_wanted.clear();
+    for(size_t i = 0; i < m_route_tiles.size() && m_wanted.size() < m_max_tiles; ++i)
+    {
+      const auto& tile = m_route_tiles[i];
+      const double end = i + 1 < m_route_tiles.size() ? m_route_tiles[i + 1].begin
+                               : std::numeric_limits<double>::infinity();
+      if(end <= position) {
+        continue;     // already passed
+      }
+      if(tile.begin > position + m_lookahead) {
+        break;
+      }
+      if(std::find(m_wanted.begin(), m_wanted.end(), tile.key) == m_wanted.end()) {
+        m_wanted.push_back(tile.key);
+      }
+    }
+
+    for(auto iter = m_tiles.begin(); iter != m_tiles.end();) {
+      if(std::find(m_wanted.begin(), m_wanted.end(), iter->first) == m_wanted.end()) {
+        iter = m_tiles.erase(iter);
+      } else {
+        iter++;
+      }
+    }
+    schedule();
+  }
+
+  /*
+   * Posts the computation of the next missing tile, one at a time.
+   */
+  void schedule()
+  {
+    if(m_is_pending) {
+      return;
+    }
+    for(const auto& key : m_wanted)
+    {
+      if(m_tiles.count(key)) {
+        continue;
+      }
+      m_is_pending = true;
+      const std::weak_ptr<TilePrefetcher> weak_self = weak_from_this();
+      const world_ptr_t world = m_world;
+
+      m_post([weak_self, world, key]() {
+        auto self = weak_self.lock();
+        if(!self) {
+          return;
+        }
+        tile_ptr_t tile;
+        try {
+          tile = self->m_compute(world, key.first, key.second);
+        } catch(...) {
+          // leave it to the regular map update
+        }
+        std::lock_guard<std::mutex> lock(self->m_mutex);
+        self->m_is_pending = false;
+        if(world == self->m_world
+          && std::find(self->m_wanted.begin(), self->m_wanted.end(), key) != self->m_wanted.end())
+        {
+          self->m_tiles[key] = tile;    // null if failed, not retried until the route changes
+        }
+        self->schedule();
+      });
+      return;
+    }
+  }
+
+  const int m_map_size;
+  const int m_tile_step;
+  const double m_lookahead;
+  const size_t m_max_tiles;
+  const compute_func_t m_compute;
+  const post_func_t m_post;
+
+  mutable std::mutex m_mutex;
+  world_ptr_t m_world;
+  std::vector<route_point_t> m_route;
+  std::vector<route_tile_t> m_route_tiles;
+  size_t m_progress = 0;          // index into m_route
+  bool m_have_progress = false;
+  std::vector<key_t> m_wanted;    // tiles to keep, in route order
+  std::map<key_t, tile_ptr_t> m_tiles;
+  bool m_is_pending = false;
+  std::atomic<uint64_t> m_num_hits {0};
+  std::atomic<uint64_t> m_num_misses {0};
+
+};
+
+
+#endif /* INCLUDE_NEO_LOCALIZATION_TILEPREFETCHER_H_ */
@@ -0,0 +1,17 @@
+import launch
+import launch.actions
+import launch.substitutions
+import os
+from ament_index_python.packages import get_package_share_directory
+import launch_ros.actions
+
+
+def generate_launch_description():
+
+    config = os.path.join(get_package_share_directory('neo_localization2'),'launch','multi_robot_host.yaml')
+
+    return launch.LaunchDescription([
+        launch_ros.actions.Node(
+            package='neo_localization2', executable='neo_localization_host', output='screen',
+            parameters = [config])
+    ])
@@ -0,0 +1,128 @@
+/*
+ * neo_localization_host.cpp
+ *
+ * Runs the localization of several robots in one process, sharing the map, the map tiles
+ * and a bounded pool of worker threads.
+ */
+#include <neo_localization/NeoLocalizationNode.h>
+
+#include <iostream>
+#include <thread>
+
+
+class NeoLocalizationHost : public rclcpp::Node {
+public:
+  NeoLocalizationHost(): Node("neo_localization_host")
+  {
+    this->declare_parameter<std::vector<std::string>>("robot_namespaces", std::vector<std::string>());
+    this->get_parameter("robot_namespaces", m_robot_namespaces);
+
+    this->declare_parameter<int>("num_threads", 0);
+    this->get_parameter("num_threads", m_num_threads);
+
+    this->declare_parameter<int>("tile_step", 0);
+    this->get_parameter("tile_step", m_tile_step);
+
+    this->declare_parameter<double>("report_interval", 10.);
+    this->get_parameter("report_interval", m_report_interval);
+
+    if(m_num_threads <= 0) {
+      m_num_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    }
+    m_shared = std::make_shared<NeoLocalizationShared>();
+    m_shared->pool = std::make_unique<ThreadPool>(m_num_threads);
+    m_shared->tile_step = m_tile_step;
+
+    for(const auto& robot_namespace : m_robot_namespaces) {
+      m_robots.push_back(std::make_shared<NeoLocalizationNode>(robot_namespace, m_shared));
+    }
+
+    m_sub_map_topic = this->create_subscription<nav_msgs::msg::OccupancyGrid>("/map", rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+                            std::bind(&NeoLocalizationHost::map_callback, this, std::placeholders::_1));
+
+    if(m_report_interval > 0) {
+      m_report_timer = create_wall_timer(
+                  std::chrono::duration<double>(m_report_interval), std::bind(&NeoLocalizationHost::report, this));
+    }
+
+    RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationHost: Running " << m_robots.size() << " robots on " << m_num_threads << " threads");
+  }
+
+  /*
+   * Waits for all pending updates, has to be called before the nodes are destroyed.
+   */
+  void shutdown()
+  {
+    m_shared->pool.reset();
+  }
+
+  const std::vector<std::shared_ptr<NeoLocalizationNode>>& get_robots() const {
+    return m_robots;
+  }
+
+protected:
+  /*
+   * Hands the map to all robots, without copying it.
+   */
+  void map_callback(const nav_msgs::msg::OccupancyGrid::SharedPtr ros_map)
+  {
+    for(const auto& robot : m_robots) {
+      robot->set_map(ros_map);
+    }
+  }
+
+  /*
+   * Logs the loc_update() latency of every robot.
+   */
+  void report()
+  {
+    for(size_t i = 0; i < m_robots.size(); ++i)
+    {
+      const auto latency = m_robots[i]->get_latency();
+      RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationHost: [" << m_robot_namespaces[i] << "] "
+          << latency.num_updates << " updates, latency mean=" << float(latency.mean * 1e3) << " ms, max="
+          << float(latency.max * 1e3) << " ms, skipped=" << latency.num_skipped);
+    }
+    RCLCPP_INFO_STREAM(this->get_logger(), "NeoLocalizationHost: " << m_shared->tiles.size() << " map tiles in use, "
+        << m_shared->tiles.num_hits() << " hits, " << m_shared->tiles.num_misses() << " misses, "
+        << m_shared->pool->queue_size() << " tasks queued");
+  }
+
+private:
+  std::vector<std::string> m_robot_namespaces;
+  int m_num_threads = 0;
+  int m_tile_step = 0;
+  double m_report_interval = 0;
+
+  std::shared_ptr<NeoLocalizationShared> m_shared;
+  std::vector<std::shared_ptr<NeoLocalizationNode>> m_robots;
+
+  rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr m_sub_map_topic;
+  rclcpp::TimerBase::SharedPtr m_report_timer;
+
+};
+
+int main(int argc, char** argv)
+{
+  // initialize ROS
+  rclcpp::init(argc, argv);
+
+  try {
+    auto host = std::make_shared<NeoLocalizationHost>();
+
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(host);
+    for(const auto& robot : host->get_robots()) {
+      executor.add_node(robot);
+    }
+    executor.spin();
+
+    host->shutdown();
+  }
+  catch(const std::exception& ex) {
+    std::cout<<"NeoLocalizationHost: " << ex.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/*********************************************************************
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ *********************************************************************/
+
+#ifndef INCLUDE_MPCCOSTFUNCTION_H_
+#define INCLUDE_MPCCOSTFUNCTION_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace neo_mpc_planner {
+
+struct Pose2D {
+  double x = 0;
+  double y = 0;
+  double yaw = 0;
+};
+
+struct MpcCostParams {
+  double w_trans = 0.5;
+  double w_orient = 0.5;
+  double w_control = 0.5;
+  double w_terminal = 0.5;
+  double w_costmap = 0.5;
+  double w_footprint = 2000;
+  double dt = 0.1;
+  int control_steps = 3;
+};
+
+/**
+ * @brief Native version of the MPC objective used by mpc_optimization_server.py
+ *
+ * The control sequence is laid out as [vx_0, vy_0, wz_0, vx_1, vy_1, wz_1, ...].
+ * Costmap values are taken from a nav_msgs/OccupancyGrid (0 to 100, -1 unknown)
+ * and scaled to 0 to 1, cells outside of the grid count as 1 (lethal).
+ */
+class MpcCostFunction {
+
+public:
+  void setParams(const MpcCostParams & params);
+
+  void setCostmap(
+    const int8_t * data, int width, int height,
+    double resolution, double origin_x, double origin_y);
+
+  /**
+   * @brief Sets the footprint polygon, as published by the local costmap.
+   */
+  void setFootprint(const std::vector<double> & points_x, const std::vector<double> & points_y);
+
+  /**
+   * @brief Sets the per-request inputs
+   * @param current_pose  Robot pose in the costmap frame
+   * @param current_vel   Current robot velocity (vx, vy, wz stored as x, y, yaw)
+   * @param carrot        Lookahead pose relative to the robot
+   * @param goal          Final goal pose
+   */
+  void setState(
+    const Pose2D & current_pose, const Pose2D & current_vel,
+    const Pose2D & carrot, const Pose2D & goal);
+
+  /**
+   * @brief Evaluates the objective for a control sequence
+   * @param control   Control sequence of size 3 * control_steps
+   * @param gradient  Output, if not NULL, filled with 3 * control_steps partial derivatives
+   * @return          Total cost
+   *
+   * Gives the same cost as the python objective of the optimization server.
+   * Costmap and footprint terms are piecewise constant in the controls, their
+   * contribution to the gradient is zero.
+   */
+  double evaluate(const double * control, double * gradient) const;
+
+  /**
+   * @brief Returns the costmap value (-0.01 for unknown, 0 to 1) at a world position,
+   * same as Costmap2d.getCost() in python.
+   * @throws std::out_of_range where the python lookup raises an IndexError
+   */
+  double getCost(double x, double y) const;
+
+  int numVariables() const { return 3 * params_.control_steps; }
+
+private:
+  double getCellCost(long mx, long my) const;
+
+  double getFootprintCost() const;
+
+  MpcCostParams params_;
+
+  std::vector<int8_t> costmap_;
+  int width_ = 0;
+  int height_ = 0;
+  double resolution_ = 1;
+  double origin_x_ = 0;
+  double origin_y_ = 0;
+
+  std::vector<double> footprint_x_;
+  std::vector<double> footprint_y_;
+
+  Pose2D current_pose_;
+  Pose2D current_vel_;
+  Pose2D carrot_;
+  Pose2D goal_;
+};
+
+} // neo_mpc_planner
+
+#endif /* INCLUDE_MPCCOSTFUNCTION_H_ */
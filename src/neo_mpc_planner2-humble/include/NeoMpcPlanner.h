@@ -34,6 +34,8 @@ SOFTWARE.
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 
 #include "nav2_core/controller.hpp"
 #include "nav2_util/geometry_utils.hpp"
@@ -157,6 +159,40 @@ private:
 
   double getLookAheadDistance(const geometry_msgs::msg::Twist & speed);
 
+  /**
+   * @brief Command used when the optimizer misses the deadline: the last optimised
+   * control sequence, shifted by its age, or else a simple tracking law towards the carrot.
+   * Stops if the command would collide, or if the last response was a stop.
+   * @param pose        Current robot pose (costmap frame)
+   * @param speed       Current robot velocity
+   * @param carrot_pose Look ahead point (robot frame)
+   */
+  geometry_msgs::msg::Twist computeFallbackCommand(
+    const geometry_msgs::msg::PoseStamped & pose,
+    const geometry_msgs::msg::Twist & speed,
+    const geometry_msgs::msg::PoseStamped & carrot_pose);
+
+  /**
+   * @brief Checks the footprint along the path of a constant command
+   * @return false if it hits a lethal cell within the horizon
+   */
+  bool isCommandSafe(
+    const geometry_msgs::msg::PoseStamped & pose,
+    const geometry_msgs::msg::Twist & cmd, double horizon) const;
+
+  /**
+   * @brief Keeps the control sequence of an optimizer response sent at the given time,
+   * and whether the response stopped the robot
+   */
+  void storeControlSequence(
+    const neo_srvs2::srv::Optimizer::Response & response,
+    const rclcpp::Time & stamp);
+
+  /**
+   * @brief Logs the deadline misses once per report interval
+   */
+  void reportDeadlineMisses();
+
   geometry_msgs::msg::Pose goal_pose;
   bool closer_to_goal = false;
   bool slow_down_ = true;
@@ -167,6 +203,38 @@ private:
   double lookahead_dist_close_to_goal_ = 0.0;
   double control_frequency = 0.0;
 
+  // optimizer deadline and fallback
+  double optimizer_deadline_ = 0.0;         // [s], 0 = wait for the optimizer
+  double fallback_gain_trans_ = 0.0;        // [1/s]
+  double fallback_gain_theta_ = 0.0;        // [1/s]
+  double fallback_max_vel_x_ = 0.0;
+  double fallback_max_vel_y_ = 0.0;         // 0 for differential drive
+  double fallback_max_vel_theta_ = 0.0;
+  double fallback_acc_lim_trans_ = 0.0;
+  double fallback_acc_lim_theta_ = 0.0;
+  double fallback_collision_horizon_ = 0.0; // [s]
+  double deadline_report_interval_ = 0.0;   // [s]
+
+  rclcpp::Client<neo_srvs2::srv::Optimizer>::SharedFuture pending_result_;
+  uint64_t pending_cycle_ = 0;              // cycle in which the pending request was sent
+  uint64_t pending_goal_generation_ = 0;    // goal for which the pending request was sent
+  uint64_t goal_generation_ = 0;            // incremented on every new goal
+  rclcpp::Time pending_stamp_;
+  std::vector<geometry_msgs::msg::Twist> last_sequence_;
+  double last_sequence_dt_ = 0.0;
+  rclcpp::Time last_sequence_stamp_;
+  bool last_response_stop_ = false;         // the optimizer stopped the robot for a collision
+
+  // statistics since the last report
+  uint64_t num_cycles_ = 0;
+  uint64_t num_deadline_misses_ = 0;
+  uint64_t num_sequence_fallbacks_ = 0;
+  uint64_t num_tracking_fallbacks_ = 0;
+  uint64_t num_fallback_stops_ = 0;
+  uint64_t total_cycles_ = 0;
+  uint64_t total_deadline_misses_ = 0;
+  std::chrono::steady_clock::time_point last_report_time_;
+
   std::unique_ptr<nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>>
   collision_checker_;
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
@@ -1 +0,0 @@
-from neo_mpc_planner2.mpc import *
\ No newline at end of file
@@ -25,7 +25,7 @@
 import rclpy
 from rclpy.node import Node
 from neo_srvs2.srv import Optimizer
-from geometry_msgs.msg import TwistStamped, PoseStamped, Pose, Polygon
+from geometry_msgs.msg import TwistStamped, PoseStamped, Pose, Polygon, Twist
 from nav_msgs.msg import OccupancyGrid, Path
 import numpy as np
 from scipy.optimize import minimize
@@ -41,6 +41,11 @@ from tf2_ros.transform_listener import TransformListener
 from rcl_interfaces.msg import SetParametersResult
 from rclpy.parameter import Parameter
 
+try:
+	from neo_mpc_planner2._mpc_cost import MpcCostFunction, MpcCostParams, Pose2D
+except ImportError:
+	MpcCostFunction = None
+
 class MpcOptimizationServer(Node):
 	def __init__(self):
 		super().__init__('mpc_optimization_server')
@@ -73,6 +78,8 @@ class MpcOptimizationServer(Node):
 		self.declare_parameter('prediction_horizon', value = 0.5)
 		# self.declare_parameter('control_horizon', value = 0.5)
 		self.declare_parameter('control_steps', value = 3)
+		# Evaluate the objective with the compiled cost function (if available)
+		self.declare_parameter('use_native_cost', value = True)
 
 		# Get Parameters
 		self.acc_x_limit = self.get_parameter('acc_x_limit').value
@@ -101,6 +108,11 @@ class MpcOptimizationServer(Node):
 		self.prediction_horizon= self.get_parameter('prediction_horizon').value
 		self.no_ctrl_steps = self.get_parameter('control_steps').value
 		self.waiting_time = self.get_parameter('waiting_time').value
+		self.use_native_cost = self.get_parameter('use_native_cost').value
+
+		if self.use_native_cost and MpcCostFunction is None:
+			self.get_logger().warn("Native cost function not available, falling back to python objective")
+			self.use_native_cost = False
 
 		self.srv = self.create_service(Optimizer, 'optimizer', self.optimizer)
 		self.add_on_set_parameters_callback(self.cb_params)
@@ -151,8 +163,13 @@ class MpcOptimizationServer(Node):
 		self.tf_listener = TransformListener(self.tf_buffer, self)
 		self.control_interval = 0.0;
 
+		self.native_cost = MpcCostFunction() if self.use_native_cost else None
+		self.native_costmap = None
+
 	def footprint_callback(self, msg):
 		self.footprint = msg.polygon
+		if self.native_cost is not None:
+			self.native_cost.set_footprint([p.x for p in msg.polygon.points], [p.y for p in msg.polygon.points])
 
 	def f_constraint(self, initial, index):
 		return  self.max_vel_trans - (np.sqrt((initial[0 + index * 3]) * (initial[0 + index * 3]) +(initial[1 + index * 3]) * (initial[1 + index * 3])))   
@@ -268,6 +285,39 @@ class MpcOptimizationServer(Node):
 		self.cost_total += ((self.w_trans * step_dist_error**2) + (self.w_orient* step_orient_error**2)) * self.w_terminal 
 		return self.cost_total
 
+	def update_native_cost(self):
+		params = MpcCostParams()
+		params.w_trans = self.w_trans
+		params.w_orient = self.w_orient
+		params.w_control = self.w_control
+		params.w_terminal = self.w_terminal
+		params.w_costmap = self.w_costmap_scale
+		params.w_footprint = self.w_footprint_scale
+		params.dt = self.dt
+		params.control_steps = self.no_ctrl_steps
+		self.native_cost.set_params(params)
+
+		# only upload the costmap when a new one was received
+		if self.native_costmap is not self.costmap_ros.costmap:
+			info = self.costmap_ros.costmap.info
+			self.native_cost.set_costmap(self.costmap_ros.grid, info.width, info.height, info.resolution, \
+				info.origin.position.x, info.origin.position.y)
+			self.native_costmap = self.costmap_ros.costmap
+
+		_, _, target_yaw = self.euler_from_quaternion(self.carrot_pose.pose.orientation.x, self.carrot_pose.pose.orientation.y, self.carrot_pose.pose.orientation.z, self.carrot_pose.pose.orientation.w)
+		_, _, final_yaw = self.euler_from_quaternion(self.goal_pose.orientation.x, self.goal_pose.orientation.y, self.goal_pose.orientation.z, self.goal_pose.orientation.w)
+		_, _, odom_yaw = self.euler_from_quaternion(self.current_pose.pose.orientation.x, self.current_pose.pose.orientation.y, self.current_pose.pose.orientation.z, self.goal_pose.orientation.w)
+
+		self.native_cost.set_state(
+			Pose2D(self.current_pose.pose.position.x, self.current_pose.pose.position.y, odom_yaw),
+			Pose2D(self.current_velocity.linear.x, self.current_velocity.linear.y, self.current_velocity.angular.z),
+			Pose2D(self.carrot_pose.pose.position.x, self.carrot_pose.pose.position.y, target_yaw),
+			Pose2D(self.goal_pose.position.x, self.goal_pose.position.y, final_yaw))
+
+	def native_objective(self, cmd_vel):
+		# returns cost and gradient
+		return self.native_cost.evaluate(cmd_vel)
+
 	def publishLocalPlan(self, x):
 		self.local_plan.poses.clear()
 		try:
@@ -360,8 +410,13 @@ class MpcOptimizationServer(Node):
 			self.last_control = [0,0,0]
 			self.waiting_time = 0.0
 
-		x = minimize(self.objective, self.initial_guess,
-				method='SLSQP',bounds= self.bnds, constraints = self.cons, options={'ftol':self.opt_tolerance,'disp':False})		
+		if self.native_cost is not None:
+			self.update_native_cost()
+			x = minimize(self.native_objective, self.initial_guess, jac = True,
+					method='SLSQP',bounds= self.bnds, constraints = self.cons, options={'ftol':self.opt_tolerance,'disp':False})
+		else:
+			x = minimize(self.objective, self.initial_guess,
+					method='SLSQP',bounds= self.bnds, constraints = self.cons, options={'ftol':self.opt_tolerance,'disp':False})
 		self.publishLocalPlan(x.x)
 		for i in range(0,3):
 			x.x[i] = x.x[i] * self.low_pass_gain + self.last_control[i] * (1 - self.low_pass_gain)
@@ -371,7 +426,8 @@ class MpcOptimizationServer(Node):
 		self.last_time = current_time
 		self.collision_check(x.x)
 
-		if (self.collision == True or self.collision_footprint == True):
+		stopped = (self.collision == True or self.collision_footprint == True)
+		if stopped:
 			response.output_vel.twist.linear.x = 0.0
 			response.output_vel.twist.linear.y = 0.0
 			response.output_vel.twist.angular.z = 0.0
@@ -390,6 +446,22 @@ class MpcOptimizationServer(Node):
 			response.output_vel.twist.linear.y = np.fmax(temp_y, self.last_control[1] - self.acc_y_limit * self.control_interval) 
 			response.output_vel.twist.angular.z = np.fmax(temp_z, self.last_control[2] - self.acc_theta_limit * self.control_interval)
 
+		# the whole optimised sequence, starting with the command sent now, so that the
+		# planner can keep following it if a later call misses its deadline
+		response.control_dt = float(self.dt)
+		response.stopped = bool(stopped)
+		if stopped:
+			# stopped for a collision, the planner keeps standing as well
+			response.control_sequence = [Twist() for i in range(self.no_ctrl_steps)]
+		else:
+			response.control_sequence.append(response.output_vel.twist)
+			for i in range(1, self.no_ctrl_steps):
+				step = Twist()
+				step.linear.x = float(x.x[0+3*i])
+				step.linear.y = float(x.x[1+3*i])
+				step.angular.z = float(x.x[2+3*i])
+				response.control_sequence.append(step)
+
 		self.last_control[0] = response.output_vel.twist.linear.x 
 		self.last_control[1] = response.output_vel.twist.linear.y 
 		self.last_control[2] = response.output_vel.twist.angular.z
@@ -0,0 +1,218 @@
+/*********************************************************************
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ *********************************************************************/
+
+#include "../include/MpcCostFunction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace neo_mpc_planner {
+
+void MpcCostFunction::setParams(const MpcCostParams & params)
+{
+  params_ = params;
+}
+
+void MpcCostFunction::setCostmap(
+  const int8_t * data, int width, int height,
+  double resolution, double origin_x, double origin_y)
+{
+  width_ = width;
+  height_ = height;
+  resolution_ = resolution;
+  origin_x_ = origin_x;
+  origin_y_ = origin_y;
+
+  costmap_.assign(data, data + size_t(width) * height);
+}
+
+void MpcCostFunction::setFootprint(
+  const std::vector<double> & points_x, const std::vector<double> & points_y)
+{
+  const size_t num_points = std::min(points_x.size(), points_y.size());
+  footprint_x_.assign(points_x.begin(), points_x.begin() + num_points);
+  footprint_y_.assign(points_y.begin(), points_y.begin() + num_points);
+}
+
+void MpcCostFunction::setState(
+  const Pose2D & current_pose, const Pose2D & current_vel,
+  const Pose2D & carrot, const Pose2D & goal)
+{
+  current_pose_ = current_pose;
+  current_vel_ = current_vel;
+  carrot_ = carrot;
+  goal_ = goal;
+}
+
+double MpcCostFunction::getCellCost(long mx, long my) const
+{
+  // same lookup as Costmap2d.getCost() in neo_nav2_py_costmap2D: x is checked against
+  // the height and y against the width, negative indices wrap around like numpy's
+  if (std::labs(mx) > height_ - 1 || std::labs(my) > width_ - 1) {
+    return 1.0;
+  }
+  const long row = my < 0 ? my + height_ : my;
+  const long col = mx < 0 ? mx + width_ : mx;
+  if (row < 0 || row >= height_ || col < 0 || col >= width_) {
+    // IndexError in python, only possible for non-square costmaps
+    throw std::out_of_range("costmap index out of range");
+  }
+  // unknown (-1) cells give -0.01, as in python
+  return costmap_[size_t(row) * width_ + col] / 100.;
+}
+
+double MpcCostFunction::getCost(double x, double y) const
+{
+  // same rounding (half to even) as python's round()
+  const long mx = std::lrint((x - origin_x_) / resolution_);
+  const long my = std::lrint((y - origin_y_) / resolution_);
+  return getCellCost(mx, my);
+}
+
+double MpcCostFunction::getFootprintCost() const
+{
+  double footprint_cost = 0;
+
+  // the last point is skipped, as in Costmap2d.getFootprintCost()
+  for (size_t j = 0; j + 1 < footprint_x_.size(); ++j) {
+    footprint_cost = std::max(getCost(footprint_x_[j], footprint_y_[j]), footprint_cost);
+    if (footprint_cost == 1.0) {
+      return 1.0;
+    }
+  }
+  return footprint_cost;
+}
+
+double MpcCostFunction::evaluate(const double * control, double * gradient) const
+{
+  const int N = params_.control_steps;
+  const double dt = params_.dt;
+
+  // rollout relative to the robot (x, y, z) and in the costmap frame (pos_x, pos_y, odom_yaw)
+  std::vector<double> x(N), y(N), z(N);
+  std::vector<double> pos_x(N), pos_y(N);
+  {
+    double x_ = 0, y_ = 0, z_ = 0;
+    double px = current_pose_.x, py = current_pose_.y, odom_yaw = current_pose_.yaw;
+    for (int i = 0; i < N; ++i) {
+      const double vx = control[3 * i];
+      const double vy = control[3 * i + 1];
+      const double wz = control[3 * i + 2];
+
+      z_ += wz * dt;
+      x_ += (vx * std::cos(z_) - vy * std::sin(z_)) * dt;
+      y_ += (vx * std::sin(z_) + vy * std::cos(z_)) * dt;
+      odom_yaw += wz * dt;
+      px += (vx * std::cos(odom_yaw) - vy * std::sin(odom_yaw)) * dt;
+      py += (vx * std::sin(odom_yaw) + vy * std::cos(odom_yaw)) * dt;
+
+      x[i] = x_;
+      y[i] = y_;
+      z[i] = z_;
+      pos_x[i] = px;
+      pos_y[i] = py;
+    }
+  }
+
+  // partial derivatives of the cost with respect to each rollout pose
+  std::vector<double> gx(N, 0), gy(N, 0), gz(N, 0);
+  double cost = 0;
+
+  // the python objective checks the footprint as published, i.e. at the current pose
+  const bool footprint_collision = getFootprintCost() == 1.0;
+
+  for (int i = 0; i < N; ++i) {
+    // i) error in displacement and orientation
+    const double ex = carrot_.x - x[i];
+    const double ey = carrot_.y - y[i];
+    const double eyaw = carrot_.yaw - z[i];
+    cost += (params_.w_trans * (ex * ex + ey * ey) + params_.w_orient * eyaw * eyaw) / N;
+    gx[i] += -2 * params_.w_trans * ex / N;
+    gy[i] += -2 * params_.w_trans * ey / N;
+    gz[i] += -2 * params_.w_orient * eyaw / N;
+
+    // control error
+    const double du_x = current_vel_.x - control[3 * i];
+    const double du_y = current_vel_.y - control[3 * i + 1];
+    const double du_z = current_vel_.yaw - control[3 * i + 2];
+    const double du = std::sqrt(du_x * du_x + du_y * du_y + du_z * du_z);
+    cost += params_.w_control * du / N;
+    if (gradient) {
+      const double scale = du > 0 ? -params_.w_control / (N * du) : 0;
+      gradient[3 * i] = scale * du_x;
+      gradient[3 * i + 1] = scale * du_y;
+      gradient[3 * i + 2] = scale * du_z;
+    }
+
+    // ii) obstacle cost
+    const double cell_cost = getCost(pos_x[i], pos_y[i]);
+    const double costmap_cost = cell_cost * cell_cost;
+    if (cell_cost == 1.0) {
+      cost += costmap_cost * 1000 / N;
+    } else {
+      cost += params_.w_costmap * costmap_cost / N;
+    }
+    if (footprint_collision) {
+      cost += params_.w_footprint / N;
+    }
+  }
+
+  // iii) terminal cost
+  {
+    const double ex = carrot_.x - goal_.x;
+    const double ey = carrot_.y - goal_.y;
+    const double eyaw = goal_.yaw - (N > 0 ? z[N - 1] : 0);
+    cost += (params_.w_trans * (ex * ex + ey * ey) + params_.w_orient * eyaw * eyaw) *
+      params_.w_terminal;
+    if (N > 0) {
+      gz[N - 1] += -2 * params_.w_orient * eyaw * params_.w_terminal;
+    }
+  }
+
+  if (!gradient) {
+    return cost;
+  }
+
+  // back-propagate through the rollout, from the last step to the first
+  double sum_gx = 0, sum_gy = 0, sum_h = 0;
+  for (int i = N - 1; i >= 0; --i) {
+    const double vx = control[3 * i];
+    const double vy = control[3 * i + 1];
+    const double cos_z = std::cos(z[i]);
+    const double sin_z = std::sin(z[i]);
+
+    sum_gx += gx[i];
+    sum_gy += gy[i];
+    sum_h += gz[i] + dt * ((-vx * sin_z - vy * cos_z) * sum_gx + (vx * cos_z - vy * sin_z) * sum_gy);
+
+    gradient[3 * i] += dt * (cos_z * sum_gx + sin_z * sum_gy);
+    gradient[3 * i + 1] += dt * (-sin_z * sum_gx + cos_z * sum_gy);
+    gradient[3 * i + 2] += dt * sum_h;
+  }
+  return cost;
+}
+
+} // neo_mpc_planner
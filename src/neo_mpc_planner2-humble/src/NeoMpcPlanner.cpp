@@ -35,10 +35,14 @@ SOFTWARE.
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/geometry_utils.hpp"
 #include "nav2_costmap_2d/costmap_filters/filter_values.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include <algorithm>
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <chrono>
+#include <cmath>
+#include <future>
+#include <neo_tracetools/tracetools.h>
 
 using std::hypot;
 using std::min;
@@ -205,6 +209,7 @@ geometry_msgs::msg::TwistStamped NeoMpcPlanner::computeVelocityCommands(
   nav2_core::GoalChecker * goal_checker)
 {
   std::lock_guard<std::mutex> lock_reinit(mutex_);
+  NEO_TRACE_SCOPE("neo_mpc_planner", "computeVelocityCommands", neo_tracetools::stamp_ns(position.header.stamp));
   auto transformed_plan = transformGlobalPlan(position);
 
   // Find look ahead distance and point on path and publish
@@ -245,15 +250,188 @@ geometry_msgs::msg::TwistStamped NeoMpcPlanner::computeVelocityCommands(
   request->switch_opt = closer_to_goal;
   request->control_interval = 1.0 / control_frequency;
 
-  auto result = client->async_send_request(request);
+  total_cycles_++;
+  num_cycles_++;
+  const auto deadline = std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(optimizer_deadline_));
+
+  while (true) {
+    // only one request at a time, if the optimizer is still busy with the one of an
+    // earlier cycle we wait for that first
+    if (!pending_result_.valid()) {
+      NEO_TRACEPOINT(message, "neo_mpc_planner", "send", "optimizer", neo_tracetools::stamp_ns(position.header.stamp));
+      pending_result_ = client->async_send_request(request).future.share();
+      pending_cycle_ = total_cycles_;
+      pending_goal_generation_ = goal_generation_;
+      pending_stamp_ = clock_->now();
+    }
+
+    if (optimizer_deadline_ <= 0.0) {
+      pending_result_.wait();
+    } else if (pending_result_.wait_until(deadline) != std::future_status::ready) {
+      break;
+    }
+
+    auto out = pending_result_.get();
+    pending_result_ = {};
+    NEO_TRACEPOINT(message, "neo_mpc_planner", "receive", "optimizer", neo_tracetools::stamp_ns(position.header.stamp));
+    if (pending_goal_generation_ != goal_generation_) {
+      // optimised for the previous goal, drop it
+      continue;
+    }
+    storeControlSequence(*out, pending_stamp_);
+
+    if (pending_cycle_ == total_cycles_) {
+      reportDeadlineMisses();
+      geometry_msgs::msg::TwistStamped cmd_vel_final;
+      cmd_vel_final = out->output_vel;
+      return cmd_vel_final;
+    }
+    // result of an earlier cycle, send the current request within the remaining time
+  }
+
+  // no result in time, the request stays pending for the next cycles
+  NEO_TRACEPOINT(phase, "neo_mpc_planner", "deadline_miss", neo_tracetools::stamp_ns(position.header.stamp));
+  total_deadline_misses_++;
+  num_deadline_misses_++;
 
-  auto out = result.get();
   geometry_msgs::msg::TwistStamped cmd_vel_final;
-  cmd_vel_final = out->output_vel; 
+  cmd_vel_final.header.stamp = position.header.stamp;
+  cmd_vel_final.header.frame_id = costmap_ros_->getBaseFrameID();
+  cmd_vel_final.twist = computeFallbackCommand(position, speed, carrot_pose);
 
+  reportDeadlineMisses();
   return cmd_vel_final;
 }
 
+geometry_msgs::msg::Twist NeoMpcPlanner::computeFallbackCommand(
+  const geometry_msgs::msg::PoseStamped & pose,
+  const geometry_msgs::msg::Twist & speed,
+  const geometry_msgs::msg::PoseStamped & carrot_pose)
+{
+  geometry_msgs::msg::Twist cmd;
+  bool have_cmd = false;
+
+  // the optimizer stopped the robot for a collision, keep standing until it says otherwise
+  if (last_response_stop_) {
+    num_fallback_stops_++;
+    return cmd;
+  }
+
+  // keep following the last optimised sequence, at the step which is due now
+  if (!last_sequence_.empty() && last_sequence_dt_ > 0.0) {
+    const double age = (clock_->now() - last_sequence_stamp_).seconds();
+    if (age >= 0.0) {
+      const size_t index = static_cast<size_t>(age / last_sequence_dt_);
+      if (index < last_sequence_.size()) {
+        cmd = last_sequence_[index];
+        have_cmd = true;
+        num_sequence_fallbacks_++;
+      }
+    }
+  }
+
+  // otherwise steer towards the carrot (in robot frame)
+  if (!have_cmd) {
+    const double carrot_x = carrot_pose.pose.position.x;
+    const double carrot_y = carrot_pose.pose.position.y;
+    cmd.linear.x = fallback_gain_trans_ * carrot_x;
+    if (fallback_max_vel_y_ > 0.0) {
+      cmd.linear.y = fallback_gain_trans_ * carrot_y;
+      cmd.angular.z = fallback_gain_theta_ * tf2::getYaw(carrot_pose.pose.orientation);
+    } else {
+      // differential drive, turn towards the carrot instead
+      cmd.angular.z = fallback_gain_theta_ * std::atan2(carrot_y, carrot_x);
+      if (carrot_x < 0.0) {
+        cmd.linear.x = 0.0;
+      }
+    }
+    num_tracking_fallbacks_++;
+  }
+
+  // velocity limits, keeping the direction of translation
+  const double scale = std::min(
+    std::min(fabs(cmd.linear.x) > fallback_max_vel_x_ ? fallback_max_vel_x_ / fabs(cmd.linear.x) : 1.0,
+    fabs(cmd.linear.y) > fallback_max_vel_y_ ? fallback_max_vel_y_ / fabs(cmd.linear.y) : 1.0), 1.0);
+  cmd.linear.x *= scale;
+  cmd.linear.y *= scale;
+  cmd.angular.z = std::clamp(cmd.angular.z, -fallback_max_vel_theta_, fallback_max_vel_theta_);
+
+  // acceleration limits
+  const double dt = 1.0 / control_frequency;
+  cmd.linear.x = std::clamp(
+    cmd.linear.x, speed.linear.x - fallback_acc_lim_trans_ * dt,
+    speed.linear.x + fallback_acc_lim_trans_ * dt);
+  cmd.linear.y = std::clamp(
+    cmd.linear.y, speed.linear.y - fallback_acc_lim_trans_ * dt,
+    speed.linear.y + fallback_acc_lim_trans_ * dt);
+  cmd.angular.z = std::clamp(
+    cmd.angular.z, speed.angular.z - fallback_acc_lim_theta_ * dt,
+    speed.angular.z + fallback_acc_lim_theta_ * dt);
+
+  if (!isCommandSafe(pose, cmd, fallback_collision_horizon_)) {
+    num_fallback_stops_++;
+    return geometry_msgs::msg::Twist();
+  }
+  return cmd;
+}
+
+bool NeoMpcPlanner::isCommandSafe(
+  const geometry_msgs::msg::PoseStamped & pose,
+  const geometry_msgs::msg::Twist & cmd, double horizon) const
+{
+  const int num_steps = 10;
+  const double dt = horizon / num_steps;
+  double x = pose.pose.position.x;
+  double y = pose.pose.position.y;
+  double yaw = tf2::getYaw(pose.pose.orientation);
+
+  for (int i = 0; i < num_steps; ++i) {
+    yaw += cmd.angular.z * dt;
+    x += (cmd.linear.x * cos(yaw) - cmd.linear.y * sin(yaw)) * dt;
+    y += (cmd.linear.x * sin(yaw) + cmd.linear.y * cos(yaw)) * dt;
+    if (collision_checker_->footprintCostAtPose(x, y, yaw, costmap_ros_->getRobotFootprint()) >=
+      LETHAL_OBSTACLE)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void NeoMpcPlanner::storeControlSequence(
+  const neo_srvs2::srv::Optimizer::Response & response,
+  const rclcpp::Time & stamp)
+{
+  last_sequence_ = response.control_sequence;
+  last_sequence_dt_ = response.control_dt;
+  last_sequence_stamp_ = stamp;
+  last_response_stop_ = response.stopped;
+}
+
+void NeoMpcPlanner::reportDeadlineMisses()
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (std::chrono::duration<double>(now - last_report_time_).count() < deadline_report_interval_) {
+    return;
+  }
+  if (num_deadline_misses_ > 0) {
+    RCLCPP_WARN_STREAM(
+      logger_, "Optimizer missed the deadline of " << optimizer_deadline_ * 1e3 << " ms in " <<
+        num_deadline_misses_ << " of " << num_cycles_ << " cycles (" << total_deadline_misses_ <<
+        " of " << total_cycles_ << " in total): followed the last sequence " <<
+        num_sequence_fallbacks_ << " times, tracked the carrot " << num_tracking_fallbacks_ <<
+        " times, stopped for collision " << num_fallback_stops_ << " times");
+  }
+  num_cycles_ = 0;
+  num_deadline_misses_ = 0;
+  num_sequence_fallbacks_ = 0;
+  num_tracking_fallbacks_ = 0;
+  num_fallback_stops_ = 0;
+  last_report_time_ = now;
+}
+
 void NeoMpcPlanner::cleanup()
 {
 }
@@ -269,6 +447,8 @@ void NeoMpcPlanner::activate()
 
 void NeoMpcPlanner::deactivate()
 {
+  last_sequence_.clear();
+  last_response_stop_ = false;
 }
 
 void NeoMpcPlanner::setPlan(const nav_msgs::msg::Path & plan)
@@ -276,6 +456,9 @@ void NeoMpcPlanner::setPlan(const nav_msgs::msg::Path & plan)
   global_plan_ = plan;
   if (goal_pose != plan.poses[plan.poses.size() - 1].pose) {
     slow_down_ = true;
+    last_sequence_.clear();
+    last_response_stop_ = false;
+    goal_generation_++;
   }
   goal_pose = plan.poses[plan.poses.size() - 1].pose;
 }
@@ -322,6 +505,39 @@ void NeoMpcPlanner::configure(
     lookahead_dist_close_to_goal_);
   node->get_parameter("controller_frequency", control_frequency);
 
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".optimizer_deadline", rclcpp::ParameterValue(0.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_gain_trans", rclcpp::ParameterValue(1.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_gain_theta", rclcpp::ParameterValue(1.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_max_vel_x", rclcpp::ParameterValue(0.3));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_max_vel_y", rclcpp::ParameterValue(0.3));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_max_vel_theta", rclcpp::ParameterValue(0.5));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_acc_lim_trans", rclcpp::ParameterValue(1.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_acc_lim_theta", rclcpp::ParameterValue(1.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".fallback_collision_horizon", rclcpp::ParameterValue(1.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".deadline_report_interval", rclcpp::ParameterValue(10.0));
+
+  node->get_parameter(plugin_name_ + ".optimizer_deadline", optimizer_deadline_);
+  node->get_parameter(plugin_name_ + ".fallback_gain_trans", fallback_gain_trans_);
+  node->get_parameter(plugin_name_ + ".fallback_gain_theta", fallback_gain_theta_);
+  node->get_parameter(plugin_name_ + ".fallback_max_vel_x", fallback_max_vel_x_);
+  node->get_parameter(plugin_name_ + ".fallback_max_vel_y", fallback_max_vel_y_);
+  node->get_parameter(plugin_name_ + ".fallback_max_vel_theta", fallback_max_vel_theta_);
+  node->get_parameter(plugin_name_ + ".fallback_acc_lim_trans", fallback_acc_lim_trans_);
+  node->get_parameter(plugin_name_ + ".fallback_acc_lim_theta", fallback_acc_lim_theta_);
+  node->get_parameter(plugin_name_ + ".fallback_collision_horizon", fallback_collision_horizon_);
+  node->get_parameter(plugin_name_ + ".deadline_report_interval", deadline_report_interval_);
+  last_report_time_ = std::chrono::steady_clock::now();
+
   while (!client->wait_for_service(1s)) {
     if (!rclcpp::ok()) {
       RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "Interrupted while waiting for the service. Exiting.");
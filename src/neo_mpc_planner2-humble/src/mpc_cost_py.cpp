@@ -0,0 +1,90 @@
+/*********************************************************************
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ *********************************************************************/
+
+#include "../include/MpcCostFunction.h"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <stdexcept>
+
+namespace py = pybind11;
+using namespace neo_mpc_planner;
+
+PYBIND11_MODULE(_mpc_cost, m)
+{
+  m.doc() = "Native cost function for the neo_mpc_planner2 optimization server";
+
+  py::class_<Pose2D>(m, "Pose2D")
+    .def(py::init<>())
+    .def(py::init([](double x, double y, double yaw) { return Pose2D{x, y, yaw}; }))
+    .def_readwrite("x", &Pose2D::x)
+    .def_readwrite("y", &Pose2D::y)
+    .def_readwrite("yaw", &Pose2D::yaw);
+
+  py::class_<MpcCostParams>(m, "MpcCostParams")
+    .def(py::init<>())
+    .def_readwrite("w_trans", &MpcCostParams::w_trans)
+    .def_readwrite("w_orient", &MpcCostParams::w_orient)
+    .def_readwrite("w_control", &MpcCostParams::w_control)
+    .def_readwrite("w_terminal", &MpcCostParams::w_terminal)
+    .def_readwrite("w_costmap", &MpcCostParams::w_costmap)
+    .def_readwrite("w_footprint", &MpcCostParams::w_footprint)
+    .def_readwrite("dt", &MpcCostParams::dt)
+    .def_readwrite("control_steps", &MpcCostParams::control_steps);
+
+  py::class_<MpcCostFunction>(m, "MpcCostFunction")
+    .def(py::init<>())
+    .def("set_params", &MpcCostFunction::setParams)
+    .def("set_costmap",
+      [](MpcCostFunction & self, py::array_t<int8_t, py::array::c_style | py::array::forcecast> data,
+        int width, int height, double resolution, double origin_x, double origin_y)
+      {
+        if (data.size() < py::ssize_t(width) * height) {
+          throw std::invalid_argument("costmap data is smaller than width * height");
+        }
+        self.setCostmap(data.data(), width, height, resolution, origin_x, origin_y);
+      })
+    .def("set_footprint", &MpcCostFunction::setFootprint)
+    .def("set_state", &MpcCostFunction::setState)
+    .def("get_cost", &MpcCostFunction::getCost)
+    .def("evaluate",
+      [](const MpcCostFunction & self, py::array_t<double, py::array::c_style | py::array::forcecast> control)
+      {
+        if (control.size() != self.numVariables()) {
+          throw std::invalid_argument("control sequence has wrong size");
+        }
+        py::array_t<double> gradient(control.size());
+        const double * input = control.data();
+        double * output = gradient.mutable_data();
+        double cost;
+        {
+          py::gil_scoped_release release;
+          cost = self.evaluate(input, output);
+        }
+        return py::make_tuple(cost, gradient);
+      },
+      "Returns (cost, gradient) for a control sequence [vx_0, vy_0, wz_0, ...]");
+}
@@ -0,0 +1,150 @@
+# MIT License
+
+# Copyright (c) 2022 neobotix gmbh
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Compares the native cost function with the python objective of the optimization server."""
+
+import math
+
+from geometry_msgs.msg import Point32, Polygon, Pose, PoseStamped, Twist
+from nav_msgs.msg import OccupancyGrid
+from neo_mpc_planner2._mpc_cost import MpcCostFunction
+from neo_mpc_planner2.mpc_optimization_server import MpcOptimizationServer
+from neo_nav2_py_costmap2D.costmap import Costmap2d
+import numpy as np
+import pytest
+
+
+def make_costmap(width, height, resolution, origin_x, origin_y, data):
+    msg = OccupancyGrid()
+    msg.info.width = width
+    msg.info.height = height
+    msg.info.resolution = resolution
+    msg.info.origin.position.x = origin_x
+    msg.info.origin.position.y = origin_y
+    msg.data = data
+    # only the parts which do not need a node
+    costmap = Costmap2d.__new__(Costmap2d)
+    costmap.costmap_callback(msg)
+    return costmap
+
+
+def make_pose(x, y, yaw):
+    pose = Pose()
+    pose.position.x = x
+    pose.position.y = y
+    pose.orientation.z = math.sin(yaw / 2)
+    pose.orientation.w = math.cos(yaw / 2)
+    return pose
+
+
+def make_server(costmap, footprint, current, carrot, goal, velocity):
+    server = MpcOptimizationServer.__new__(MpcOptimizationServer)
+    server.w_trans = 0.5
+    server.w_orient = 0.4
+    server.w_control = 0.3
+    server.w_terminal = 0.2
+    server.w_costmap_scale = 0.6
+    server.w_footprint_scale = 2000.0
+    server.no_ctrl_steps = 3
+    server.dt = 0.5 / server.no_ctrl_steps
+    server.costmap_ros = costmap
+    server.footprint = Polygon(points=[Point32(x=float(x), y=float(y)) for x, y in footprint])
+    server.current_pose = PoseStamped(pose=make_pose(*current))
+    server.carrot_pose = PoseStamped(pose=make_pose(*carrot))
+    server.goal_pose = make_pose(*goal)
+    server.current_velocity = Twist()
+    server.current_velocity.linear.x, server.current_velocity.linear.y, \
+        server.current_velocity.angular.z = velocity
+
+    server.native_cost = MpcCostFunction()
+    server.native_costmap = None
+    server.native_cost.set_footprint(
+        [p.x for p in server.footprint.points], [p.y for p in server.footprint.points])
+    server.update_native_cost()
+    return server
+
+
+# 8 x 8 cells of 0.25 m, free with an unknown row, some inflation and a lethal corner
+SQUARE_MAP = [0] * 64
+for mx in range(8):
+    SQUARE_MAP[2 * 8 + mx] = -1
+for my in range(5, 8):
+    for mx in range(5, 8):
+        SQUARE_MAP[my * 8 + mx] = 100 if my > 5 and mx > 5 else 60
+SQUARE_MAP[3 * 8 + 4] = 37
+
+
+def check_objective(footprint, current, carrot, goal, velocity):
+    costmap = make_costmap(8, 8, 0.25, -1.0, -1.0, SQUARE_MAP)
+    server = make_server(costmap, footprint, current, carrot, goal, velocity)
+    rng = np.random.default_rng(3)
+    for _ in range(50):
+        control = rng.uniform(-0.5, 0.5, 3 * server.no_ctrl_steps)
+        native, _ = server.native_cost.evaluate(control)
+        assert native == pytest.approx(server.objective(control), rel=1e-9, abs=1e-9)
+
+
+def footprint_at(x, y, corners):
+    return [(x + cx, y + cy) for cx, cy in corners]
+
+
+def test_objective_free():
+    corners = [(0.2, 0.15), (-0.2, 0.15), (-0.2, -0.15), (0.2, -0.15)]
+    check_objective(footprint_at(0.0, 0.0, corners), (0.0, 0.0, 0.3), (0.4, 0.1, 0.2),
+                    (0.6, 0.3, 0.5), (0.1, 0.0, 0.1))
+
+
+def test_objective_unknown_and_inflated():
+    # the rollout crosses the unknown row and the inflated cells
+    corners = [(0.2, 0.15), (-0.2, 0.15), (-0.2, -0.15), (0.2, -0.15)]
+    check_objective(footprint_at(0.3, -0.55, corners), (0.3, -0.55, 1.2), (0.0, 0.5, 0.0),
+                    (0.3, 0.6, 1.0), (0.0, 0.2, 0.0))
+
+
+def test_objective_footprint_collision():
+    corners = [(0.25, 0.25), (-0.25, 0.25), (-0.25, -0.25), (0.25, -0.25)]
+    check_objective(footprint_at(0.55, 0.55, corners), (0.55, 0.55, 0.0), (0.2, 0.0, 0.0),
+                    (0.2, 0.0, 0.0), (0.0, 0.0, 0.0))
+
+
+def test_objective_last_footprint_point_ignored():
+    # only the last point is on a lethal cell, python skips it
+    footprint = [(0.1, 0.1), (-0.1, 0.1), (-0.1, -0.1), (0.6, 0.6)]
+    check_objective(footprint, (0.0, 0.0, 0.0), (0.2, 0.0, 0.0), (0.2, 0.0, 0.0), (0.0, 0.0, 0.0))
+
+
+def test_get_cost_non_square():
+    # 6 x 4 cells, python checks x against the height and y against the width
+    data = [(i * 7) % 101 - 1 for i in range(24)]
+    costmap = make_costmap(6, 4, 0.5, -1.0, -2.0, data)
+    native = MpcCostFunction()
+    native.set_costmap(costmap.grid, 6, 4, 0.5, -1.0, -2.0)
+    for x in np.arange(-4.0, 4.0, 0.2):
+        for y in np.arange(-5.0, 5.0, 0.2):
+            mx, my = costmap.getWorldToMap(x, y)
+            try:
+                expected = costmap.getCost(mx, my)
+            except IndexError:
+                with pytest.raises(IndexError):
+                    native.get_cost(x, y)
+                continue
+            assert native.get_cost(x, y) == expected
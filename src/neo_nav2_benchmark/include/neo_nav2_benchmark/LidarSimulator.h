@@ -0,0 +1,334 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_NAV2_BENCHMARK_LIDARSIMULATOR_H_
+#define INCLUDE_NEO_NAV2_BENCHMARK_LIDARSIMULATOR_H_
+
+#include <nav_msgs/msg/occupancy_grid.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace neo_nav2_benchmark {
+
+struct Pose2D {
+  double x = 0;
+  double y = 0;
+  double yaw = 0;
+};
+
+/*
+ * Circular obstacle which moves back and forth along (vx, vy),
+ * reversing its direction every half period.
+ */
+struct DynamicObstacle {
+  double x = 0;
+  double y = 0;
+  double vx = 0;
+  double vy = 0;
+  double radius = 0.2;
+  double period = 10;   // [s]
+
+  void get_position(double t, double& px, double& py) const
+  {
+    // triangle wave between 0 and period / 2
+    const double half = period / 2;
+    double s = 0;
+    if(half > 0) {
+      s = std::fmod(std::max(t, 0.), period);
+      s = s < half ? s : period - s;
+    }
+    px = x + vx * s;
+    py = y + vy * s;
+  }
+};
+
+/*
+ * Raycasts synthetic 2D laser scans in an occupancy grid.
+ * Cells with a value >= occupied_threshold are hit, unknown cells are not.
+ * The beams of a scan are split into num_threads chunks, all but the first one are
+ * raycast by worker threads which are started once and kept for the following scans.
+ */
+class LidarSimulator {
+public:
+  LidarSimulator() = default;
+  LidarSimulator(const LidarSimulator&) = delete;
+  LidarSimulator& operator=(const LidarSimulator&) = delete;
+
+  ~LidarSimulator()
+  {
+    stop_workers();
+  }
+
+  int num_beams = 541;
+  double angle_min = -2.356;
+  double angle_max = 2.356;
+  double range_min = 0.05;
+  double range_max = 20;
+  double range_noise_std = 0.01;  // [m]
+  double dropout_probability = 0;  // probability of a beam returning no echo
+  int occupied_threshold = 65;
+  int num_threads = 4;
+
+  std::vector<DynamicObstacle> obstacles;
+
+  void set_map(const nav_msgs::msg::OccupancyGrid& map)
+  {
+    m_width = map.info.width;
+    m_height = map.info.height;
+    m_resolution = map.info.resolution;
+    m_origin_x = map.info.origin.position.x;
+    m_origin_y = map.info.origin.position.y;
+    m_occupied.resize(map.data.size());
+    for(size_t i = 0; i < map.data.size(); ++i) {
+      m_occupied[i] = map.data[i] >= occupied_threshold;
+    }
+  }
+
+  double get_angle_increment() const
+  {
+    return num_beams > 1 ? (angle_max - angle_min) / (num_beams - 1) : 0;
+  }
+
+  /*
+   * Computes the ranges seen from the given sensor pose (in map coordinates) at time t.
+   * Beams without echo are set to +inf.
+   */
+  void simulate(const Pose2D& sensor, double t, uint64_t seed, std::vector<float>& ranges)
+  {
+    ranges.resize(std::max(num_beams, 0));
+
+    // obstacle positions are the same for all beams
+    std::vector<DynamicObstacle> current = obstacles;
+    for(auto& obstacle : current) {
+      obstacle.get_position(t, obstacle.x, obstacle.y);
+    }
+
+    const int num_chunks = std::max(std::min(num_threads, num_beams), 1);
+    const int chunk_size = (num_beams + num_chunks - 1) / num_chunks;
+
+    if(int(m_workers.size()) != num_chunks - 1) {
+      stop_workers();
+      start_workers(num_chunks - 1);
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_job_sensor = sensor;
+      m_job_obstacles = &current;
+      m_job_seed = seed;
+      m_job_chunk_size = chunk_size;
+      m_job_ranges = &ranges;
+      m_pending = num_chunks - 1;
+      m_job++;
+    }
+    m_job_cond.notify_all();
+
+    simulate_range(sensor, current, seed, 0, std::min(chunk_size, num_beams), ranges);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cond.wait(lock, [this]() { return m_pending == 0; });
+  }
+
+private:
+  void start_workers(int count)
+  {
+    m_stop = false;
+    for(int k = 1; k <= count; ++k) {
+      m_workers.emplace_back(&LidarSimulator::worker_loop, this, k, m_job);
+    }
+  }
+
+  void stop_workers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_job_cond.notify_all();
+    for(auto& worker : m_workers) {
+      worker.join();
+    }
+    m_workers.clear();
+  }
+
+  // raycasts chunk k of every scan
+  void worker_loop(const int k, uint64_t last_job)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true)
+    {
+      m_job_cond.wait(lock, [this, last_job]() { return m_stop || m_job != last_job; });
+      if(m_stop) {
+        return;
+      }
+      last_job = m_job;
+
+      const Pose2D sensor = m_job_sensor;
+      const int begin = k * m_job_chunk_size;
+      const int end = std::min(begin + m_job_chunk_size, num_beams);
+      lock.unlock();
+      simulate_range(sensor, *m_job_obstacles, m_job_seed + k, begin, end, *m_job_ranges);
+      lock.lock();
+
+      if(--m_pending == 0) {
+        m_done_cond.notify_one();
+      }
+    }
+  }
+
+  void simulate_range(const Pose2D& sensor, const std::vector<DynamicObstacle>& current,
+                      uint64_t seed, int begin, int end, std::vector<float>& ranges) const
+  {
+    std::mt19937_64 generator(seed);
+    std::normal_distribution<double> noise(0, std::max(range_noise_std, 0.));
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const double increment = get_angle_increment();
+
+    for(int i = begin; i < end; ++i)
+    {
+      const double angle = sensor.yaw + angle_min + i * increment;
+      const double dx = std::cos(angle);
+      const double dy = std::sin(angle);
+
+      double range = std::min(cast_grid(sensor.x, sensor.y, dx, dy),
+                              cast_obstacles(sensor.x, sensor.y, dx, dy, current));
+
+      if(range >= range_max || (dropout_probability > 0 && uniform(generator) < dropout_probability)) {
+        ranges[i] = std::numeric_limits<float>::infinity();
+        continue;
+      }
+      if(range_noise_std > 0) {
+        range += noise(generator);
+      }
+      ranges[i] = std::max(range, range_min);
+    }
+  }
+
+  /*
+   * Grid traversal (Amanatides & Woo), returns distance to the first occupied cell.
+   */
+  double cast_grid(double x, double y, double dx, double dy) const
+  {
+    const double inf = std::numeric_limits<double>::infinity();
+    if(m_width <= 0 || m_height <= 0) {
+      return inf;
+    }
+
+    const double gx = (x - m_origin_x) / m_resolution;
+    const double gy = (y - m_origin_y) / m_resolution;
+    int cx = int(std::floor(gx));
+    int cy = int(std::floor(gy));
+
+    const int step_x = dx > 0 ? 1 : -1;
+    const int step_y = dy > 0 ? 1 : -1;
+    const double delta_x = dx != 0 ? std::abs(1 / dx) : inf;
+    const double delta_y = dy != 0 ? std::abs(1 / dy) : inf;
+    double next_x = dx != 0 ? (dx > 0 ? cx + 1 - gx : gx - cx) * delta_x : inf;
+    double next_y = dy != 0 ? (dy > 0 ? cy + 1 - gy : gy - cy) * delta_y : inf;
+
+    const double max_dist = range_max / m_resolution;
+    double dist = 0;
+    while(dist <= max_dist)
+    {
+      if(cx < 0 || cy < 0 || cx >= m_width || cy >= m_height) {
+        // rays leaving the map never come back
+        if((cx < 0 && step_x < 0) || (cx >= m_width && step_x > 0)
+          || (cy < 0 && step_y < 0) || (cy >= m_height && step_y > 0))
+        {
+          return inf;
+        }
+      } else if(m_occupied[size_t(cy) * m_width + cx]) {
+        return dist * m_resolution;
+      }
+      if(next_x < next_y) {
+        dist = next_x;
+        next_x += delta_x;
+        cx += step_x;
+      } else {
+        dist = next_y;
+        next_y += delta_y;
+        cy += step_y;
+      }
+    }
+    return inf;
+  }
+
+  static double cast_obstacles(double x, double y, double dx, double dy,
+                               const std::vector<DynamicObstacle>& current)
+  {
+    double best = std::numeric_limits<double>::infinity();
+    for(const auto& obstacle : current)
+    {
+      // solve |p + t * d - c| = r for the smallest t >= 0
+      const double ox = x - obstacle.x;
+      const double oy = y - obstacle.y;
+      const double b = ox * dx + oy * dy;
+      const double c = ox * ox + oy * oy - obstacle.radius * obstacle.radius;
+      const double disc = b * b - c;
+      if(disc < 0) {
+        continue;
+      }
+      const double root = std::sqrt(disc);
+      double t = -b - root;
+      if(t < 0) {
+        t = -b + root;
+      }
+      if(t >= 0) {
+        best = std::min(best, t);
+      }
+    }
+    return best;
+  }
+
+  int m_width = 0;
+  int m_height = 0;
+  double m_resolution = 0.05;
+  double m_origin_x = 0;
+  double m_origin_y = 0;
+  std::vector<uint8_t> m_occupied;
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_job_cond;
+  std::condition_variable m_done_cond;
+  bool m_stop = false;
+  uint64_t m_job = 0;         // incremented for every scan
+  int m_pending = 0;          // chunks of the current scan not done yet
+  Pose2D m_job_sensor;
+  const std::vector<DynamicObstacle>* m_job_obstacles = nullptr;
+  uint64_t m_job_seed = 0;
+  int m_job_chunk_size = 0;
+  std::vector<float>* m_job_ranges = nullptr;
+};
+
+} // neo_nav2_benchmark
+
+#endif /* INCLUDE_NEO_NAV2_BENCHMARK_LIDARSIMULATOR_H_ */
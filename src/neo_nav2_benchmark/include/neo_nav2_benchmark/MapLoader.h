@@ -0,0 +1,155 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_NAV2_BENCHMARK_MAPLOADER_H_
+#define INCLUDE_NEO_NAV2_BENCHMARK_MAPLOADER_H_
+
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace neo_nav2_benchmark {
+
+/*
+ * Reads a binary (P5) or ascii (P2) PGM image.
+ */
+inline void read_pgm(const std::string& file, int& width, int& height, std::vector<int>& pixels, int& max_value)
+{
+  std::ifstream in(file, std::ios::binary);
+  if(!in) {
+    throw std::runtime_error("could not open " + file);
+  }
+  std::string magic;
+  in >> magic;
+  if(magic != "P5" && magic != "P2") {
+    throw std::runtime_error(file + " is not a PGM image");
+  }
+
+  // header fields may be interleaved with comments
+  auto next_int = [&in, &file]() -> int {
+    while(true) {
+      in >> std::ws;
+      if(in.peek() == '#') {
+        std::string comment;
+        std::getline(in, comment);
+        continue;
+      }
+      int value = 0;
+      if(!(in >> value)) {
+        throw std::runtime_error("invalid PGM header in " + file);
+      }
+      return value;
+    }
+  };
+  width = next_int();
+  height = next_int();
+  max_value = next_int();
+  if(width <= 0 || height <= 0 || max_value <= 0 || max_value > 255) {
+    throw std::runtime_error("unsupported PGM format in " + file);
+  }
+
+  pixels.resize(size_t(width) * height);
+  if(magic == "P5") {
+    in.get();    // single whitespace after the header
+    std::vector<unsigned char> raw(pixels.size());
+    in.read(reinterpret_cast<char*>(raw.data()), raw.size());
+    if(size_t(in.gcount()) != raw.size()) {
+      throw std::runtime_error("truncated PGM image " + file);
+    }
+    for(size_t i = 0; i < raw.size(); ++i) {
+      pixels[i] = raw[i];
+    }
+  } else {
+    for(auto& pixel : pixels) {
+      pixel = next_int();
+    }
+  }
+}
+
+/*
+ * Loads a map_server style map (yaml + pgm) into an occupancy grid,
+ * using the same thresholding as nav2_map_server in trinary mode.
+ */
+inline nav_msgs::msg::OccupancyGrid load_map(const std::string& yaml_file)
+{
+  const YAML::Node doc = YAML::LoadFile(yaml_file);
+
+  std::string image = doc["image"].as<std::string>();
+  if(!image.empty() && image[0] != '/') {
+    const size_t slash = yaml_file.find_last_of('/');
+    if(slash != std::string::npos) {
+      image = yaml_file.substr(0, slash + 1) + image;
+    }
+  }
+  const double resolution = doc["resolution"].as<double>();
+  const std::vector<double> origin = doc["origin"].as<std::vector<double>>();
+  const bool negate = doc["negate"] ? doc["negate"].as<int>() != 0 : false;
+  const double occupied_thresh = doc["occupied_thresh"] ? doc["occupied_thresh"].as<double>() : 0.65;
+  const double free_thresh = doc["free_thresh"] ? doc["free_thresh"].as<double>() : 0.196;
+  if(origin.size() < 3) {
+    throw std::runtime_error("invalid origin in " + yaml_file);
+  }
+
+  int width = 0;
+  int height = 0;
+  int max_value = 0;
+  std::vector<int> pixels;
+  read_pgm(image, width, height, pixels, max_value);
+
+  nav_msgs::msg::OccupancyGrid grid;
+  grid.info.resolution = resolution;
+  grid.info.width = width;
+  grid.info.height = height;
+  grid.info.origin.position.x = origin[0];
+  grid.info.origin.position.y = origin[1];
+  grid.info.origin.orientation.z = std::sin(origin[2] / 2);
+  grid.info.origin.orientation.w = std::cos(origin[2] / 2);
+  grid.data.resize(size_t(width) * height);
+
+  for(int y = 0; y < height; ++y) {
+    for(int x = 0; x < width; ++x) {
+      // image rows go top down, grid rows bottom up
+      const double value = pixels[size_t(height - y - 1) * width + x] / double(max_value);
+      const double occ = negate ? value : 1 - value;
+      int8_t cell = -1;
+      if(occ > occupied_thresh) {
+        cell = 100;
+      } else if(occ < free_thresh) {
+        cell = 0;
+      }
+      grid.data[size_t(y) * width + x] = cell;
+    }
+  }
+  return grid;
+}
+
+} // neo_nav2_benchmark
+
+#endif /* INCLUDE_NEO_NAV2_BENCHMARK_MAPLOADER_H_ */
@@ -0,0 +1,210 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef INCLUDE_NEO_NAV2_BENCHMARK_METRICS_H_
+#define INCLUDE_NEO_NAV2_BENCHMARK_METRICS_H_
+
+#include <unistd.h>
+#include <dirent.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace neo_nav2_benchmark {
+
+/*
+ * Collects all samples of a value for a summary at the end of a run.
+ */
+class SampleStatistics {
+public:
+  void add(double value)
+  {
+    m_samples.push_back(value);
+  }
+
+  size_t size() const
+  {
+    return m_samples.size();
+  }
+
+  double mean() const
+  {
+    double sum = 0;
+    for(const double value : m_samples) {
+      sum += value;
+    }
+    return m_samples.empty() ? 0 : sum / m_samples.size();
+  }
+
+  /*
+   * @param p Percentile from 0 to 100
+   */
+  double percentile(double p) const
+  {
+    if(m_samples.empty()) {
+      return 0;
+    }
+    std::vector<double> sorted = m_samples;
+    const size_t k = std::min(size_t(std::round(p / 100. * (sorted.size() - 1))), sorted.size() - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    return sorted[k];
+  }
+
+  double max() const
+  {
+    return m_samples.empty() ? 0 : *std::max_element(m_samples.begin(), m_samples.end());
+  }
+
+  /*
+   * Writes "name: {count, mean, p50, p95, p99, max}" with values multiplied by scale.
+   */
+  void write(std::ostream& out, const std::string& name, double scale = 1) const
+  {
+    out << name << ": {count: " << size()
+        << ", mean: " << mean() * scale
+        << ", p50: " << percentile(50) * scale
+        << ", p95: " << percentile(95) * scale
+        << ", p99: " << percentile(99) * scale
+        << ", max: " << max() * scale << "}" << std::endl;
+  }
+
+private:
+  std::vector<double> m_samples;
+};
+
+/*
+ * Measures the CPU usage of other processes, found by name in /proc/<pid>/cmdline.
+ */
+class ProcessMonitor {
+public:
+  explicit ProcessMonitor(const std::vector<std::string>& names)
+    : m_names(names)
+  {
+  }
+
+  /*
+   * Starts the measurement, looks up the processes again.
+   */
+  void start()
+  {
+    m_start_ticks.clear();
+    m_pids.clear();
+    DIR* dir = opendir("/proc");
+    if(!dir) {
+      return;
+    }
+    while(dirent* entry = readdir(dir))
+    {
+      const std::string pid = entry->d_name;
+      if(pid.empty() || !std::all_of(pid.begin(), pid.end(), ::isdigit)) {
+        continue;
+      }
+      std::ifstream file("/proc/" + pid + "/cmdline");
+      std::string cmdline;
+      std::getline(file, cmdline, '\0');    // executable only
+      for(const auto& name : m_names) {
+        if(!name.empty() && cmdline.find(name) != std::string::npos) {
+          m_pids[name].push_back(pid);
+        }
+      }
+    }
+    closedir(dir);
+
+    for(const auto& entry : m_pids) {
+      m_start_ticks[entry.first] = read_ticks(entry.second);
+    }
+    m_start_time = std::chrono::steady_clock::now();
+  }
+
+  /*
+   * Returns the CPU usage of each process since start() in percent of one core,
+   * -1 if the process was not found.
+   */
+  std::map<std::string, double> get_usage() const
+  {
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+    const double ticks_per_sec = sysconf(_SC_CLK_TCK);
+
+    std::map<std::string, double> usage;
+    for(const auto& name : m_names)
+    {
+      auto iter = m_pids.find(name);
+      if(iter == m_pids.end() || elapsed <= 0) {
+        usage[name] = -1;
+        continue;
+      }
+      const double ticks = read_ticks(iter->second) - m_start_ticks.at(name);
+      usage[name] = 100 * ticks / ticks_per_sec / elapsed;
+    }
+    return usage;
+  }
+
+private:
+  static double read_ticks(const std::vector<std::string>& pids)
+  {
+    double total = 0;
+    for(const auto& pid : pids)
+    {
+      std::ifstream file("/proc/" + pid + "/stat");
+      std::string line;
+      std::getline(file, line);
+
+      // skip "pid (comm)", comm may contain spaces
+      const size_t paren = line.rfind(')');
+      if(paren == std::string::npos) {
+        continue;
+      }
+      std::istringstream fields(line.substr(paren + 2));
+      std::string field;
+      double utime = 0;
+      double stime = 0;
+      // fields 3 to 13 come before utime (14) and stime (15)
+      for(int i = 3; i <= 15 && fields >> field; ++i) {
+        if(i == 14) {
+          utime = std::stod(field);
+        } else if(i == 15) {
+          stime = std::stod(field);
+        }
+      }
+      total += utime + stime;
+    }
+    return total;
+  }
+
+  std::vector<std::string> m_names;
+  std::map<std::string, std::vector<std::string>> m_pids;
+  std::map<std::string, double> m_start_ticks;
+  std::chrono::steady_clock::time_point m_start_time;
+};
+
+} // neo_nav2_benchmark
+
+#endif /* INCLUDE_NEO_NAV2_BENCHMARK_METRICS_H_ */
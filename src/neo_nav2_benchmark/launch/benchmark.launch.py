@@ -0,0 +1,85 @@
+# Copyright (c) 2022 Neobotix GmbH
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Headless benchmark of laser_filters -> neo_localization -> ekf_node -> NeoLocalPlanner.
+# The benchmark node simulates the robot and shuts everything down when done.
+
+import os
+
+from ament_index_python.packages import get_package_share_directory
+
+import launch.actions
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+
+
+def generate_launch_description():
+    benchmark_dir = get_package_share_directory('neo_nav2_benchmark')
+
+    map_yaml = LaunchConfiguration('map')
+    params_file = LaunchConfiguration('params_file')
+    report_file = LaunchConfiguration('report_file')
+
+    return LaunchDescription([
+        DeclareLaunchArgument(
+            'map',
+            default_value=os.path.join(benchmark_dir, 'maps', 'custom_map.yaml'),
+            description='Map yaml file (map_server format) to simulate'),
+        DeclareLaunchArgument(
+            'params_file',
+            default_value=os.path.join(benchmark_dir, 'config', 'benchmark.yaml'),
+            description='Parameters of the benchmark and of all nodes under test'),
+        DeclareLaunchArgument(
+            'report_file',
+            default_value='benchmark_report.yaml',
+            description='File the results are written to'),
+
+        Node(
+            package='neo_nav2_benchmark',
+            executable='neo_nav2_benchmark_node',
+            name='neo_nav2_benchmark',
+            output='screen',
+            parameters=[params_file, {'map_yaml': map_yaml, 'report_file': report_file}],
+            on_exit=launch.actions.Shutdown()),
+        Node(
+            package='laser_filters',
+            executable='scan_to_scan_filter_chain',
+            output='screen',
+            parameters=[params_file]),
+        Node(
+            package='neo_localization2',
+            executable='neo_localization_node',
+            name='neo_localization2_node',
+            output='screen',
+            parameters=[params_file]),
+        Node(
+            package='robot_localization',
+            executable='ekf_node',
+            name='ekf_filter_node',
+            output='screen',
+            parameters=[params_file]),
+        Node(
+            package='nav2_controller',
+            executable='controller_server',
+            output='screen',
+            parameters=[params_file]),
+        Node(
+            package='nav2_lifecycle_manager',
+            executable='lifecycle_manager',
+            name='lifecycle_manager_benchmark',
+            output='screen',
+            parameters=[params_file]),
+    ])
@@ -0,0 +1,707 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#include <neo_nav2_benchmark/LidarSimulator.h>
+#include <neo_nav2_benchmark/MapLoader.h>
+#include <neo_nav2_benchmark/Metrics.h>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+
+#include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <geometry_msgs/msg/twist.hpp>
+#include <nav2_msgs/action/follow_path.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+#include <nav_msgs/msg/path.hpp>
+#include <rosgraph_msgs/msg/clock.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <tf2_ros/static_transform_broadcaster.h>
+#include <tf2_ros/transform_broadcaster.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace neo_nav2_benchmark;
+using std::placeholders::_1;
+using std::placeholders::_2;
+
+typedef std::chrono::steady_clock wall_clock;
+
+static double normalize_angle(double angle)
+{
+  return std::atan2(std::sin(angle), std::cos(angle));
+}
+
+static double get_yaw(const geometry_msgs::msg::Quaternion& q)
+{
+  return std::atan2(2 * (q.w * q.z + q.x * q.y), 1 - 2 * (q.y * q.y + q.z * q.z));
+}
+
+static geometry_msgs::msg::Quaternion from_yaw(double yaw)
+{
+  geometry_msgs::msg::Quaternion q;
+  q.z = std::sin(yaw / 2);
+  q.w = std::cos(yaw / 2);
+  return q;
+}
+
+/*
+ * Returns the pose b expressed relative to pose a, ie. inverse(a) * b.
+ */
+static Pose2D relative_pose(const Pose2D& a, const Pose2D& b)
+{
+  const double dx = b.x - a.x;
+  const double dy = b.y - a.y;
+  const double c = std::cos(a.yaw);
+  const double s = std::sin(a.yaw);
+  return Pose2D{c * dx + s * dy, -s * dx + c * dy, normalize_angle(b.yaw - a.yaw)};
+}
+
+/*
+ * Headless benchmark for the navigation stack.
+ *
+ * Drives a simulated robot through a map loaded from a map_server yaml file, publishes
+ * /clock, raycasted laser scans, wheel odometry and the map, and measures how the real
+ * nodes (laser filters, localization, ekf, local planner) react:
+ * - per stage latency, as wall time between the simulated time of the input data and
+ *   the reception of the corresponding output
+ * - localization and ekf error with respect to the ground truth
+ * - path tracking error
+ * - CPU usage of the monitored processes
+ *
+ * The node itself runs on wall time, all other nodes have to use simulated time.
+ */
+class NavBenchmarkNode : public rclcpp::Node {
+public:
+  NavBenchmarkNode()
+    : Node("neo_nav2_benchmark", rclcpp::NodeOptions().parameter_overrides({{"use_sim_time", false}}))
+  {
+    m_map_yaml = this->declare_parameter<std::string>("map_yaml", "");
+    m_duration = this->declare_parameter<double>("duration", 120.);
+    m_warmup = this->declare_parameter<double>("warmup", 5.);
+    m_real_time_factor = this->declare_parameter<double>("real_time_factor", 1.);
+    m_clock_rate = this->declare_parameter<double>("clock_rate", 100.);
+    m_scan_rate = this->declare_parameter<double>("scan_rate", 10.);
+    m_odom_rate = this->declare_parameter<double>("odom_rate", 50.);
+    m_use_controller = this->declare_parameter<bool>("use_controller", true);
+    m_speed = this->declare_parameter<double>("speed", 0.5);
+    m_rot_speed = this->declare_parameter<double>("rot_speed", 0.5);
+    m_odom_noise_lin = this->declare_parameter<double>("odom_noise_lin", 0.02);
+    m_odom_noise_ang = this->declare_parameter<double>("odom_noise_ang", 0.02);
+    m_publish_odom_tf = this->declare_parameter<bool>("publish_odom_tf", false);
+    m_report_file = this->declare_parameter<std::string>("report_file", "");
+    m_seed = this->declare_parameter<int>("seed", 1);
+
+    m_map_frame = this->declare_parameter<std::string>("map_frame", "map");
+    m_odom_frame = this->declare_parameter<std::string>("odom_frame", "odom");
+    m_base_frame = this->declare_parameter<std::string>("base_frame", "base_link");
+    m_laser_frame = this->declare_parameter<std::string>("laser_frame", "laser");
+
+    m_lidar.num_beams = this->declare_parameter<int>("laser.num_beams", m_lidar.num_beams);
+    m_lidar.angle_min = this->declare_parameter<double>("laser.angle_min", m_lidar.angle_min);
+    m_lidar.angle_max = this->declare_parameter<double>("laser.angle_max", m_lidar.angle_max);
+    m_lidar.range_min = this->declare_parameter<double>("laser.range_min", m_lidar.range_min);
+    m_lidar.range_max = this->declare_parameter<double>("laser.range_max", m_lidar.range_max);
+    m_lidar.range_noise_std = this->declare_parameter<double>("laser.range_noise_std", m_lidar.range_noise_std);
+    m_lidar.dropout_probability = this->declare_parameter<double>("laser.dropout_probability", m_lidar.dropout_probability);
+    m_lidar.num_threads = this->declare_parameter<int>("laser.num_threads", m_lidar.num_threads);
+    m_laser_offset.x = this->declare_parameter<double>("laser.x", 0.3);
+    m_laser_offset.y = this->declare_parameter<double>("laser.y", 0.);
+    m_laser_offset.yaw = this->declare_parameter<double>("laser.yaw", 0.);
+
+    // [x, y, yaw] start pose followed by [x, y] waypoints, in map coordinates
+    const auto start = this->declare_parameter<std::vector<double>>("start_pose", {0., 0., 0.});
+    const auto waypoints = this->declare_parameter<std::vector<double>>("waypoints", std::vector<double>{});
+    // [x, y, vx, vy, radius, period] per obstacle
+    const auto obstacles = this->declare_parameter<std::vector<double>>("obstacles", std::vector<double>{});
+
+    const auto processes = this->declare_parameter<std::vector<std::string>>("monitored_processes",
+        {"scan_to_scan_filter_chain", "neo_localization_node", "ekf_node", "controller_server"});
+
+    const auto scan_topic = this->declare_parameter<std::string>("scan_topic", "scan");
+    const auto filtered_scan_topic = this->declare_parameter<std::string>("filtered_scan_topic", "scan_filtered");
+    const auto odom_topic = this->declare_parameter<std::string>("odom_topic", "odom");
+    const auto filtered_odom_topic = this->declare_parameter<std::string>("filtered_odom_topic", "odometry/filtered");
+    const auto localization_topic = this->declare_parameter<std::string>("localization_topic", "amcl_pose");
+    const auto cmd_vel_topic = this->declare_parameter<std::string>("cmd_vel_topic", "cmd_vel");
+
+    if(start.size() != 3 || waypoints.size() % 2 || obstacles.size() % 6) {
+      throw std::runtime_error("start_pose needs 3, waypoints 2 and obstacles 6 values per entry");
+    }
+    m_true_pose = Pose2D{start[0], start[1], start[2]};
+    m_start_pose = m_true_pose;
+    m_waypoints.push_back(m_true_pose);
+    for(size_t i = 0; i + 1 < waypoints.size(); i += 2) {
+      m_waypoints.push_back(Pose2D{waypoints[i], waypoints[i + 1], 0});
+    }
+    for(size_t i = 0; i + 5 < obstacles.size(); i += 6) {
+      DynamicObstacle obstacle;
+      obstacle.x = obstacles[i];
+      obstacle.y = obstacles[i + 1];
+      obstacle.vx = obstacles[i + 2];
+      obstacle.vy = obstacles[i + 3];
+      obstacle.radius = obstacles[i + 4];
+      obstacle.period = obstacles[i + 5];
+      m_lidar.obstacles.push_back(obstacle);
+    }
+
+    m_map = load_map(m_map_yaml);
+    m_map.header.frame_id = m_map_frame;
+    m_lidar.set_map(m_map);
+    RCLCPP_INFO_STREAM(this->get_logger(), "Loaded map " << m_map_yaml << " with " << m_map.info.width
+        << " x " << m_map.info.height << " cells");
+
+    m_monitor = std::make_shared<ProcessMonitor>(processes);
+    m_generator.seed(m_seed);
+
+    m_pub_clock = this->create_publisher<rosgraph_msgs::msg::Clock>("/clock", 10);
+    m_pub_map = this->create_publisher<nav_msgs::msg::OccupancyGrid>("/map", rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable());
+    m_pub_scan = this->create_publisher<sensor_msgs::msg::LaserScan>(scan_topic, rclcpp::SensorDataQoS());
+    m_pub_odom = this->create_publisher<nav_msgs::msg::Odometry>(odom_topic, 10);
+    m_pub_initial_pose = this->create_publisher<geometry_msgs::msg::PoseWithCovarianceStamped>("initialpose", 1);
+
+    m_sub_filtered_scan = this->create_subscription<sensor_msgs::msg::LaserScan>(filtered_scan_topic, rclcpp::SensorDataQoS(),
+        std::bind(&NavBenchmarkNode::filtered_scan_callback, this, _1));
+    m_sub_localization = this->create_subscription<geometry_msgs::msg::PoseWithCovarianceStamped>(localization_topic, 10,
+        std::bind(&NavBenchmarkNode::localization_callback, this, _1));
+    m_sub_filtered_odom = this->create_subscription<nav_msgs::msg::Odometry>(filtered_odom_topic, 10,
+        std::bind(&NavBenchmarkNode::filtered_odom_callback, this, _1));
+    m_sub_cmd_vel = this->create_subscription<geometry_msgs::msg::Twist>(cmd_vel_topic, 10,
+        std::bind(&NavBenchmarkNode::cmd_vel_callback, this, _1));
+
+    m_follow_path = rclcpp_action::create_client<nav2_msgs::action::FollowPath>(this, "follow_path");
+
+    m_tf_broadcaster = std::make_shared<tf2_ros::TransformBroadcaster>(this);
+    m_static_tf_broadcaster = std::make_shared<tf2_ros::StaticTransformBroadcaster>(this);
+
+    geometry_msgs::msg::TransformStamped laser_tf;
+    laser_tf.header.frame_id = m_base_frame;
+    laser_tf.child_frame_id = m_laser_frame;
+    laser_tf.transform.translation.x = m_laser_offset.x;
+    laser_tf.transform.translation.y = m_laser_offset.y;
+    laser_tf.transform.rotation = from_yaw(m_laser_offset.yaw);
+    m_static_tf_broadcaster->sendTransform(laser_tf);
+
+    m_pub_map->publish(m_map);
+
+    // start at a non-zero time, zero means "no time" for many nodes
+    m_sim_time = 1000 * 1000000000ll;
+    m_start_time = m_sim_time;
+    m_step = int64_t(1e9 * m_real_time_factor / m_clock_rate);
+
+    m_timer = this->create_wall_timer(std::chrono::nanoseconds(int64_t(1e9 / m_clock_rate)),
+        std::bind(&NavBenchmarkNode::step, this));
+  }
+
+protected:
+  struct HistoryEntry {
+    int64_t sim_time;
+    wall_clock::time_point wall_time;
+    Pose2D pose;    // ground truth in map frame
+  };
+
+  double elapsed() const
+  {
+    return (m_sim_time - m_start_time) * 1e-9;
+  }
+
+  rclcpp::Time sim_stamp() const
+  {
+    return rclcpp::Time(m_sim_time, RCL_ROS_TIME);
+  }
+
+  /*
+   * Advances the simulation by one clock step.
+   */
+  void step()
+  {
+    if(m_finished) {
+      return;
+    }
+    const double dt = m_step * 1e-9;
+    m_sim_time += m_step;
+
+    rosgraph_msgs::msg::Clock clock;
+    clock.clock = sim_stamp();
+    m_pub_clock->publish(clock);
+
+    if(!m_initial_pose_sent && elapsed() > 1) {
+      publish_initial_pose();
+    }
+    if(!m_measuring && elapsed() > m_warmup) {
+      // localization may have missed the first one
+      publish_initial_pose();
+      start_measurement();
+    }
+
+    if(m_measuring) {
+      update_command();
+    }
+    integrate(dt);
+
+    m_history.push_back(HistoryEntry{m_sim_time, wall_clock::now(), m_true_pose});
+    while(!m_history.empty() && m_history.front().sim_time < m_sim_time - 30 * 1000000000ll) {
+      m_history.pop_front();
+    }
+
+    if(elapsed() >= m_next_odom) {
+      m_next_odom = elapsed() + 1 / m_odom_rate;
+      publish_odometry();
+    }
+    if(elapsed() >= m_next_scan) {
+      m_next_scan = elapsed() + 1 / m_scan_rate;
+      publish_scan();
+    }
+
+    if(m_measuring) {
+      m_tracking_error.add(get_path_distance(m_true_pose));
+      if(elapsed() > m_warmup + m_duration || (m_path_done && elapsed() > m_path_done_time + 1)) {
+        finish();
+      }
+    }
+  }
+
+  void start_measurement()
+  {
+    m_measuring = true;
+    m_measure_start_wall = wall_clock::now();
+    m_measure_start_sim = m_sim_time;
+    m_monitor->start();
+
+    if(m_use_controller) {
+      send_path();
+    }
+    RCLCPP_INFO(this->get_logger(), "Started measurement");
+  }
+
+  /*
+   * Computes the velocity command: latest cmd_vel when using the controller,
+   * otherwise a simple rotate-then-drive tracker along the waypoints.
+   */
+  void update_command()
+  {
+    if(m_use_controller) {
+      if(wall_clock::now() - m_last_cmd_wall > 500ms) {
+        m_cmd = Pose2D();
+      }
+      return;
+    }
+
+    m_cmd = Pose2D();
+    if(m_waypoint_index + 1 >= m_waypoints.size()) {
+      if(!m_path_done) {
+        m_path_done = true;
+        m_path_done_time = elapsed();
+      }
+      return;
+    }
+    const Pose2D& target = m_waypoints[m_waypoint_index + 1];
+    const double dx = target.x - m_true_pose.x;
+    const double dy = target.y - m_true_pose.y;
+    const double dist = std::hypot(dx, dy);
+    if(dist < 0.02) {
+      m_waypoint_index++;
+      return;
+    }
+    const double yaw_error = normalize_angle(std::atan2(dy, dx) - m_true_pose.yaw);
+    m_cmd.yaw = std::max(std::min(2 * yaw_error, m_rot_speed), -m_rot_speed);
+    if(std::abs(yaw_error) < 0.1) {
+      m_cmd.x = std::min(m_speed, dist * 2);
+    }
+  }
+
+  /*
+   * Moves the robot by the current command, and the wheel odometry by a noisy version of it.
+   */
+  void integrate(double dt)
+  {
+    auto move = [dt](Pose2D& pose, double vx, double vy, double wz) {
+      const double c = std::cos(pose.yaw);
+      const double s = std::sin(pose.yaw);
+      pose.x += (c * vx - s * vy) * dt;
+      pose.y += (s * vx + c * vy) * dt;
+      pose.yaw = normalize_angle(pose.yaw + wz * dt);
+    };
+    move(m_true_pose, m_cmd.x, m_cmd.y, m_cmd.yaw);
+
+    std::normal_distribution<double> lin_noise(0, m_odom_noise_lin);
+    std::normal_distribution<double> ang_noise(0, m_odom_noise_ang);
+    m_odom_velocity = Pose2D{m_cmd.x * (1 + lin_noise(m_generator)),
+                             m_cmd.y * (1 + lin_noise(m_generator)),
+                             m_cmd.yaw * (1 + ang_noise(m_generator))};
+    move(m_odom_pose, m_odom_velocity.x, m_odom_velocity.y, m_odom_velocity.yaw);
+  }
+
+  void publish_initial_pose()
+  {
+    geometry_msgs::msg::PoseWithCovarianceStamped pose;
+    pose.header.stamp = sim_stamp();
+    pose.header.frame_id = m_map_frame;
+    pose.pose.pose.position.x = m_true_pose.x;
+    pose.pose.pose.position.y = m_true_pose.y;
+    pose.pose.pose.orientation = from_yaw(m_true_pose.yaw);
+    pose.pose.covariance[0] = 0.01;
+    pose.pose.covariance[7] = 0.01;
+    pose.pose.covariance[35] = 0.01;
+    m_pub_initial_pose->publish(pose);
+    m_initial_pose_sent = true;
+  }
+
+  void publish_odometry()
+  {
+    nav_msgs::msg::Odometry odom;
+    odom.header.stamp = sim_stamp();
+    odom.header.frame_id = m_odom_frame;
+    odom.child_frame_id = m_base_frame;
+    odom.pose.pose.position.x = m_odom_pose.x;
+    odom.pose.pose.position.y = m_odom_pose.y;
+    odom.pose.pose.orientation = from_yaw(m_odom_pose.yaw);
+    odom.twist.twist.linear.x = m_odom_velocity.x;
+    odom.twist.twist.linear.y = m_odom_velocity.y;
+    odom.twist.twist.angular.z = m_odom_velocity.yaw;
+    for(int i = 0; i < 6; ++i) {
+      odom.pose.covariance[i * 7] = 0.001;
+      odom.twist.covariance[i * 7] = 0.001;
+    }
+    m_pub_odom->publish(odom);
+
+    if(m_publish_odom_tf) {
+      geometry_msgs::msg::TransformStamped tf;
+      tf.header = odom.header;
+      tf.child_frame_id = m_base_frame;
+      tf.transform.translation.x = m_odom_pose.x;
+      tf.transform.translation.y = m_odom_pose.y;
+      tf.transform.rotation = odom.pose.pose.orientation;
+      m_tf_broadcaster->sendTransform(tf);
+    }
+
+    if(m_measuring) {
+      // drift of the raw wheel odometry, for reference to the ekf error
+      const Pose2D truth = relative_pose(m_start_pose, m_true_pose);
+      m_odom_error_xy.add(std::hypot(m_odom_pose.x - truth.x, m_odom_pose.y - truth.y));
+    }
+  }
+
+  void publish_scan()
+  {
+    const double c = std::cos(m_true_pose.yaw);
+    const double s = std::sin(m_true_pose.yaw);
+    const Pose2D sensor{m_true_pose.x + c * m_laser_offset.x - s * m_laser_offset.y,
+                        m_true_pose.y + s * m_laser_offset.x + c * m_laser_offset.y,
+                        normalize_angle(m_true_pose.yaw + m_laser_offset.yaw)};
+
+    auto scan = std::make_unique<sensor_msgs::msg::LaserScan>();
+    scan->header.stamp = sim_stamp();
+    scan->header.frame_id = m_laser_frame;
+    scan->angle_min = m_lidar.angle_min;
+    scan->angle_max = m_lidar.angle_max;
+    scan->angle_increment = m_lidar.get_angle_increment();
+    scan->scan_time = 1 / m_scan_rate;
+    scan->range_min = m_lidar.range_min;
+    scan->range_max = m_lidar.range_max;
+
+    const auto t0 = wall_clock::now();
+    m_lidar.simulate(sensor, elapsed(), m_generator(), scan->ranges);
+    if(m_measuring) {
+      m_raycast_time.add(std::chrono::duration<double>(wall_clock::now() - t0).count());
+    }
+    m_pub_scan->publish(std::move(scan));
+  }
+
+  void send_path()
+  {
+    if(!m_follow_path->wait_for_action_server(5s)) {
+      RCLCPP_ERROR(this->get_logger(), "follow_path action server not available, aborting");
+      finish();
+      return;
+    }
+
+    nav2_msgs::action::FollowPath::Goal goal;
+    goal.path.header.frame_id = m_map_frame;
+    goal.path.header.stamp = sim_stamp();
+    goal.controller_id = "FollowPath";
+    for(size_t i = 0; i + 1 < m_waypoints.size(); ++i)
+    {
+      // densify the polyline, the local planner expects a global plan
+      const Pose2D& a = m_waypoints[i];
+      const Pose2D& b = m_waypoints[i + 1];
+      const double yaw = std::atan2(b.y - a.y, b.x - a.x);
+      const int count = std::max(int(std::hypot(b.x - a.x, b.y - a.y) / 0.05), 1);
+      for(int k = 0; k <= count; ++k) {
+        if(k == 0 && i > 0) {
+          continue;
+        }
+        geometry_msgs::msg::PoseStamped pose;
+        pose.header = goal.path.header;
+        pose.pose.position.x = a.x + (b.x - a.x) * k / count;
+        pose.pose.position.y = a.y + (b.y - a.y) * k / count;
+        pose.pose.orientation = from_yaw(yaw);
+        goal.path.poses.push_back(pose);
+      }
+    }
+
+    rclcpp_action::Client<nav2_msgs::action::FollowPath>::SendGoalOptions options;
+    options.result_callback =
+      [this](const rclcpp_action::ClientGoalHandle<nav2_msgs::action::FollowPath>::WrappedResult& result) {
+        if(result.code != rclcpp_action::ResultCode::SUCCEEDED) {
+          RCLCPP_WARN(this->get_logger(), "follow_path did not succeed");
+        }
+        m_path_done = true;
+        m_path_done_time = elapsed();
+      };
+    m_follow_path->async_send_goal(goal, options);
+  }
+
+  /*
+   * Returns the wall time at which the simulation reached the given time,
+   * or false if it is not in the history anymore.
+   */
+  bool get_history(const builtin_interfaces::msg::Time& stamp, HistoryEntry& entry) const
+  {
+    const int64_t time = rclcpp::Time(stamp, RCL_ROS_TIME).nanoseconds();
+    auto iter = std::lower_bound(m_history.begin(), m_history.end(), time,
+        [](const HistoryEntry& a, int64_t t) { return a.sim_time < t; });
+    if(iter == m_history.end()) {
+      return false;
+    }
+    entry = *iter;
+    return true;
+  }
+
+  double get_latency(const HistoryEntry& entry) const
+  {
+    return std::chrono::duration<double>(wall_clock::now() - entry.wall_time).count();
+  }
+
+  double get_path_distance(const Pose2D& pose) const
+  {
+    double best = std::numeric_limits<double>::infinity();
+    for(size_t i = 0; i + 1 < m_waypoints.size(); ++i)
+    {
+      const Pose2D& a = m_waypoints[i];
+      const Pose2D& b = m_waypoints[i + 1];
+      const double lx = b.x - a.x;
+      const double ly = b.y - a.y;
+      const double len2 = lx * lx + ly * ly;
+      const double t = len2 > 0 ? std::max(std::min(((pose.x - a.x) * lx + (pose.y - a.y) * ly) / len2, 1.), 0.) : 0;
+      best = std::min(best, std::hypot(a.x + t * lx - pose.x, a.y + t * ly - pose.y));
+    }
+    return m_waypoints.size() > 1 ? best : 0;
+  }
+
+  void filtered_scan_callback(const sensor_msgs::msg::LaserScan::SharedPtr scan)
+  {
+    HistoryEntry entry;
+    if(m_measuring && get_history(scan->header.stamp, entry)) {
+      m_filter_latency.add(get_latency(entry));
+    }
+  }
+
+  void localization_callback(const geometry_msgs::msg::PoseWithCovarianceStamped::SharedPtr pose)
+  {
+    HistoryEntry entry;
+    if(m_measuring && get_history(pose->header.stamp, entry)) {
+      m_localization_latency.add(get_latency(entry));
+      m_localization_error_xy.add(std::hypot(pose->pose.pose.position.x - entry.pose.x,
+                                             pose->pose.pose.position.y - entry.pose.y));
+      m_localization_error_yaw.add(std::abs(normalize_angle(get_yaw(pose->pose.pose.orientation) - entry.pose.yaw)));
+    }
+  }
+
+  void filtered_odom_callback(const nav_msgs::msg::Odometry::SharedPtr odom)
+  {
+    HistoryEntry entry;
+    if(m_measuring && get_history(odom->header.stamp, entry)) {
+      // odom frame starts at the start pose
+      const Pose2D truth = relative_pose(m_start_pose, entry.pose);
+      m_ekf_latency.add(get_latency(entry));
+      m_ekf_error_xy.add(std::hypot(odom->pose.pose.position.x - truth.x, odom->pose.pose.position.y - truth.y));
+      m_ekf_error_yaw.add(std::abs(normalize_angle(get_yaw(odom->pose.pose.orientation) - truth.yaw)));
+    }
+  }
+
+  void cmd_vel_callback(const geometry_msgs::msg::Twist::SharedPtr twist)
+  {
+    const auto now = wall_clock::now();
+    if(m_measuring && m_last_cmd_wall != wall_clock::time_point()) {
+      m_cmd_vel_interval.add(std::chrono::duration<double>(now - m_last_cmd_wall).count());
+    }
+    m_last_cmd_wall = now;
+    if(m_use_controller) {
+      m_cmd = Pose2D{twist->linear.x, twist->linear.y, twist->angular.z};
+    }
+  }
+
+  void finish()
+  {
+    if(m_finished) {
+      return;
+    }
+    m_finished = true;
+
+    const double wall_elapsed = std::chrono::duration<double>(wall_clock::now() - m_measure_start_wall).count();
+    const double sim_elapsed = (m_sim_time - m_measure_start_sim) * 1e-9;
+
+    std::ostringstream out;
+    out << "map: " << m_map_yaml << std::endl;
+    out << "sim_duration: " << sim_elapsed << std::endl;
+    out << "real_time_factor: " << (m_measuring && wall_elapsed > 0 ? sim_elapsed / wall_elapsed : 0) << std::endl;
+    out << "path_completed: " << (m_path_done ? "true" : "false") << std::endl;
+    out << "latency_ms:" << std::endl;
+    m_filter_latency.write(out << "  ", "laser_filters", 1e3);
+    m_localization_latency.write(out << "  ", "localization", 1e3);
+    m_ekf_latency.write(out << "  ", "ekf", 1e3);
+    m_cmd_vel_interval.write(out << "  ", "cmd_vel_interval", 1e3);
+    m_raycast_time.write(out << "  ", "raycast", 1e3);
+    out << "error:" << std::endl;
+    m_localization_error_xy.write(out << "  ", "localization_xy_m");
+    m_localization_error_yaw.write(out << "  ", "localization_yaw_rad");
+    m_ekf_error_xy.write(out << "  ", "ekf_xy_m");
+    m_ekf_error_yaw.write(out << "  ", "ekf_yaw_rad");
+    m_odom_error_xy.write(out << "  ", "wheel_odom_xy_m");
+    m_tracking_error.write(out << "  ", "path_tracking_m");
+    out << "cpu_percent:" << std::endl;
+    for(const auto& entry : m_monitor->get_usage()) {
+      out << "  " << entry.first << ": " << entry.second << std::endl;
+    }
+
+    RCLCPP_INFO_STREAM(this->get_logger(), "Benchmark results:\n" << out.str());
+    if(!m_report_file.empty()) {
+      std::ofstream file(m_report_file);
+      file << out.str();
+      if(!file) {
+        RCLCPP_ERROR_STREAM(this->get_logger(), "Could not write " << m_report_file);
+      }
+    }
+    m_timer->cancel();
+    rclcpp::shutdown();
+  }
+
+private:
+  std::string m_map_yaml;
+  std::string m_report_file;
+  std::string m_map_frame;
+  std::string m_odom_frame;
+  std::string m_base_frame;
+  std::string m_laser_frame;
+  double m_duration = 0;
+  double m_warmup = 0;
+  double m_real_time_factor = 1;
+  double m_clock_rate = 100;
+  double m_scan_rate = 10;
+  double m_odom_rate = 50;
+  bool m_use_controller = true;
+  double m_speed = 0;
+  double m_rot_speed = 0;
+  double m_odom_noise_lin = 0;
+  double m_odom_noise_ang = 0;
+  bool m_publish_odom_tf = false;
+  int m_seed = 1;
+
+  nav_msgs::msg::OccupancyGrid m_map;
+  LidarSimulator m_lidar;
+  Pose2D m_laser_offset;
+  std::vector<Pose2D> m_waypoints;
+  size_t m_waypoint_index = 0;
+  std::mt19937_64 m_generator;
+
+  int64_t m_sim_time = 0;     // [ns]
+  int64_t m_start_time = 0;   // [ns]
+  int64_t m_step = 0;         // [ns]
+  double m_next_scan = 0;     // [s] since start
+  double m_next_odom = 0;     // [s] since start
+
+  Pose2D m_true_pose;         // in map frame
+  Pose2D m_start_pose;        // in map frame, origin of odom frame
+  Pose2D m_odom_pose;         // in odom frame
+  Pose2D m_odom_velocity;     // in base frame
+  Pose2D m_cmd;               // [vx, vy, wz] in base frame
+  std::deque<HistoryEntry> m_history;
+
+  bool m_initial_pose_sent = false;
+  bool m_measuring = false;
+  bool m_path_done = false;
+  bool m_finished = false;
+  double m_path_done_time = 0;
+  wall_clock::time_point m_measure_start_wall;
+  int64_t m_measure_start_sim = 0;
+  wall_clock::time_point m_last_cmd_wall;
+
+  std::shared_ptr<ProcessMonitor> m_monitor;
+  SampleStatistics m_filter_latency;
+  SampleStatistics m_localization_latency;
+  SampleStatistics m_ekf_latency;
+  SampleStatistics m_cmd_vel_interval;
+  SampleStatistics m_raycast_time;
+  SampleStatistics m_localization_error_xy;
+  SampleStatistics m_localization_error_yaw;
+  SampleStatistics m_ekf_error_xy;
+  SampleStatistics m_ekf_error_yaw;
+  SampleStatistics m_odom_error_xy;
+  SampleStatistics m_tracking_error;
+
+  rclcpp::Publisher<rosgraph_msgs::msg::Clock>::SharedPtr m_pub_clock;
+  rclcpp::Publisher<nav_msgs::msg::OccupancyGrid>::SharedPtr m_pub_map;
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr m_pub_scan;
+  rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr m_pub_odom;
+  rclcpp::Publisher<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr m_pub_initial_pose;
+  rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr m_sub_filtered_scan;
+  rclcpp::Subscription<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr m_sub_localization;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr m_sub_filtered_odom;
+  rclcpp::Subscription<geometry_msgs::msg::Twist>::SharedPtr m_sub_cmd_vel;
+  rclcpp_action::Client<nav2_msgs::action::FollowPath>::SharedPtr m_follow_path;
+  std::shared_ptr<tf2_ros::TransformBroadcaster> m_tf_broadcaster;
+  std::shared_ptr<tf2_ros::StaticTransformBroadcaster> m_static_tf_broadcaster;
+  rclcpp::TimerBase::SharedPtr m_timer;
+};
+
+int main(int argc, char** argv)
+{
+  rclcpp::init(argc, argv);
+
+  try {
+    auto node = std::make_shared<NavBenchmarkNode>();
+    rclcpp::spin(node);
+  }
+  catch(const std::exception& ex) {
+    std::cout << "NavBenchmarkNode: " << ex.what() << std::endl;
+    return -1;
+  }
+
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+/*
+ * LTTng tracepoint provider definition, only used by the neo_tracetools library.
+ */
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER neo_nav
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "neo_tracetools/tp_call.h"
+
+#if !defined(NEO_TRACETOOLS__TP_CALL_H_) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define NEO_TRACETOOLS__TP_CALL_H_
+
+#include <lttng/tracepoint.h>
+
+TRACEPOINT_EVENT_CLASS(
+  neo_nav,
+  scope_class,
+  TP_ARGS(
+    const char *, component_arg,
+    const char *, name_arg,
+    int64_t, stamp_arg
+  ),
+  TP_FIELDS(
+    ctf_string(component, component_arg)
+    ctf_string(name, name_arg)
+    ctf_integer(int64_t, stamp, stamp_arg)
+  )
+)
+
+TRACEPOINT_EVENT_INSTANCE(
+  neo_nav,
+  scope_class,
+  scope_entry,
+  TP_ARGS(
+    const char *, component_arg,
+    const char *, name_arg,
+    int64_t, stamp_arg
+  )
+)
+
+TRACEPOINT_EVENT_INSTANCE(
+  neo_nav,
+  scope_class,
+  scope_exit,
+  TP_ARGS(
+    const char *, component_arg,
+    const char *, name_arg,
+    int64_t, stamp_arg
+  )
+)
+
+TRACEPOINT_EVENT_INSTANCE(
+  neo_nav,
+  scope_class,
+  phase,
+  TP_ARGS(
+    const char *, component_arg,
+    const char *, name_arg,
+    int64_t, stamp_arg
+  )
+)
+
+TRACEPOINT_EVENT(
+  neo_nav,
+  message,
+  TP_ARGS(
+    const char *, component_arg,
+    const char *, event_arg,
+    const char *, topic_arg,
+    int64_t, stamp_arg
+  ),
+  TP_FIELDS(
+    ctf_string(component, component_arg)
+    ctf_string(event, event_arg)
+    ctf_string(topic, topic_arg)
+    ctf_integer(int64_t, stamp, stamp_arg)
+  )
+)
+
+#endif  // NEO_TRACETOOLS__TP_CALL_H_
+
+#include <lttng/tracepoint-event.h>
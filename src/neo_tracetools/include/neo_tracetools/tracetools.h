@@ -0,0 +1,128 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#ifndef NEO_TRACETOOLS__TRACETOOLS_H_
+#define NEO_TRACETOOLS__TRACETOOLS_H_
+
+#include <stdint.h>
+
+#include "neo_tracetools/config.h"
+
+/*
+ * Tracepoints of the navigation stack, provider "neo_nav".
+ *
+ * Every event carries the name of the component (node or plugin) and a stamp, which is
+ * the header stamp of the message being processed in [ns] (0 if there is none). Events
+ * with the same stamp are linked together by scripts/analyze_trace.py to compute the
+ * latency of a message across nodes.
+ *
+ * - scope_entry / scope_exit: begin and end of a function or stage
+ * - phase: start of a phase inside the current scope, ends with the next phase or scope exit
+ * - message: a message was received, published, sent or consumed (event), on a topic
+ *
+ * Enable with ros2_tracing, for example: ros2 trace -u 'neo_nav:*' 'ros2:*'
+ *
+ * If LTTng is not available or NEO_TRACETOOLS_DISABLED is set, all macros expand
+ * to nothing and their arguments are not evaluated.
+ */
+
+#ifdef NEO_TRACETOOLS_LTTNG_ENABLED
+#define NEO_TRACEPOINT(event_name, ...) (neo_trace_ ## event_name)(__VA_ARGS__)
+#else
+#define NEO_TRACEPOINT(event_name, ...) ((void)0)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Returns 1 if the tracepoints are compiled in.
+ */
+int neo_trace_compile_status(void);
+
+void neo_trace_scope_entry(const char * component, const char * name, int64_t stamp);
+
+void neo_trace_scope_exit(const char * component, const char * name, int64_t stamp);
+
+void neo_trace_phase(const char * component, const char * name, int64_t stamp);
+
+void neo_trace_message(const char * component, const char * event, const char * topic, int64_t stamp);
+
+#ifdef __cplusplus
+}
+
+namespace neo_tracetools
+{
+
+/*
+ * Converts a message stamp (builtin_interfaces::msg::Time) to [ns].
+ */
+template<typename StampT>
+inline int64_t stamp_ns(const StampT & stamp)
+{
+  return int64_t(stamp.sec) * 1000000000 + stamp.nanosec;
+}
+
+/*
+ * Emits scope_entry on construction and scope_exit on destruction.
+ */
+class TraceScope
+{
+public:
+  TraceScope(const char * component, const char * name, int64_t stamp)
+  : m_component(component), m_name(name), m_stamp(stamp)
+  {
+    NEO_TRACEPOINT(scope_entry, m_component, m_name, m_stamp);
+  }
+
+  ~TraceScope()
+  {
+    NEO_TRACEPOINT(scope_exit, m_component, m_name, m_stamp);
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope & operator=(const TraceScope &) = delete;
+
+private:
+  const char * m_component;
+  const char * m_name;
+  int64_t m_stamp;
+};
+
+}  // namespace neo_tracetools
+
+#define NEO_TRACETOOLS_CONCAT_(a, b) a ## b
+#define NEO_TRACETOOLS_CONCAT(a, b) NEO_TRACETOOLS_CONCAT_(a, b)
+
+#ifdef NEO_TRACETOOLS_LTTNG_ENABLED
+#define NEO_TRACE_SCOPE(component, name, stamp) \
+  neo_tracetools::TraceScope NEO_TRACETOOLS_CONCAT(neo_trace_scope_, __LINE__)(component, name, stamp)
+#else
+#define NEO_TRACE_SCOPE(component, name, stamp) ((void)0)
+#endif
+
+#endif  // __cplusplus
+
+#endif  // NEO_TRACETOOLS__TRACETOOLS_H_
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Neobotix GmbH
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+Analyzes a trace with neo_nav events recorded by ros2_tracing / LTTng.
+
+Prints:
+- the duration of every scope (function / stage) and of every phase inside a scope
+- for every message stamp, the latency of each message event and scope exit with
+  respect to the first event seen with that stamp, aggregated per hop
+
+Usage: analyze_trace.py <trace directory> [--csv <file>] [--component <name>]
+"""
+
+import argparse
+import collections
+import csv
+import sys
+
+try:
+    import bt2
+except ImportError:
+    sys.exit('analyze_trace.py needs the babeltrace2 python bindings (python3-bt2)')
+
+
+def read_events(path):
+    """Yield (timestamp_ns, tid, event_name, fields) for all neo_nav events."""
+    for msg in bt2.TraceCollectionMessageIterator(path):
+        if type(msg) is not bt2._EventMessageConst:
+            continue
+        event = msg.event
+        if not event.name.startswith('neo_nav:'):
+            continue
+        tid = None
+        if event.common_context_field is not None and 'vtid' in event.common_context_field:
+            tid = int(event.common_context_field['vtid'])
+        fields = {name: event.payload_field[name] for name in event.payload_field}
+        yield (msg.default_clock_snapshot.ns_from_origin, tid,
+               event.name[len('neo_nav:'):], fields)
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    if not ordered:
+        return 0.0
+    k = min(int(round(p / 100.0 * (len(ordered) - 1))), len(ordered) - 1)
+    return ordered[k]
+
+
+def print_table(title, samples):
+    """Print count / mean / p50 / p95 / p99 / max in [ms] per key."""
+    print(title)
+    print('  %-60s %8s %9s %9s %9s %9s %9s' %
+          ('', 'count', 'mean', 'p50', 'p95', 'p99', 'max'))
+    for key in sorted(samples):
+        values = samples[key]
+        print('  %-60s %8d %9.3f %9.3f %9.3f %9.3f %9.3f' % (
+            key, len(values), sum(values) / len(values) * 1e-6,
+            percentile(values, 50) * 1e-6, percentile(values, 95) * 1e-6,
+            percentile(values, 99) * 1e-6, max(values) * 1e-6))
+    print()
+
+
+def analyze(path, component_filter=None, csv_file=None):
+    scope_durations = collections.defaultdict(list)
+    phase_durations = collections.defaultdict(list)
+    # per thread stack of [component, name, entry time, current phase, phase start]
+    stacks = collections.defaultdict(list)
+    # stamp -> list of (time, hop name)
+    messages = collections.defaultdict(list)
+
+    def close_phase(frame, now):
+        if frame[3] is not None:
+            phase_durations['%s: %s / %s' % (frame[0], frame[1], frame[3])].append(now - frame[4])
+            frame[3] = None
+
+    for time, tid, name, fields in read_events(path):
+        component = str(fields['component'])
+        if component_filter and component != component_filter:
+            continue
+        stamp = int(fields['stamp'])
+        stack = stacks[tid]
+
+        if name == 'scope_entry':
+            stack.append([component, str(fields['name']), time, None, 0])
+        elif name == 'scope_exit':
+            scope = str(fields['name'])
+            # tolerate unmatched events at the start of the trace
+            while stack and (stack[-1][0] != component or stack[-1][1] != scope):
+                stack.pop()
+            if not stack:
+                continue
+            frame = stack.pop()
+            close_phase(frame, time)
+            scope_durations['%s: %s' % (component, scope)].append(time - frame[2])
+            if stamp:
+                messages[stamp].append((time, '%s: %s done' % (component, scope)))
+        elif name == 'phase':
+            if stack:
+                close_phase(stack[-1], time)
+                stack[-1][3] = str(fields['name'])
+                stack[-1][4] = time
+        elif name == 'message':
+            if stamp:
+                messages[stamp].append(
+                    (time, '%s: %s %s' % (component, fields['event'], fields['topic'])))
+
+    # latency of every hop with respect to the first event of the same stamp
+    hop_latency = collections.defaultdict(list)
+    rows = []
+    for stamp, events in messages.items():
+        events.sort()
+        origin_time, origin = events[0]
+        for time, hop in events[1:]:
+            key = '%s -> %s' % (origin, hop)
+            hop_latency[key].append(time - origin_time)
+            rows.append((stamp, origin, hop, time - origin_time))
+
+    print_table('Scope duration [ms]', scope_durations)
+    if phase_durations:
+        print_table('Phase duration [ms]', phase_durations)
+    if hop_latency:
+        print_table('Message latency from first event [ms]', hop_latency)
+
+    if csv_file:
+        with open(csv_file, 'w', newline='') as out:
+            writer = csv.writer(out)
+            writer.writerow(['stamp_ns', 'origin', 'hop', 'latency_ns'])
+            writer.writerows(sorted(rows))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('trace', help='trace directory (as written by ros2 trace)')
+    parser.add_argument('--csv', help='write the per message latencies to this file')
+    parser.add_argument('--component', help='only analyze events of this component')
+    args = parser.parse_args()
+    analyze(args.trace, args.component, args.csv)
+
+
+if __name__ == '__main__':
+    main()
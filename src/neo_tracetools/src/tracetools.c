@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2022 neobotix gmbh
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+#include "neo_tracetools/tracetools.h"
+
+#ifdef NEO_TRACETOOLS_LTTNG_ENABLED
+#include "neo_tracetools/tp_call.h"
+#define CONDITIONAL_TP(...) tracepoint(neo_nav, __VA_ARGS__)
+#else
+#define CONDITIONAL_TP(...)
+#endif
+
+int neo_trace_compile_status(void)
+{
+#ifdef NEO_TRACETOOLS_LTTNG_ENABLED
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+void neo_trace_scope_entry(const char * component, const char * name, int64_t stamp)
+{
+  CONDITIONAL_TP(scope_entry, component, name, stamp);
+  (void)component;
+  (void)name;
+  (void)stamp;
+}
+
+void neo_trace_scope_exit(const char * component, const char * name, int64_t stamp)
+{
+  CONDITIONAL_TP(scope_exit, component, name, stamp);
+  (void)component;
+  (void)name;
+  (void)stamp;
+}
+
+void neo_trace_phase(const char * component, const char * name, int64_t stamp)
+{
+  CONDITIONAL_TP(phase, component, name, stamp);
+  (void)component;
+  (void)name;
+  (void)stamp;
+}
+
+void neo_trace_message(const char * component, const char * event, const char * topic, int64_t stamp)
+{
+  CONDITIONAL_TP(message, component, event, topic, stamp);
+  (void)component;
+  (void)event;
+  (void)topic;
+  (void)stamp;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2014, 2015, 2016, Charles River Analytics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Memory use and push / revert timings of FilterStateHistory, with double and
+ * float covariance, against the former history layout: a
+ * std::deque<FilterStatePtr> with one heap allocated FilterState per entry.
+ *
+ * Usage: filter_state_history_benchmark [history_size]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <memory>
+
+#include "robot_localization/ekf.hpp"
+#include "robot_localization/filter_state.hpp"
+#include "robot_localization/filter_state_history.hpp"
+
+using robot_localization::Ekf;
+using robot_localization::FilterStateHistory;
+using robot_localization::STATE_SIZE;
+
+namespace
+{
+
+// Fills the filter with a distinct, symmetric positive definite state for
+// time stamp @p i
+void setFilterState(Ekf & filter, const int i)
+{
+  Eigen::VectorXd state(STATE_SIZE);
+  Eigen::MatrixXd covariance(STATE_SIZE, STATE_SIZE);
+  for (int row = 0; row < STATE_SIZE; ++row) {
+    state(row) = 0.5 * i + row;
+    for (int col = 0; col < STATE_SIZE; ++col) {
+      covariance(row, col) = 1e-3 * (row + col + i % 7);
+    }
+    covariance(row, row) += 1.0 + row;
+  }
+  filter.setState(state);
+  filter.setEstimateErrorCovariance(covariance);
+  filter.setLastMeasurementTime(rclcpp::Time(i, 0, RCL_ROS_TIME));
+}
+
+// Allocated size of a FilterState as it was stored in the old
+// std::deque<FilterStatePtr> history
+size_t legacyStateSize()
+{
+  return sizeof(robot_localization::FilterStatePtr) +
+         sizeof(robot_localization::FilterState) +
+         sizeof(double) * (STATE_SIZE + STATE_SIZE * STATE_SIZE +
+         robot_localization::TWIST_SIZE);
+}
+
+double microsecondsSince(const std::chrono::steady_clock::time_point & start)
+{
+  return std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  const int history_size = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+  Ekf filter;
+  std::deque<robot_localization::FilterStatePtr> legacy_history;
+
+  // Old layout: one heap allocated FilterState per entry, three Eigen members
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < history_size; ++i) {
+    setFilterState(filter, i);
+    auto state = std::make_shared<robot_localization::FilterState>();
+    state->state_ = filter.getState();
+    state->estimate_error_covariance_ = filter.getEstimateErrorCovariance();
+    state->latest_control_ = filter.getControl();
+    state->last_measurement_time_ = filter.getLastMeasurementTime();
+    state->latest_control_time_ = filter.getControlTime();
+    legacy_history.push_back(state);
+  }
+  const double legacy_push_us = microsecondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  while (!legacy_history.empty()) {
+    const auto & state = legacy_history.back();
+    filter.setState(state->state_);
+    filter.setEstimateErrorCovariance(state->estimate_error_covariance_);
+    filter.setLastMeasurementTime(state->last_measurement_time_);
+    legacy_history.pop_back();
+  }
+  const double legacy_revert_us = microsecondsSince(start);
+
+  std::cout << "legacy: " << history_size << " states, " <<
+    history_size * legacyStateSize() << " bytes, push " << legacy_push_us <<
+    " us, revert " << legacy_revert_us << " us\n";
+
+  for (const bool float_covariance : {false, true}) {
+    FilterStateHistory history;
+    history.setFloatCovariance(float_covariance);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < history_size; ++i) {
+      setFilterState(filter, i);
+      history.push(filter);
+    }
+    const double push_us = microsecondsSince(start);
+    const size_t bytes = history.memoryUsage();
+
+    start = std::chrono::steady_clock::now();
+    while (!history.empty()) {
+      history.restoreBack(filter);
+      history.popBack();
+    }
+    const double revert_us = microsecondsSince(start);
+
+    std::cout << (float_covariance ? "packed float: " : "packed double: ") <<
+      bytes << " bytes, push " << push_us << " us, revert " << revert_us << " us\n";
+  }
+  return 0;
+}
@@ -33,6 +33,8 @@
 #ifndef ROBOT_LOCALIZATION__EKF_HPP_
 #define ROBOT_LOCALIZATION__EKF_HPP_
 
+#include <vector>
+
 #include "rclcpp/time.hpp"
 #include "robot_localization/filter_base.hpp"
 #include "robot_localization/measurement.hpp"
@@ -67,6 +69,17 @@ public:
    */
   void correct(const Measurement & measurement) override;
 
+  /**
+   * @brief Fuses several measurements with the same time stamp in a single
+   * correction, stacking them into one measurement vector.
+   *
+   * Each measurement is still subject to its own Mahalanobis threshold,
+   * which is evaluated against the state before the correction.
+   *
+   * @param[in] measurements - The measurements to fuse with our estimate
+   */
+  void correctBatch(const std::vector<MeasurementPtr> & measurements) override;
+
   /**
    * @brief Carries out the predict step in the predict/update cycle.
    *
@@ -79,6 +92,22 @@ public:
   void predict(
     const rclcpp::Time & reference_time,
     const rclcpp::Duration & delta) override;
+
+private:
+  /**
+   * @brief Extracts the valid (updated, finite) variables of a measurement
+   *
+   * @param[in] measurement - The measurement to extract from
+   * @param[out] update_indices - The state indices of the extracted variables
+   * @param[out] measurement_subset - The extracted measurement values
+   * @param[out] measurement_covariance_subset - The extracted covariance, with
+   * the diagonal made positive and at least 1e-9
+   */
+  void prepareMeasurementSubset(
+    const Measurement & measurement,
+    std::vector<size_t> & update_indices,
+    Eigen::VectorXd & measurement_subset,
+    Eigen::MatrixXd & measurement_covariance_subset);
 };
 
 }  // namespace robot_localization
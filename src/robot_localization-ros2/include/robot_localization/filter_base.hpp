@@ -77,6 +77,14 @@ public:
    */
   virtual void correct(const Measurement & measurement) = 0;
 
+  /**
+   * @brief Carries out the correct step for several measurements that share
+   * the same time stamp. The default implementation corrects with each of
+   * them in turn, subclasses can override it to fuse them in one update.
+   * @param[in] measurements - The measurements to fuse with the state estimate
+   */
+  virtual void correctBatch(const std::vector<MeasurementPtr> & measurements);
+
   /**
    * @brief Returns the control vector currently being used
    *
@@ -167,6 +175,13 @@ public:
    */
   virtual void processMeasurement(const Measurement & measurement);
 
+  /**
+   * @brief Same as processMeasurement(), for measurements that all have the
+   * same time stamp. Predicts once and calls correctBatch().
+   * @param[in] measurements - The measurement objects to fuse into the filter
+   */
+  void processMeasurementBatch(const std::vector<MeasurementPtr> & measurements);
+
   /**
    * @brief Sets the most recent control term
    * @param[in] control - The control term to be applied
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2014, 2015, 2016 Charles River Analytics, Inc.
+ * Copyright (c) 2017, Locus Robotics, Inc.
+ * Copyright (c) 2019, Steve Macenski
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef ROBOT_LOCALIZATION__FILTER_STATE_HISTORY_HPP_
+#define ROBOT_LOCALIZATION__FILTER_STATE_HISTORY_HPP_
+
+#include <boost/circular_buffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "Eigen/Dense"
+#include "rclcpp/time.hpp"
+#include "robot_localization/filter_common.hpp"
+
+namespace robot_localization
+{
+
+//! @brief Number of elements in the upper triangle of a STATE_SIZE x
+//! STATE_SIZE matrix, including the diagonal
+const int PACKED_COVARIANCE_SIZE = STATE_SIZE * (STATE_SIZE + 1) / 2;
+
+/**
+ * @brief Stores the upper triangle (row major, including the diagonal) of the
+ * symmetric STATE_SIZE x STATE_SIZE matrix @p matrix in @p packed
+ */
+template<typename Scalar>
+void packCovariance(const Eigen::MatrixXd & matrix, Scalar * packed)
+{
+  for (int row = 0; row < STATE_SIZE; ++row) {
+    for (int col = row; col < STATE_SIZE; ++col) {
+      *packed++ = static_cast<Scalar>(matrix(row, col));
+    }
+  }
+}
+
+/**
+ * @brief Expands a covariance stored by packCovariance() into the full
+ * symmetric matrix
+ */
+template<typename Scalar>
+void unpackCovariance(const Scalar * packed, Eigen::MatrixXd & matrix)
+{
+  matrix.resize(STATE_SIZE, STATE_SIZE);
+  for (int row = 0; row < STATE_SIZE; ++row) {
+    for (int col = row; col < STATE_SIZE; ++col) {
+      matrix(row, col) = matrix(col, row) = static_cast<double>(*packed++);
+    }
+  }
+}
+
+/**
+ * @brief Filter state in one fixed-size record, with the estimate error
+ * covariance stored as packed upper triangle
+ *
+ * Unlike FilterState, the record owns no heap memory, so a history of these
+ * is one contiguous block. The state is always kept in double precision, the
+ * covariance in @p CovarianceScalar.
+ */
+template<typename CovarianceScalar>
+struct PackedFilterState
+{
+  // The filter state vector
+  std::array<double, STATE_SIZE> state_;
+
+  // Upper triangle of the filter error covariance matrix
+  std::array<CovarianceScalar, PACKED_COVARIANCE_SIZE> estimate_error_covariance_;
+
+  // The most recent control vector
+  std::array<double, TWIST_SIZE> latest_control_;
+
+  // The time stamp of the most recent measurement for the filter
+  rclcpp::Time last_measurement_time_;
+
+  // The time stamp of the most recent control term
+  rclcpp::Time latest_control_time_;
+};
+
+/**
+ * @brief History of filter states, ordered from oldest to newest
+ *
+ * The states are kept as PackedFilterState records in a circular buffer that
+ * grows as needed, and are only expanded when the filter is restored from one
+ * of them. The covariance can optionally be stored in single precision, which
+ * almost halves the size of a record.
+ */
+class FilterStateHistory
+{
+public:
+  /**
+   * @brief Selects single precision storage of the covariance. Clears the
+   * history if the precision changes.
+   */
+  void setFloatCovariance(const bool float_covariance)
+  {
+    if (float_covariance != float_covariance_) {
+      clear();
+      double_states_.set_capacity(0);
+      float_states_.set_capacity(0);
+    }
+    float_covariance_ = float_covariance;
+  }
+
+  bool getFloatCovariance() const
+  {
+    return float_covariance_;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  size_t size() const
+  {
+    return float_covariance_ ? float_states_.size() : double_states_.size();
+  }
+
+  //! @brief Bytes reserved for the records
+  size_t memoryUsage() const
+  {
+    return double_states_.capacity() * sizeof(PackedFilterState<double>) +
+           float_states_.capacity() * sizeof(PackedFilterState<float>);
+  }
+
+  void clear()
+  {
+    double_states_.clear();
+    float_states_.clear();
+  }
+
+  //! @brief Appends the current state of @p filter
+  template<typename Filter>
+  void push(Filter & filter)
+  {
+    if (float_covariance_) {
+      push(filter, float_states_);
+    } else {
+      push(filter, double_states_);
+    }
+  }
+
+  //! @brief Time of the newest state. The history must not be empty.
+  const rclcpp::Time & backTime() const
+  {
+    return float_covariance_ ?
+           float_states_.back().last_measurement_time_ :
+           double_states_.back().last_measurement_time_;
+  }
+
+  //! @brief Time of the oldest state. The history must not be empty.
+  const rclcpp::Time & frontTime() const
+  {
+    return float_covariance_ ?
+           float_states_.front().last_measurement_time_ :
+           double_states_.front().last_measurement_time_;
+  }
+
+  void popBack()
+  {
+    if (float_covariance_) {
+      float_states_.pop_back();
+    } else {
+      double_states_.pop_back();
+    }
+  }
+
+  void popFront()
+  {
+    if (float_covariance_) {
+      float_states_.pop_front();
+    } else {
+      double_states_.pop_front();
+    }
+  }
+
+  /**
+   * @brief Sets state, covariance and last measurement time of @p filter to
+   * the newest state. The history must not be empty.
+   */
+  template<typename Filter>
+  void restoreBack(Filter & filter)
+  {
+    if (float_covariance_) {
+      restore(float_states_.back(), filter);
+    } else {
+      restore(double_states_.back(), filter);
+    }
+  }
+
+private:
+  template<typename Filter, typename Scalar>
+  void push(Filter & filter, boost::circular_buffer<PackedFilterState<Scalar>> & states)
+  {
+    if (states.full()) {
+      states.set_capacity(std::max<size_t>(2 * states.capacity(), 64));
+    }
+    states.push_back(PackedFilterState<Scalar>());
+    PackedFilterState<Scalar> & record = states.back();
+
+    const Eigen::VectorXd & state = filter.getState();
+    std::copy(state.data(), state.data() + STATE_SIZE, record.state_.begin());
+    packCovariance(filter.getEstimateErrorCovariance(), record.estimate_error_covariance_.data());
+    const Eigen::VectorXd & control = filter.getControl();
+    std::copy(control.data(), control.data() + TWIST_SIZE, record.latest_control_.begin());
+    record.last_measurement_time_ = filter.getLastMeasurementTime();
+    record.latest_control_time_ = filter.getControlTime();
+  }
+
+  template<typename Filter, typename Scalar>
+  void restore(const PackedFilterState<Scalar> & record, Filter & filter)
+  {
+    state_ = Eigen::Map<const Eigen::VectorXd>(record.state_.data(), STATE_SIZE);
+    unpackCovariance(record.estimate_error_covariance_.data(), covariance_);
+    filter.setState(state_);
+    filter.setEstimateErrorCovariance(covariance_);
+    filter.setLastMeasurementTime(record.last_measurement_time_);
+  }
+
+  bool float_covariance_ = false;
+  boost::circular_buffer<PackedFilterState<double>> double_states_;
+  boost::circular_buffer<PackedFilterState<float>> float_states_;
+
+  // Scratch space for restoring, to avoid allocations on every revert
+  Eigen::VectorXd state_;
+  Eigen::MatrixXd covariance_;
+};
+
+}  // namespace robot_localization
+
+#endif  // ROBOT_LOCALIZATION__FILTER_STATE_HISTORY_HPP_
@@ -51,6 +51,7 @@
 #include <stdlib.h>
 
 #include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
 #include <GeographicLib/UTMUPS.hpp>
 
 #include <cmath>
@@ -219,6 +220,119 @@ static inline void UTMtoLL(
   UTMtoLL(UTMNorthing, UTMEasting, UTMZone, Lat, Long, gamma);
 }
 
+/**
+ * Converts between lat/long and the UTM coordinates of one fixed zone.
+ *
+ * The zone string is parsed once, so converting many points avoids the MGRS zone
+ * formatting and parsing done by every LLtoUTM() / UTMtoLL() call. Within the zone the
+ * results are the same as those of LLtoUTM() / UTMtoLL(). Points outside of the zone are
+ * projected into it (GeographicLib extends the UTM zones), so a series of points crossing
+ * a zone boundary stays in one consistent frame.
+ */
+class UTMZoneConverter
+{
+public:
+  UTMZoneConverter() = default;
+
+  explicit UTMZoneConverter(const std::string & UTMZone)
+  {
+    setZone(UTMZone);
+  }
+
+  /**
+   * Sets the zone, as returned by LLtoUTM(). An empty string clears the zone.
+   */
+  void setZone(const std::string & UTMZone)
+  {
+    zone_string_ = UTMZone;
+    zone_ = GeographicLib::UTMUPS::INVALID;
+    if (UTMZone.empty()) {
+      return;
+    }
+    double x_unused;
+    double y_unused;
+    int prec_unused;
+    GeographicLib::MGRS::Reverse(UTMZone, zone_, northp_, x_unused, y_unused, prec_unused, true);
+    central_meridian_ = 6.0 * zone_ - 183.0;
+  }
+
+  bool valid() const
+  {
+    return zone_ != GeographicLib::UTMUPS::INVALID;
+  }
+
+  const std::string & zone() const
+  {
+    return zone_string_;
+  }
+
+  /**
+   * Convert lat/long to UTM coords of this zone.
+   *
+   * @param[out] gamma meridian convergence at point (degrees).
+   */
+  void LLtoUTM(
+    const double Lat, const double Long,
+    double & UTMNorthing, double & UTMEasting, double & gamma) const
+  {
+    double k_unused;
+    if (zone_ == GeographicLib::UTMUPS::UPS) {
+      int zone_unused;
+      bool northp_unused;
+      GeographicLib::UTMUPS::Forward(
+        Lat, Long, zone_unused, northp_unused, UTMEasting, UTMNorthing, gamma, k_unused, zone_);
+      return;
+    }
+    // same as UTMUPS::Forward() with a fixed zone, without the zone selection and checks
+    GeographicLib::TransverseMercator::UTM().Forward(
+      central_meridian_, Lat, Long, UTMEasting, UTMNorthing, gamma, k_unused);
+    UTMEasting += UTM_FE;
+    UTMNorthing += northp_ ? UTM_FN_N : UTM_FN_S;
+  }
+
+  void LLtoUTM(
+    const double Lat, const double Long,
+    double & UTMNorthing, double & UTMEasting) const
+  {
+    double gamma;
+    LLtoUTM(Lat, Long, UTMNorthing, UTMEasting, gamma);
+  }
+
+  /**
+   * Converts UTM coords of this zone to lat/long.
+   *
+   * @param[out] gamma meridian convergence at point (degrees).
+   */
+  void UTMtoLL(
+    const double UTMNorthing, const double UTMEasting,
+    double & Lat, double & Long, double & gamma) const
+  {
+    double k_unused;
+    if (zone_ == GeographicLib::UTMUPS::UPS) {
+      GeographicLib::UTMUPS::Reverse(
+        zone_, northp_, UTMEasting, UTMNorthing, Lat, Long, gamma, k_unused);
+      return;
+    }
+    GeographicLib::TransverseMercator::UTM().Reverse(
+      central_meridian_, UTMEasting - UTM_FE, UTMNorthing - (northp_ ? UTM_FN_N : UTM_FN_S),
+      Lat, Long, gamma, k_unused);
+  }
+
+  void UTMtoLL(
+    const double UTMNorthing, const double UTMEasting,
+    double & Lat, double & Long) const
+  {
+    double gamma;
+    UTMtoLL(UTMNorthing, UTMEasting, Lat, Long, gamma);
+  }
+
+private:
+  std::string zone_string_;
+  int zone_ = GeographicLib::UTMUPS::INVALID;
+  bool northp_ = true;
+  double central_meridian_ = 0.0;
+};
+
 }  // namespace navsat_conversions
 }  // namespace robot_localization
 
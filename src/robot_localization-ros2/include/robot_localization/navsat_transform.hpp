@@ -37,12 +37,16 @@
 
 #include "Eigen/Dense"
 #include "GeographicLib/LocalCartesian.hpp"
+#include "geometry_msgs/msg/point.hpp"
 #include "nav_msgs/msg/odometry.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp/timer.hpp"
+#include "robot_localization/navsat_conversions.hpp"
 #include "robot_localization/srv/from_ll.hpp"
+#include "robot_localization/srv/from_ll_array.hpp"
 #include "robot_localization/srv/set_datum.hpp"
 #include "robot_localization/srv/to_ll.hpp"
+#include "robot_localization/srv/to_ll_array.hpp"
 #include "sensor_msgs/msg/imu.hpp"
 #include "sensor_msgs/msg/nav_sat_fix.hpp"
 #include "tf2/LinearMath/Quaternion.h"
@@ -99,6 +103,18 @@ private:
     const std::shared_ptr<robot_localization::srv::FromLL::Request> request,
     std::shared_ptr<robot_localization::srv::FromLL::Response> response);
 
+  //! @brief Callback for the to Lat Long service over an array of points
+  //!
+  bool toLLArrayCallback(
+    const std::shared_ptr<robot_localization::srv::ToLLArray::Request> request,
+    std::shared_ptr<robot_localization::srv::ToLLArray::Response> response);
+
+  //! @brief Callback for the from Lat Long service over an array of points
+  //!
+  bool fromLLArrayCallback(
+    const std::shared_ptr<robot_localization::srv::FromLLArray::Request> request,
+    std::shared_ptr<robot_localization::srv::FromLLArray::Response> response);
+
   /**
    * @brief Given the pose of the navsat sensor in the Cartesian frame, removes the
    * offset from the vehicle's centroid and returns the Cartesian-frame pose of said
@@ -177,6 +193,14 @@ private:
     const tf2::Vector3 & point, double & latitude, double & longitude,
     double & altitude) const;
 
+  /**
+   * @brief Transforms the passed in lat/long to a point in map frame
+   * @param[in] latitude, longitude, altitude the position to transform
+   */
+  geometry_msgs::msg::Point llToMap(
+    const double latitude, const double longitude,
+    const double altitude) const;
+
   /**
    * @brief Sets the manual datum pose to be used by the transform computation
    */
@@ -216,6 +240,16 @@ private:
    */
   rclcpp::Service<robot_localization::srv::FromLL>::SharedPtr from_ll_srv_;
 
+  /**
+   * @brief Service for to Lat Long over an array of points
+   */
+  rclcpp::Service<robot_localization::srv::ToLLArray>::SharedPtr to_ll_array_srv_;
+
+  /**
+   * @brief Service for from Lat Long over an array of points
+   */
+  rclcpp::Service<robot_localization::srv::FromLLArray>::SharedPtr from_ll_array_srv_;
+
   /**
    * @brief Navsatfix publisher
    */
@@ -415,6 +449,11 @@ private:
    */
   std::string utm_zone_;
 
+  /**
+   * @brief Converts to / from the UTM coordinates of utm_zone_
+   */
+  navsat_conversions::UTMZoneConverter utm_converter_;
+
   /**
    * @brief Frame ID of the GPS odometry output
    *
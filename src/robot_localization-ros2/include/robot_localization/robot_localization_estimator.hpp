@@ -32,6 +32,7 @@
 #ifndef ROBOT_LOCALIZATION__ROBOT_LOCALIZATION_ESTIMATOR_HPP_
 #define ROBOT_LOCALIZATION__ROBOT_LOCALIZATION_ESTIMATOR_HPP_
 
+#include <array>
 #include <ostream>
 #include <memory>
 #include <vector>
@@ -40,6 +41,7 @@
 #include "Eigen/Dense"
 #include "robot_localization/filter_base.hpp"
 #include "robot_localization/filter_common.hpp"
+#include "robot_localization/filter_state_history.hpp"
 
 namespace robot_localization
 {
@@ -83,6 +85,40 @@ struct EstimatorState
   }
 };
 
+//! @brief EstimatorState in one fixed-size record
+//!
+//! The covariance is stored as packed upper triangle. The state buffer keeps
+//! these records and only expands the ones used for a query.
+//!
+struct PackedEstimatorState
+{
+  PackedEstimatorState()
+  : time_stamp(0.0), state(), covariance()
+  {
+  }
+
+  explicit PackedEstimatorState(const EstimatorState & estimator_state)
+  : time_stamp(estimator_state.time_stamp)
+  {
+    std::copy(
+      estimator_state.state.data(), estimator_state.state.data() + STATE_SIZE,
+      state.begin());
+    packCovariance(estimator_state.covariance, covariance.data());
+  }
+
+  //! @brief Expands the record into @p estimator_state
+  void unpack(EstimatorState & estimator_state) const
+  {
+    estimator_state.time_stamp = time_stamp;
+    estimator_state.state = Eigen::Map<const Eigen::VectorXd>(state.data(), STATE_SIZE);
+    unpackCovariance(covariance.data(), estimator_state.covariance);
+  }
+
+  double time_stamp;
+  std::array<double, STATE_SIZE> state;
+  std::array<double, PACKED_COVARIANCE_SIZE> covariance;
+};
+
 namespace EstimatorResults
 {
 enum EstimatorResult
@@ -181,10 +217,12 @@ private:
     std::ostream & os,
     const RobotLocalizationEstimator & rle)
   {
-    for (boost::circular_buffer<EstimatorState>::const_iterator it =
+    EstimatorState state;
+    for (boost::circular_buffer<PackedEstimatorState>::const_iterator it =
       rle.state_buffer_.begin(); it != rle.state_buffer_.end(); ++it)
     {
-      os << *it << "\n";
+      it->unpack(state);
+      os << state << "\n";
     }
     return os;
   }
@@ -196,7 +234,7 @@ private:
   //! @param[out] state_at_req_time - predicted state at requested time
   //!
   void extrapolate(
-    const EstimatorState & boundary_state,
+    const PackedEstimatorState & boundary_state,
     const double requested_time,
     EstimatorState & state_at_req_time) const;
 
@@ -208,15 +246,15 @@ private:
   //! @param[out] state_at_req_time - predicted state at requested time
   //!
   void interpolate(
-    const EstimatorState & given_state_1,
-    const EstimatorState & /*given_state_2*/,
+    const PackedEstimatorState & given_state_1,
+    const PackedEstimatorState & /*given_state_2*/,
     const double requested_time, EstimatorState & state_at_req_time) const;
 
   //!
   //! @brief The buffer holding the system states that have come in.
   //! Interpolation and extrapolation is done starting from these states.
   //!
-  boost::circular_buffer<EstimatorState> state_buffer_;
+  boost::circular_buffer<PackedEstimatorState> state_buffer_;
 
   //!
   //! @brief A pointer to the filter instance that is used for extrapolation
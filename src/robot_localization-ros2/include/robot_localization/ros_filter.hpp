@@ -32,6 +32,7 @@
 #ifndef ROBOT_LOCALIZATION__ROS_FILTER_HPP_
 #define ROBOT_LOCALIZATION__ROS_FILTER_HPP_
 
+#include <cstdint>
 #include <deque>
 #include <fstream>
 #include <map>
@@ -53,7 +54,9 @@
 #include "nav_msgs/msg/odometry.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "robot_localization/filter_state.hpp"
+#include "robot_localization/filter_state_history.hpp"
 #include "robot_localization/measurement.hpp"
+#include "robot_localization/shared_sensor_inputs.hpp"
 #include "robot_localization/srv/toggle_filter_processing.hpp"
 #include "robot_localization/srv/set_pose.hpp"
 #include "sensor_msgs/msg/imu.hpp"
@@ -92,7 +95,26 @@ using MeasurementQueue =
   std::priority_queue<MeasurementPtr, std::vector<MeasurementPtr>,
     Measurement>;
 using MeasurementHistoryDeque = std::deque<MeasurementPtr>;
-using FilterStateHistoryDeque = std::deque<FilterStatePtr>;
+
+//! @brief Counters for the handling of out-of-sequence measurements, used to
+//! tune the reorder_delay parameter
+struct ReorderStatistics
+{
+  //! @brief Measurements enqueued after a measurement with a later time stamp
+  uint64_t late_measurements_ = 0;
+
+  //! @brief Reverts of the filter to an earlier state from the history
+  uint64_t reverts_ = 0;
+
+  //! @brief Measurements processed again after a revert
+  uint64_t reintegrated_measurements_ = 0;
+
+  //! @brief Calls of integrateMeasurements()
+  uint64_t integrations_ = 0;
+
+  //! @brief CPU time spent in integrateMeasurements(), in seconds
+  double integration_cpu_time_ = 0.0;
+};
 
 template<class T>
 class RosFilter : public rclcpp::Node
@@ -203,6 +225,14 @@ public:
     return filter_;
   }
 
+  //! @brief Returns the counters for out-of-sequence measurements since
+  //! startup
+  //!
+  const ReorderStatistics & getReorderStatistics() const
+  {
+    return reorder_statistics_;
+  }
+
   //! @brief Retrieves the EKF's output for broadcasting
   //! @param[out] message - The standard ROS odometry message to be filled
   //! @return true if the filter is initialized, false otherwise
@@ -241,7 +271,7 @@ public:
   //! order
   //!
   //! @param[in] current_time - The time at which to carry out integration (the
-  //! current time)
+  //! current time). Measurements younger than reorder_delay_ stay in the queue.
   //!
   void integrateMeasurements(const rclcpp::Time & current_time);
 
@@ -290,6 +320,13 @@ public:
   //!
   void initialize();
 
+  //! @brief Makes this filter use sensor subscriptions and a tf buffer
+  //! shared with other filters in the same process. Must be called before
+  //! initialize().
+  //! @param[in] inputs - The shared inputs
+  //!
+  void setSharedSensorInputs(std::shared_ptr<SharedSensorInputs> inputs);
+
   //! @brief Service callback for resetting the filter to its initial state. Parameters are unused.
   //!
   void resetSrvCallback(
@@ -371,6 +408,28 @@ protected:
   //!
   void clearMeasurementQueue();
 
+  //! @brief Subscribes to a sensor topic, through the shared inputs if this
+  //! filter has any
+  //!
+  template<typename MessageT>
+  rclcpp::SubscriptionBase::SharedPtr subscribeSensor(
+    const std::string & topic, const rclcpp::QoS & qos,
+    std::function<void(const std::shared_ptr<MessageT>)> callback)
+  {
+    if (shared_inputs_) {
+      return shared_inputs_->subscribe<MessageT>(*this, topic, qos, callback);
+    }
+    return this->create_subscription<MessageT>(topic, qos, callback);
+  }
+
+  //! @brief Looks up a transform for a sensor message, through the shared
+  //! inputs if this filter has any
+  //!
+  bool lookupSensorTransform(
+    const std::string & target_frame, const std::string & source_frame,
+    const rclcpp::Time & time, const rclcpp::Duration & timeout,
+    tf2::Transform & target_frame_trans);
+
   //! @brief Adds a diagnostic message to the accumulating map and updates the
   //! error level
   //! @param[in] error_level - The error level of the diagnostic
@@ -522,6 +581,11 @@ protected:
   //!
   bool smooth_lagged_data_;
 
+  //! @brief Whether measurements with the same time stamp are fused in a
+  //! single correction
+  //!
+  bool batch_simultaneous_measurements_;
+
   //! @brief Whether the filter should process new measurements or not.
   //!
   bool toggled_on_;
@@ -576,6 +640,27 @@ protected:
   //!
   rclcpp::Duration history_length_;
 
+  //! @brief How long measurements are held back before they are processed
+  //!
+  //! Measurements arriving out of order within this delay are sorted in
+  //! instead of reverting the filter. The published state is predicted to
+  //! the current time.
+  //!
+  rclcpp::Duration reorder_delay_;
+
+  //! @brief The latest time stamp of an enqueued measurement
+  //!
+  rclcpp::Time latest_enqueued_time_;
+
+  //! @brief Counters for out-of-sequence measurements, see
+  //! getReorderStatistics()
+  //!
+  ReorderStatistics reorder_statistics_;
+
+  //! @brief The counters at the time of the last diagnostics report
+  //!
+  ReorderStatistics reported_reorder_statistics_;
+
   //! @brief The sensor timeout value that gets passed to the core filter
   //!
   rclcpp::Duration sensor_timeout_;
@@ -711,7 +796,8 @@ protected:
   //
   // front() refers to the filter state with the earliest timestamp.
   // back() refers to the filter state with the latest timestamp.
-  FilterStateHistoryDeque filter_state_history_;
+  // The states are stored as packed records, see FilterStateHistory.
+  FilterStateHistory filter_state_history_;
 
   //! @brief A deque of previous measurements which is implicitly ordered from
   //! earliest to latest measurement.
@@ -800,9 +886,14 @@ protected:
   //!
   rclcpp::Service<std_srvs::srv::Empty>::SharedPtr reset_srv_;
 
+  //! @brief Sensor subscriptions and tf buffer shared with other filters,
+  //! null if this filter owns its own
+  //!
+  std::shared_ptr<SharedSensorInputs> shared_inputs_;
+
   //! @brief Transform buffer for managing coordinate transforms
   //!
-  std::unique_ptr<tf2_ros::Buffer> tf_buffer_;
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
 
   //! @brief Transform listener for receiving transforms
   //!
@@ -829,6 +920,11 @@ protected:
   //!
   T filter_;
 
+  //! @brief Copy of filter_ while the prediction to the current time is
+  //! published (reorder_delay_ > 0)
+  //!
+  T committed_filter_;
+
   //! @brief Timer for filter updates
   //!
   rclcpp::TimerBase::SharedPtr timer_;
@@ -32,6 +32,7 @@
 #ifndef ROBOT_LOCALIZATION__ROS_ROBOT_LOCALIZATION_LISTENER_HPP_
 #define ROBOT_LOCALIZATION__ROS_ROBOT_LOCALIZATION_LISTENER_HPP_
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -61,6 +62,10 @@ get_subscription_options_with_default_qos_override_policies()
 }
 }  // namespace detail
 
+//! @brief Converts a filter_type parameter ("ekf" or "ukf") to a FilterType
+//!
+FilterTypes::FilterType filterTypeFromString(const std::string & filter_type_str);
+
 //! @brief RosRobotLocalizationListener class
 //!
 //! This class wraps the RobotLocalizationEstimator. It listens to topics over
@@ -140,6 +145,13 @@ public:
   //!
   const std::string & getWorldFrameId() const;
 
+  //!
+  //! \brief setStateCallback Sets a function that is called with every state
+  //! that is added to the estimator, e.g. to mirror it elsewhere
+  //! \param callback The function to call
+  //!
+  void setStateCallback(std::function<void(const EstimatorState &)> callback);
+
 private:
   //! @brief Callback for odom and accel
   //!
@@ -196,6 +208,10 @@ private:
   //!
   std::string world_frame_id_;
 
+  //! @brief Called with every new state
+  //!
+  std::function<void(const EstimatorState &)> state_callback_;
+
   //! @brief Tf buffer for looking up transforms
   //!
   tf2_ros::Buffer tf_buffer_;
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2014, 2015, 2016 Charles River Analytics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef ROBOT_LOCALIZATION__SHARED_SENSOR_INPUTS_HPP_
+#define ROBOT_LOCALIZATION__SHARED_SENSOR_INPUTS_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "tf2/LinearMath/Transform.h"
+#include "tf2_ros/buffer.h"
+#include "tf2_ros/transform_listener.h"
+
+namespace robot_localization
+{
+
+//! @brief Sensor inputs shared by several filters running in one process
+//!
+//! When two filters (e.g., the odom and map instances of a dual EKF setup)
+//! consume the same sensor topics, each of them normally holds its own
+//! subscription, deserializes every message, and keeps its own tf buffer and
+//! listener. This class holds one subscription per (resolved topic, message
+//! type) pair and hands the same message to all registered callbacks, and
+//! provides one tf buffer for all filters. Transform lookups made while a
+//! message is being dispatched are memoized, so the second filter reuses the
+//! sensor-to-target transforms looked up by the first one.
+//!
+//! The measurement preparation itself stays per filter, as it depends on
+//! each filter's own state and world frame.
+//!
+class SharedSensorInputs
+{
+public:
+  //! @brief Constructor
+  //! @param[in] owner - Node on which the shared subscriptions are created,
+  //! and whose clock drives the tf buffer
+  //!
+  explicit SharedSensorInputs(const rclcpp::Node::SharedPtr & owner);
+
+  ~SharedSensorInputs();
+
+  //! @brief Subscribes a callback to a topic, sharing the subscription with
+  //! any other callback registered for the same topic and message type
+  //! @param[in] node - The node requesting the subscription, used to resolve
+  //! relative topic names and remappings
+  //! @param[in] topic - Topic name
+  //! @param[in] qos - QoS used if the subscription does not exist yet
+  //! @param[in] callback - Callback invoked for every message
+  //! @return the shared subscription
+  //!
+  template<typename MessageT>
+  rclcpp::SubscriptionBase::SharedPtr subscribe(
+    rclcpp::Node & node, const std::string & topic, const rclcpp::QoS & qos,
+    std::function<void(const std::shared_ptr<MessageT>)> callback)
+  {
+    const std::string resolved =
+      node.get_node_topics_interface()->resolve_topic_name(topic);
+    const std::string key = resolved + "#" + typeid(MessageT).name();
+
+    auto & fanout = fanouts_[key];
+    if (!fanout.subscription) {
+      auto owner = owner_.lock();
+      if (!owner) {
+        throw std::runtime_error("Owner node of the shared sensor inputs is gone");
+      }
+
+      auto callbacks = std::make_shared<
+        std::vector<std::function<void(const std::shared_ptr<MessageT>)>>>();
+      fanout.callbacks = callbacks;
+      fanout.subscription = owner->create_subscription<MessageT>(
+        resolved, qos,
+        [this, callbacks](const std::shared_ptr<MessageT> msg) {
+          beginDispatch();
+          for (const auto & cb : *callbacks) {
+            cb(msg);
+          }
+          endDispatch();
+        });
+
+      RCLCPP_INFO_STREAM(
+        owner->get_logger(), "Shared sensor subscription on " << resolved);
+    }
+
+    std::static_pointer_cast<
+      std::vector<std::function<void(const std::shared_ptr<MessageT>)>>>(
+      fanout.callbacks)->push_back(callback);
+
+    return fanout.subscription;
+  }
+
+  //! @brief Returns the tf buffer shared by all filters
+  //!
+  std::shared_ptr<tf2_ros::Buffer> getTfBuffer() const
+  {
+    return tf_buffer_;
+  }
+
+  //! @brief Looks up a transform in the shared buffer (see
+  //! ros_filter_utilities::lookupTransformSafe). While a message is being
+  //! dispatched, successful lookups are memoized and reused by the other
+  //! callbacks of the same message.
+  //!
+  bool lookupTransform(
+    const std::string & target_frame, const std::string & source_frame,
+    const rclcpp::Time & time, const rclcpp::Duration & timeout,
+    tf2::Transform & target_frame_trans);
+
+  //! @brief Drops all memoized transforms and clears the shared tf buffer
+  //!
+  void clearTransforms();
+
+  //! @brief Number of transform lookups answered from the memo
+  //!
+  uint64_t getTransformCacheHits() const
+  {
+    return transform_cache_hits_;
+  }
+
+  //! @brief Number of transform lookups forwarded to the tf buffer
+  //!
+  uint64_t getTransformCacheMisses() const
+  {
+    return transform_cache_misses_;
+  }
+
+private:
+  struct Fanout
+  {
+    rclcpp::SubscriptionBase::SharedPtr subscription;
+    std::shared_ptr<void> callbacks;
+  };
+
+  struct CachedTransform
+  {
+    std::string target_frame;
+    std::string source_frame;
+    int64_t stamp;
+    tf2::Transform transform;
+  };
+
+  void beginDispatch();
+
+  void endDispatch();
+
+  rclcpp::Node::WeakPtr owner_;
+
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
+
+  std::unique_ptr<tf2_ros::TransformListener> tf_listener_;
+
+  std::map<std::string, Fanout> fanouts_;
+
+  //! @brief Transforms looked up during the current dispatch. The memo only
+  //! lives for the dispatch of a single message so that a lookup that fell
+  //! back to the latest transform is never reused for another message.
+  //!
+  std::vector<CachedTransform> transform_cache_;
+
+  bool dispatching_;
+
+  uint64_t transform_cache_hits_;
+
+  uint64_t transform_cache_misses_;
+};
+
+}  // namespace robot_localization
+
+#endif  // ROBOT_LOCALIZATION__SHARED_SENSOR_INPUTS_HPP_
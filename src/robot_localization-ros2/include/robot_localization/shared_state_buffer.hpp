@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2016, TNO IVS Helmond.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef ROBOT_LOCALIZATION__SHARED_STATE_BUFFER_HPP_
+#define ROBOT_LOCALIZATION__SHARED_STATE_BUFFER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "robot_localization/filter_common.hpp"
+#include "robot_localization/robot_localization_estimator.hpp"
+
+namespace robot_localization
+{
+
+namespace shared_state
+{
+
+//! @brief Identifies a segment written by SharedStateWriter ("RLSS")
+const uint32_t MAGIC = 0x524c5353;
+
+//! @brief Incremented whenever the memory layout below changes
+const uint32_t LAYOUT_VERSION = 1;
+
+const size_t FRAME_ID_LENGTH = 128;
+
+const size_t MAX_FILTER_ARGS = 3;
+
+//! @brief One buffered estimator state
+//!
+struct Slot
+{
+  double time_stamp;
+  double state[STATE_SIZE];
+  double covariance[STATE_SIZE * STATE_SIZE];
+};
+
+//! @brief Start of the shared memory segment, followed by capacity Slots
+//!
+//! All fields after magic are protected by the sequence counter (seqlock):
+//! the writer makes it odd before and even again after each modification,
+//! readers retry when it is odd or has changed while they were copying.
+//!
+struct Header
+{
+  std::atomic<uint32_t> magic;
+  uint32_t layout_version;
+  uint32_t capacity;
+  int32_t filter_type;
+  std::atomic<uint64_t> sequence;
+  uint64_t begin;
+  uint64_t size;
+  uint32_t num_filter_args;
+  double filter_args[MAX_FILTER_ARGS];
+  double process_noise_covariance[STATE_SIZE * STATE_SIZE];
+  char world_frame_id[FRAME_ID_LENGTH];
+  char base_frame_id[FRAME_ID_LENGTH];
+};
+
+//! @brief Returns the size in bytes of a segment holding capacity states
+//!
+size_t segmentSize(uint32_t capacity);
+
+}  // namespace shared_state
+
+//! @brief Publishes a time ordered state buffer into POSIX shared memory
+//!
+//! The buffer has the same semantics as the one of RobotLocalizationEstimator
+//! (a time ordered circular buffer), so that a SharedStateClient on the same
+//! host answers queries exactly like the estimator would, without a service
+//! call. The segment is removed when the writer is destroyed.
+//!
+class SharedStateWriter
+{
+public:
+  SharedStateWriter();
+
+  ~SharedStateWriter();
+
+  //! @brief Creates (or replaces) the shared memory segment
+  //!
+  //! @param[in] name - POSIX shared memory name, e.g. "/robot_localization_state"
+  //! @param[in] capacity - Number of states kept in the buffer
+  //! @param[in] filter_type - Filter used by clients for extrapolation
+  //! @param[in] process_noise_covariance - Process noise used by clients
+  //! @param[in] filter_args - Optional filter arguments (UKF alpha, kappa, beta)
+  //!
+  //! @return false if the segment could not be created (see errno)
+  //!
+  bool initialize(
+    const std::string & name,
+    unsigned int capacity,
+    FilterTypes::FilterType filter_type,
+    const Eigen::MatrixXd & process_noise_covariance,
+    const std::vector<double> & filter_args = std::vector<double>());
+
+  //! @brief Sets the frame ids that the buffered states refer to
+  //!
+  void setFrameIds(const std::string & world_frame_id, const std::string & base_frame_id);
+
+  //! @brief Inserts a state, same as RobotLocalizationEstimator::setState()
+  //!
+  void setState(const EstimatorState & state);
+
+  //! @brief Returns true once initialize() succeeded
+  //!
+  bool isInitialized() const;
+
+private:
+  void beginWrite();
+
+  void endWrite();
+
+  std::string name_;
+  shared_state::Header * header_;
+  shared_state::Slot * slots_;
+  size_t size_;
+};
+
+//! @brief Answers state queries from a segment published by SharedStateWriter
+//!
+//! States are in the world frame of the listener, i.e. the frame of the
+//! filtered odometry. Queries for other frames need the get_state service.
+//! An instance must not be used from several threads at the same time.
+//!
+class SharedStateClient
+{
+public:
+  SharedStateClient();
+
+  ~SharedStateClient();
+
+  //! @brief Maps an existing segment
+  //!
+  //! @param[in] name - POSIX shared memory name used by the writer
+  //!
+  //! @return false if the segment does not exist or is not compatible
+  //!
+  bool open(const std::string & name);
+
+  //! @brief Returns the state at a given time
+  //!
+  //! Same semantics and result codes as RobotLocalizationEstimator::getState()
+  //!
+  //! @param[in] time - The time of the requested state, in seconds
+  //! @param[out] state - The state at the given time
+  //!
+  EstimatorResults::EstimatorResult getState(const double time, EstimatorState & state);
+
+  //! @brief Returns the world frame id of the buffered states (empty if unknown)
+  //!
+  std::string getWorldFrameId() const;
+
+  //! @brief Returns the base frame id of the buffered states (empty if unknown)
+  //!
+  std::string getBaseFrameId() const;
+
+  //! @brief Returns true once open() succeeded
+  //!
+  bool isOpen() const;
+
+private:
+  void close();
+
+  std::string readFrameId(const char * frame_id) const;
+
+  const shared_state::Header * header_;
+  const shared_state::Slot * slots_;
+  size_t size_;
+
+  //! @brief Extrapolates from the state found in shared memory
+  //!
+  std::unique_ptr<RobotLocalizationEstimator> estimator_;
+};
+
+}  // namespace robot_localization
+
+#endif  // ROBOT_LOCALIZATION__SHARED_STATE_BUFFER_HPP_
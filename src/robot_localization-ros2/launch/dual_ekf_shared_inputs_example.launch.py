@@ -0,0 +1,52 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Same setup as dual_ekf_navsat_example.launch.py, but both EKF instances run
+# in a single dual_ekf_node process that shares sensor subscriptions and tf.
+
+from launch import LaunchDescription
+import launch_ros.actions
+import os
+from ament_index_python.packages import get_package_share_directory
+
+
+def generate_launch_description():
+    robot_localization_dir = get_package_share_directory('robot_localization')
+    parameters_file_path = os.path.join(
+        robot_localization_dir, 'params', 'dual_ekf_navsat_example.yaml')
+    return LaunchDescription([
+        # Node names are set by dual_ekf_node itself, so the remappings of
+        # the two filters have to be qualified with the node name
+        launch_ros.actions.Node(
+            package='robot_localization',
+            executable='dual_ekf_node',
+            output='screen',
+            parameters=[parameters_file_path],
+            arguments=[
+                '--ros-args',
+                '-r', 'ekf_filter_node_odom:odometry/filtered:=odometry/local',
+                '-r', 'ekf_filter_node_map:odometry/filtered:=odometry/global']
+        ),
+        launch_ros.actions.Node(
+            package='robot_localization',
+            executable='navsat_transform_node',
+            name='navsat_transform',
+            output='screen',
+            parameters=[parameters_file_path],
+            remappings=[('imu/data', 'imu/data'),
+                        ('gps/fix', 'gps/fix'),
+                        ('gps/filtered', 'gps/filtered'),
+                        ('odometry/gps', 'odometry/gps'),
+                        ('odometry/filtered', 'odometry/global')]
+        )
+    ])
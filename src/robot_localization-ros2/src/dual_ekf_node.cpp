@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2018, Locus Robotics
+ * Copyright (c) 2019, Steve Macenski
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "robot_localization/ros_filter_types.hpp"
+#include "robot_localization/shared_sensor_inputs.hpp"
+
+// Runs the odom and map instances of a dual EKF setup in one process. Both
+// filters share their sensor subscriptions and tf buffer, so every sensor
+// message is received and deserialized once and handed to both filters.
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+
+  rclcpp::NodeOptions odom_options;
+  odom_options.arguments({"ekf_filter_node_odom"});
+  auto odom_filter =
+    std::make_shared<robot_localization::RosEkf>(odom_options);
+
+  rclcpp::NodeOptions map_options;
+  map_options.arguments({"ekf_filter_node_map"});
+  auto map_filter =
+    std::make_shared<robot_localization::RosEkf>(map_options);
+
+  auto inputs =
+    std::make_shared<robot_localization::SharedSensorInputs>(odom_filter);
+  odom_filter->setSharedSensorInputs(inputs);
+  map_filter->setSharedSensorInputs(inputs);
+
+  odom_filter->initialize();
+  map_filter->initialize();
+
+  // A single thread, so the shared callbacks never run concurrently with
+  // either filter's update
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(odom_filter->get_node_base_interface());
+  executor.add_node(map_filter->get_node_base_interface());
+  executor.spin();
+
+  rclcpp::shutdown();
+  return 0;
+}
@@ -76,22 +76,11 @@ void Ekf::correct(const Measurement & measurement)
 
   // First, determine how many state vector values we're updating
   std::vector<size_t> update_indices;
-  for (size_t i = 0; i < measurement.update_vector_.size(); ++i) {
-    if (measurement.update_vector_[i]) {
-      // Handle nan and inf values in measurements
-      if (std::isnan(measurement.measurement_(i))) {
-        FB_DEBUG(
-          "Value at index " << i <<
-            " was nan. Excluding from update.\n");
-      } else if (std::isinf(measurement.measurement_(i))) {
-        FB_DEBUG(
-          "Value at index " << i <<
-            " was inf. Excluding from update.\n");
-      } else {
-        update_indices.push_back(i);
-      }
-    }
-  }
+  Eigen::VectorXd measurement_subset;             // z
+  Eigen::MatrixXd measurement_covariance_subset;  // R
+  prepareMeasurementSubset(
+    measurement, update_indices, measurement_subset,
+    measurement_covariance_subset);
 
   FB_DEBUG("Update indices are:\n" << update_indices << "\n");
 
@@ -99,57 +88,17 @@ void Ekf::correct(const Measurement & measurement)
 
   // Now set up the relevant matrices
   Eigen::VectorXd state_subset(update_size);       // x (in most literature)
-  Eigen::VectorXd measurement_subset(update_size);  // z
-  Eigen::MatrixXd measurement_covariance_subset(update_size, update_size);  // R
   Eigen::MatrixXd state_to_measurement_subset(update_size, state_.rows());  // H
   Eigen::MatrixXd kalman_gain_subset(state_.rows(), update_size);          // K
   Eigen::VectorXd innovation_subset(update_size);  // z - Hx
 
   state_subset.setZero();
-  measurement_subset.setZero();
-  measurement_covariance_subset.setZero();
   state_to_measurement_subset.setZero();
   kalman_gain_subset.setZero();
   innovation_subset.setZero();
 
-  // Now build the sub-matrices from the full-sized matrices
   for (size_t i = 0; i < update_size; ++i) {
-    measurement_subset(i) = measurement.measurement_(update_indices[i]);
     state_subset(i) = state_(update_indices[i]);
-
-    for (size_t j = 0; j < update_size; ++j) {
-      measurement_covariance_subset(i, j) =
-        measurement.covariance_(update_indices[i], update_indices[j]);
-    }
-
-    // Handle negative (read: bad) covariances in the measurement. Rather
-    // than exclude the measurement or make up a covariance, just take
-    // the absolute value.
-    if (measurement_covariance_subset(i, i) < 0) {
-      FB_DEBUG(
-        "WARNING: Negative covariance for index " <<
-          i << " of measurement (value is" <<
-          measurement_covariance_subset(i, i) <<
-          "). Using absolute value...\n");
-
-      measurement_covariance_subset(i, i) =
-        ::fabs(measurement_covariance_subset(i, i));
-    }
-
-    // If the measurement variance for a given variable is very
-    // near 0 (as in e-50 or so) and the variance for that
-    // variable in the covariance matrix is also near zero, then
-    // the Kalman gain computation will blow up. Really, no
-    // measurement can be completely without error, so add a small
-    // amount in that case.
-    if (measurement_covariance_subset(i, i) < 1e-9) {
-      FB_DEBUG(
-        "WARNING: measurement had very small error covariance for index " <<
-          update_indices[i] <<
-          ". Adding some noise to maintain filter stability.\n");
-
-      measurement_covariance_subset(i, i) = 1e-9;
-    }
   }
 
   // The state-to-measurement function, h, will now be a measurement_size x
@@ -219,6 +168,179 @@ void Ekf::correct(const Measurement & measurement)
   }
 }
 
+void Ekf::prepareMeasurementSubset(
+  const Measurement & measurement,
+  std::vector<size_t> & update_indices,
+  Eigen::VectorXd & measurement_subset,
+  Eigen::MatrixXd & measurement_covariance_subset)
+{
+  update_indices.clear();
+  for (size_t i = 0; i < measurement.update_vector_.size(); ++i) {
+    if (measurement.update_vector_[i]) {
+      // Handle nan and inf values in measurements
+      if (std::isnan(measurement.measurement_(i))) {
+        FB_DEBUG(
+          "Value at index " << i <<
+            " was nan. Excluding from update.\n");
+      } else if (std::isinf(measurement.measurement_(i))) {
+        FB_DEBUG(
+          "Value at index " << i <<
+            " was inf. Excluding from update.\n");
+      } else {
+        update_indices.push_back(i);
+      }
+    }
+  }
+
+  size_t update_size = update_indices.size();
+  measurement_subset.setZero(update_size);
+  measurement_covariance_subset.setZero(update_size, update_size);
+
+  // Now build the sub-matrices from the full-sized matrices
+  for (size_t i = 0; i < update_size; ++i) {
+    measurement_subset(i) = measurement.measurement_(update_indices[i]);
+
+    for (size_t j = 0; j < update_size; ++j) {
+      measurement_covariance_subset(i, j) =
+        measurement.covariance_(update_indices[i], update_indices[j]);
+    }
+
+    // Handle negative (read: bad) covariances in the measurement. Rather
+    // than exclude the measurement or make up a covariance, just take
+    // the absolute value.
+    if (measurement_covariance_subset(i, i) < 0) {
+      FB_DEBUG(
+        "WARNING: Negative covariance for index " <<
+          i << " of measurement (value is" <<
+          measurement_covariance_subset(i, i) <<
+          "). Using absolute value...\n");
+
+      measurement_covariance_subset(i, i) =
+        ::fabs(measurement_covariance_subset(i, i));
+    }
+
+    // If the measurement variance for a given variable is very
+    // near 0 (as in e-50 or so) and the variance for that
+    // variable in the covariance matrix is also near zero, then
+    // the Kalman gain computation will blow up. Really, no
+    // measurement can be completely without error, so add a small
+    // amount in that case.
+    if (measurement_covariance_subset(i, i) < 1e-9) {
+      FB_DEBUG(
+        "WARNING: measurement had very small error covariance for index " <<
+          update_indices[i] <<
+          ". Adding some noise to maintain filter stability.\n");
+
+      measurement_covariance_subset(i, i) = 1e-9;
+    }
+  }
+}
+
+void Ekf::correctBatch(const std::vector<MeasurementPtr> & measurements)
+{
+  FB_DEBUG(
+    "---------------------- Ekf::correctBatch ----------------------\n" <<
+      "State is:\n" << state_ << "\n"
+      "Fusing " << measurements.size() << " measurements\n");
+
+  // Each measurement is gated on its own against the predicted state, and the
+  // ones that pass are stacked into a single measurement with a block
+  // diagonal covariance. As H only selects state variables, one update with
+  // the stacked measurement gives the same result as sequential updates.
+  std::vector<size_t> update_indices;
+  std::vector<Eigen::VectorXd> innovations;
+  std::vector<Eigen::MatrixXd> covariances;
+  size_t update_size = 0;
+
+  for (const MeasurementPtr & measurement : measurements) {
+    std::vector<size_t> indices;
+    Eigen::VectorXd measurement_subset;
+    Eigen::MatrixXd measurement_covariance_subset;
+    prepareMeasurementSubset(
+      *measurement, indices, measurement_subset,
+      measurement_covariance_subset);
+
+    if (indices.empty()) {
+      continue;
+    }
+
+    Eigen::VectorXd innovation_subset(indices.size());
+    Eigen::MatrixXd hphr(measurement_covariance_subset);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      innovation_subset(i) = measurement_subset(i) - state_(indices[i]);
+      if (indices[i] == StateMemberRoll || indices[i] == StateMemberPitch ||
+        indices[i] == StateMemberYaw)
+      {
+        innovation_subset(i) = ::angles::normalize_angle(innovation_subset(i));
+      }
+      for (size_t j = 0; j < indices.size(); ++j) {
+        hphr(i, j) += estimate_error_covariance_(indices[i], indices[j]);
+      }
+    }
+
+    if (!checkMahalanobisThreshold(
+        innovation_subset, hphr.inverse(),
+        measurement->mahalanobis_thresh_))
+    {
+      FB_DEBUG("Measurement from " << measurement->topic_name_ << " rejected.\n");
+      continue;
+    }
+
+    update_indices.insert(update_indices.end(), indices.begin(), indices.end());
+    innovations.push_back(innovation_subset);
+    covariances.push_back(measurement_covariance_subset);
+    update_size += indices.size();
+  }
+
+  if (update_size == 0) {
+    return;
+  }
+
+  Eigen::VectorXd innovation_subset(update_size);  // z - Hx
+  Eigen::MatrixXd measurement_covariance_subset =
+    Eigen::MatrixXd::Zero(update_size, update_size);  // R
+  Eigen::MatrixXd state_to_measurement_subset =
+    Eigen::MatrixXd::Zero(update_size, state_.rows());  // H
+  for (size_t k = 0, offset = 0; k < innovations.size(); ++k) {
+    const size_t size = innovations[k].size();
+    innovation_subset.segment(offset, size) = innovations[k];
+    measurement_covariance_subset.block(offset, offset, size, size) = covariances[k];
+    offset += size;
+  }
+  for (size_t i = 0; i < update_size; ++i) {
+    state_to_measurement_subset(i, update_indices[i]) = 1;
+  }
+
+  // K = (PH') / (HPH' + R)
+  Eigen::MatrixXd pht =
+    estimate_error_covariance_ * state_to_measurement_subset.transpose();
+  Eigen::MatrixXd hphr_inverse =
+    (state_to_measurement_subset * pht + measurement_covariance_subset)
+    .inverse();
+  Eigen::MatrixXd kalman_gain_subset = pht * hphr_inverse;
+
+  // x = x + K(z - Hx)
+  state_.noalias() += kalman_gain_subset * innovation_subset;
+
+  // Joseph form: (I - KH)P(I - KH)' + KRK'
+  Eigen::MatrixXd gain_residual = identity_;
+  gain_residual.noalias() -= kalman_gain_subset * state_to_measurement_subset;
+  estimate_error_covariance_ =
+    gain_residual * estimate_error_covariance_ * gain_residual.transpose();
+  estimate_error_covariance_.noalias() += kalman_gain_subset *
+    measurement_covariance_subset *
+    kalman_gain_subset.transpose();
+
+  wrapStateAngles();
+
+  FB_DEBUG(
+    "Stacked innovation is:\n" <<
+      innovation_subset << "\nCorrected full state is:\n" <<
+      state_ << "\nCorrected full estimate error covariance is:\n" <<
+      estimate_error_covariance_ <<
+      "\n\n---------------------- /Ekf::correctBatch ----------------------\n");
+}
+
 void Ekf::predict(
   const rclcpp::Time & reference_time,
   const rclcpp::Duration & delta)
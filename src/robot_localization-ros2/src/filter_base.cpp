@@ -264,6 +264,57 @@ void FilterBase::processMeasurement(const Measurement & measurement)
       ") ------\n");
 }
 
+void FilterBase::correctBatch(const std::vector<MeasurementPtr> & measurements)
+{
+  for (const MeasurementPtr & measurement : measurements) {
+    correct(*measurement);
+  }
+}
+
+void FilterBase::processMeasurementBatch(
+  const std::vector<MeasurementPtr> & measurements)
+{
+  if (measurements.empty()) {
+    return;
+  }
+
+  if (measurements.size() == 1) {
+    processMeasurement(*measurements.front());
+    return;
+  }
+
+  // The first measurement initializes the filter, the others correct it
+  if (!initialized_) {
+    processMeasurement(*measurements.front());
+    processMeasurementBatch(
+      std::vector<MeasurementPtr>(measurements.begin() + 1, measurements.end()));
+    return;
+  }
+
+  const rclcpp::Time & measurement_time = measurements.front()->time_;
+
+  FB_DEBUG(
+    "------ FilterBase::processMeasurementBatch (" <<
+      measurements.size() << " measurements) ------\n");
+
+  rclcpp::Duration delta = measurement_time - last_measurement_time_;
+  if (delta > rclcpp::Duration(0, 0u)) {
+    validateDelta(delta);
+    predict(measurement_time, delta);
+
+    // Return this to the user
+    predicted_state_ = state_;
+  }
+
+  correctBatch(measurements);
+
+  if (delta >= rclcpp::Duration(0, 0u)) {
+    last_measurement_time_ = measurement_time;
+  }
+
+  FB_DEBUG("------ /FilterBase::processMeasurementBatch ------\n");
+}
+
 void FilterBase::setControl(
   const Eigen::VectorXd & control,
   const rclcpp::Time & control_time)
@@ -148,6 +148,10 @@ NavSatTransform::NavSatTransform(const rclcpp::NodeOptions & options)
     "toLL", std::bind(&NavSatTransform::toLLCallback, this, _1, _2));
   from_ll_srv_ = this->create_service<robot_localization::srv::FromLL>(
     "fromLL", std::bind(&NavSatTransform::fromLLCallback, this, _1, _2));
+  to_ll_array_srv_ = this->create_service<robot_localization::srv::ToLLArray>(
+    "toLLArray", std::bind(&NavSatTransform::toLLArrayCallback, this, _1, _2));
+  from_ll_array_srv_ = this->create_service<robot_localization::srv::FromLLArray>(
+    "fromLLArray", std::bind(&NavSatTransform::fromLLArrayCallback, this, _1, _2));
 
   std::vector<double> datum_vals;
   if (use_manual_datum_) {
@@ -432,12 +436,59 @@ bool NavSatTransform::fromLLCallback(
   const std::shared_ptr<robot_localization::srv::FromLL::Request> request,
   std::shared_ptr<robot_localization::srv::FromLL::Response> response)
 {
-  double altitude = request->ll_point.altitude;
-  double longitude = request->ll_point.longitude;
-  double latitude = request->ll_point.latitude;
+  if (!transform_good_) {
+    return false;
+  }
+
+  response->map_point = llToMap(
+    request->ll_point.latitude, request->ll_point.longitude,
+    request->ll_point.altitude);
+
+  return true;
+}
+
+bool NavSatTransform::toLLArrayCallback(
+  const std::shared_ptr<robot_localization::srv::ToLLArray::Request> request,
+  std::shared_ptr<robot_localization::srv::ToLLArray::Response> response)
+{
+  if (!transform_good_) {
+    return false;
+  }
+
+  response->ll_points.resize(request->map_points.size());
+  for (size_t i = 0; i < request->map_points.size(); ++i) {
+    const auto & map_point = request->map_points[i];
+    auto & ll_point = response->ll_points[i];
+    mapToLL(
+      tf2::Vector3(map_point.x, map_point.y, map_point.z),
+      ll_point.latitude, ll_point.longitude, ll_point.altitude);
+  }
 
-  tf2::Transform cartesian_pose;
+  return true;
+}
+
+bool NavSatTransform::fromLLArrayCallback(
+  const std::shared_ptr<robot_localization::srv::FromLLArray::Request> request,
+  std::shared_ptr<robot_localization::srv::FromLLArray::Response> response)
+{
+  if (!transform_good_) {
+    return false;
+  }
 
+  response->map_points.resize(request->ll_points.size());
+  for (size_t i = 0; i < request->ll_points.size(); ++i) {
+    const auto & ll_point = request->ll_points[i];
+    response->map_points[i] = llToMap(
+      ll_point.latitude, ll_point.longitude, ll_point.altitude);
+  }
+
+  return true;
+}
+
+geometry_msgs::msg::Point NavSatTransform::llToMap(
+  const double latitude, const double longitude,
+  const double altitude) const
+{
   double cartesian_x {};
   double cartesian_y {};
   double cartesian_z {};
@@ -451,26 +502,23 @@ bool NavSatTransform::fromLLCallback(
       cartesian_y,
       cartesian_z);
   } else {
-    std::string utm_zone_tmp;
-    navsat_conversions::LLtoUTM(
+    // project into the zone of the transform, even if the point is in a neighboring zone
+    utm_converter_.LLtoUTM(
       latitude,
       longitude,
       cartesian_y,
-      cartesian_x,
-      utm_zone_tmp);
+      cartesian_x);
   }
 
-  cartesian_pose.setOrigin(tf2::Vector3(cartesian_x, cartesian_y, altitude));
-
-  nav_msgs::msg::Odometry gps_odom;
+  // same as cartesianToMap(), without filling in an odometry message
+  const tf2::Vector3 map_point =
+    cartesian_world_transform_ * tf2::Vector3(cartesian_x, cartesian_y, altitude);
 
-  if (!transform_good_) {
-    return false;
-  }
-
-  response->map_point = cartesianToMap(cartesian_pose).pose.pose.position;
-
-  return true;
+  geometry_msgs::msg::Point point;
+  point.x = map_point.getX();
+  point.y = map_point.getY();
+  point.z = (zero_altitude_ ? 0.0 : map_point.getZ());
+  return point;
 }
 
 nav_msgs::msg::Odometry NavSatTransform::cartesianToMap(
@@ -512,13 +560,22 @@ void NavSatTransform::mapToLL(
   odom_as_cartesian.setRotation(tf2::Quaternion::getIdentity());
 
   // Now convert the data back to lat/long and place into the message
-  navsat_conversions::UTMtoLL(
-    odom_as_cartesian.getOrigin().getY(),
-    odom_as_cartesian.getOrigin().getX(),
-    utm_zone_,
-    latitude,
-    longitude);
-  altitude = odom_as_cartesian.getOrigin().getZ();
+  if (use_local_cartesian_) {
+    gps_local_cartesian_.Reverse(
+      odom_as_cartesian.getOrigin().getX(),
+      odom_as_cartesian.getOrigin().getY(),
+      odom_as_cartesian.getOrigin().getZ(),
+      latitude,
+      longitude,
+      altitude);
+  } else {
+    utm_converter_.UTMtoLL(
+      odom_as_cartesian.getOrigin().getY(),
+      odom_as_cartesian.getOrigin().getX(),
+      latitude,
+      longitude);
+    altitude = odom_as_cartesian.getOrigin().getZ();
+  }
 }
 
 void NavSatTransform::getRobotOriginCartesianPose(
@@ -869,6 +926,7 @@ void NavSatTransform::setTransformGps(
       utm_zone_,
       utm_meridian_convergence_);
     utm_meridian_convergence_ *= navsat_conversions::RADIANS_PER_DEGREE;
+    utm_converter_.setZone(utm_zone_);
   }
 
   RCLCPP_INFO(
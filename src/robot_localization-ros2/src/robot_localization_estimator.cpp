@@ -78,14 +78,14 @@ void RobotLocalizationEstimator::setState(const EstimatorState & state)
   if (state_buffer_.empty() || state.time_stamp >
     state_buffer_.back().time_stamp)
   {
-    state_buffer_.push_back(state);
+    state_buffer_.push_back(PackedEstimatorState(state));
     // If it is older, put it in the right position
   } else {
-    for (boost::circular_buffer<EstimatorState>::iterator it =
+    for (boost::circular_buffer<PackedEstimatorState>::iterator it =
       state_buffer_.begin(); it != state_buffer_.end(); ++it)
     {
       if (state.time_stamp < it->time_stamp) {
-        state_buffer_.insert(it, state);
+        state_buffer_.insert(it, PackedEstimatorState(state));
         return;
       }
     }
@@ -101,16 +101,14 @@ EstimatorResults::EstimatorResult RobotLocalizationEstimator::getState(
     return EstimatorResults::EmptyBuffer;
   }
 
-  // Set state to the most recent one for now
-  state = state_buffer_.back();
-
-  // Go through buffer from new to old
-  EstimatorState last_state_before_time = state_buffer_.front();
-  EstimatorState next_state_after_time = state_buffer_.back();
+  // Go through buffer from new to old, only the record we end up using is
+  // expanded
+  const PackedEstimatorState * last_state_before_time = &state_buffer_.front();
+  const PackedEstimatorState * next_state_after_time = &state_buffer_.back();
   bool previous_state_found = false;
   bool next_state_found = false;
 
-  for (boost::circular_buffer<EstimatorState>::const_reverse_iterator it =
+  for (boost::circular_buffer<PackedEstimatorState>::const_reverse_iterator it =
     state_buffer_.rbegin(); it != state_buffer_.rend(); ++it)
   {
     /* If the time stamp of the current state from the buffer is
@@ -119,31 +117,32 @@ EstimatorResults::EstimatorResult RobotLocalizationEstimator::getState(
      * next one after, and go on to find the last one before.
      */
     if (it->time_stamp == time) {
-      state = *it;
+      it->unpack(state);
       return EstimatorResults::Exact;
     } else if (it->time_stamp <= time) {
-      last_state_before_time = *it;
+      last_state_before_time = &(*it);
       previous_state_found = true;
       break;
     } else {
-      next_state_after_time = *it;
+      next_state_after_time = &(*it);
       next_state_found = true;
     }
   }
 
   // If we found a previous state and a next state, we can do interpolation
   if (previous_state_found && next_state_found) {
-    interpolate(last_state_before_time, next_state_after_time, time, state);
+    interpolate(*last_state_before_time, *next_state_after_time, time, state);
     return EstimatorResults::Interpolation;
     // If only a previous state is found, we can do extrapolation into the future
   } else if (previous_state_found) {
-    extrapolate(last_state_before_time, time, state);
+    extrapolate(*last_state_before_time, time, state);
     return EstimatorResults::ExtrapolationIntoFuture;
     // If only a next state is found, we'll have to extrapolate into the past.
   } else if (next_state_found) {
-    extrapolate(next_state_after_time, time, state);
+    extrapolate(*next_state_after_time, time, state);
     return EstimatorResults::ExtrapolationIntoPast;
   } else {
+    state_buffer_.back().unpack(state);
     return EstimatorResults::Failed;
   }
 }
@@ -169,13 +168,14 @@ unsigned int RobotLocalizationEstimator::getSize() const
 }
 
 void RobotLocalizationEstimator::extrapolate(
-  const EstimatorState & boundary_state,
+  const PackedEstimatorState & boundary_state,
   const double requested_time,
   EstimatorState & state_at_req_time) const
 {
-  // Set up the filter with the boundary state
-  filter_->setState(boundary_state.state);
-  filter_->setEstimateErrorCovariance(boundary_state.covariance);
+  // Set up the filter with the boundary state, expanding the record
+  boundary_state.unpack(state_at_req_time);
+  filter_->setState(state_at_req_time.state);
+  filter_->setEstimateErrorCovariance(state_at_req_time.covariance);
 
   // Calculate how much time we need to extrapolate into the future
   double delta = requested_time - boundary_state.time_stamp;
@@ -193,8 +193,8 @@ void RobotLocalizationEstimator::extrapolate(
 }
 
 void RobotLocalizationEstimator::interpolate(
-  const EstimatorState & given_state_1,
-  const EstimatorState & /*given_state_2*/,
+  const PackedEstimatorState & given_state_1,
+  const PackedEstimatorState & /*given_state_2*/,
   const double requested_time,
   EstimatorState & state_at_req_time) const
 {
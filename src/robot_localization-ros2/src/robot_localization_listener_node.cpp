@@ -29,13 +29,17 @@
  * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#include <cerrno>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Eigen/Dense"
 #include "rclcpp/rclcpp.hpp"
 #include "robot_localization/ros_robot_localization_listener.hpp"
+#include "robot_localization/shared_state_buffer.hpp"
 #include "robot_localization/srv/get_state.hpp"
 
 namespace robot_localization
@@ -52,6 +56,10 @@ public:
       std::bind(
         &RobotLocalizationListenerNode::getStateCallback, this,
         std::placeholders::_1, std::placeholders::_2));
+
+    // If set, the state buffer is also published into this POSIX shared
+    // memory segment, for SharedStateClient instances on the same host
+    shared_memory_name_ = this->declare_parameter<std::string>("shared_memory_name", "");
   }
 
   std::string getService()
@@ -63,10 +71,61 @@ public:
     std::shared_ptr<robot_localization::RosRobotLocalizationListener> rll)
   {
     rll_ = rll;
+
+    if (shared_memory_name_.empty()) {
+      return;
+    }
+
+    // The listener has declared these parameters, unless the filter type is invalid
+    const FilterTypes::FilterType filter_type =
+      filterTypeFromString(this->get_parameter("filter_type").as_string());
+    if (filter_type == FilterTypes::NotDefined) {
+      return;
+    }
+
+    const std::vector<double> process_noise_covar_config =
+      this->get_parameter("process_noise_covariance").as_double_array();
+    Eigen::MatrixXd process_noise_covariance(STATE_SIZE, STATE_SIZE);
+    process_noise_covariance.setZero();
+    if (process_noise_covar_config.size() == STATE_SIZE * STATE_SIZE) {
+      process_noise_covariance = Eigen::Map<const Eigen::Matrix<double, STATE_SIZE, STATE_SIZE,
+          Eigen::RowMajor>>(process_noise_covar_config.data());
+    }
+
+    if (!shared_state_writer_.initialize(
+        shared_memory_name_,
+        this->get_parameter("buffer_size").as_int(),
+        filter_type,
+        process_noise_covariance,
+        this->get_parameter("filter_args").as_double_array()))
+    {
+      RCLCPP_ERROR(
+        this->get_logger(),
+        "Robot Localization Listener Node: Could not create shared memory "
+        "segment %s: %s", shared_memory_name_.c_str(), strerror(errno));
+      return;
+    }
+
+    rll_->setStateCallback(
+      [this](const EstimatorState & state) {
+        if (!frame_ids_shared_) {
+          shared_state_writer_.setFrameIds(rll_->getWorldFrameId(), rll_->getBaseFrameId());
+          frame_ids_shared_ = true;
+        }
+        shared_state_writer_.setState(state);
+      });
+
+    RCLCPP_INFO(
+      this->get_logger(),
+      "Robot Localization Listener Node: Publishing states to shared memory "
+      "segment %s", shared_memory_name_.c_str());
   }
 
 private:
   std::shared_ptr<RosRobotLocalizationListener> rll_;
+  std::string shared_memory_name_;
+  SharedStateWriter shared_state_writer_;
+  bool frame_ids_shared_ = false;
   rclcpp::Service<robot_localization::srv::GetState>::SharedPtr service_;
 
   bool getStateCallback(
@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <ctime>
 #include <iomanip>
 #include <functional>
 #include <limits>
@@ -56,6 +57,7 @@
 #include "geometry_msgs/msg/twist.hpp"
 #include "geometry_msgs/msg/twist_stamped.hpp"
 #include "nav_msgs/msg/odometry.hpp"
+#include "neo_tracetools/tracetools.h"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "robot_localization/ekf.hpp"
@@ -81,6 +83,19 @@ namespace robot_localization
 {
 using namespace std::chrono_literals;
 
+namespace
+{
+
+//! @brief CPU time used by the calling thread, in seconds
+double threadCpuTime()
+{
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return static_cast<double>(time.tv_sec) + 1e-9 * static_cast<double>(time.tv_nsec);
+}
+
+}  // namespace
+
 template<typename T>
 RosFilter<T>::RosFilter(const rclcpp::NodeOptions & options)
 : Node(options.arguments()[0], options),
@@ -89,6 +104,7 @@ RosFilter<T>::RosFilter(const rclcpp::NodeOptions & options)
   publish_transform_(true),
   reset_on_time_jump_(false),
   smooth_lagged_data_(false),
+  batch_simultaneous_measurements_(false),
   toggled_on_(true),
   two_d_mode_(false),
   use_control_(false),
@@ -100,6 +116,8 @@ RosFilter<T>::RosFilter(const rclcpp::NodeOptions & options)
   frequency_(30.0),
   gravitational_acceleration_(9.80665),
   history_length_(0ns),
+  reorder_delay_(0ns),
+  latest_enqueued_time_(0, 0, RCL_ROS_TIME),
   sensor_timeout_(0ns),
   latest_control_(),
   process_noise_covariance_(STATE_SIZE, STATE_SIZE),
@@ -112,7 +130,7 @@ RosFilter<T>::RosFilter(const rclcpp::NodeOptions & options)
   tf_timeout_(0ns),
   tf_time_offset_(0ns)
 {
-  tf_buffer_ = std::make_unique<tf2_ros::Buffer>(this->get_clock());
+  tf_buffer_ = std::make_shared<tf2_ros::Buffer>(this->get_clock());
   tf_listener_ = std::make_unique<tf2_ros::TransformListener>(*tf_buffer_);
 
   state_variable_names_.push_back("X");
@@ -141,6 +159,7 @@ RosFilter<T>::~RosFilter()
   control_sub_.reset();
   tf_listener_.reset();
   tf_buffer_.reset();
+  shared_inputs_.reset();
   diagnostic_updater_.reset();
   world_transform_broadcaster_.reset();
   set_pose_service_.reset();
@@ -168,9 +187,14 @@ void RosFilter<T>::reset()
   last_diag_time_ = rclcpp::Time(0, 0, RCL_ROS_TIME);
   latest_control_time_ = rclcpp::Time(0, 0, RCL_ROS_TIME);
   last_published_stamp_ = rclcpp::Time(0, 0, RCL_ROS_TIME);
+  latest_enqueued_time_ = rclcpp::Time(0, 0, RCL_ROS_TIME);
 
   // clear tf buffer to avoid TF_OLD_DATA errors
-  tf_buffer_->clear();
+  if (shared_inputs_) {
+    shared_inputs_->clearTransforms();
+  } else {
+    tf_buffer_->clear();
+  }
 
   // clear last message timestamp, so older messages will be accepted
   last_message_times_.clear();
@@ -372,6 +396,17 @@ void RosFilter<T>::enqueueMeasurement(
   meas->latest_control_ = latest_control_;
   meas->latest_control_time_ = latest_control_time_;
   measurement_queue_.push(meas);
+
+  // Compare the stamps only, sensor messages and tests may use different clocks
+  if (time.nanoseconds() < latest_enqueued_time_.nanoseconds()) {
+    reorder_statistics_.late_measurements_++;
+  } else {
+    latest_enqueued_time_ = time;
+  }
+
+  NEO_TRACEPOINT(
+    message, "robot_localization", "enqueue", topic_name.c_str(),
+    time.nanoseconds());
 }
 
 template<typename T>
@@ -636,6 +671,14 @@ void RosFilter<T>::integrateMeasurements(const rclcpp::Time & current_time)
       "\n" <<
       measurement_queue_.size() << " measurements in queue.\n");
 
+  NEO_TRACE_SCOPE("robot_localization", "integrateMeasurements", current_time.nanoseconds());
+
+  const double cpu_start_time = threadCpuTime();
+
+  // Measurements younger than the reorder window wait in the (sorted) queue,
+  // so that slightly late ones are sorted in without reverting the filter
+  const rclcpp::Time process_time = current_time - reorder_delay_;
+
   bool predict_to_current_time = predict_to_current_time_;
 
   // If we have any measurements in the queue, process them
@@ -658,6 +701,7 @@ void RosFilter<T>::integrateMeasurements(const rclcpp::Time & current_time)
           " seconds in the past. Reverting filter state and "
           "measurement queue...");
 
+      reorder_statistics_.reverts_++;
       int original_count = static_cast<int>(measurement_queue_.size());
       const rclcpp::Time first_measurement_time = first_measurement->time_;
       const std::string first_measurement_topic =
@@ -679,20 +723,33 @@ void RosFilter<T>::integrateMeasurements(const rclcpp::Time & current_time)
 
       restored_measurement_count =
         static_cast<int>(measurement_queue_.size()) - original_count;
+      reorder_statistics_.reintegrated_measurements_ += restored_measurement_count;
     }
 
+    std::vector<MeasurementPtr> batch;
     while (!measurement_queue_.empty() && rclcpp::ok()) {
       MeasurementPtr measurement = measurement_queue_.top();
 
-      // If we've reached a measurement that has a time later than now, it
-      // should wait until a future iteration. Since measurements are stored in
-      // a priority queue, all remaining measurements will be in the future.
-      if (current_time < measurement->time_) {
+      // If we've reached a measurement that has a time later than now (minus
+      // the reorder delay), it should wait until a future iteration. Since
+      // measurements are stored in a priority queue, all remaining
+      // measurements will be in the future.
+      if (process_time < measurement->time_) {
         break;
       }
 
       measurement_queue_.pop();
 
+      // Collect all other measurements with the same time stamp, they are
+      // fused in a single correction
+      batch.assign(1, measurement);
+      while (batch_simultaneous_measurements_ && !measurement_queue_.empty() &&
+        measurement_queue_.top()->time_ == measurement->time_)
+      {
+        batch.push_back(measurement_queue_.top());
+        measurement_queue_.pop();
+      }
+
       // When we receive control messages, we call this directly in the control
       // callback. However, we also associate a control with each sensor message
       // so that we can support lagged smoothing. As we cannot guarantee that
@@ -706,17 +763,27 @@ void RosFilter<T>::integrateMeasurements(const rclcpp::Time & current_time)
         filter_.setControl(
           measurement->latest_control_,
           measurement->latest_control_time_);
-        restored_measurement_count--;
+        restored_measurement_count -= static_cast<int>(batch.size());
+      }
+
+      for (size_t i = 0; i < batch.size(); ++i) {
+        NEO_TRACEPOINT(
+          message, "robot_localization", "integrate",
+          batch[i]->topic_name_.c_str(), batch[i]->time_.nanoseconds());
       }
 
       // This will call predict and, if necessary, correct
-      filter_.processMeasurement(*(measurement.get()));
+      if (batch.size() == 1) {
+        filter_.processMeasurement(*(measurement.get()));
+      } else {
+        filter_.processMeasurementBatch(batch);
+      }
 
       // Store old states and measurements if we're smoothing
       if (smooth_lagged_data_) {
         // Invariant still holds: measurementHistoryDeque_.back().time_ <
         // measurement_queue_.top().time_
-        measurement_history_.push_back(measurement);
+        measurement_history_.insert(measurement_history_.end(), batch.begin(), batch.end());
 
         // We should only save the filter state once per unique timstamp
         if (measurement_queue_.empty() ||
@@ -732,7 +799,7 @@ void RosFilter<T>::integrateMeasurements(const rclcpp::Time & current_time)
     // we still need to continue to estimate our state. Therefore, we
     // should project the state forward here.
     rclcpp::Duration last_update_delta =
-      current_time - filter_.getLastMeasurementTime();
+      process_time - filter_.getLastMeasurementTime();
 
     // If we get a large delta, then continuously predict until
     if (last_update_delta >= filter_.getSensorTimeout()) {
@@ -751,10 +818,10 @@ void RosFilter<T>::integrateMeasurements(const rclcpp::Time & current_time)
 
   if (filter_.getInitializedStatus() && predict_to_current_time) {
     rclcpp::Duration last_update_delta =
-      current_time - filter_.getLastMeasurementTime();
+      process_time - filter_.getLastMeasurementTime();
 
     filter_.validateDelta(last_update_delta);
-    filter_.predict(current_time, last_update_delta);
+    filter_.predict(process_time, last_update_delta);
 
     // Update the last measurement time and last update time
     filter_.setLastMeasurementTime(
@@ -762,6 +829,9 @@ void RosFilter<T>::integrateMeasurements(const rclcpp::Time & current_time)
       last_update_delta);
   }
 
+  reorder_statistics_.integrations_++;
+  reorder_statistics_.integration_cpu_time_ += threadCpuTime() - cpu_start_time;
+
   RF_DEBUG("\n----- /RosFilter<T>::integrateMeasurements ------\n");
 }
 
@@ -939,10 +1009,18 @@ void RosFilter<T>::loadParams()
   // Determine if we're in 2D mode
   two_d_mode_ = this->declare_parameter("two_d_mode", false);
 
+  // Whether to fuse measurements with identical time stamps at once
+  batch_simultaneous_measurements_ =
+    this->declare_parameter("batch_simultaneous_measurements", false);
+
   // Smoothing window size
   smooth_lagged_data_ = this->declare_parameter("smooth_lagged_data", false);
   double history_length_double = this->declare_parameter("history_length", 0.0);
 
+  // Store the covariance of the state history in single precision
+  filter_state_history_.setFloatCovariance(
+    this->declare_parameter("history_float_covariance", false));
+
   if (!smooth_lagged_data_ && std::abs(history_length_double) > 0) {
     RCLCPP_ERROR_STREAM(
       get_logger(),
@@ -959,6 +1037,25 @@ void RosFilter<T>::loadParams()
 
   history_length_ = rclcpp::Duration::from_seconds(std::abs(history_length_double));
 
+  // Delay for sorting in measurements which arrive out of order
+  double reorder_delay_double = this->declare_parameter("reorder_delay", 0.0);
+
+  if (reorder_delay_double < 0) {
+    RCLCPP_ERROR_STREAM(
+      get_logger(),
+      "Negative reorder delay of " << reorder_delay_double << " specified. Absolute value "
+        "will be assumed.");
+  }
+
+  if (smooth_lagged_data_ && std::abs(reorder_delay_double) > history_length_.seconds()) {
+    RCLCPP_WARN_STREAM(
+      get_logger(),
+      "Reorder delay of " << std::abs(reorder_delay_double) << " is longer than the history "
+        "length of " << history_length_.seconds() << ".");
+  }
+
+  reorder_delay_ = rclcpp::Duration::from_seconds(std::abs(reorder_delay_double));
+
   // Whether we reset filter on jump back in time
   reset_on_time_jump_ = this->declare_parameter("reset_on_time_jump", false);
 
@@ -1110,6 +1207,7 @@ void RosFilter<T>::loadParams()
       "\ntwo_d_mode is " << (two_d_mode_ ? "true" : "false") <<
       "\nsmooth_lagged_data is " << (smooth_lagged_data_ ? "true" : "false") <<
       "\nhistory_length is " << filter_utilities::toSec(history_length_) <<
+      "\nreorder_delay is " << filter_utilities::toSec(reorder_delay_) <<
       "\nuse_control is " << use_control_ <<
       "\ncontrol_config is " << control_update_vector <<
       "\ncontrol_timeout is " << control_timeout <<
@@ -1259,7 +1357,7 @@ void RosFilter<T>::loadParams()
 
         auto custom_qos = rclcpp::SensorDataQoS(rclcpp::KeepLast(queue_size));
         topic_subs_.push_back(
-          this->create_subscription<nav_msgs::msg::Odometry>(
+          subscribeSensor<nav_msgs::msg::Odometry>(
             odom_topic, custom_qos,
             odom_callback));
       } else {
@@ -1397,7 +1495,7 @@ void RosFilter<T>::loadParams()
         auto custom_qos = rclcpp::SensorDataQoS(rclcpp::KeepLast(queue_size));
 
         topic_subs_.push_back(
-          this->create_subscription<
+          subscribeSensor<
             geometry_msgs::msg::PoseWithCovarianceStamped>(
             pose_topic, custom_qos, pose_callback));
 
@@ -1492,7 +1590,7 @@ void RosFilter<T>::loadParams()
 
         auto custom_qos = rclcpp::SensorDataQoS(rclcpp::KeepLast(queue_size));
         topic_subs_.push_back(
-          this->create_subscription<
+          subscribeSensor<
             geometry_msgs::msg::TwistWithCovarianceStamped>(
             twist_topic, custom_qos, twist_callback));
 
@@ -1701,7 +1799,7 @@ void RosFilter<T>::loadParams()
 
         auto custom_qos = rclcpp::SensorDataQoS(rclcpp::KeepLast(queue_size));
         topic_subs_.push_back(
-          this->create_subscription<sensor_msgs::msg::Imu>(
+          subscribeSensor<sensor_msgs::msg::Imu>(
             imu_topic, custom_qos, imu_callback));
       } else {
         RCLCPP_ERROR_STREAM(
@@ -2091,6 +2189,19 @@ void RosFilter<T>::initialize()
   this->get_node_timers_interface()->add_timer(timer_, nullptr);
 }
 
+template<typename T>
+void RosFilter<T>::setSharedSensorInputs(
+  std::shared_ptr<SharedSensorInputs> inputs)
+{
+  shared_inputs_ = inputs;
+
+  // Drop our own listener; the shared buffer is fed by a single one
+  if (shared_inputs_) {
+    tf_listener_.reset();
+    tf_buffer_ = shared_inputs_->getTfBuffer();
+  }
+}
+
 template<typename T>
 void RosFilter<T>::periodicUpdate()
 {
@@ -2120,6 +2231,23 @@ void RosFilter<T>::periodicUpdate()
     }
   }
 
+  // With a reorder window the filter lags behind by reorder_delay_. Publish
+  // its prediction to the current time and restore it afterwards, so the
+  // next measurements are still in sequence.
+  const bool publish_prediction = reorder_delay_ > 0ns &&
+    filter_.getInitializedStatus() && filter_.getLastMeasurementTime() < cur_time;
+
+  if (publish_prediction) {
+    const double cpu_start_time = threadCpuTime();
+    committed_filter_ = filter_;
+
+    rclcpp::Duration last_update_delta = cur_time - filter_.getLastMeasurementTime();
+    filter_.validateDelta(last_update_delta);
+    filter_.predict(cur_time, last_update_delta);
+    filter_.setLastMeasurementTime(cur_time);
+    reorder_statistics_.integration_cpu_time_ += threadCpuTime() - cpu_start_time;
+  }
+
   // Get latest state and publish it
   auto filtered_position = std::make_unique<nav_msgs::msg::Odometry>();
 
@@ -2237,6 +2365,9 @@ void RosFilter<T>::periodicUpdate()
 
     // Fire off the position and the transform
     if (!corrected_data) {
+      NEO_TRACEPOINT(
+        message, "robot_localization", "publish", "odometry/filtered",
+        neo_tracetools::stamp_ns(filtered_position->header.stamp));
       position_pub_->publish(std::move(filtered_position));
     }
 
@@ -2253,6 +2384,10 @@ void RosFilter<T>::periodicUpdate()
     accel_pub_->publish(std::move(filtered_acceleration));
   }
 
+  if (publish_prediction) {
+    filter_ = committed_filter_;
+  }
+
   /* Diagnostics can behave strangely when playing back from bag
    * files and using simulated time, so we have to check for
    * time suddenly moving backwards as well as the standard
@@ -2542,6 +2677,21 @@ void RosFilter<T>::aggregateDiagnostics(
   }
   dynamic_diagnostics_.clear();
 
+  // Out-of-sequence measurements since the last report, for tuning reorder_delay
+  const ReorderStatistics & current = reorder_statistics_;
+  const ReorderStatistics & reported = reported_reorder_statistics_;
+  const uint64_t integrations = current.integrations_ - reported.integrations_;
+  wrapper.add("Reorder delay (s)", filter_utilities::toSec(reorder_delay_));
+  wrapper.add("Late measurements", current.late_measurements_ - reported.late_measurements_);
+  wrapper.add("Reverts", current.reverts_ - reported.reverts_);
+  wrapper.add(
+    "Reintegrated measurements",
+    current.reintegrated_measurements_ - reported.reintegrated_measurements_);
+  wrapper.add(
+    "Integration CPU time per update (ms)", integrations == 0 ? 0.0 :
+    1e3 * (current.integration_cpu_time_ - reported.integration_cpu_time_) / integrations);
+  reported_reorder_statistics_ = reorder_statistics_;
+
   // Reset the warning level for the dynamic diagnostic messages
   dynamic_diag_error_level_ = diagnostic_msgs::msg::DiagnosticStatus::OK;
 }
@@ -2681,8 +2831,8 @@ bool RosFilter<T>::prepareAcceleration(
   // It's unlikely that we'll get a velocity measurement in another frame, but
   // we have to handle the situation.
   tf2::Transform target_frame_trans;
-  bool can_transform = ros_filter_utilities::lookupTransformSafe(
-    tf_buffer_.get(), target_frame, msg_frame, msg->header.stamp, tf_timeout_,
+  bool can_transform = lookupSensorTransform(
+    target_frame, msg_frame, msg->header.stamp, tf_timeout_,
     target_frame_trans);
 
   if (can_transform) {
@@ -2911,8 +3061,8 @@ bool RosFilter<T>::preparePose(
 
   // 2. Get the target frame transformation
   tf2::Transform target_frame_trans;
-  bool can_transform = ros_filter_utilities::lookupTransformSafe(
-    tf_buffer_.get(), final_target_frame, pose_tmp.frame_id_,
+  bool can_transform = lookupSensorTransform(
+    final_target_frame, pose_tmp.frame_id_,
     rclcpp::Time(tf2::timeToSec(pose_tmp.stamp_)), tf_timeout_,
     target_frame_trans);
 
@@ -2921,8 +3071,8 @@ bool RosFilter<T>::preparePose(
   tf2::Transform source_frame_trans;
   bool can_src_transform = false;
   if (source_frame != base_link_frame_id_) {
-    can_src_transform = ros_filter_utilities::lookupTransformSafe(
-      tf_buffer_.get(), source_frame, base_link_frame_id_,
+    can_src_transform = lookupSensorTransform(
+      source_frame, base_link_frame_id_,
       rclcpp::Time(tf2::timeToSec(pose_tmp.stamp_)), tf_timeout_,
       source_frame_trans);
   }
@@ -3344,8 +3494,8 @@ bool RosFilter<T>::prepareTwist(
 
   // 4. We need to transform this into the target frame (probably base_link)
   tf2::Transform target_frame_trans;
-  bool can_transform = ros_filter_utilities::lookupTransformSafe(
-    tf_buffer_.get(), target_frame, msg_frame, msg->header.stamp, tf_timeout_,
+  bool can_transform = lookupSensorTransform(
+    target_frame, msg_frame, msg->header.stamp, tf_timeout_,
     target_frame_trans);
 
   if (can_transform) {
@@ -3438,18 +3588,11 @@ bool RosFilter<T>::prepareTwist(
 template<typename T>
 void RosFilter<T>::saveFilterState(T & filter)
 {
-  FilterStatePtr state = FilterStatePtr(new FilterState());
-  state->state_ = Eigen::VectorXd(filter.getState());
-  state->estimate_error_covariance_ =
-    Eigen::MatrixXd(filter.getEstimateErrorCovariance());
-  state->last_measurement_time_ = filter.getLastMeasurementTime();
-  state->latest_control_ = Eigen::VectorXd(filter.getControl());
-  state->latest_control_time_ = filter.getControlTime();
-  filter_state_history_.push_back(state);
+  filter_state_history_.push(filter);
   RF_DEBUG(
     "Saved state with timestamp " <<
       std::setprecision(20) <<
-      filter_utilities::toSec(state->last_measurement_time_) <<
+      filter_utilities::toSec(filter_state_history_.backTime()) <<
       " to history. " << filter_state_history_.size() <<
       " measurements are in the queue.\n");
 }
@@ -3462,57 +3605,43 @@ bool RosFilter<T>::revertTo(const rclcpp::Time & time)
     "\nRequested time was " << std::setprecision(20) <<
       filter_utilities::toSec(time) << "\n")
 
-  // size_t history_size = filter_state_history_.size();
-
   // Walk back through the queue until we reach a filter state whose time stamp
   // is less than or equal to the requested time. Since every saved state after
   // that time will be overwritten/corrected, we can pop from the queue. If the
   // history is insufficiently short, we just take the oldest state we have.
-  FilterStatePtr last_history_state;
-  while (!filter_state_history_.empty() &&
-    filter_state_history_.back()->last_measurement_time_ > time)
+  while (filter_state_history_.size() > 1 &&
+    filter_state_history_.backTime() > time)
   {
-    last_history_state = filter_state_history_.back();
-    filter_state_history_.pop_back();
+    filter_state_history_.popBack();
   }
 
-  // If the state history is not empty at this point, it means that our history
-  // was large enough, and we should revert to the state at the back of the
-  // history deque.
-  bool ret_val = false;
-  if (!filter_state_history_.empty()) {
-    ret_val = true;
-    last_history_state = filter_state_history_.back();
-  } else {
+  // If the state at the back of the history is not newer than the requested
+  // time, our history was large enough and we revert to it. Otherwise it is
+  // the oldest state we have, which we revert to and drop as well.
+  const bool have_state = !filter_state_history_.empty();
+  const bool ret_val = have_state && filter_state_history_.backTime() <= time;
+  if (have_state && !ret_val) {
     RF_DEBUG(
       "Insufficient history to revert to time " <<
         filter_utilities::toSec(time) << "\n");
-
-    if (last_history_state) {
-      RF_DEBUG(
-        "Will revert to oldest state at " <<
-          filter_utilities::toSec(last_history_state->latest_control_time_) <<
-          ".\n");
-
-      // ROS_WARN_STREAM_DELAYED_THROTTLE(history_length_, "Could not revert "
-      //   "to state with time " << std::setprecision(20) << time <<
-      //   ". Instead reverted to state with time " <<
-      //   lastHistoryState->lastMeasurementTime_ << ". History size was " <<
-      //   history_size);
-    }
+    RF_DEBUG(
+      "Will revert to oldest state at " <<
+        filter_utilities::toSec(filter_state_history_.backTime()) <<
+        ".\n");
   }
 
   // If we have a valid reversion state, revert
-  if (last_history_state) {
-    // Reset filter to the latest state from the queue.
-    const FilterStatePtr & state = last_history_state;
-    filter_.setState(state->state_);
-    filter_.setEstimateErrorCovariance(state->estimate_error_covariance_);
-    filter_.setLastMeasurementTime(state->last_measurement_time_);
+  if (have_state) {
+    // Reset filter to the latest state from the queue, expanding the record
+    const rclcpp::Time state_time = filter_state_history_.backTime();
+    filter_state_history_.restoreBack(filter_);
+    if (!ret_val) {
+      filter_state_history_.popBack();
+    }
 
     RF_DEBUG(
       "Reverted to state with time " <<
-        filter_utilities::toSec(state->last_measurement_time_) << "\n");
+        filter_utilities::toSec(state_time) << "\n");
 
     // Repeat for measurements, but push every measurement onto the measurement
     // queue as we go
@@ -3521,7 +3650,7 @@ bool RosFilter<T>::revertTo(const rclcpp::Time & time)
       measurement_history_.back()->time_ > time)
     {
       // Don't need to restore measurements that predate our earliest state time
-      if (state->last_measurement_time_ <= measurement_history_.back()->time_) {
+      if (state_time <= measurement_history_.back()->time_) {
         measurement_queue_.push(measurement_history_.back());
         restored_measurements++;
       }
@@ -3589,9 +3718,9 @@ void RosFilter<T>::clearExpiredHistory(const rclcpp::Time cutoff_time)
   }
 
   while (!filter_state_history_.empty() &&
-    filter_state_history_.front()->last_measurement_time_ < cutoff_time)
+    filter_state_history_.frontTime() < cutoff_time)
   {
-    filter_state_history_.pop_front();
+    filter_state_history_.popFront();
     popped_states++;
   }
 
@@ -3611,6 +3740,22 @@ void RosFilter<T>::clearMeasurementQueue()
     measurement_queue_.pop();
   }
 }
+
+template<typename T>
+bool RosFilter<T>::lookupSensorTransform(
+  const std::string & target_frame, const std::string & source_frame,
+  const rclcpp::Time & time, const rclcpp::Duration & timeout,
+  tf2::Transform & target_frame_trans)
+{
+  if (shared_inputs_) {
+    return shared_inputs_->lookupTransform(
+      target_frame, source_frame, time, timeout, target_frame_trans);
+  }
+
+  return ros_filter_utilities::lookupTransformSafe(
+    tf_buffer_.get(), target_frame, source_frame, time, timeout,
+    target_frame_trans);
+}
 }  // namespace robot_localization
 
 template class robot_localization::RosFilter<robot_localization::Ekf>;
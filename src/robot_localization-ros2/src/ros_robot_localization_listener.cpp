@@ -261,6 +261,10 @@ void RosRobotLocalizationListener::odomAndAccelCallback(
 
   // Add the state to the buffer, so that we can later interpolate between this and earlier states
   estimator_->setState(state);
+
+  if (state_callback_) {
+    state_callback_(state);
+  }
 }
 
 bool findAncestorRecursiveYAML(
@@ -555,4 +559,10 @@ const std::string & RosRobotLocalizationListener::getWorldFrameId() const
   return world_frame_id_;
 }
 
+void RosRobotLocalizationListener::setStateCallback(
+  std::function<void(const EstimatorState &)> callback)
+{
+  state_callback_ = callback;
+}
+
 }  // namespace robot_localization
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2014, 2015, 2016 Charles River Analytics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "robot_localization/shared_sensor_inputs.hpp"
+
+#include <memory>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "robot_localization/ros_filter_utilities.hpp"
+#include "tf2/LinearMath/Transform.h"
+#include "tf2_ros/buffer.h"
+#include "tf2_ros/transform_listener.h"
+
+namespace robot_localization
+{
+
+SharedSensorInputs::SharedSensorInputs(const rclcpp::Node::SharedPtr & owner)
+: owner_(owner),
+  dispatching_(false),
+  transform_cache_hits_(0),
+  transform_cache_misses_(0)
+{
+  tf_buffer_ = std::make_shared<tf2_ros::Buffer>(owner->get_clock());
+  tf_listener_ = std::make_unique<tf2_ros::TransformListener>(*tf_buffer_);
+}
+
+SharedSensorInputs::~SharedSensorInputs()
+{
+  fanouts_.clear();
+  tf_listener_.reset();
+  tf_buffer_.reset();
+}
+
+bool SharedSensorInputs::lookupTransform(
+  const std::string & target_frame, const std::string & source_frame,
+  const rclcpp::Time & time, const rclcpp::Duration & timeout,
+  tf2::Transform & target_frame_trans)
+{
+  const int64_t stamp = time.nanoseconds();
+
+  if (dispatching_) {
+    for (const auto & cached : transform_cache_) {
+      if (cached.stamp == stamp && cached.target_frame == target_frame &&
+        cached.source_frame == source_frame)
+      {
+        target_frame_trans = cached.transform;
+        ++transform_cache_hits_;
+        return true;
+      }
+    }
+  }
+
+  ++transform_cache_misses_;
+  const bool can_transform = ros_filter_utilities::lookupTransformSafe(
+    tf_buffer_.get(), target_frame, source_frame, time, timeout,
+    target_frame_trans);
+
+  if (can_transform && dispatching_) {
+    transform_cache_.push_back(
+      CachedTransform{target_frame, source_frame, stamp, target_frame_trans});
+  }
+
+  return can_transform;
+}
+
+void SharedSensorInputs::clearTransforms()
+{
+  transform_cache_.clear();
+  tf_buffer_->clear();
+}
+
+void SharedSensorInputs::beginDispatch()
+{
+  transform_cache_.clear();
+  dispatching_ = true;
+}
+
+void SharedSensorInputs::endDispatch()
+{
+  dispatching_ = false;
+  transform_cache_.clear();
+}
+
+}  // namespace robot_localization
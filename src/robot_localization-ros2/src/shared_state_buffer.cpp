@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2016, TNO IVS Helmond.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "robot_localization/shared_state_buffer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Eigen/Dense"
+
+namespace robot_localization
+{
+
+namespace shared_state
+{
+
+size_t segmentSize(uint32_t capacity)
+{
+  return sizeof(Header) + capacity * sizeof(Slot);
+}
+
+}  // namespace shared_state
+
+namespace
+{
+
+void copyFrameId(const std::string & source, char * destination)
+{
+  const size_t length = std::min(source.size(), shared_state::FRAME_ID_LENGTH - 1);
+  std::memcpy(destination, source.data(), length);
+  destination[length] = '\0';
+}
+
+}  // namespace
+
+SharedStateWriter::SharedStateWriter()
+: header_(nullptr),
+  slots_(nullptr),
+  size_(0)
+{
+}
+
+SharedStateWriter::~SharedStateWriter()
+{
+  if (header_ != nullptr) {
+    munmap(header_, size_);
+    shm_unlink(name_.c_str());
+  }
+}
+
+bool SharedStateWriter::initialize(
+  const std::string & name,
+  unsigned int capacity,
+  FilterTypes::FilterType filter_type,
+  const Eigen::MatrixXd & process_noise_covariance,
+  const std::vector<double> & filter_args)
+{
+  if (header_ != nullptr || capacity == 0 ||
+    process_noise_covariance.rows() != STATE_SIZE ||
+    process_noise_covariance.cols() != STATE_SIZE)
+  {
+    return false;
+  }
+
+  // Start from a fresh segment, clients that still map an old one keep
+  // reading stale data until they open() again
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    return false;
+  }
+
+  const size_t size = shared_state::segmentSize(capacity);
+  if (ftruncate(fd, size) != 0) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  void * address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  name_ = name;
+  size_ = size;
+  header_ = new (address) shared_state::Header();
+  slots_ = reinterpret_cast<shared_state::Slot *>(
+    static_cast<char *>(address) + sizeof(shared_state::Header));
+
+  header_->layout_version = shared_state::LAYOUT_VERSION;
+  header_->capacity = capacity;
+  header_->filter_type = filter_type;
+  header_->num_filter_args = std::min(filter_args.size(), shared_state::MAX_FILTER_ARGS);
+  std::copy(
+    filter_args.begin(), filter_args.begin() + header_->num_filter_args,
+    header_->filter_args);
+  // Row major, as the process_noise_covariance parameter
+  for (int i = 0; i < STATE_SIZE; ++i) {
+    for (int j = 0; j < STATE_SIZE; ++j) {
+      header_->process_noise_covariance[i * STATE_SIZE + j] = process_noise_covariance(i, j);
+    }
+  }
+
+  // Publish the segment only once it is complete
+  header_->magic.store(shared_state::MAGIC, std::memory_order_release);
+  return true;
+}
+
+bool SharedStateWriter::isInitialized() const
+{
+  return header_ != nullptr;
+}
+
+void SharedStateWriter::beginWrite()
+{
+  header_->sequence.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SharedStateWriter::endWrite()
+{
+  header_->sequence.fetch_add(1, std::memory_order_release);
+}
+
+void SharedStateWriter::setFrameIds(
+  const std::string & world_frame_id,
+  const std::string & base_frame_id)
+{
+  if (header_ == nullptr) {
+    return;
+  }
+
+  beginWrite();
+  copyFrameId(world_frame_id, header_->world_frame_id);
+  copyFrameId(base_frame_id, header_->base_frame_id);
+  endWrite();
+}
+
+void SharedStateWriter::setState(const EstimatorState & state)
+{
+  if (header_ == nullptr) {
+    return;
+  }
+
+  const uint64_t capacity = header_->capacity;
+  auto slot = [this, capacity](uint64_t index) -> shared_state::Slot & {
+      return slots_[(header_->begin + index) % capacity];
+    };
+
+  // Same as RobotLocalizationEstimator::setState() on a boost::circular_buffer:
+  // append newer states, insert older ones before the first newer state
+  uint64_t position = header_->size;
+  if (header_->size > 0 && state.time_stamp <= slot(header_->size - 1).time_stamp) {
+    for (position = 0; position < header_->size; ++position) {
+      if (state.time_stamp < slot(position).time_stamp) {
+        break;
+      }
+    }
+    if (position == header_->size) {
+      return;
+    }
+  }
+
+  beginWrite();
+
+  // A full buffer drops its oldest state. Inserting in front of it drops the
+  // new state instead.
+  bool insert = true;
+  if (header_->size == capacity) {
+    if (position == 0) {
+      insert = false;
+    } else {
+      header_->begin = (header_->begin + 1) % capacity;
+      header_->size--;
+      position--;
+    }
+  }
+
+  if (insert) {
+    for (uint64_t i = header_->size; i > position; --i) {
+      slot(i) = slot(i - 1);
+    }
+    shared_state::Slot & target = slot(position);
+    target.time_stamp = state.time_stamp;
+    Eigen::Map<Eigen::Matrix<double, STATE_SIZE, 1>>(target.state) = state.state;
+    Eigen::Map<Eigen::Matrix<double, STATE_SIZE, STATE_SIZE>>(target.covariance) =
+      state.covariance;
+    header_->size++;
+  }
+
+  endWrite();
+}
+
+SharedStateClient::SharedStateClient()
+: header_(nullptr),
+  slots_(nullptr),
+  size_(0)
+{
+}
+
+SharedStateClient::~SharedStateClient()
+{
+  close();
+}
+
+void SharedStateClient::close()
+{
+  if (header_ != nullptr) {
+    munmap(const_cast<shared_state::Header *>(header_), size_);
+    header_ = nullptr;
+    slots_ = nullptr;
+    size_ = 0;
+  }
+  estimator_.reset();
+}
+
+bool SharedStateClient::open(const std::string & name)
+{
+  close();
+
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) != 0 ||
+    static_cast<size_t>(status.st_size) < sizeof(shared_state::Header))
+  {
+    ::close(fd);
+    return false;
+  }
+
+  const size_t size = status.st_size;
+  void * address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    return false;
+  }
+
+  const auto * header = static_cast<const shared_state::Header *>(address);
+  if (header->magic.load(std::memory_order_acquire) != shared_state::MAGIC ||
+    header->layout_version != shared_state::LAYOUT_VERSION ||
+    shared_state::segmentSize(header->capacity) > size ||
+    (header->filter_type != FilterTypes::EKF && header->filter_type != FilterTypes::UKF))
+  {
+    munmap(address, size);
+    return false;
+  }
+
+  header_ = header;
+  slots_ = reinterpret_cast<const shared_state::Slot *>(
+    static_cast<const char *>(address) + sizeof(shared_state::Header));
+  size_ = size;
+
+  // The filter parameters never change after the segment was published
+  Eigen::MatrixXd process_noise_covariance(STATE_SIZE, STATE_SIZE);
+  for (int i = 0; i < STATE_SIZE; ++i) {
+    for (int j = 0; j < STATE_SIZE; ++j) {
+      process_noise_covariance(i, j) = header_->process_noise_covariance[i * STATE_SIZE + j];
+    }
+  }
+  estimator_ = std::make_unique<RobotLocalizationEstimator>(
+    1, static_cast<FilterTypes::FilterType>(header_->filter_type), process_noise_covariance,
+    std::vector<double>(header_->filter_args, header_->filter_args + header_->num_filter_args));
+
+  return true;
+}
+
+bool SharedStateClient::isOpen() const
+{
+  return header_ != nullptr;
+}
+
+EstimatorResults::EstimatorResult SharedStateClient::getState(
+  const double time,
+  EstimatorState & state)
+{
+  if (header_ == nullptr) {
+    return EstimatorResults::Failed;
+  }
+
+  // Find the state to start from, the same one RobotLocalizationEstimator
+  // would use, and copy it out under the seqlock
+  shared_state::Slot boundary;
+  EstimatorResults::EstimatorResult result;
+  while (true) {
+    const uint64_t sequence = header_->sequence.load(std::memory_order_acquire);
+    if (sequence % 2 == 1) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const uint64_t capacity = header_->capacity;
+    const uint64_t begin = header_->begin;
+    const uint64_t size = std::min<uint64_t>(header_->size, capacity);
+    bool previous_state_found = false;
+    bool next_state_found = false;
+    result = EstimatorResults::EmptyBuffer;
+
+    for (uint64_t i = size; i > 0; --i) {
+      const shared_state::Slot & slot = slots_[(begin + i - 1) % capacity];
+      if (slot.time_stamp == time) {
+        boundary = slot;
+        result = EstimatorResults::Exact;
+        break;
+      } else if (slot.time_stamp <= time) {
+        boundary = slot;
+        previous_state_found = true;
+        break;
+      } else {
+        boundary = slot;
+        next_state_found = true;
+      }
+    }
+
+    if (result != EstimatorResults::Exact) {
+      if (previous_state_found && next_state_found) {
+        result = EstimatorResults::Interpolation;
+      } else if (previous_state_found) {
+        result = EstimatorResults::ExtrapolationIntoFuture;
+      } else if (next_state_found) {
+        result = EstimatorResults::ExtrapolationIntoPast;
+      }
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header_->sequence.load(std::memory_order_relaxed) == sequence) {
+      break;
+    }
+  }
+
+  if (result == EstimatorResults::EmptyBuffer) {
+    return result;
+  }
+
+  EstimatorState boundary_state;
+  boundary_state.time_stamp = boundary.time_stamp;
+  boundary_state.state = Eigen::Map<const Eigen::Matrix<double, STATE_SIZE, 1>>(boundary.state);
+  boundary_state.covariance =
+    Eigen::Map<const Eigen::Matrix<double, STATE_SIZE, STATE_SIZE>>(boundary.covariance);
+
+  if (result == EstimatorResults::Exact) {
+    state = boundary_state;
+    return result;
+  }
+
+  // Like the estimator, interpolation is an extrapolation from the state
+  // before the requested time
+  estimator_->clearBuffer();
+  estimator_->setState(boundary_state);
+  estimator_->getState(time, state);
+  return result;
+}
+
+std::string SharedStateClient::readFrameId(const char * frame_id) const
+{
+  if (header_ == nullptr) {
+    return std::string();
+  }
+
+  char buffer[shared_state::FRAME_ID_LENGTH];
+  while (true) {
+    const uint64_t sequence = header_->sequence.load(std::memory_order_acquire);
+    if (sequence % 2 == 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::memcpy(buffer, frame_id, sizeof(buffer));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header_->sequence.load(std::memory_order_relaxed) == sequence) {
+      break;
+    }
+  }
+  buffer[sizeof(buffer) - 1] = '\0';
+  return std::string(buffer);
+}
+
+std::string SharedStateClient::getWorldFrameId() const
+{
+  return readFrameId(header_ != nullptr ? header_->world_frame_id : nullptr);
+}
+
+std::string SharedStateClient::getBaseFrameId() const
+{
+  return readFrameId(header_ != nullptr ? header_->base_frame_id : nullptr);
+}
+
+}  // namespace robot_localization
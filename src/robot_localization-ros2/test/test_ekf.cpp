@@ -31,6 +31,7 @@
  */
 #include <limits>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -41,9 +42,27 @@
 #include "robot_localization/ros_filter_types.hpp"
 
 using robot_localization::Ekf;
+using robot_localization::Measurement;
+using robot_localization::MeasurementPtr;
 using robot_localization::RosEkf;
 using robot_localization::STATE_SIZE;
 
+// Gives the tests access to the state history of RosEkf
+class RosEkfHistoryAccess : public RosEkf
+{
+public:
+  explicit RosEkfHistoryAccess(const rclcpp::NodeOptions & options)
+  : RosEkf(options) {}
+
+  using RosEkf::revertTo;
+  using RosEkf::saveFilterState;
+
+  size_t historySize() const
+  {
+    return filter_state_history_.size();
+  }
+};
+
 TEST(EkfTest, Measurements) {
   rclcpp::NodeOptions options;
   options.arguments({"ekf_filter_node"});
@@ -113,6 +132,180 @@ TEST(EkfTest, Measurements) {
   }
 }
 
+TEST(EkfTest, BatchCorrectionMatchesSequential) {
+  Ekf sequential;
+  Ekf batch;
+
+  // Initialize both filters from the same full state measurement
+  Measurement initial;
+  initial.time_ = rclcpp::Time(1, 0, RCL_ROS_TIME);
+  initial.measurement_ = Eigen::VectorXd::Zero(STATE_SIZE);
+  initial.covariance_ = Eigen::MatrixXd::Identity(STATE_SIZE, STATE_SIZE) * 0.5;
+  initial.update_vector_.assign(STATE_SIZE, true);
+  initial.measurement_(robot_localization::StateMemberVx) = 1.0;
+  initial.measurement_(robot_localization::StateMemberVyaw) = 0.2;
+  sequential.processMeasurement(initial);
+  batch.processMeasurement(initial);
+
+  // Odometry pose and twist and an IMU, all with the same time stamp. The
+  // IMU overlaps with the odometry in yaw and yaw velocity.
+  auto make_measurement = [](
+    std::vector<int> indices, std::vector<double> values, double variance) {
+      auto measurement = std::make_shared<Measurement>();
+      measurement->time_ = rclcpp::Time(1, 100000000, RCL_ROS_TIME);
+      measurement->measurement_ = Eigen::VectorXd::Zero(STATE_SIZE);
+      measurement->covariance_ =
+        Eigen::MatrixXd::Identity(STATE_SIZE, STATE_SIZE) * variance;
+      measurement->update_vector_.assign(STATE_SIZE, false);
+      for (size_t i = 0; i < indices.size(); ++i) {
+        measurement->measurement_(indices[i]) = values[i];
+        measurement->update_vector_[indices[i]] = true;
+      }
+      return measurement;
+    };
+
+  std::vector<MeasurementPtr> measurements;
+  measurements.push_back(
+    make_measurement(
+      {robot_localization::StateMemberX, robot_localization::StateMemberY,
+        robot_localization::StateMemberYaw}, {0.12, -0.01, 0.03}, 0.01));
+  measurements.push_back(
+    make_measurement(
+      {robot_localization::StateMemberVx, robot_localization::StateMemberVyaw},
+      {1.1, 0.25}, 0.02));
+  measurements.push_back(
+    make_measurement(
+      {robot_localization::StateMemberYaw, robot_localization::StateMemberVyaw,
+        robot_localization::StateMemberAx}, {0.025, 0.22, 0.1}, 0.05));
+  measurements.back()->covariance_(
+    robot_localization::StateMemberYaw, robot_localization::StateMemberVyaw) = 0.01;
+  measurements.back()->covariance_(
+    robot_localization::StateMemberVyaw, robot_localization::StateMemberYaw) = 0.01;
+
+  for (const auto & measurement : measurements) {
+    sequential.processMeasurement(*measurement);
+  }
+  batch.processMeasurementBatch(measurements);
+
+  EXPECT_EQ(sequential.getLastMeasurementTime(), batch.getLastMeasurementTime());
+  for (size_t i = 0; i < STATE_SIZE; ++i) {
+    EXPECT_NEAR(sequential.getState()(i), batch.getState()(i), 1e-9);
+    for (size_t j = 0; j < STATE_SIZE; ++j) {
+      EXPECT_NEAR(
+        sequential.getEstimateErrorCovariance()(i, j),
+        batch.getEstimateErrorCovariance()(i, j), 1e-9);
+    }
+  }
+}
+
+TEST(EkfTest, ReorderDelayAvoidsReverts) {
+  auto make_filter = [](const std::string & name, const double reorder_delay) {
+      rclcpp::NodeOptions options;
+      options.arguments({name});
+      options.parameter_overrides(
+        {rclcpp::Parameter("smooth_lagged_data", true),
+          rclcpp::Parameter("history_length", 1.0),
+          rclcpp::Parameter("reorder_delay", reorder_delay)});
+      auto filter = std::make_shared<RosEkf>(options);
+      filter->initialize();
+      return filter;
+    };
+
+  auto enqueue = [](RosEkf & filter, const std::string & topic, const int64_t stamp_ms) {
+      Eigen::VectorXd measurement = Eigen::VectorXd::Zero(STATE_SIZE);
+      measurement(robot_localization::StateMemberVx) = 1.0;
+      Eigen::MatrixXd covariance = Eigen::MatrixXd::Identity(STATE_SIZE, STATE_SIZE) * 1e-3;
+      filter.enqueueMeasurement(
+        topic, measurement, covariance, std::vector<bool>(STATE_SIZE, true),
+        std::numeric_limits<double>::max(), rclcpp::Time(stamp_ms * 1000000, RCL_ROS_TIME));
+    };
+  auto time = [](const int64_t stamp_ms) {
+      return rclcpp::Time(stamp_ms * 1000000, RCL_ROS_TIME);
+    };
+
+  // Without a reorder window the imu measurement arrives after the filter
+  // already processed a later odometry measurement
+  auto immediate = make_filter("ekf_immediate", 0.0);
+  enqueue(*immediate, "odom0", 1000);
+  enqueue(*immediate, "odom0", 1020);
+  immediate->integrateMeasurements(time(1021));
+  enqueue(*immediate, "imu0", 1010);
+  immediate->integrateMeasurements(time(1031));
+  EXPECT_EQ(1u, immediate->getReorderStatistics().late_measurements_);
+  EXPECT_EQ(1u, immediate->getReorderStatistics().reverts_);
+  EXPECT_EQ(1u, immediate->getReorderStatistics().reintegrated_measurements_);
+
+  // With a 50 ms window it is still sorted in before the odometry
+  auto delayed = make_filter("ekf_delayed", 0.05);
+  enqueue(*delayed, "odom0", 1000);
+  enqueue(*delayed, "odom0", 1020);
+  delayed->integrateMeasurements(time(1021));
+  EXPECT_FALSE(delayed->getFilter().getInitializedStatus());
+  enqueue(*delayed, "imu0", 1010);
+  delayed->integrateMeasurements(time(1031));
+  delayed->integrateMeasurements(time(1071));
+  EXPECT_EQ(time(1020), delayed->getFilter().getLastMeasurementTime());
+  EXPECT_EQ(1u, delayed->getReorderStatistics().late_measurements_);
+  EXPECT_EQ(0u, delayed->getReorderStatistics().reverts_);
+  EXPECT_EQ(0u, delayed->getReorderStatistics().reintegrated_measurements_);
+  EXPECT_EQ(3u, delayed->getReorderStatistics().integrations_);
+
+  // Both end up with the same estimate
+  for (size_t i = 0; i < STATE_SIZE; ++i) {
+    EXPECT_NEAR(immediate->getFilter().getState()(i), delayed->getFilter().getState()(i), 1e-9);
+  }
+}
+
+TEST(EkfTest, RevertPastOldestState) {
+  rclcpp::NodeOptions options;
+  options.arguments({"ekf_revert"});
+  options.parameter_overrides(
+    {rclcpp::Parameter("smooth_lagged_data", true),
+      rclcpp::Parameter("history_length", 1.0)});
+  auto filter = std::make_shared<RosEkfHistoryAccess>(options);
+  filter->initialize();
+
+  auto time = [](const int64_t stamp_ms) {
+      return rclcpp::Time(stamp_ms * 1000000, RCL_ROS_TIME);
+    };
+  auto state = [](const int64_t stamp_ms) {
+      return Eigen::VectorXd::Constant(STATE_SIZE, 0.001 * stamp_ms);
+    };
+
+  // States saved at 1000, 1010 and 1020 ms
+  for (const int64_t stamp_ms : {1000, 1010, 1020}) {
+    filter->getFilter().setState(state(stamp_ms));
+    filter->getFilter().setLastMeasurementTime(time(stamp_ms));
+    filter->saveFilterState(filter->getFilter());
+  }
+  ASSERT_EQ(3u, filter->historySize());
+
+  // Between two states: the older one is restored and kept
+  filter->getFilter().setState(state(0));
+  EXPECT_TRUE(filter->revertTo(time(1015)));
+  EXPECT_EQ(state(1010), filter->getFilter().getState());
+  EXPECT_EQ(time(1010), filter->getFilter().getLastMeasurementTime());
+  EXPECT_EQ(2u, filter->historySize());
+
+  // Exactly at the oldest state: restored and kept
+  EXPECT_TRUE(filter->revertTo(time(1000)));
+  EXPECT_EQ(state(1000), filter->getFilter().getState());
+  EXPECT_EQ(1u, filter->historySize());
+
+  // Before the oldest state: insufficient history, the oldest state is
+  // restored anyway and dropped from the history
+  filter->getFilter().setState(state(0));
+  EXPECT_FALSE(filter->revertTo(time(990)));
+  EXPECT_EQ(state(1000), filter->getFilter().getState());
+  EXPECT_EQ(time(1000), filter->getFilter().getLastMeasurementTime());
+  EXPECT_EQ(0u, filter->historySize());
+
+  // Nothing left to revert to
+  filter->getFilter().setState(state(0));
+  EXPECT_FALSE(filter->revertTo(time(990)));
+  EXPECT_EQ(state(0), filter->getFilter().getState());
+}
+
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2014, 2015, 2016, Charles River Analytics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <array>
+
+#include "gtest/gtest.h"
+#include "robot_localization/ekf.hpp"
+#include "robot_localization/filter_state.hpp"
+#include "robot_localization/filter_state_history.hpp"
+
+using robot_localization::Ekf;
+using robot_localization::FilterStateHistory;
+using robot_localization::STATE_SIZE;
+
+namespace
+{
+
+const int HISTORY_SIZE = 1000;
+
+// Fills the filter with a distinct, symmetric positive definite state for
+// time stamp @p i
+void setFilterState(Ekf & filter, const int i)
+{
+  Eigen::VectorXd state(STATE_SIZE);
+  Eigen::MatrixXd covariance(STATE_SIZE, STATE_SIZE);
+  for (int row = 0; row < STATE_SIZE; ++row) {
+    state(row) = 0.5 * i + row;
+    for (int col = 0; col < STATE_SIZE; ++col) {
+      covariance(row, col) = 1e-3 * (row + col + i % 7);
+    }
+    covariance(row, row) += 1.0 + row;
+  }
+  filter.setState(state);
+  filter.setEstimateErrorCovariance(covariance);
+  filter.setLastMeasurementTime(rclcpp::Time(i, 0, RCL_ROS_TIME));
+}
+
+// Allocated size of a FilterState as it was stored in the old
+// std::deque<FilterStatePtr> history
+size_t legacyStateSize()
+{
+  return sizeof(robot_localization::FilterStatePtr) +
+         sizeof(robot_localization::FilterState) +
+         sizeof(double) * (STATE_SIZE + STATE_SIZE * STATE_SIZE +
+         robot_localization::TWIST_SIZE);
+}
+
+}  // namespace
+
+TEST(FilterStateHistoryTest, PackRoundTrip)
+{
+  Ekf filter;
+  setFilterState(filter, 3);
+  const Eigen::MatrixXd covariance = filter.getEstimateErrorCovariance();
+
+  std::array<double, robot_localization::PACKED_COVARIANCE_SIZE> packed;
+  robot_localization::packCovariance(covariance, packed.data());
+  Eigen::MatrixXd unpacked;
+  robot_localization::unpackCovariance(packed.data(), unpacked);
+  EXPECT_EQ(covariance, unpacked);
+
+  std::array<float, robot_localization::PACKED_COVARIANCE_SIZE> packed_float;
+  robot_localization::packCovariance(covariance, packed_float.data());
+  robot_localization::unpackCovariance(packed_float.data(), unpacked);
+  EXPECT_TRUE(covariance.isApprox(unpacked, 1e-6));
+}
+
+TEST(FilterStateHistoryTest, RestoreOrder)
+{
+  for (const bool float_covariance : {false, true}) {
+    Ekf filter;
+    FilterStateHistory history;
+    history.setFloatCovariance(float_covariance);
+
+    for (int i = 0; i < 10; ++i) {
+      setFilterState(filter, i);
+      history.push(filter);
+    }
+    ASSERT_EQ(10u, history.size());
+    EXPECT_EQ(rclcpp::Time(0, 0, RCL_ROS_TIME), history.frontTime());
+    EXPECT_EQ(rclcpp::Time(9, 0, RCL_ROS_TIME), history.backTime());
+
+    history.popFront();
+    history.popBack();
+    history.popBack();
+    EXPECT_EQ(7u, history.size());
+    EXPECT_EQ(rclcpp::Time(1, 0, RCL_ROS_TIME), history.frontTime());
+
+    Ekf expected;
+    setFilterState(expected, 7);
+    setFilterState(filter, 42);
+    history.restoreBack(filter);
+
+    EXPECT_EQ(expected.getState(), filter.getState());
+    EXPECT_TRUE(
+      expected.getEstimateErrorCovariance().isApprox(
+        filter.getEstimateErrorCovariance(), float_covariance ? 1e-6 : 0.0));
+    EXPECT_EQ(expected.getLastMeasurementTime(), filter.getLastMeasurementTime());
+  }
+}
+
+TEST(FilterStateHistoryTest, MemoryUsage)
+{
+  size_t double_bytes = 0;
+  for (const bool float_covariance : {false, true}) {
+    Ekf filter;
+    FilterStateHistory history;
+    history.setFloatCovariance(float_covariance);
+    for (int i = 0; i < HISTORY_SIZE; ++i) {
+      setFilterState(filter, i);
+      history.push(filter);
+    }
+    const size_t bytes = history.memoryUsage();
+
+    // Capacity grows by doubling, so at most twice the records are reserved
+    EXPECT_LE(bytes, 2 * HISTORY_SIZE * legacyStateSize());
+    if (float_covariance) {
+      EXPECT_LT(bytes, double_bytes);
+    } else {
+      double_bytes = bytes;
+    }
+  }
+
+  // A single record is much smaller than a heap allocated FilterState
+  EXPECT_LT(sizeof(robot_localization::PackedFilterState<double>), legacyStateSize());
+  EXPECT_LT(
+    sizeof(robot_localization::PackedFilterState<float>),
+    sizeof(robot_localization::PackedFilterState<double>));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
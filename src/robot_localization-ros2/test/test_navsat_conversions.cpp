@@ -65,6 +65,78 @@ TEST(NavsatConversionsTest, UtmTest)
   NavsatConversionsTest(-43.530955, 172.636645, 5178919.718, 632246.802, "59G", -1.127);
 }
 
+TEST(NavsatConversionsTest, UtmZoneConverterTest)
+{
+  // within the zone the results must match GeographicLib through LLtoUTM() / UTMtoLL()
+  const double points[][2] = {
+    {51.423964, 5.494271}, {51.0, 0.1}, {55.9, 5.9}, {-43.530955, 172.636645},
+    {-47.9, 168.1}, {0.5, 3.0}, {83.9, 2.5}};
+  for (const auto & point : points) {
+    double UTMNorthing;
+    double UTMEasting;
+    std::string UTMZone;
+    double gamma;
+    robot_localization::navsat_conversions::LLtoUTM(
+      point[0], point[1], UTMNorthing, UTMEasting, UTMZone, gamma);
+
+    const robot_localization::navsat_conversions::UTMZoneConverter converter(UTMZone);
+    ASSERT_TRUE(converter.valid());
+    EXPECT_EQ(UTMZone, converter.zone());
+
+    double UTMNorthing_new;
+    double UTMEasting_new;
+    double gamma_new;
+    converter.LLtoUTM(point[0], point[1], UTMNorthing_new, UTMEasting_new, gamma_new);
+    EXPECT_NEAR(UTMNorthing, UTMNorthing_new, 1e-6);
+    EXPECT_NEAR(UTMEasting, UTMEasting_new, 1e-6);
+    EXPECT_NEAR(gamma, gamma_new, 1e-9);
+
+    double lat;
+    double lon;
+    double lat_new;
+    double lon_new;
+    robot_localization::navsat_conversions::UTMtoLL(
+      UTMNorthing, UTMEasting, UTMZone, lat, lon);
+    converter.UTMtoLL(UTMNorthing, UTMEasting, lat_new, lon_new);
+    EXPECT_NEAR(lat, lat_new, 1e-12);
+    EXPECT_NEAR(lon, lon_new, 1e-12);
+    EXPECT_NEAR(point[0], lat_new, 1e-9);
+    EXPECT_NEAR(point[1], lon_new, 1e-9);
+  }
+}
+
+TEST(NavsatConversionsTest, UtmZoneConverterNeighborZoneTest)
+{
+  // points of the neighboring zones and hemisphere are projected into the given zone,
+  // same as GeographicLib::UTMUPS::Forward() with that zone set
+  const robot_localization::navsat_conversions::UTMZoneConverter converter("31U");
+  const double points[][2] = {{51.5, -0.5}, {51.5, 6.5}, {-0.1, 3.0}};
+  for (const auto & point : points) {
+    int zone;
+    bool northp;
+    double x;
+    double y;
+    double gamma;
+    double k;
+    GeographicLib::UTMUPS::Forward(point[0], point[1], zone, northp, x, y, gamma, k, 31);
+    if (!northp) {
+      y -= GeographicLib::UTMUPS::UTMShift();
+    }
+
+    double UTMNorthing;
+    double UTMEasting;
+    converter.LLtoUTM(point[0], point[1], UTMNorthing, UTMEasting);
+    EXPECT_NEAR(y, UTMNorthing, 1e-6);
+    EXPECT_NEAR(x, UTMEasting, 1e-6);
+
+    double lat;
+    double lon;
+    converter.UTMtoLL(UTMNorthing, UTMEasting, lat, lon);
+    EXPECT_NEAR(point[0], lat, 1e-9);
+    EXPECT_NEAR(point[1], lon, 1e-9);
+  }
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
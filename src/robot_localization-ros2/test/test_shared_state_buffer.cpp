@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2014, 2015, 2016, Charles River Analytics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "robot_localization/robot_localization_estimator.hpp"
+#include "robot_localization/shared_state_buffer.hpp"
+
+using robot_localization::EstimatorResults::EstimatorResult;
+using robot_localization::EstimatorState;
+
+std::string segmentName()
+{
+  return "/rl_test_shared_state_" + std::to_string(getpid());
+}
+
+EstimatorState makeState(double t)
+{
+  EstimatorState state;
+  state.time_stamp = t;
+  state.state(robot_localization::StateMemberX) = t;
+  state.state(robot_localization::StateMemberYaw) = 0.1 * t;
+  state.state(robot_localization::StateMemberVx) = 1;
+  state.state(robot_localization::StateMemberVyaw) = 0.1;
+  state.covariance.setIdentity();
+  state.covariance *= 0.01 * (t + 1);
+  return state;
+}
+
+TEST(SharedStateBufferTest, MatchesEstimator)
+{
+  const unsigned int buffer_capacity = 5;
+  Eigen::MatrixXd process_noise_covariance = Eigen::MatrixXd::Identity(
+    robot_localization::STATE_SIZE, robot_localization::STATE_SIZE) * 0.05;
+
+  robot_localization::RobotLocalizationEstimator estimator(buffer_capacity,
+    robot_localization::FilterTypes::EKF, process_noise_covariance);
+  robot_localization::SharedStateWriter writer;
+  ASSERT_TRUE(writer.initialize(
+    segmentName(), buffer_capacity, robot_localization::FilterTypes::EKF,
+    process_noise_covariance));
+
+  robot_localization::SharedStateClient client;
+  ASSERT_TRUE(client.open(segmentName()));
+
+  EstimatorState state;
+  EXPECT_EQ(
+    robot_localization::EstimatorResults::EmptyBuffer, client.getState(1.0, state));
+
+  writer.setFrameIds("odom", "base_link");
+  EXPECT_EQ(client.getWorldFrameId(), "odom");
+  EXPECT_EQ(client.getBaseFrameId(), "base_link");
+
+  // In order, out of order, duplicate and dropped (older than a full buffer)
+  // insertions
+  std::vector<double> times = {1, 2, 4, 3, 0.5, 4, 5, 6, 0.2, 7, 5.5};
+  std::vector<double> queries = {0, 0.5, 1, 2.5, 3, 5.2, 7, 9};
+  for (double t : times) {
+    estimator.setState(makeState(t));
+    writer.setState(makeState(t));
+
+    for (double query : queries) {
+      EstimatorState expected, actual;
+      EstimatorResult expected_result = estimator.getState(query, expected);
+      EstimatorResult actual_result = client.getState(query, actual);
+      EXPECT_EQ(expected_result, actual_result);
+      EXPECT_DOUBLE_EQ(expected.time_stamp, actual.time_stamp);
+      EXPECT_TRUE(expected.state.isApprox(actual.state, 1e-12));
+      EXPECT_TRUE(expected.covariance.isApprox(actual.covariance, 1e-12));
+    }
+  }
+}
+
+TEST(SharedStateBufferTest, OpenFailures)
+{
+  robot_localization::SharedStateClient client;
+  EXPECT_FALSE(client.open(segmentName() + "_missing"));
+  EXPECT_FALSE(client.isOpen());
+
+  EstimatorState state;
+  EXPECT_EQ(robot_localization::EstimatorResults::Failed, client.getState(0.0, state));
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}